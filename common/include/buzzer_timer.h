@@ -0,0 +1,167 @@
+/**
+ * @file buzzer_timer.h
+ * @brief Header for buzzer_timer.c file.
+ *
+ * Register values ({PSC, ARR, CCR1}) of the timers of the buzzer. The PWM timer generates the frequency of the note
+ * and the duration timer its length. The values of every note of `melodies.h` (DO3 to SI5) and of the common
+ * durations are precomputed at build time for BUZZER_TIMER_TABLE_CLOCK_HZ, so changing the note is a table lookup.
+ * Any other value, or any other clock, is computed with buzzer_timer_solve(), an integer-only closed-form solver,
+ * instead of searching the prescaler.
+ *
+ * The module does not access the hardware: the ports write the values in the registers.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef BUZZER_TIMER_H_
+#define BUZZER_TIMER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Other includes */
+#include "melodies.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define BUZZER_TIMER_TABLE_CLOCK_HZ 16000000U /*!< Clock of the timers for which the tables are precomputed (HSI) */
+#define BUZZER_TIMER_MAX_COUNT 65536U         /*!< Number of values of the 16-bit PSC and ARR registers */
+#define BUZZER_TIMER_PWM_DUTY_PERCENT 50U     /*!< Duty cycle of the PWM signal of the buzzer */
+#define BUZZER_TIMER_FIRST_NOTE MIDI_DO3      /*!< MIDI note number of the first note of the table */
+#define BUZZER_TIMER_NUM_NOTES 36U            /*!< Number of notes in the table (DO3 to SI5) */
+#define BUZZER_TIMER_NUM_DURATIONS 10U        /*!< Number of durations in the table */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Values of the registers of a timer.
+ */
+typedef struct
+{
+    uint16_t psc;  /*!< Prescaler */
+    uint16_t arr;  /*!< Auto-reload value: the period is (PSC + 1) * (ARR + 1) clock cycles */
+    uint16_t ccr1; /*!< Compare value of channel 1 (PWM only) */
+} buzzer_timer_config_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Get the index of a note in the table of notes.
+ *
+ * @param frequency_mhz Frequency of the note in millihertz
+ * @return int32_t Index of the note, or -1 if it is not in the table
+ */
+int32_t buzzer_timer_find_note(uint32_t frequency_mhz);
+
+/**
+ * @brief Get the precomputed configuration of the PWM timer for a note of the table.
+ *
+ * @param note_index Index of the note (0 for DO3 to BUZZER_TIMER_NUM_NOTES - 1 for SI5)
+ * @return const buzzer_timer_config_t* Configuration, or NULL if the index is not valid
+ */
+const buzzer_timer_config_t *buzzer_timer_get_note_entry(uint32_t note_index);
+
+/**
+ * @brief Get the configuration of the PWM timer for a MIDI note, without floating point.
+ *
+ * The table is indexed directly if the clock is BUZZER_TIMER_TABLE_CLOCK_HZ and the note is from DO3 to SI5.
+ * Otherwise the configuration is solved with buzzer_timer_solve_frequency().
+ *
+ * @param clock_hz Clock of the timer in Hz
+ * @param note MIDI note number. It must not be MIDI_SILENCE
+ * @param p_config Pointer where the configuration is stored
+ * @return true if the configuration has been taken from the table, false if it has been computed
+ */
+bool buzzer_timer_get_midi_config(uint32_t clock_hz, uint8_t note, buzzer_timer_config_t *p_config);
+
+/**
+ * @brief Get the configuration of the PWM timer for a frequency.
+ *
+ * The frequency is converted once to millihertz. The table is used if the clock is BUZZER_TIMER_TABLE_CLOCK_HZ and the
+ * frequency is one of the notes of the table. Otherwise the configuration is solved with
+ * buzzer_timer_solve_frequency().
+ *
+ * @param clock_hz Clock of the timer in Hz
+ * @param frequency_hz Frequency of the note in Hz. It must be greater than 0
+ * @param p_config Pointer where the configuration is stored
+ * @return true if the configuration has been taken from the table, false if it has been computed
+ */
+bool buzzer_timer_get_note_config(uint32_t clock_hz, double frequency_hz, buzzer_timer_config_t *p_config);
+
+/**
+ * @brief Get the configuration of the duration timer for a duration.
+ *
+ * The table is used if the clock is BUZZER_TIMER_TABLE_CLOCK_HZ and the duration is one of the common durations of
+ * the melodies. Otherwise the configuration is computed with buzzer_timer_compute_duration().
+ *
+ * @param clock_hz Clock of the timer in Hz
+ * @param duration_ms Duration in milliseconds. It must be greater than 0
+ * @param p_config Pointer where the configuration is stored (CCR1 is not used)
+ * @return true if the configuration has been taken from the table, false if it has been computed
+ */
+bool buzzer_timer_get_duration_config(uint32_t clock_hz, uint32_t duration_ms, buzzer_timer_config_t *p_config);
+
+/**
+ * @brief Get the configuration of the duration timer for a note of a queue, carrying the rounding error to the next
+ * note.
+ *
+ * The duration that is counted is the requested one plus the error carried from the previous notes, so the errors of
+ * the notes do not accumulate. Whole-millisecond durations of the table are taken from it, at
+ * BUZZER_TIMER_TABLE_CLOCK_HZ, and the carried error only moves ARR by a count at most. Any other duration is solved
+ * with buzzer_timer_solve().
+ *
+ * @param clock_hz Clock of the timer in Hz
+ * @param duration_us Duration in microseconds
+ * @param p_error Pointer to the carried error, in millionths of a clock cycle. It is updated with the error of this note
+ * @param p_config Pointer where the configuration is stored (CCR1 is not used)
+ * @return true if the configuration has been taken from the table, false if it has been solved
+ */
+bool buzzer_timer_get_carried_duration_config(uint32_t clock_hz, uint32_t duration_us, int64_t *p_error, buzzer_timer_config_t *p_config);
+
+/**
+ * @brief Integer-only solver of the prescaler and auto-reload of a period.
+ *
+ * The prescaler is the smallest one that keeps ARR in 16 bits, PSC = ceil(cycles / 65536) - 1, so ARR has the finest
+ * resolution. ARR is rounded to the nearest count, which minimises the error of the period for that prescaler: the
+ * error is at most (PSC + 1) / 2 clock cycles. Periods longer than the timer allows are saturated. CCR1 is set for
+ * BUZZER_TIMER_PWM_DUTY_PERCENT.
+ *
+ * @param cycles_num Numerator of the period in clock cycles
+ * @param cycles_den Denominator of the period in clock cycles. It must be greater than 0
+ * @param p_config Pointer where the configuration is stored
+ * @return uint64_t Period achieved in clock cycles: (PSC + 1) * (ARR + 1)
+ */
+uint64_t buzzer_timer_solve(uint64_t cycles_num, uint64_t cycles_den, buzzer_timer_config_t *p_config);
+
+/**
+ * @brief Solve the configuration of the PWM timer for a frequency.
+ *
+ * @param clock_hz Clock of the timer in Hz
+ * @param frequency_mhz Frequency in millihertz. It must be greater than 0
+ * @param p_config Pointer where the configuration is stored
+ * @return uint32_t Frequency achieved in millihertz (rounded)
+ */
+uint32_t buzzer_timer_solve_frequency(uint32_t clock_hz, uint32_t frequency_mhz, buzzer_timer_config_t *p_config);
+
+/**
+ * @brief Solve the configuration of the duration timer for a duration.
+ *
+ * @param clock_hz Clock of the timer in Hz
+ * @param duration_us Duration in microseconds
+ * @param p_config Pointer where the configuration is stored (CCR1 is not used)
+ * @return uint32_t Duration achieved in microseconds (rounded)
+ */
+uint32_t buzzer_timer_solve_duration(uint32_t clock_hz, uint32_t duration_us, buzzer_timer_config_t *p_config);
+
+/**
+ * @brief Compute the configuration of the duration timer for any duration (closed-form fallback).
+ *
+ * @param clock_hz Clock of the timer in Hz
+ * @param duration_ms Duration in milliseconds. It must be greater than 0
+ * @param p_config Pointer where the configuration is stored (CCR1 is not used)
+ */
+void buzzer_timer_compute_duration(uint32_t clock_hz, uint32_t duration_ms, buzzer_timer_config_t *p_config);
+
+#endif /* BUZZER_TIMER_H_ */
@@ -0,0 +1,147 @@
+/**
+ * @file command_frame.h
+ * @brief Header for command_frame.c file.
+ *
+ * Binary frames of the control protocol, accepted by the same USART as the text commands. A frame is SLIP framing
+ * adapted to the line channel: it starts with COMMAND_FRAME_START (the SLIP END byte 0xC0, which never appears in
+ * UTF-8 text, so each line is told apart by its first byte) and ends with the same '\n' as a text line. Inside the
+ * frame, the bytes 0xC0 and 0xDB are escaped as in SLIP, and '\n' and '\0' are also escaped, so a frame goes through
+ * the line ring of the USART unchanged.
+ *
+ * The decoded frame is an opcode byte, its arguments with a fixed width in little-endian order and the CRC-16/CCITT
+ * (polynomial 0x1021, initial value 0xFFFF) of the opcode and the arguments, also in little-endian order. Each frame
+ * is answered with a reply frame: the opcode with COMMAND_FRAME_REPLY_FLAG set, a status byte and the text of the
+ * reply of the command, if any.
+ *
+ * The module has no hardware dependencies: the same functions encode the requests on the control host.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef COMMAND_FRAME_H_
+#define COMMAND_FRAME_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define COMMAND_FRAME_START 0xC0U       /*!< First byte of a frame (SLIP END) */
+#define COMMAND_FRAME_END '\n'          /*!< Last byte of a frame, the same as a text line */
+#define COMMAND_FRAME_ESC 0xDBU         /*!< Escape byte (SLIP ESC) */
+#define COMMAND_FRAME_ESC_START 0xDCU   /*!< Escaped COMMAND_FRAME_START */
+#define COMMAND_FRAME_ESC_ESC 0xDDU     /*!< Escaped COMMAND_FRAME_ESC */
+#define COMMAND_FRAME_ESC_END 0xDEU     /*!< Escaped '\n' */
+#define COMMAND_FRAME_ESC_NUL 0xDFU     /*!< Escaped '\0' */
+#define COMMAND_FRAME_MAX_DATA 88U      /*!< Maximum number of bytes after the opcode */
+#define COMMAND_FRAME_CRC_LENGTH 2U     /*!< Bytes of the CRC */
+#define COMMAND_FRAME_REPLY_FLAG 0x80U  /*!< Bit of the opcode set in the replies */
+#define COMMAND_FRAME_SPEED_SCALE 1000U /*!< The argument of COMMAND_OP_SPEED is the speed in thousandths */
+
+/* Enums */
+/**
+ * @brief Opcodes of the requests. Each one is a command of the text protocol with its argument in binary.
+ */
+typedef enum
+{
+    COMMAND_OP_PLAY = 0x01,   /*!< "play", no argument */
+    COMMAND_OP_STOP = 0x02,   /*!< "stop", no argument */
+    COMMAND_OP_PAUSE = 0x03,  /*!< "pause", no argument */
+    COMMAND_OP_SPEED = 0x04,  /*!< "speed", uint16_t speed in thousandths */
+    COMMAND_OP_NEXT = 0x05,   /*!< "next", no argument */
+    COMMAND_OP_SELECT = 0x06, /*!< "select", uint8_t index of the melody */
+    COMMAND_OP_LIST = 0x07,   /*!< "lista", no argument */
+    COMMAND_OP_INFO = 0x08,   /*!< "info", no argument: the reply is the melody being played */
+    COMMAND_OP_STREAM = 0x09, /*!< "stream", no argument */
+    COMMAND_OP_POLY = 0x0A,   /*!< "poly", no argument */
+    COMMAND_OP_SYNTH = 0x0B,  /*!< "synth", no argument */
+    COMMAND_NUM_OPS           /*!< Number of opcodes (the opcode 0 is not used) */
+} command_op_t;
+
+/**
+ * @brief Status of a frame, sent in the replies.
+ */
+typedef enum
+{
+    COMMAND_FRAME_OK = 0,       /*!< The frame is valid and the command has been executed */
+    COMMAND_FRAME_ERROR_FORMAT, /*!< The frame does not start with COMMAND_FRAME_START, has a wrong escape or length */
+    COMMAND_FRAME_ERROR_CRC,    /*!< The CRC does not match */
+    COMMAND_FRAME_ERROR_OPCODE, /*!< The opcode is not known */
+    COMMAND_FRAME_ERROR_ARG     /*!< The arguments do not have the width of the opcode */
+} command_frame_status_t;
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Decoded frame, without the CRC.
+ */
+typedef struct
+{
+    uint8_t opcode;                       /*!< Opcode of the request, or of the reply with COMMAND_FRAME_REPLY_FLAG */
+    uint8_t data[COMMAND_FRAME_MAX_DATA]; /*!< Arguments of the request, or status and text of the reply */
+    uint32_t length;                      /*!< Number of bytes of data */
+} command_frame_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Check if a received line is a binary frame.
+ *
+ * @param p_line Line received (without its end character)
+ * @return true if the line starts with COMMAND_FRAME_START
+ */
+bool command_frame_is_frame(const char *p_line);
+
+/**
+ * @brief Read an argument of a frame in little-endian order.
+ *
+ * @param p_data Pointer to the first byte of the argument
+ * @param width Width of the argument in bytes (1 to 4)
+ * @return uint32_t Value of the argument
+ */
+uint32_t command_frame_get_le(const uint8_t *p_data, uint32_t width);
+
+/**
+ * @brief Compute the CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF, no reflection) of some bytes.
+ *
+ * @param p_data Bytes
+ * @param length Number of bytes
+ * @return uint16_t CRC
+ */
+uint16_t command_frame_crc16(const uint8_t *p_data, uint32_t length);
+
+/**
+ * @brief Encode a frame: opcode, data and CRC, escaped between COMMAND_FRAME_START and COMMAND_FRAME_END.
+ *
+ * @param p_frame Frame to encode
+ * @param p_out Buffer for the encoded frame. It is not null-terminated
+ * @param size Size of the buffer
+ * @return uint32_t Number of bytes of the encoded frame, or 0 if it does not fit in the buffer
+ */
+uint32_t command_frame_encode(const command_frame_t *p_frame, char *p_out, uint32_t size);
+
+/**
+ * @brief Encode a request with one argument or none. Helper for the control host.
+ *
+ * @param opcode Opcode of the request
+ * @param arg Value of the argument
+ * @param width Width of the argument in bytes (0 if the opcode has no argument)
+ * @param p_out Buffer for the encoded frame. It is not null-terminated
+ * @param size Size of the buffer
+ * @return uint32_t Number of bytes of the encoded frame, or 0 if it does not fit in the buffer
+ */
+uint32_t command_frame_encode_request(uint8_t opcode, uint32_t arg, uint32_t width, char *p_out, uint32_t size);
+
+/**
+ * @brief Decode a frame received as a line: unescape it and check its CRC.
+ *
+ * @param p_line Bytes of the line, starting with COMMAND_FRAME_START. The final COMMAND_FRAME_END is optional
+ * @param length Number of bytes of the line
+ * @param p_frame Pointer to store the decoded frame
+ * @return command_frame_status_t COMMAND_FRAME_OK, COMMAND_FRAME_ERROR_FORMAT or COMMAND_FRAME_ERROR_CRC
+ */
+command_frame_status_t command_frame_decode(const char *p_line, uint32_t length, command_frame_t *p_frame);
+
+#endif /* COMMAND_FRAME_H_ */
@@ -0,0 +1,147 @@
+/**
+ * @file commands.h
+ * @brief Header for commands.c file.
+ *
+ * Table-driven registry of the commands received by the USART. Each command is an entry {name, handler, arg-spec,
+ * validator} stored in an open-addressing hash table, so the lookup cost does not depend on the number of commands registered.
+ * Lookups take the name as a view {pointer, length}, so the name does not need to be copied or null-terminated.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef COMMANDS_H_
+#define COMMANDS_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include <fsm.h>
+#include "tokenizer.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define COMMANDS_MAX 16                       /*!< Maximum number of commands registered */
+#define COMMANDS_HASH_SIZE (2 * COMMANDS_MAX) /*!< Slots of the hash table (power of 2, half empty to keep probes short) */
+#define COMMANDS_NAME_MAX_LENGTH 16           /*!< Maximum length of the name of a command */
+
+/* Enums */
+/**
+ * @brief Argument expected by a command.
+ */
+typedef enum
+{
+    COMMAND_ARG_NONE = 0, /*!< The command has no argument (it is ignored if present) */
+    COMMAND_ARG_INT,      /*!< Non-negative integer number */
+    COMMAND_ARG_FLOAT,    /*!< Decimal number */
+    COMMAND_ARG_STRING    /*!< Any word */
+} command_arg_spec_t;
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Arguments of a command. The first one is already converted according to the arg-spec of the command.
+ */
+typedef struct
+{
+    const char *p_text;    /*!< Text of the first argument (not null-terminated), NULL if there is no argument */
+    uint32_t length;       /*!< Length of the text of the first argument */
+    uint32_t int_value;    /*!< Value of a COMMAND_ARG_INT argument */
+    double float_value;    /*!< Value of a COMMAND_ARG_FLOAT argument */
+    const token_t *p_args; /*!< All the arguments, for commands with more than one */
+    uint32_t num_args;     /*!< Number of arguments */
+} command_arg_t;
+
+/**
+ * @brief Function that executes a command.
+ *
+ * @param p_this Pointer to the FSM that executes the command (the jukebox)
+ * @param p_arg Argument of the command
+ */
+typedef void (*command_handler_t)(fsm_t *p_this, const command_arg_t *p_arg);
+
+/**
+ * @brief Function that checks, without side effects, that a command can be executed with its argument in the current
+ * state. It lets a batch of commands be rejected before any of them is executed.
+ *
+ * @param p_this Pointer to the FSM that executes the command (the jukebox)
+ * @param p_arg Argument of the command, already converted according to its arg-spec
+ * @return true if the command can be executed, false otherwise
+ */
+typedef bool (*command_validator_t)(fsm_t *p_this, const command_arg_t *p_arg);
+
+/**
+ * @brief Entry of the registry.
+ */
+typedef struct
+{
+    const char *p_name;           /*!< Name of the command. It must be a string with static storage */
+    command_handler_t handler;    /*!< Function that executes the command */
+    command_arg_spec_t arg_spec;  /*!< Argument expected by the command */
+    command_validator_t validate; /*!< Function that checks the argument in the current state, NULL if any is valid */
+} command_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Remove all the commands of the registry.
+ */
+void commands_init(void);
+
+/**
+ * @brief Register a command without validator. If a command with the same name is already registered, it is replaced.
+ *
+ * @param p_name Name of the command. It must be a string with static storage
+ * @param handler Function that executes the command
+ * @param arg_spec Argument expected by the command
+ * @return true if the command has been registered, false if the name is too long or the registry is full
+ */
+bool commands_register(const char *p_name, command_handler_t handler, command_arg_spec_t arg_spec);
+
+/**
+ * @brief Register several commands, with their validators.
+ *
+ * @param p_commands Array of commands
+ * @param count Number of commands of the array
+ * @return true if all the commands have been registered, false otherwise
+ */
+bool commands_register_table(const command_t *p_commands, uint32_t count);
+
+/**
+ * @brief Find a command by its name.
+ *
+ * @param p_name Name of the command (it does not need to be null-terminated)
+ * @param length Length of the name
+ * @return const command_t* Pointer to the command, or NULL if it is not registered
+ */
+const command_t *commands_find(const char *p_name, uint32_t length);
+
+/**
+ * @brief Check and convert the arguments of a command according to its arg-spec.
+ *
+ * @param p_command Pointer to the command
+ * @param p_args Views of the arguments. They must remain valid while the command is executed
+ * @param num_args Number of arguments
+ * @param p_arg Pointer to store the converted arguments
+ * @return true if the arguments are valid for the command, false otherwise
+ */
+bool commands_parse_arg(const command_t *p_command, const token_t *p_args, uint32_t num_args, command_arg_t *p_arg);
+
+/**
+ * @brief Check that a command can be executed with its argument, with its validator if it has one.
+ *
+ * @param p_command Pointer to the command
+ * @param p_this Pointer to the FSM that executes the command
+ * @param p_arg Argument of the command, converted with commands_parse_arg()
+ * @return true if the command has no validator or its validator accepts the argument, false otherwise
+ */
+bool commands_validate(const command_t *p_command, fsm_t *p_this, const command_arg_t *p_arg);
+
+/**
+ * @brief Get the number of commands registered.
+ *
+ * @return uint32_t
+ */
+uint32_t commands_get_count(void);
+
+#endif /* COMMANDS_H_ */
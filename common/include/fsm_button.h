@@ -30,8 +30,8 @@ enum  FSM_BUTTON {
 typedef struct 
 {
     fsm_t f; 
-    uint32_t next_timeout; 
-    uint32_t tick_pressed; 
+    uint64_t next_timeout; /*!< First tick (64 bits) at which the debounce timeout has expired */
+    uint64_t tick_pressed; /*!< Tick (64 bits) of the last press */
     uint32_t duration; 
     uint32_t button_id;
     
@@ -75,5 +75,14 @@ void fsm_button_reset_duration (fsm_t *p_this);
  * @return false 
  */
 bool fsm_button_check_activity (fsm_t *p_this);
+/**
+ * @brief Get the tick at which the debounce timeout of the button FSM expires, for the tickless idle.
+ * 
+ * @param p_this 
+ * @param p_deadline_ms Tick at which the timeout expires
+ * @return true If the FSM is waiting for the debounce timeout
+ * @return false If the FSM has no timeout pending
+ */
+bool fsm_button_get_next_timeout (fsm_t *p_this, uint64_t *p_deadline_ms);
 
 #endif
\ No newline at end of file
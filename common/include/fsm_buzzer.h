@@ -15,6 +15,8 @@
 #include <stdbool.h>
 #include <fsm.h>
 #include "melodies.h"
+#include "melody_stream.h"
+#include "melody_poly.h"
 
 /* Other includes */
 
@@ -22,6 +24,11 @@
 
 
 /* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define FSM_BUZZER_SPEED_SHIFT 16U                          /*!< Bits fraccionarios de la velocidad de reproducción */
+#define FSM_BUZZER_SPEED_ONE (1U << FSM_BUZZER_SPEED_SHIFT) /*!< Velocidad 1.0 en coma fija Q16.16 */
+#define FSM_BUZZER_US_PER_MS 1000U                          /*!< Microsegundos por milisegundo */
+
 /* Enums */
 enum  	FSM_BUZZER {
   WAIT_START = 0,
@@ -40,10 +47,14 @@ enum  	USER_ACTIONS {
 typedef struct{
 fsm_t f;
 melody_t *p_melody;
+melody_stream_t *p_stream; /*!< Flujo de eventos a reproducir en lugar de p_melody (NULL si no hay) */
+const melody_poly_t *p_poly; /*!< Melodía de varias voces a reproducir en lugar de p_melody (NULL si no hay) */
+melody_poly_cursor_t poly_cursor; /*!< Posición en p_poly */
 uint32_t note_index;
 uint8_t buzzer_id;
 uint8_t user_action;
-double player_speed; 
+uint32_t player_speed; /*!< Velocidad de reproducción en coma fija Q16.16 (FSM_BUZZER_SPEED_ONE es 1.0) */
+uint32_t duration_remainder; /*!< Resto de la división por la velocidad de la última duración, que se suma a la siguiente */
 } fsm_buzzer_t;
 
 
@@ -66,8 +77,32 @@ bool 	fsm_buzzer_check_activity (fsm_t *p_this);
  * @param p_melody 
  */
 void 	fsm_buzzer_set_melody (fsm_t *p_this, const melody_t *p_melody);
+/**
+ * @brief Establece un flujo de eventos que debe reproducir el buzzer en lugar de una melodía en memoria.
+ *
+ * Las notas se leen del flujo por bloques; el siguiente bloque se precarga mientras suena la nota actual.
+ * 
+ * @param p_this 
+ * @param p_stream Flujo abierto con melody_stream_open()
+ */
+void 	fsm_buzzer_set_stream (fsm_t *p_this, melody_stream_t *p_stream);
+/**
+ * @brief Establece una melodía de varias voces que debe reproducir el buzzer en lugar de una melodía de una voz.
+ *
+ * Las voces se mezclan en acordes (melody_poly_next()) y cada acorde se encola como una sola nota: la ISR del
+ * temporizador de duración cambia todas las voces a la vez. Las voces que no tienen salida en el puerto se ignoran.
+ * 
+ * @param p_this 
+ * @param p_poly 
+ */
+void 	fsm_buzzer_set_poly (fsm_t *p_this, const melody_poly_t *p_poly);
 /**
  * @brief Establece la velocidad de reproducción del buzzer.
+ *
+ * La velocidad se guarda en coma fija Q16.16, redondeada a 2^-16. Las duraciones se escalan en microsegundos y el
+ * resto de cada división se arrastra a la nota siguiente, así que la duración total de la melodía coincide con la
+ * ideal a la velocidad Q16.16 con un error menor de 1 µs. Respecto de la velocidad pedida queda además el error del
+ * redondeo, relativo y de hasta 2^-17 / velocidad.
  * 
  * @param p_this 
  * @param speed 
@@ -0,0 +1,105 @@
+/**
+ * @file fsm_index.h
+ * @brief Header for fsm_index.c file.
+ *
+ * Compiled index of the transition tables of the FSMs. fsm_fire() scans the whole table comparing the origin state
+ * of every row with the current state. The index groups the rows of each state, keeping their order in the table,
+ * so fsm_index_fire() only visits the rows of the current state and takes the first one whose guard is true, with
+ * the same result as fsm_fire().
+ *
+ * The rows of a state can also be ordered by the number of times they have fired in a profile (fsm_profile.h), so
+ * that the most frequent guard is evaluated first. This changes which transition is taken when two guards of the
+ * state are true at the same time, so it is only applied to the states whose guards are mutually exclusive.
+ *
+ * An index belongs to a transition table and is shared by all the FSMs that use it.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef FSM_INDEX_H_
+#define FSM_INDEX_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include <fsm.h>
+
+/* Other includes */
+#include "fsm_profile.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define FSM_INDEX_MAX_TABLES 8                                  /*!< Maximum number of indexed transition tables */
+#define FSM_INDEX_MAX_STATES 16                                 /*!< States of an indexed table must be lower than this */
+#define FSM_INDEX_MAX_TRANSITIONS FSM_PROFILE_MAX_TRANSITIONS   /*!< Maximum number of transitions of an indexed table */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Index of a transition table.
+ */
+typedef struct
+{
+    const fsm_trans_t *p_tt;                   /*!< Transition table indexed */
+    uint32_t num_trans;                        /*!< Number of transitions of the table */
+    uint8_t first[FSM_INDEX_MAX_STATES];       /*!< Position in rows[] of the first row of each state */
+    uint8_t count[FSM_INDEX_MAX_STATES];       /*!< Number of rows of each state */
+    uint8_t rows[FSM_INDEX_MAX_TRANSITIONS];   /*!< Positions in the table of the rows, grouped by state in evaluation order */
+} fsm_index_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Remove all the indexes.
+ */
+void fsm_index_init(void);
+
+/**
+ * @brief Build the index of a transition table, or get it if it is already built.
+ *
+ * @param p_tt Transition table, ended with a row with origin state -1
+ * @return const fsm_index_t* Index, or NULL if there is no room or the table has too many rows or states
+ */
+const fsm_index_t *fsm_index_build(const fsm_trans_t *p_tt);
+
+/**
+ * @brief Get the index of a transition table.
+ *
+ * @param p_tt Transition table
+ * @return const fsm_index_t* Index, or NULL if the table is not indexed
+ */
+const fsm_index_t *fsm_index_find(const fsm_trans_t *p_tt);
+
+/**
+ * @brief Get the rows of a state in evaluation order.
+ *
+ * @param p_index Index of the table
+ * @param state State
+ * @param pp_rows Pointer to store the positions in the table of the rows of the state
+ * @return uint32_t Number of rows of the state
+ */
+uint32_t fsm_index_get_rows(const fsm_index_t *p_index, int state, const uint8_t **pp_rows);
+
+/**
+ * @brief Fire an FSM visiting only the rows of its current state. If its table is not indexed the whole table is
+ * scanned, as fsm_fire() does.
+ *
+ * @param p_fsm Pointer to the FSM
+ * @return const fsm_trans_t* Transition taken, or NULL if no guard was true
+ */
+const fsm_trans_t *fsm_index_fire(fsm_t *p_fsm);
+
+/**
+ * @brief Order the rows of some states by the number of fires recorded in a profile, most frequent first.
+ *
+ * Rows with the same number of fires keep their order in the table.
+ *
+ * @param p_profile Profile of an FSM whose table is indexed
+ * @param exclusive_states Bit mask (1 << state) of the states whose guards are mutually exclusive. Other states keep
+ * the order of the table.
+ * @return uint32_t Number of states whose order has changed
+ */
+uint32_t fsm_index_reorder(const fsm_profile_t *p_profile, uint32_t exclusive_states);
+
+#endif /* FSM_INDEX_H_ */
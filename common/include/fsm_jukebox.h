@@ -22,12 +22,17 @@
 #include <stdint.h>
 #include <fsm.h>
 #include "melodies.h"
+#include "melody_stream.h"
 
 /* Otros includes */
 
 /* Defines y enumeraciones --------------------------------------------------*/
 /* Defines */
 #define MELODIES_MEMORY_SIZE 10  /**< Define el número máximo de melodías que el jukebox puede almacenar */
+#define JUKEBOX_MAX_ARGS 4       /**< Número máximo de argumentos de un comando recibido por la USART */
+#define JUKEBOX_MAX_COMMANDS_PER_FIRE 8 /**< Número máximo de comandos ejecutados en un disparo de la FSM */
+#define JUKEBOX_MAX_BATCH_COMMANDS 8    /**< Número máximo de comandos de un lote */
+#define JUKEBOX_BATCH_SEPARATOR ';'     /**< Carácter que separa los comandos de un lote */
 
 /* Enumeraciones */
 /**
@@ -62,6 +67,8 @@ typedef struct {
     fsm_t *p_fsm_buzzer;                /**< Puntero a la FSM del buzzer */
     uint32_t next_song_press_time_ms;   /**< Tiempo en milisegundos para la pulsación del botón de la siguiente canción */
     double speed;                       /**< Velocidad de reproducción */
+    melody_stream_upload_t upload;      /**< Melodía recibida por la USART con el comando "upload" */
+    melody_stream_t stream;             /**< Flujo con el que se reproduce la melodía recibida */
 } fsm_jukebox_t;
 
 /* Prototipos de funciones y explicación -------------------------------------*/
@@ -93,4 +100,16 @@ fsm_t * fsm_jukebox_new(fsm_t *p_fsm_button, uint32_t on_off_press_time_ms, fsm_
  */
 void fsm_jukebox_init(fsm_t *p_this, fsm_t *p_fsm_button, uint32_t on_off_press_time_ms, fsm_t *p_fsm_usart, fsm_t *p_fsm_buzzer, uint32_t next_song_press_time_ms);
 
+/**
+ * @brief Comprueba si el jukebox está en reposo: apagado y sin actividad en el botón, la USART ni el buzzer.
+ * 
+ * En reposo no hace falta ningún periférico hasta que se pulse el botón o llegue un byte por la USART, así que la
+ * política de consumo (power_policy.h) puede entrar en modo Stop.
+ * 
+ * @param p_this Puntero a la FSM del jukebox
+ * @return true Si el jukebox está en reposo
+ * @return false Si el jukebox está encendido o hay actividad
+ */
+bool fsm_jukebox_check_standby(fsm_t *p_this);
+
 #endif /* FSM_JUKEBOX_H_ */
\ No newline at end of file
@@ -0,0 +1,113 @@
+/**
+ * @file fsm_profile.h
+ * @brief Header for fsm_profile.c file.
+ *
+ * Opt-in profiler of the transition tables of the FSMs. An FSM attached with fsm_profile_attach() is fired by
+ * fsm_profile_fire() with the same semantics as fsm_fire(), but counting for each transition of its table how many
+ * times its guard has been evaluated, the cycles spent in the guard, how many times it has fired and the minimum,
+ * average and maximum duration of its action. FSMs that are not attached are fired with fsm_index_fire().
+ *
+ * Durations are measured with port_system_get_cycles(): DWT->CYCCNT on the target and nanoseconds of the host
+ * monotonic clock on the native port.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef FSM_PROFILE_H_
+#define FSM_PROFILE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include <fsm.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#ifndef FSM_PROFILE
+#define FSM_PROFILE 0 /*!< Set to 1 (-DFSM_PROFILE=1) to attach the FSMs of main.c to the profiler */
+#endif
+#define FSM_PROFILE_MAX_FSMS 4         /*!< Maximum number of FSMs attached to the profiler */
+#define FSM_PROFILE_MAX_TRANSITIONS 16 /*!< Maximum number of transitions of a profiled table */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Counters of a transition.
+ */
+typedef struct
+{
+    uint32_t guard_evals;  /*!< Number of times the guard has been evaluated */
+    uint64_t guard_cycles; /*!< Cycles spent evaluating the guard */
+    uint32_t fires;        /*!< Number of times the guard has been true */
+    uint32_t min_cycles;   /*!< Shortest duration of the action */
+    uint32_t max_cycles;   /*!< Longest duration of the action */
+    uint64_t total_cycles; /*!< Sum of the durations of the action */
+} fsm_profile_trans_t;
+
+/**
+ * @brief Profile of an FSM.
+ */
+typedef struct
+{
+    fsm_t *p_fsm;                                             /*!< FSM profiled */
+    const char *p_name;                                       /*!< Name of the FSM in the reports */
+    fsm_trans_t *p_tt;                                        /*!< Transition table of the FSM */
+    uint32_t num_trans;                                       /*!< Number of transitions of the table */
+    uint32_t fires;                                           /*!< Number of calls to fsm_profile_fire() */
+    uint32_t rows;                                            /*!< Rows of the table visited by those calls */
+    fsm_profile_trans_t trans[FSM_PROFILE_MAX_TRANSITIONS];   /*!< Counters of each transition, in table order */
+} fsm_profile_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Detach all the FSMs from the profiler.
+ */
+void fsm_profile_init(void);
+
+/**
+ * @brief Attach an FSM to the profiler.
+ *
+ * @param p_fsm Pointer to the FSM
+ * @param p_name Name of the FSM in the reports. It must be a string with static storage
+ * @return true if the FSM has been attached, false if there is no room or its table is too long
+ */
+bool fsm_profile_attach(fsm_t *p_fsm, const char *p_name);
+
+/**
+ * @brief Fire an FSM, recording the counters of its transitions if it is attached.
+ *
+ * @param p_fsm Pointer to the FSM
+ * @return const fsm_trans_t* Transition taken, or NULL if no guard was true
+ */
+const fsm_trans_t *fsm_profile_fire(fsm_t *p_fsm);
+
+/**
+ * @brief Get the profile of an FSM.
+ *
+ * @param p_fsm Pointer to the FSM
+ * @return const fsm_profile_t* Profile, or NULL if the FSM is not attached
+ */
+const fsm_profile_t *fsm_profile_get(const fsm_t *p_fsm);
+
+/**
+ * @brief Reset the counters of all the attached FSMs.
+ */
+void fsm_profile_reset(void);
+
+/**
+ * @brief Print the counters of every transition of the attached FSMs with printf().
+ */
+void fsm_profile_print(void);
+
+/**
+ * @brief Write a one-line summary with the transition whose guard has consumed most cycles.
+ *
+ * @param p_msg Buffer to store the line, ended with '\n'
+ * @param size Size of the buffer
+ * @return uint32_t Number of characters written (0 if no FSM is attached)
+ */
+uint32_t fsm_profile_format_hottest(char *p_msg, uint32_t size);
+
+#endif /* FSM_PROFILE_H_ */
@@ -69,6 +69,15 @@ bool fsm_usart_check_data_received (fsm_t *p_this);
  * @param p_data 
  */
 void fsm_usart_get_in_data (fsm_t *p_this, char *p_data);
+/**
+ * @brief Devuelve un puntero de solo lectura a los datos de entrada, sin copiarlos.
+ *
+ * El contenido es válido hasta que se llama a fsm_usart_reset_input_data().
+ *
+ * @param p_this 
+ * @return const char* Puntero al buffer de entrada (USART_INPUT_BUFFER_LENGTH bytes, no siempre terminado en '\0')
+ */
+const char *fsm_usart_peek_in_data (fsm_t *p_this);
 /**
  * @brief 
  * 
@@ -82,6 +91,34 @@ void fsm_usart_set_out_data (fsm_t *p_this, char *p_data);
  * @param p_this 
  */
 void fsm_usart_reset_input_data (fsm_t *p_this);
+/**
+ * @brief Descarta los datos de salida que todavía no se han empezado a transmitir.
+ * 
+ * @param p_this 
+ */
+void fsm_usart_reset_output_data (fsm_t *p_this);
+/**
+ * @brief Carga en los datos de entrada la siguiente línea recibida, si la hay.
+ * 
+ * @param p_this 
+ * @return true si se ha cargado una línea, false si no había ninguna pendiente
+ */
+bool fsm_usart_get_next_line (fsm_t *p_this);
+/**
+ * @brief Obtiene el número de líneas recibidas pendientes de procesar.
+ * 
+ * @param p_this 
+ * @return uint32_t 
+ */
+uint32_t fsm_usart_get_lines_pending (fsm_t *p_this);
+/**
+ * @brief Comprueba si hay datos de salida esperando a ser transmitidos o transmitiéndose.
+ * 
+ * @param p_this 
+ * @return true 
+ * @return false 
+ */
+bool fsm_usart_check_out_data_pending (fsm_t *p_this);
 /**
  * @brief Comprueba la actividad de la FSM USART.
  * 
@@ -0,0 +1,108 @@
+/**
+ * @file line_ring.h
+ * @brief Header for line_ring.c file.
+ *
+ * Lock-free single-producer/single-consumer ring buffer of text lines. The producer (the RX ISR of the USART) adds
+ * bytes with line_ring_put() and the consumer (the USART FSM) takes complete lines with line_ring_get_line(). Each
+ * index is written by only one side, so no critical sections are needed between the ISR and the main loop.
+ *
+ * A line is only visible to the consumer once its end character has been received. If a line does not fit in the
+ * ring, or it is longer than the maximum line length, the whole line is discarded and counted as an overrun, so a
+ * command is never delivered corrupted. Empty lines are ignored.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef LINE_RING_H_
+#define LINE_RING_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define LINE_RING_LENGTH 256    /*!< Size of the ring in bytes (power of 2) */
+#define LINE_RING_END_CHAR '\n' /*!< Character that ends a line. It is not stored */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Ring buffer of lines.
+ */
+typedef struct
+{
+    char data[LINE_RING_LENGTH]; /*!< Bytes of the lines. Each stored line ends with a '\0' */
+    volatile uint32_t head;      /*!< Index after the last complete line. Written only by the producer */
+    volatile uint32_t tail;      /*!< Index of the first byte not read. Written only by the consumer */
+    volatile uint32_t lines_in;  /*!< Number of complete lines added. Written only by the producer */
+    volatile uint32_t lines_out; /*!< Number of lines taken. Written only by the consumer */
+    volatile uint32_t overruns;  /*!< Number of lines discarded. Written only by the producer */
+    uint32_t write;              /*!< Index where the producer writes the line being received */
+    uint32_t max_line_length;    /*!< Maximum number of characters of a line */
+    bool discarding;             /*!< The line being received is being discarded */
+} line_ring_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize an empty ring. It must not be called while the producer is running.
+ *
+ * @param p_ring Pointer to the ring
+ * @param max_line_length Maximum number of characters of a line. Longer lines are discarded
+ */
+void line_ring_init(line_ring_t *p_ring, uint32_t max_line_length);
+
+/**
+ * @brief Add a received byte. It must be called only from the producer (the RX ISR).
+ *
+ * @param p_ring Pointer to the ring
+ * @param c Byte received
+ */
+void line_ring_put(line_ring_t *p_ring, char c);
+
+/**
+ * @brief Discard the line being received, up to and including its next end character, without counting an overrun.
+ * It must be called only from the producer side, or while the producer is stopped.
+ *
+ * @param p_ring Pointer to the ring
+ */
+void line_ring_discard_line(line_ring_t *p_ring);
+
+/**
+ * @brief Get the number of complete lines waiting to be taken.
+ *
+ * @param p_ring Pointer to the ring
+ * @return uint32_t
+ */
+uint32_t line_ring_lines_pending(const line_ring_t *p_ring);
+
+/**
+ * @brief Take the oldest complete line. It must be called only from the consumer.
+ *
+ * The line is copied without its end character and the rest of the destination buffer is filled with '\0'.
+ *
+ * @param p_ring Pointer to the ring
+ * @param p_line Buffer to store the line, or NULL to discard the line
+ * @param size Size of the buffer. It should be greater than the maximum line length of the ring
+ * @return int32_t Number of characters stored, or -1 if there are no complete lines
+ */
+int32_t line_ring_get_line(line_ring_t *p_ring, char *p_line, uint32_t size);
+
+/**
+ * @brief Discard all the complete lines. It must be called only from the consumer.
+ *
+ * @param p_ring Pointer to the ring
+ */
+void line_ring_flush(line_ring_t *p_ring);
+
+/**
+ * @brief Get the number of lines discarded because they did not fit.
+ *
+ * @param p_ring Pointer to the ring
+ * @return uint32_t
+ */
+uint32_t line_ring_get_overruns(const line_ring_t *p_ring);
+
+#endif /* LINE_RING_H_ */
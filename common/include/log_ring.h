@@ -0,0 +1,172 @@
+/**
+ * @file log_ring.h
+ * @brief Header for log_ring.c file.
+ *
+ * Deferred logging. A log call does not format any text: it writes a binary record with the identifier of its format
+ * string, a timestamp, up to LOG_RING_MAX_ARGS integer arguments and, optionally, a short copied string into a
+ * lock-free single-producer/single-consumer ring. The text is expanded later, when the main loop has nothing to
+ * dispatch, by log_ring_drain(), so an FSM action never waits for the ITM or the console.
+ *
+ * The producer is the code of the main loop (the actions of the FSMs); log calls must not be made from ISRs. If a
+ * record does not fit in the ring it is discarded whole and counted as dropped. The cost of each log call is measured
+ * with port_system_get_cycles() (DWT->CYCCNT on the target and nanoseconds on the host).
+ *
+ * The format strings are in the table LOG_RING_MESSAGES, so a record can also be sent in binary (see
+ * LOG_RING_DRAIN_BINARY) and decoded on the host with log_ring_parse() and log_ring_format() built with the same table.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef LOG_RING_H_
+#define LOG_RING_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define LOG_RING_LENGTH 256U       /*!< Size of the ring in 32-bit words (power of 2) */
+#define LOG_RING_MAX_ARGS 4U       /*!< Maximum number of integer arguments of a record */
+#define LOG_RING_MAX_STRING 23U    /*!< Maximum number of characters of the string argument. Longer ones are cut */
+#define LOG_RING_HEADER_WORDS 2U   /*!< Words of the header of a record: identifier and timestamp */
+#define LOG_RING_MAX_RECORD_WORDS (LOG_RING_HEADER_WORDS + LOG_RING_MAX_ARGS + (LOG_RING_MAX_STRING + 4U) / 4U) /*!< Words of the longest record */
+#define LOG_RING_SYNC 0xA5U        /*!< Byte in the top of the first word of every record, to find records in a binary dump */
+#define LOG_RING_DRAIN_RECORDS 4U  /*!< Records expanded by the main loop each time it has nothing to dispatch */
+
+#ifndef LOG_RING_DRAIN_BINARY
+#define LOG_RING_DRAIN_BINARY 0 /*!< Set to 1 (-DLOG_RING_DRAIN_BINARY=1) to send the records in binary instead of as text */
+#endif
+
+/**
+ * @brief Format strings of the log records: identifier and format. The string argument is expanded by the "%s"
+ * conversion and the integer arguments, in order, by "%d", "%i", "%u", "%x", "%X" and "%c" (with an optional "l").
+ */
+#define LOG_RING_MESSAGES(X)                       \
+    X(LOG_JUKEBOX_ON, "Jukebox ON\n")              \
+    X(LOG_JUKEBOX_OFF, "Jukebox OFF\n")            \
+    X(LOG_PLAYING, "Reproduciendo: %s\n")          \
+    X(LOG_SYNTH, "Sintetizando: %s\n")             \
+    X(LOG_LIST_HEADER, "Lista de melodías: \n")    \
+    X(LOG_LIST_ITEM, "%d. %s\n")
+
+/* Enums */
+#define LOG_RING_ID(id, format) id,
+/**
+ * @brief Identifiers of the format strings.
+ */
+typedef enum
+{
+    LOG_RING_MESSAGES(LOG_RING_ID)
+    LOG_NUM_MESSAGES /*!< Number of format strings */
+} log_id_t;
+#undef LOG_RING_ID
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Record decoded from its binary words.
+ */
+typedef struct
+{
+    log_id_t id;                          /*!< Identifier of the format string */
+    uint32_t timestamp_ms;                /*!< System tick when the log call was made */
+    uint32_t num_args;                    /*!< Number of integer arguments */
+    uint32_t args[LOG_RING_MAX_ARGS];     /*!< Integer arguments */
+    char text[LOG_RING_MAX_STRING + 1U];  /*!< String argument, empty if there is none */
+} log_record_t;
+
+/**
+ * @brief Counters of the log.
+ */
+typedef struct
+{
+    uint32_t records;      /*!< Records written */
+    uint32_t dropped;      /*!< Records discarded because they did not fit */
+    uint32_t drained;      /*!< Records taken by the consumer */
+    uint32_t max_cycles;   /*!< Longest log call */
+    uint64_t total_cycles; /*!< Sum of the durations of the log calls, written and dropped */
+} log_ring_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Empty the ring and reset the counters. It must not be called while there are log calls running.
+ *
+ */
+void log_ring_init(void);
+
+/**
+ * @brief Write a record. It must be called only from the main loop.
+ *
+ * @param id Identifier of the format string
+ * @param p_text String argument, copied into the record, or NULL if the format has no "%s"
+ * @param num_args Number of integer arguments that follow (maximum LOG_RING_MAX_ARGS)
+ * @param ... Integer arguments, as uint32_t
+ */
+void log_ring_write(log_id_t id, const char *p_text, uint32_t num_args, ...);
+
+/**
+ * @brief Get the number of records waiting to be taken.
+ *
+ * @return uint32_t
+ */
+uint32_t log_ring_pending(void);
+
+/**
+ * @brief Take the binary words of the oldest record. It must be called only from the consumer.
+ *
+ * @param p_words Buffer to store the words
+ * @param max_words Size of the buffer in words. It should be at least LOG_RING_MAX_RECORD_WORDS
+ * @return int32_t Number of words stored, or -1 if there are no records or the buffer is too small
+ */
+int32_t log_ring_read(uint32_t *p_words, uint32_t max_words);
+
+/**
+ * @brief Decode a record from its binary words. It is the decoder of the host for a binary dump of the log.
+ *
+ * @param p_words Words of the record
+ * @param num_words Number of words available
+ * @param p_record Pointer where the decoded record is stored
+ * @return uint32_t Number of words of the record, or 0 if the words are not a valid record
+ */
+uint32_t log_ring_parse(const uint32_t *p_words, uint32_t num_words, log_record_t *p_record);
+
+/**
+ * @brief Expand the text of a decoded record with its format string.
+ *
+ * @param p_record Pointer to the record
+ * @param p_out Buffer for the text, always ended with '\0'
+ * @param size Size of the buffer
+ * @return uint32_t Number of characters stored
+ */
+uint32_t log_ring_format(const log_record_t *p_record, char *p_out, uint32_t size);
+
+/**
+ * @brief Send some records to the standard output (the ITM on the target). It must be called only from the consumer,
+ * the main loop when it has nothing to dispatch.
+ *
+ * The records are expanded as text, or sent in binary if LOG_RING_DRAIN_BINARY is 1.
+ *
+ * @param max_records Maximum number of records to send
+ * @return uint32_t Number of records sent
+ */
+uint32_t log_ring_drain(uint32_t max_records);
+
+/**
+ * @brief Get the format string of an identifier.
+ *
+ * @param id Identifier of the format string
+ * @return const char* Format string, or NULL if the identifier is not known
+ */
+const char *log_ring_get_format(log_id_t id);
+
+/**
+ * @brief Get the counters of the log.
+ *
+ * @param p_stats Pointer where the counters are stored
+ */
+void log_ring_get_stats(log_ring_stats_t *p_stats);
+
+#endif /* LOG_RING_H_ */
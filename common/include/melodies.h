@@ -56,16 +56,90 @@
 #define LAs5 932.328  /*!< LA#5 note frequency */
 #define SI5 987.767   /*!< SI5 note frequency */
 
+// MIDI note numbers of the notes above, used by the packed melodies (MIDI_SILENCE is a rest)
+#define MIDI_SILENCE 0          /*!< Silence (rest) */
+#define MIDI_DO3 48             /*!< DO3 MIDI note number */
+#define MIDI_DOs3 (MIDI_DO3 + 1)  /*!< DO#3 MIDI note number */
+#define MIDI_RE3 (MIDI_DO3 + 2)   /*!< RE3 MIDI note number */
+#define MIDI_REs3 (MIDI_DO3 + 3)  /*!< RE#3 MIDI note number */
+#define MIDI_MI3 (MIDI_DO3 + 4)   /*!< MI3 MIDI note number */
+#define MIDI_FA3 (MIDI_DO3 + 5)   /*!< FA3 MIDI note number */
+#define MIDI_FAs3 (MIDI_DO3 + 6)  /*!< FA#3 MIDI note number */
+#define MIDI_SOL3 (MIDI_DO3 + 7)  /*!< SOL3 MIDI note number */
+#define MIDI_SOLs3 (MIDI_DO3 + 8) /*!< SOL#3 MIDI note number */
+#define MIDI_LA3 (MIDI_DO3 + 9)   /*!< LA3 MIDI note number */
+#define MIDI_LAs3 (MIDI_DO3 + 10) /*!< LA#3 MIDI note number */
+#define MIDI_SI3 (MIDI_DO3 + 11)  /*!< SI3 MIDI note number */
+#define MIDI_DO4 60             /*!< DO4 MIDI note number */
+#define MIDI_DOs4 (MIDI_DO4 + 1)  /*!< DO#4 MIDI note number */
+#define MIDI_RE4 (MIDI_DO4 + 2)   /*!< RE4 MIDI note number */
+#define MIDI_REs4 (MIDI_DO4 + 3)  /*!< RE#4 MIDI note number */
+#define MIDI_MI4 (MIDI_DO4 + 4)   /*!< MI4 MIDI note number */
+#define MIDI_FA4 (MIDI_DO4 + 5)   /*!< FA4 MIDI note number */
+#define MIDI_FAs4 (MIDI_DO4 + 6)  /*!< FA#4 MIDI note number */
+#define MIDI_SOL4 (MIDI_DO4 + 7)  /*!< SOL4 MIDI note number */
+#define MIDI_SOLs4 (MIDI_DO4 + 8) /*!< SOL#4 MIDI note number */
+#define MIDI_LA4 (MIDI_DO4 + 9)   /*!< LA4 MIDI note number */
+#define MIDI_LAs4 (MIDI_DO4 + 10) /*!< LA#4 MIDI note number */
+#define MIDI_SI4 (MIDI_DO4 + 11)  /*!< SI4 MIDI note number */
+#define MIDI_DO5 72             /*!< DO5 MIDI note number */
+#define MIDI_DOs5 (MIDI_DO5 + 1)  /*!< DO#5 MIDI note number */
+#define MIDI_RE5 (MIDI_DO5 + 2)   /*!< RE5 MIDI note number */
+#define MIDI_REs5 (MIDI_DO5 + 3)  /*!< RE#5 MIDI note number */
+#define MIDI_MI5 (MIDI_DO5 + 4)   /*!< MI5 MIDI note number */
+#define MIDI_FA5 (MIDI_DO5 + 5)   /*!< FA5 MIDI note number */
+#define MIDI_FAs5 (MIDI_DO5 + 6)  /*!< FA#5 MIDI note number */
+#define MIDI_SOL5 (MIDI_DO5 + 7)  /*!< SOL5 MIDI note number */
+#define MIDI_SOLs5 (MIDI_DO5 + 8) /*!< SOL#5 MIDI note number */
+#define MIDI_LA5 (MIDI_DO5 + 9)   /*!< LA5 MIDI note number */
+#define MIDI_LAs5 (MIDI_DO5 + 10) /*!< LA#5 MIDI note number */
+#define MIDI_SI5 (MIDI_DO5 + 11)  /*!< SI5 MIDI note number */
+#define MIDI_MAX_NOTE 127         /*!< Highest MIDI note number */
+
+// Packed melodies
+#define MELODY_DURATION_UNIT_MS 10U                              /*!< Resolution of the durations of the packed events */
+#define MELODY_MAX_DURATION_MS (255U * MELODY_DURATION_UNIT_MS) /*!< Longest duration of a packed event */
+
+/**
+ * @brief Packed event of a melody: a note and its duration.
+ *
+ * @param name Name of the note (DO4, LAs3, SILENCE...)
+ * @param duration_ms Duration in milliseconds. It must be a multiple of MELODY_DURATION_UNIT_MS and at most MELODY_MAX_DURATION_MS
+ */
+#define MELODY_EVENT(name, duration_ms) {.note = MIDI_##name, .duration = (uint8_t)((duration_ms) / MELODY_DURATION_UNIT_MS)}
+
+#define MELODY_EVENT_DURATION_MS(p_event) ((uint32_t)(p_event)->duration * MELODY_DURATION_UNIT_MS) /*!< Duration of a packed event in milliseconds */
+
+/* Frequencies of the 9th octave (MIDI 120 to 131) in millihertz. Lower octaves are obtained by shifting right, so the
+ * frequency of any MIDI note is an integer constant expression */
+#define _MELODY_OCTAVE9_MHZ(i) ((i) == 0 ? 8372018U : (i) == 1 ? 8869844U : (i) == 2 ? 9397273U : (i) == 3 ? 9956063U :    \
+                                (i) == 4 ? 10548082U : (i) == 5 ? 11175303U : (i) == 6 ? 11839822U : (i) == 7 ? 12543854U : \
+                                (i) == 8 ? 13289750U : (i) == 9 ? 14080000U : (i) == 10 ? 14917240U : 15804266U)
+#define _MELODY_OCTAVE_SHIFT(note) (10U - (note) / 12U) /*!< Octaves below the 9th one */
+
+/**
+ * @brief Frequency of a MIDI note in millihertz (equal temperament, LA4 = 440 Hz), rounded. Constant expression.
+ */
+#define MELODY_NOTE_MHZ(note) ((_MELODY_OCTAVE9_MHZ((note) % 12U) + ((1U << _MELODY_OCTAVE_SHIFT(note)) >> 1)) >> _MELODY_OCTAVE_SHIFT(note))
+
 /* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Packed event of a melody (2 bytes).
+ */
+typedef struct
+{
+    uint8_t note;     /*!< MIDI note number, or MIDI_SILENCE */
+    uint8_t duration; /*!< Duration in units of MELODY_DURATION_UNIT_MS */
+} melody_event_t;
+
 /**
  * @brief Structure to define the Buzzer melody player FSM.
  */
 typedef struct
 {
-    char *p_name;           /*!< Pointer to the name of the melody to play */
-    double *p_notes;        /*!< Pointer to the notes of the melody */
-    uint16_t *p_durations;  /*!< Pointer to the duration of each note of the melody in milliseconds */
-    uint16_t melody_length; /*!< Length of the melody to play */
+    char *p_name;                   /*!< Pointer to the name of the melody to play */
+    const melody_event_t *p_events; /*!< Pointer to the packed events (note and duration) of the melody */
+    uint16_t melody_length;         /*!< Length of the melody to play */
 } melody_t;
 
 // Melodies must be defined in melodies.c, and declared here as extern
@@ -82,4 +156,13 @@ extern const melody_t himno_madrid_melody;
 
 extern const melody_t windows_shutdown_melody;
 
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Get the frequency of a MIDI note in millihertz, without floating point.
+ *
+ * @param note MIDI note number
+ * @return uint32_t Frequency in millihertz, or 0 for MIDI_SILENCE or a note out of range
+ */
+uint32_t melody_get_note_mhz(uint8_t note);
+
 #endif /* MELODIES_H_ */
\ No newline at end of file
@@ -0,0 +1,95 @@
+/**
+ * @file melody_poly.h
+ * @brief Header for melody_poly.c file.
+ *
+ * Melodies of several simultaneous voices. Each voice is an ordinary packed melody (`melody_t`), and a cursor merges
+ * them into a single stream of frames: a frame is the chord that sounds until the next note of any voice starts. The
+ * player schedules one frame at a time, so one timer interrupt changes the notes of all the voices at once.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef MELODY_POLY_H_
+#define MELODY_POLY_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Other includes */
+#include "melodies.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define MELODY_POLY_MAX_VOICES 4U /*!< Maximum number of voices of a melody */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Melody of several voices that start at the same time.
+ */
+typedef struct
+{
+    char *p_name;                                    /*!< Name of the melody */
+    const melody_t *p_voices[MELODY_POLY_MAX_VOICES]; /*!< Voices of the melody. The first one is the main voice */
+    uint8_t num_voices;                              /*!< Number of voices of the melody */
+} melody_poly_t;
+
+/**
+ * @brief Chord that sounds until the next note of any voice starts.
+ */
+typedef struct
+{
+    uint8_t notes[MELODY_POLY_MAX_VOICES]; /*!< MIDI note number of each voice, or MIDI_SILENCE */
+    uint8_t num_voices;                    /*!< Number of voices of the frame */
+    uint8_t onsets;                        /*!< Bit v set if the note (or the silence) of voice v starts in this frame */
+    uint32_t duration_ms;                  /*!< Duration of the frame in milliseconds */
+} melody_frame_t;
+
+/**
+ * @brief Position in a melody of several voices.
+ */
+typedef struct
+{
+    const melody_poly_t *p_poly;                  /*!< Melody being played */
+    uint16_t index[MELODY_POLY_MAX_VOICES];       /*!< Index of the current event of each voice */
+    uint32_t remaining_ms[MELODY_POLY_MAX_VOICES]; /*!< Time left of the current event of each voice */
+    uint8_t starting;                             /*!< Bit v set if the current event of voice v has not sounded yet */
+} melody_poly_cursor_t;
+
+/* Global variables */
+extern const melody_poly_t tetris_poly_melody; /*!< Tetris with a bass line */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Go to the start of a melody of several voices.
+ *
+ * @param p_cursor Pointer to the cursor
+ * @param p_poly Pointer to the melody
+ */
+void melody_poly_rewind(melody_poly_cursor_t *p_cursor, const melody_poly_t *p_poly);
+
+/**
+ * @brief Check if any voice has notes left.
+ *
+ * @param p_cursor Pointer to the cursor
+ * @return true if there is another frame, false at the end of the melody
+ */
+bool melody_poly_has_next(const melody_poly_cursor_t *p_cursor);
+
+/**
+ * @brief Get the next frame of the melody.
+ *
+ * The duration of the frame is the shortest time left of the notes of the voices. The voices that have already ended
+ * are silent until the longest one ends. A note that lasts several frames is only marked as an onset in the first one,
+ * so a player can tell a new note from the continuation of the same one.
+ *
+ * @param p_cursor Pointer to the cursor
+ * @param p_frame Pointer where the frame is stored
+ * @return true if a frame has been returned, false at the end of the melody
+ */
+bool melody_poly_next(melody_poly_cursor_t *p_cursor, melody_frame_t *p_frame);
+
+#endif /* MELODY_POLY_H_ */
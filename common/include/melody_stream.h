@@ -0,0 +1,169 @@
+/**
+ * @file melody_stream.h
+ * @brief Header for melody_stream.c file.
+ *
+ * Streaming of melodies of any length with constant RAM. The events are pulled from a source in chunks of
+ * MELODY_STREAM_CHUNK_EVENTS events into two buffers: the player consumes the front buffer while the back buffer is
+ * prefetched with melody_stream_prefetch(), and the buffers are swapped without a gap when the front one is empty.
+ *
+ * A source is a read function that copies the events starting at an offset. This module provides a memory blob source
+ * (packed events in flash or in any memory-mapped region) and an upload source filled by the USART; the native port
+ * adds a file source (`port_melody_file.h`).
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef MELODY_STREAM_H_
+#define MELODY_STREAM_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Other includes */
+#include "melodies.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define MELODY_STREAM_CHUNK_EVENTS 16U  /*!< Number of events of each of the two buffers of a stream */
+#define MELODY_STREAM_UPLOAD_EVENTS 64U /*!< Number of events of the FIFO of an upload source. It must be a power of 2 */
+#define MELODY_STREAM_WAIT_MS MELODY_DURATION_UNIT_MS /*!< Silence played by an upload source while it waits for data */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Read function of a source of events.
+ *
+ * @param p_source Pointer to the source
+ * @param offset Index of the first event to read. Sequential sources may ignore it
+ * @param p_events Array where the events are stored
+ * @param max_events Maximum number of events to read
+ * @return uint32_t Number of events read. 0 means the end of the melody
+ */
+typedef uint32_t (*melody_stream_read_t)(void *p_source, uint32_t offset, melody_event_t *p_events, uint32_t max_events);
+
+/**
+ * @brief Stream of events with two chunk buffers.
+ */
+typedef struct
+{
+    melody_stream_read_t read;                                  /*!< Read function of the source */
+    void *p_source;                                             /*!< Source of the events */
+    melody_event_t chunks[2][MELODY_STREAM_CHUNK_EVENTS];       /*!< Front and back buffers */
+    uint16_t chunk_length[2];                                   /*!< Number of events of each buffer */
+    uint8_t front;                                              /*!< Index of the buffer being played */
+    uint16_t index;                                             /*!< Index of the next event in the front buffer */
+    bool back_ready;                                            /*!< The back buffer holds the next chunk */
+    bool source_end;                                            /*!< The source has no more events */
+    uint32_t read_offset;                                       /*!< Offset in the source of the next chunk to read */
+    uint32_t position;                                          /*!< Number of events played since the start */
+    uint32_t chunks_loaded;                                     /*!< Number of chunks read from the source */
+    uint32_t underruns;                                         /*!< Chunks that had to be read when they were needed */
+} melody_stream_t;
+
+/**
+ * @brief Memory blob source: packed events {note, duration code}, 2 bytes each, as in `melody_event_t`.
+ */
+typedef struct
+{
+    const uint8_t *p_data; /*!< Pointer to the blob */
+    uint32_t size;         /*!< Size of the blob in bytes */
+} melody_stream_blob_t;
+
+/**
+ * @brief Upload source: FIFO of events filled by the commands of the USART and read by the stream. Both run in the
+ * main loop.
+ */
+typedef struct
+{
+    melody_event_t events[MELODY_STREAM_UPLOAD_EVENTS]; /*!< Events uploaded and not read yet */
+    uint32_t head;                                      /*!< Index where the next event is written */
+    uint32_t tail;                                      /*!< Index of the next event to read */
+    bool closed;                                        /*!< No more events will be uploaded */
+    uint32_t waits;                                     /*!< Silences played because the FIFO was empty */
+} melody_stream_upload_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Open a stream on a source and read its first chunk.
+ *
+ * @param p_stream Pointer to the stream
+ * @param read Read function of the source
+ * @param p_source Pointer to the source
+ */
+void melody_stream_open(melody_stream_t *p_stream, melody_stream_read_t read, void *p_source);
+
+/**
+ * @brief Go back to the first event of the source. Nothing is read if no event has been played yet.
+ *
+ * @param p_stream Pointer to the stream
+ */
+void melody_stream_rewind(melody_stream_t *p_stream);
+
+/**
+ * @brief Check if the stream has another event. It reads the next chunk if it has not been prefetched (underrun).
+ *
+ * @param p_stream Pointer to the stream
+ * @return true if there is another event, false at the end of the melody
+ */
+bool melody_stream_has_next(melody_stream_t *p_stream);
+
+/**
+ * @brief Get the next event of the stream.
+ *
+ * @param p_stream Pointer to the stream
+ * @param p_event Pointer where the event is stored
+ * @return true if an event has been returned, false at the end of the melody
+ */
+bool melody_stream_next(melody_stream_t *p_stream, melody_event_t *p_event);
+
+/**
+ * @brief Read the next chunk into the back buffer if it is empty. It must be called while a note is playing.
+ *
+ * @param p_stream Pointer to the stream
+ * @return true if a chunk has been read
+ */
+bool melody_stream_prefetch(melody_stream_t *p_stream);
+
+/**
+ * @brief Read function of a memory blob source (`melody_stream_blob_t`).
+ */
+uint32_t melody_stream_read_blob(void *p_source, uint32_t offset, melody_event_t *p_events, uint32_t max_events);
+
+/**
+ * @brief Initialize an empty upload source.
+ *
+ * @param p_upload Pointer to the upload source
+ */
+void melody_stream_upload_init(melody_stream_upload_t *p_upload);
+
+/**
+ * @brief Add events to an upload source from their hexadecimal text: 4 digits per event, note then duration code.
+ *
+ * The events are added only if the text is valid and all of them fit in the FIFO.
+ *
+ * @param p_upload Pointer to the upload source
+ * @param p_hex Text (not null-terminated)
+ * @param length Length of the text
+ * @return true if the events have been added
+ */
+bool melody_stream_upload_put_hex(melody_stream_upload_t *p_upload, const char *p_hex, uint32_t length);
+
+/**
+ * @brief Mark the end of the melody of an upload source.
+ *
+ * @param p_upload Pointer to the upload source
+ */
+void melody_stream_upload_close(melody_stream_upload_t *p_upload);
+
+/**
+ * @brief Read function of an upload source (`melody_stream_upload_t`).
+ *
+ * It is sequential (the offset is ignored). If the FIFO is empty and the source is not closed, it returns a silence
+ * of MELODY_STREAM_WAIT_MS so the melody continues when more events are uploaded.
+ */
+uint32_t melody_stream_read_upload(void *p_source, uint32_t offset, melody_event_t *p_events, uint32_t max_events);
+
+#endif /* MELODY_STREAM_H_ */
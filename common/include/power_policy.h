@@ -0,0 +1,100 @@
+/**
+ * @file power_policy.h
+ * @brief Header for power_policy.c file.
+ *
+ * Power policy of the main loop. When the scheduler has no events to process, power_policy_idle() chooses the low
+ * power mode:
+ *
+ * - Stop mode, if the FSM given to power_policy_init() is in standby (the jukebox is OFF and nothing is playing,
+ *   being received or sent) and no FSM registered in the tickless idle has a timeout pending. Only the user button
+ *   and the RX pin of the USART wake up the core.
+ * - Otherwise, the tickless Sleep mode of tickless_idle(), that keeps the peripherals running.
+ *
+ * It counts the time spent (residency) and the number of entries in each power state.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef POWER_POLICY_H_
+#define POWER_POLICY_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include <fsm.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Enums */
+/**
+ * @brief Power states of the system.
+ */
+enum POWER_POLICY_STATE
+{
+    POWER_POLICY_RUN = 0,   /*!< The core is running */
+    POWER_POLICY_SLEEP,     /*!< Tickless Sleep mode: core stopped, peripherals running */
+    POWER_POLICY_STOP,      /*!< Stop mode: all the clocks stopped but the LSI */
+    POWER_POLICY_NUM_STATES /*!< Number of power states */
+};
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Check if an FSM allows Stop mode.
+ *
+ * @param p_fsm Pointer to the FSM
+ * @return true if the peripherals are not needed until the next wake-up source, false otherwise
+ */
+typedef bool (*power_policy_check_t)(fsm_t *p_fsm);
+
+/**
+ * @brief Residency of a power state.
+ */
+typedef struct
+{
+    uint32_t entries;      /*!< Number of times the system has entered the state */
+    uint64_t residency_ms; /*!< Total time spent in the state in milliseconds */
+} power_policy_residency_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize the power policy and reset the residency counters.
+ *
+ * @param p_fsm Pointer to the FSM that decides when Stop mode is allowed
+ * @param check_stop Function that checks if the FSM allows Stop mode
+ * @param wakeup_usart_id USART whose RX pin wakes up the core from Stop mode. If its RX line cannot be armed (see
+ * port_usart_set_rx_wakeup()), the idle periods use the tickless Sleep mode instead
+ */
+void power_policy_init(fsm_t *p_fsm, power_policy_check_t check_stop, uint32_t wakeup_usart_id);
+
+/**
+ * @brief Choose the power state for the next idle period.
+ *
+ * @return uint8_t POWER_POLICY_STOP or POWER_POLICY_SLEEP
+ */
+uint8_t power_policy_select(void);
+
+/**
+ * @brief Enter the power state chosen by power_policy_select() until the next wake-up. Call it when the scheduler has
+ * no events to process.
+ */
+void power_policy_idle(void);
+
+/**
+ * @brief Get the residency of each power state since power_policy_init().
+ *
+ * @param p_residency Array of POWER_POLICY_NUM_STATES elements, indexed by POWER_POLICY_STATE
+ */
+void power_policy_get_residency(power_policy_residency_t *p_residency);
+
+/**
+ * @brief Write the residency of each power state in a text line.
+ *
+ * @param p_buffer Buffer to store the text
+ * @param length Size of the buffer
+ * @return uint32_t Number of characters written, without the end of string
+ */
+uint32_t power_policy_format(char *p_buffer, uint32_t length);
+
+#endif /* POWER_POLICY_H_ */
@@ -0,0 +1,82 @@
+/**
+ * @file scheduler.h
+ * @brief Header for scheduler.c file.
+ *
+ * Event-driven scheduler of the FSMs of the system. The ISRs post events (see PORT_SYSTEM_EVENT_*) and each FSM is
+ * subscribed to the events that can make its transitions change. The main loop only fires the FSMs subscribed to the
+ * pending events and sleeps until the next interrupt when there is nothing to do.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include <fsm.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define SCHEDULER_MAX_TASKS 8                           /*!< Maximum number of FSMs subscribed to the scheduler */
+#define SCHEDULER_EVENT_STATE_CHANGE (0x01U << 31)      /*!< Software event: a fired FSM has changed its state or run an action */
+#define SCHEDULER_EVENT_ALL 0xFFFFFFFFU                 /*!< Mask to subscribe a FSM to all the events */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Counters to measure the activity of the scheduler.
+ */
+typedef struct
+{
+    uint32_t iterations;      /*!< Number of calls to scheduler_dispatch() */
+    uint32_t idle_iterations; /*!< Number of calls to scheduler_dispatch() without pending events */
+    uint32_t fires;           /*!< Number of calls to fsm_fire() */
+    uint32_t events;          /*!< Number of events processed (one per bit set) */
+    uint32_t active_cycles;   /*!< Cycles spent firing FSMs (see port_system_get_cycles()) */
+} scheduler_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Remove all the subscriptions and reset the counters of the scheduler.
+ */
+void scheduler_init(void);
+
+/**
+ * @brief Subscribe a FSM to some events. The FSMs are fired in the order of subscription.
+ *
+ * The transition table of the FSM is indexed (fsm_index_build()) so each fire only visits the rows of its current
+ * state. If the table cannot be indexed it is scanned as fsm_fire() does.
+ *
+ * @param p_fsm Pointer to the FSM
+ * @param events Mask of events that make the FSM be fired
+ * @return true if the FSM has been subscribed, false if there is no room for more FSMs
+ */
+bool scheduler_subscribe(fsm_t *p_fsm, uint32_t events);
+
+/**
+ * @brief Take the pending events and fire the FSMs subscribed to any of them.
+ *
+ * If the state of a fired FSM changes, or it runs the action of a transition, the event SCHEDULER_EVENT_STATE_CHANGE
+ * is posted so the FSMs that depend on it are evaluated in the next call.
+ *
+ * @return true if there were events to process, false if the system can go to sleep
+ */
+bool scheduler_dispatch(void);
+
+/**
+ * @brief Get the counters of the scheduler.
+ *
+ * @param p_stats Pointer to store the counters
+ */
+void scheduler_get_stats(scheduler_stats_t *p_stats);
+
+/**
+ * @brief Reset the counters of the scheduler.
+ */
+void scheduler_reset_stats(void);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,208 @@
+/**
+ * @file synth.h
+ * @brief Header for synth.c file.
+ *
+ * Software wavetable synthesizer. Each voice reads a single-cycle table (sine, triangle, saw or square) with a 32-bit
+ * phase accumulator and linear interpolation, and is shaped by an ADSR envelope. The voices are mixed in fixed point
+ * into buffers of 16-bit samples, which the audio port sends to the DAC by DMA. A sequencer plays a melody of several
+ * voices with the timing of each frame counted in samples, so the notes change at the exact sample.
+ *
+ * The envelopes and the sequencer are updated at control rate, once every `SYNTH_BLOCK_SAMPLES` samples at most, and
+ * the inner loop only reads the tables and mixes. On the Cortex-M4 the interpolation is a single `SMLAD` and the mix
+ * saturates with `SSAT`; any other target uses the same arithmetic in portable C.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef SYNTH_H_
+#define SYNTH_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Other includes */
+#include "melody_poly.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define SYNTH_NUM_VOICES MELODY_POLY_MAX_VOICES /*!< Voices mixed by the synthesizer */
+#define SYNTH_TABLE_BITS 8U                     /*!< log2 of the number of samples of a wavetable */
+#define SYNTH_TABLE_SIZE (1U << SYNTH_TABLE_BITS) /*!< Samples of a wavetable (one cycle) */
+#define SYNTH_BLOCK_SAMPLES 16U                 /*!< Maximum samples between two updates of the envelopes and the sequencer */
+#define SYNTH_LEVEL_ONE 32767                   /*!< Full level of a Q15 envelope or gain */
+#define SYNTH_VOICE_GAIN (SYNTH_LEVEL_ONE / SYNTH_NUM_VOICES) /*!< Gain of a voice at full envelope: all the voices together do not clip */
+#define SYNTH_SPEED_SHIFT 16U                   /*!< Fractional bits of the speed of the sequencer (Q16.16) */
+#define SYNTH_SPEED_ONE (1UL << SYNTH_SPEED_SHIFT) /*!< Nominal speed of the sequencer */
+#define SYNTH_DAC_BITS 12U                      /*!< Resolution of the DAC samples */
+#define SYNTH_DAC_MID (1U << (SYNTH_DAC_BITS - 1U)) /*!< DAC code of the zero of the audio signal */
+
+/* Enums */
+/**
+ * @brief Waveforms of the wavetables.
+ */
+enum SYNTH_WAVE
+{
+    SYNTH_WAVE_SINE = 0, /*!< Sine */
+    SYNTH_WAVE_TRIANGLE, /*!< Triangle */
+    SYNTH_WAVE_SAW,      /*!< Rising saw */
+    SYNTH_WAVE_SQUARE,   /*!< Square with 50 % duty cycle */
+    SYNTH_NUM_WAVES      /*!< Number of waveforms */
+};
+
+/**
+ * @brief Stages of the envelope of a voice.
+ */
+enum SYNTH_STAGE
+{
+    SYNTH_STAGE_IDLE = 0, /*!< The voice is silent and is not mixed */
+    SYNTH_STAGE_ATTACK,   /*!< Rise to full level */
+    SYNTH_STAGE_DECAY,    /*!< Fall to the sustain level */
+    SYNTH_STAGE_SUSTAIN,  /*!< Sustain level until the note is released */
+    SYNTH_STAGE_RELEASE   /*!< Fall to silence */
+};
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief ADSR envelope of a voice.
+ */
+typedef struct
+{
+    uint16_t attack_ms;   /*!< Time from silence to full level */
+    uint16_t decay_ms;    /*!< Time from full level to the sustain level */
+    uint16_t sustain;     /*!< Sustain level in Q15 (SYNTH_LEVEL_ONE is full level) */
+    uint16_t release_ms;  /*!< Time from full level to silence after the note is released */
+} synth_adsr_t;
+
+/**
+ * @brief State of a voice of the synthesizer.
+ */
+typedef struct
+{
+    const int16_t *p_table; /*!< Wavetable of the voice */
+    uint32_t phase;         /*!< Phase accumulator: one cycle of the table is 2^32 */
+    uint32_t increment;     /*!< Phase increment per sample, from the frequency of the note */
+    int32_t level;          /*!< Level of the envelope in Q23 */
+    int32_t attack_step;    /*!< Increment of the level per sample in the attack */
+    int32_t decay_step;     /*!< Decrement of the level per sample in the decay */
+    int32_t release_step;   /*!< Decrement of the level per sample in the release */
+    int32_t sustain;        /*!< Sustain level in Q23 */
+    uint8_t stage;          /*!< Stage of the envelope (`SYNTH_STAGE`) */
+} synth_voice_t;
+
+/**
+ * @brief Statistics of the sequencer.
+ */
+typedef struct
+{
+    uint64_t samples;  /*!< Samples rendered since the last call to `synth_play()` */
+    uint32_t frames;   /*!< Frames of the melody started */
+    uint32_t blocks;   /*!< Control blocks mixed */
+} synth_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize the synthesizer: fill the wavetables, silence all the voices and stop the sequencer.
+ *
+ * The voices start with the default waveforms (triangle for the main voice, saw for the bass, sine for the rest) and
+ * the default envelope.
+ *
+ * @param sample_rate_hz Sample rate of the output in Hz
+ */
+void synth_init(uint32_t sample_rate_hz);
+
+/**
+ * @brief Get the sample rate set with `synth_init()`.
+ *
+ * @return uint32_t Sample rate in Hz
+ */
+uint32_t synth_get_sample_rate(void);
+
+/**
+ * @brief Get a wavetable. It has `SYNTH_TABLE_SIZE + 1` samples: the last one repeats the first for the interpolation.
+ *
+ * @param wave Waveform (`SYNTH_WAVE`)
+ * @return const int16_t* Samples of the table in Q15, or NULL for an unknown waveform
+ */
+const int16_t *synth_get_table(uint32_t wave);
+
+/**
+ * @brief Set the waveform and the envelope of a voice. The change applies to the next note of the voice.
+ *
+ * @param voice Index of the voice
+ * @param wave Waveform (`SYNTH_WAVE`)
+ * @param p_adsr Pointer to the envelope, or NULL for the default one
+ */
+void synth_set_voice(uint32_t voice, uint32_t wave, const synth_adsr_t *p_adsr);
+
+/**
+ * @brief Start a note in a voice: set its frequency and restart its envelope from the current level.
+ *
+ * @param voice Index of the voice
+ * @param note MIDI note number. MIDI_SILENCE releases the voice
+ */
+void synth_note_on(uint32_t voice, uint8_t note);
+
+/**
+ * @brief Release the note of a voice. The voice is silent at the end of the release of its envelope.
+ *
+ * @param voice Index of the voice
+ */
+void synth_note_off(uint32_t voice);
+
+/**
+ * @brief Start playing a melody of several voices with the sequencer. Voice v of the melody sounds in voice v of the
+ * synthesizer.
+ *
+ * @param p_poly Pointer to the melody
+ * @param speed Speed of the sequencer in Q16.16 (`SYNTH_SPEED_ONE` is the nominal speed)
+ */
+void synth_play(const melody_poly_t *p_poly, uint32_t speed);
+
+/**
+ * @brief Stop the sequencer and release all the voices.
+ *
+ */
+void synth_stop(void);
+
+/**
+ * @brief Check if the sequencer is playing a melody.
+ *
+ * @return true while there are frames of the melody left
+ */
+bool synth_is_playing(void);
+
+/**
+ * @brief Check if the synthesizer produces any sound: the sequencer is playing or any envelope is not idle.
+ *
+ * @return true if the output is not silence
+ */
+bool synth_is_active(void);
+
+/**
+ * @brief Render the next samples of the mix as signed 16-bit samples.
+ *
+ * @param p_samples Pointer to the output buffer
+ * @param num_samples Number of samples to render
+ */
+void synth_render(int16_t *p_samples, uint32_t num_samples);
+
+/**
+ * @brief Render the next samples of the mix as unsigned 12-bit DAC codes, right aligned.
+ *
+ * @param p_codes Pointer to the output buffer
+ * @param num_samples Number of samples to render
+ */
+void synth_render_dac(uint16_t *p_codes, uint32_t num_samples);
+
+/**
+ * @brief Get the statistics of the sequencer.
+ *
+ * @param p_stats Pointer where the statistics are stored
+ */
+void synth_get_stats(synth_stats_t *p_stats);
+
+#endif /* SYNTH_H_ */
@@ -0,0 +1,111 @@
+/**
+ * @file tickless.h
+ * @brief Header for tickless.c file.
+ *
+ * Tickless idle of the main loop. When the scheduler has no events to process, tickless_idle() asks the FSMs
+ * registered with tickless_register() for their next timeout (e.g. the debounce of the button), and sleeps with the
+ * SysTick suspended until the earliest one or until an interrupt arrives (end of a note, USART, button). The port
+ * adds the milliseconds slept to the system tick on wake-up, so the timing of the FSMs is kept across sleeps.
+ *
+ * The FSMs whose timing is kept by a hardware timer (the end of a note in TIM2) do not need to be registered: its
+ * interrupt wakes up the core.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef TICKLESS_H_
+#define TICKLESS_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include <fsm.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define TICKLESS_MAX_FSMS 4         /*!< Maximum number of FSMs with timeouts */
+#define TICKLESS_MAX_SLEEP_MS 1000  /*!< Longest sleep when no FSM has a timeout pending */
+#define TICKLESS_LOG_LENGTH 32      /*!< Number of sleeps kept in the power log */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Get the next timeout of an FSM.
+ *
+ * @param p_fsm Pointer to the FSM
+ * @param p_deadline_ms Pointer to store the 64-bit system tick (port_system_get_millis64()) at which the timeout expires
+ * @return true if the FSM has a timeout pending, false otherwise
+ */
+typedef bool (*tickless_deadline_t)(fsm_t *p_fsm, uint64_t *p_deadline_ms);
+
+/**
+ * @brief Entry of the power log: one sleep.
+ */
+typedef struct
+{
+    uint32_t start_ms;     /*!< System tick (low 32 bits) when the system went to sleep */
+    uint32_t requested_ms; /*!< Time until the earliest timeout, or TICKLESS_MAX_SLEEP_MS */
+    uint32_t slept_ms;     /*!< Milliseconds added to the system tick on wake-up */
+    bool timeout;          /*!< Woken up by the wake-up timer (true) or by another interrupt (false) */
+} tickless_log_entry_t;
+
+/**
+ * @brief Counters of the tickless idle.
+ */
+typedef struct
+{
+    uint32_t sleeps;           /*!< Number of sleeps */
+    uint32_t slept_ms;         /*!< Total time slept in milliseconds */
+    uint32_t timeout_wakeups;  /*!< Sleeps ended by the wake-up timer */
+    uint32_t expired;          /*!< Calls with a timeout already expired, that did not sleep */
+} tickless_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Remove all the registered FSMs and reset the counters and the log.
+ */
+void tickless_init(void);
+
+/**
+ * @brief Register an FSM that has timeouts.
+ *
+ * @param p_fsm Pointer to the FSM
+ * @param get_deadline Function that returns the next timeout of the FSM
+ * @return true if the FSM has been registered, false if there is no room
+ */
+bool tickless_register(fsm_t *p_fsm, tickless_deadline_t get_deadline);
+
+/**
+ * @brief Get the time until the earliest timeout of the registered FSMs.
+ *
+ * @return uint32_t Milliseconds until the earliest timeout (0 if it has expired), or TICKLESS_MAX_SLEEP_MS if there
+ * are no timeouts pending or they are farther
+ */
+uint32_t tickless_get_sleep_ms(void);
+
+/**
+ * @brief Sleep until the next interrupt or the earliest timeout. Call it when the scheduler has no events to process.
+ *
+ * If a timeout has already expired, PORT_SYSTEM_EVENT_TICK is posted instead of sleeping.
+ */
+void tickless_idle(void);
+
+/**
+ * @brief Get the counters of the tickless idle.
+ *
+ * @param p_stats Pointer to store the counters
+ */
+void tickless_get_stats(tickless_stats_t *p_stats);
+
+/**
+ * @brief Get the last sleeps of the power log, oldest first.
+ *
+ * @param p_log Array to store the entries
+ * @param max_entries Length of the array
+ * @return uint32_t Number of entries copied
+ */
+uint32_t tickless_get_log(tickless_log_entry_t *p_log, uint32_t max_entries);
+
+#endif /* TICKLESS_H_ */
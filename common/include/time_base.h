@@ -0,0 +1,68 @@
+/**
+ * @file time_base.h
+ * @brief Header for time_base.c file.
+ *
+ * Wrap-safe deadlines. The 64-bit time base of the port (port_system_get_millis64(), port_system_get_micros64())
+ * never wraps, so its deadlines are compared directly. The 32-bit tick (port_system_get_millis()) wraps after 2^32 ms
+ * (49.7 days): a comparison like `now > deadline` fails across the wrap, so its values are compared with the signed
+ * difference, valid while the deadline is less than 2^31 ms away.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef TIME_BASE_H_
+#define TIME_BASE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Get a deadline some milliseconds from now, in the 64-bit time base.
+ *
+ * @param delay_ms Milliseconds from now
+ * @return uint64_t System tick at which the deadline expires
+ */
+uint64_t time_base_deadline_ms(uint32_t delay_ms);
+
+/**
+ * @brief Check if a deadline of the 64-bit time base has been reached.
+ *
+ * @param now Current time
+ * @param deadline Deadline, in the same unit as `now`
+ * @return true if `now` is at or after the deadline, false otherwise
+ */
+bool time_base_reached(uint64_t now, uint64_t deadline);
+
+/**
+ * @brief Get the time until a deadline of the 64-bit time base.
+ *
+ * @param now Current time
+ * @param deadline Deadline, in the same unit as `now`
+ * @return uint64_t Time until the deadline, 0 if it has been reached
+ */
+uint64_t time_base_remaining(uint64_t now, uint64_t deadline);
+
+/**
+ * @brief Check if a deadline of the 32-bit tick has been reached, also across its wrap.
+ *
+ * @param now Current value of the 32-bit tick
+ * @param deadline Deadline, less than 2^31 ticks away from `now`
+ * @return true if `now` is at or after the deadline, false otherwise
+ */
+bool time_base_reached32(uint32_t now, uint32_t deadline);
+
+/**
+ * @brief Get the time until a deadline of the 32-bit tick, also across its wrap.
+ *
+ * @param now Current value of the 32-bit tick
+ * @param deadline Deadline, less than 2^31 ticks away from `now`
+ * @return uint32_t Ticks until the deadline, 0 if it has been reached
+ */
+uint32_t time_base_remaining32(uint32_t now, uint32_t deadline);
+
+#endif /* TIME_BASE_H_ */
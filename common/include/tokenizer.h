@@ -0,0 +1,81 @@
+/**
+ * @file tokenizer.h
+ * @brief Header for tokenizer.c file.
+ *
+ * Reentrant, allocation-free tokenizer of the commands received by the USART. Tokens are returned as views
+ * {pointer, length} into the source buffer, which is never written, so no bytes are copied to parse a command.
+ * Tokens are separated by blanks (space, tab, CR, LF). A token that starts with a double quote extends up to the next
+ * double quote, which allows arguments with blanks; the quotes are not part of the token.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef TOKENIZER_H_
+#define TOKENIZER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief View of a token inside the source buffer. It is not null-terminated.
+ */
+typedef struct
+{
+    const char *p_start; /*!< Pointer to the first character of the token */
+    uint32_t length;     /*!< Number of characters of the token */
+} token_t;
+
+/**
+ * @brief State of the tokenizer. Each user keeps its own state, so the tokenizer is reentrant.
+ */
+typedef struct
+{
+    const char *p_next; /*!< Next character to be processed */
+    const char *p_end;  /*!< End of the source buffer */
+} tokenizer_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize a tokenizer on a buffer. The buffer ends at its first null character or after `max_length` bytes.
+ *
+ * @param p_tokenizer Pointer to the state of the tokenizer
+ * @param p_buffer Source buffer. It is only read
+ * @param max_length Size of the source buffer
+ */
+void tokenizer_init(tokenizer_t *p_tokenizer, const char *p_buffer, uint32_t max_length);
+
+/**
+ * @brief Get the next token.
+ *
+ * @param p_tokenizer Pointer to the state of the tokenizer
+ * @param p_token Pointer to store the view of the token
+ * @return true if a token has been found, false if the end of the buffer has been reached
+ */
+bool tokenizer_next(tokenizer_t *p_tokenizer, token_t *p_token);
+
+/**
+ * @brief Split a buffer into tokens.
+ *
+ * @param p_buffer Source buffer. It is only read
+ * @param max_length Size of the source buffer
+ * @param p_tokens Array to store the views of the tokens
+ * @param max_tokens Size of the array of tokens
+ * @return uint32_t Number of tokens stored. The tokens that do not fit in the array are discarded
+ */
+uint32_t tokenizer_split(const char *p_buffer, uint32_t max_length, token_t *p_tokens, uint32_t max_tokens);
+
+/**
+ * @brief Compare a token with a null-terminated string.
+ *
+ * @param p_token Pointer to the token
+ * @param p_string String to compare with
+ * @return true if the token and the string are equal, false otherwise
+ */
+bool tokenizer_equals(const token_t *p_token, const char *p_string);
+
+#endif /* TOKENIZER_H_ */
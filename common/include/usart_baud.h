@@ -0,0 +1,66 @@
+/**
+ * @file usart_baud.h
+ * @brief Header for usart_baud.c file.
+ *
+ * Baud rate arithmetic of the STM32F4 USART, independent of the hardware so it can be tested on the host. The divider
+ * is the bus clock divided by the baud rate, rounded to the nearest integer: with oversampling by 16 it is written as
+ * it is in BRR (mantissa and 4-bit fraction), and with oversampling by 8 (OVER8) its 3 low bits are the fraction.
+ * Oversampling by 16 tolerates more noise and clock error, so OVER8 is only used when the divider is below 16.
+ *
+ * The autobaud detection converts the duration of a start bit, measured in cycles of a known clock, into the nearest
+ * standard baud rate.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef USART_BAUD_H_
+#define USART_BAUD_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define USART_BAUD_MIN 1200U                /*!< Lowest baud rate accepted */
+#define USART_BAUD_MAX 921600U              /*!< Highest baud rate accepted */
+#define USART_BAUD_MAX_ERROR_PPM 25000U     /*!< Largest error of the real baud rate accepted (2.5 %) */
+#define USART_BAUD_DETECT_TOLERANCE_PPM 80000U /*!< Largest difference between a measured start bit and a standard rate (8 %) */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Configuration of the USART for a baud rate.
+ */
+typedef struct
+{
+    uint32_t brr;       /*!< Value of the BRR register */
+    bool over8;         /*!< The OVER8 bit of CR1 must be set */
+    uint32_t actual;    /*!< Real baud rate obtained with the divider */
+    uint32_t error_ppm; /*!< Difference between the real and the requested baud rate, in parts per million */
+} usart_baud_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Compute the divider of a baud rate.
+ *
+ * @param pclk_hz Frequency of the bus clock of the USART (APB1 or APB2)
+ * @param baudrate Requested baud rate
+ * @param p_baud Pointer where the configuration is stored
+ * @return true if the baud rate is in range and its error is below USART_BAUD_MAX_ERROR_PPM, false otherwise
+ */
+bool usart_baud_compute(uint32_t pclk_hz, uint32_t baudrate, usart_baud_t *p_baud);
+
+/**
+ * @brief Get the standard baud rate of a start bit.
+ *
+ * @param clock_hz Frequency of the clock used to measure the start bit
+ * @param start_bit_cycles Duration of the start bit in cycles of that clock
+ * @return uint32_t Nearest standard baud rate (1200 to 921600), or 0 if no standard rate is within
+ * USART_BAUD_DETECT_TOLERANCE_PPM
+ */
+uint32_t usart_baud_detect(uint32_t clock_hz, uint32_t start_bit_cycles);
+
+#endif /* USART_BAUD_H_ */
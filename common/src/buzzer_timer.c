@@ -0,0 +1,237 @@
+/**
+ * @file buzzer_timer.c
+ * @brief Precomputed and closed-form register values of the timers of the buzzer.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stddef.h>
+
+/* Other libraries */
+#include "buzzer_timer.h"
+#include "melodies.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define MS_PER_S 1000U  /*!< Milliseconds per second */
+#define US_PER_MS 1000U /*!< Microseconds per millisecond */
+#define US_PER_S 1000000U /*!< Microseconds per second */
+#define MHZ_PER_HZ 1000U  /*!< Millihertz per hertz */
+
+/* The following macros are constant expressions, so the tables are computed by the compiler. They are the same
+ * integer expressions as buzzer_timer_solve(): a period of num/den clock cycles */
+#define _TABLE_PSC(num, den) (((num) - 1U) / ((den) * BUZZER_TIMER_MAX_COUNT))                                   /*!< Smallest prescaler: ceil(cycles / 65536) - 1 */
+#define _TABLE_COUNTS(num, den, psc) ((2U * (num) + (den) * ((psc) + 1U)) / (2U * (den) * ((psc) + 1U)))         /*!< Nearest number of counts (ARR + 1) */
+#define _TABLE_CCR1(arr) (((arr) + 1U) * BUZZER_TIMER_PWM_DUTY_PERCENT / 100U)                                  /*!< Compare value for the duty cycle */
+
+#define _NOTE_NUM ((uint64_t)BUZZER_TIMER_TABLE_CLOCK_HZ * MHZ_PER_HZ)                                          /*!< Numerator of the period of a note */
+#define _NOTE_DEN(n) ((uint64_t)MELODY_NOTE_MHZ(n))                                                              /*!< Denominator of the period of a note: frequency in mHz */
+#define _NOTE_PSC(n) _TABLE_PSC(_NOTE_NUM, _NOTE_DEN(n))                                                         /*!< Prescaler of a note */
+#define _NOTE_ARR(n) (_TABLE_COUNTS(_NOTE_NUM, _NOTE_DEN(n), _NOTE_PSC(n)) - 1U)                                 /*!< Auto-reload of a note */
+#define NOTE_ENTRY(n) {.psc = _NOTE_PSC(MIDI_##n), .arr = _NOTE_ARR(MIDI_##n), .ccr1 = _TABLE_CCR1(_NOTE_ARR(MIDI_##n))} /*!< Entry of the table of notes */
+
+#define _DURATION_NUM(d) ((uint64_t)BUZZER_TIMER_TABLE_CLOCK_HZ * (d))                                          /*!< Numerator of a duration in ms */
+#define _DURATION_PSC(d) _TABLE_PSC(_DURATION_NUM(d), MS_PER_S)                                                  /*!< Prescaler of a duration */
+#define _DURATION_ARR(d) (_TABLE_COUNTS(_DURATION_NUM(d), MS_PER_S, _DURATION_PSC(d)) - 1U)                      /*!< Auto-reload of a duration */
+#define DURATION_ENTRY(d) {.duration_ms = (d), .config = {.psc = _DURATION_PSC(d), .arr = _DURATION_ARR(d), .ccr1 = 0}} /*!< Entry of the table of durations */
+
+/* Typedefs ------------------------------------------------------------------*/
+/**
+ * @brief Entry of the table of durations.
+ */
+typedef struct
+{
+    uint32_t duration_ms;         /*!< Duration in milliseconds */
+    buzzer_timer_config_t config; /*!< Configuration of the duration timer */
+} duration_entry_t;
+
+/* Global variables ------------------------------------------------------------*/
+/**
+ * @brief Configuration of the PWM timer for each note from DO3 to SI5, indexed by MIDI note number - BUZZER_TIMER_FIRST_NOTE.
+ */
+static const buzzer_timer_config_t note_table[BUZZER_TIMER_NUM_NOTES] = {
+    NOTE_ENTRY(DO3), NOTE_ENTRY(DOs3), NOTE_ENTRY(RE3), NOTE_ENTRY(REs3), NOTE_ENTRY(MI3), NOTE_ENTRY(FA3),
+    NOTE_ENTRY(FAs3), NOTE_ENTRY(SOL3), NOTE_ENTRY(SOLs3), NOTE_ENTRY(LA3), NOTE_ENTRY(LAs3), NOTE_ENTRY(SI3),
+    NOTE_ENTRY(DO4), NOTE_ENTRY(DOs4), NOTE_ENTRY(RE4), NOTE_ENTRY(REs4), NOTE_ENTRY(MI4), NOTE_ENTRY(FA4),
+    NOTE_ENTRY(FAs4), NOTE_ENTRY(SOL4), NOTE_ENTRY(SOLs4), NOTE_ENTRY(LA4), NOTE_ENTRY(LAs4), NOTE_ENTRY(SI4),
+    NOTE_ENTRY(DO5), NOTE_ENTRY(DOs5), NOTE_ENTRY(RE5), NOTE_ENTRY(REs5), NOTE_ENTRY(MI5), NOTE_ENTRY(FA5),
+    NOTE_ENTRY(FAs5), NOTE_ENTRY(SOL5), NOTE_ENTRY(SOLs5), NOTE_ENTRY(LA5), NOTE_ENTRY(LAs5), NOTE_ENTRY(SI5)};
+
+/**
+ * @brief Configuration of the duration timer for the common durations of the melodies, in ascending order.
+ */
+static const duration_entry_t duration_table[BUZZER_TIMER_NUM_DURATIONS] = {
+    DURATION_ENTRY(100), DURATION_ENTRY(150), DURATION_ENTRY(200), DURATION_ENTRY(250), DURATION_ENTRY(300),
+    DURATION_ENTRY(400), DURATION_ENTRY(500), DURATION_ENTRY(600), DURATION_ENTRY(800), DURATION_ENTRY(1000)};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Find a duration in the table of durations.
+ *
+ * @param clock_hz Clock of the timer in Hz
+ * @param duration_ms Duration in milliseconds
+ * @return const buzzer_timer_config_t* Entry of the table, or NULL if the clock is not the one of the table or the
+ * duration is not in it
+ */
+static const buzzer_timer_config_t *_find_duration(uint32_t clock_hz, uint32_t duration_ms)
+{
+    if (clock_hz == BUZZER_TIMER_TABLE_CLOCK_HZ)
+    {
+        for (uint32_t i = 0; (i < BUZZER_TIMER_NUM_DURATIONS) && (duration_table[i].duration_ms <= duration_ms); i++)
+        {
+            if (duration_table[i].duration_ms == duration_ms)
+            {
+                return &duration_table[i].config;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Public functions -----------------------------------------------------------*/
+int32_t buzzer_timer_find_note(uint32_t frequency_mhz)
+{
+    int32_t low = 0;
+    int32_t high = BUZZER_TIMER_NUM_NOTES - 1;
+    while (low <= high)
+    {
+        int32_t mid = (low + high) / 2;
+        uint32_t mid_mhz = melody_get_note_mhz(BUZZER_TIMER_FIRST_NOTE + mid);
+        if (mid_mhz == frequency_mhz)
+        {
+            return mid;
+        }
+        if (mid_mhz < frequency_mhz)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+const buzzer_timer_config_t *buzzer_timer_get_note_entry(uint32_t note_index)
+{
+    return (note_index < BUZZER_TIMER_NUM_NOTES) ? &note_table[note_index] : NULL;
+}
+
+bool buzzer_timer_get_midi_config(uint32_t clock_hz, uint8_t note, buzzer_timer_config_t *p_config)
+{
+    uint32_t index = (uint32_t)note - BUZZER_TIMER_FIRST_NOTE;
+    if ((clock_hz == BUZZER_TIMER_TABLE_CLOCK_HZ) && (index < BUZZER_TIMER_NUM_NOTES))
+    {
+        *p_config = note_table[index];
+        return true;
+    }
+    buzzer_timer_solve_frequency(clock_hz, melody_get_note_mhz(note), p_config);
+    return false;
+}
+
+bool buzzer_timer_get_note_config(uint32_t clock_hz, double frequency_hz, buzzer_timer_config_t *p_config)
+{
+    uint32_t frequency_mhz = (uint32_t)(frequency_hz * MHZ_PER_HZ + 0.5);
+    if (clock_hz == BUZZER_TIMER_TABLE_CLOCK_HZ)
+    {
+        int32_t index = buzzer_timer_find_note(frequency_mhz);
+        if (index >= 0)
+        {
+            *p_config = note_table[index];
+            return true;
+        }
+    }
+    buzzer_timer_solve_frequency(clock_hz, frequency_mhz, p_config);
+    return false;
+}
+
+bool buzzer_timer_get_duration_config(uint32_t clock_hz, uint32_t duration_ms, buzzer_timer_config_t *p_config)
+{
+    const buzzer_timer_config_t *p_entry = _find_duration(clock_hz, duration_ms);
+    if (p_entry != NULL)
+    {
+        *p_config = *p_entry;
+        return true;
+    }
+    buzzer_timer_compute_duration(clock_hz, duration_ms, p_config);
+    return false;
+}
+
+bool buzzer_timer_get_carried_duration_config(uint32_t clock_hz, uint32_t duration_us, int64_t *p_error, buzzer_timer_config_t *p_config)
+{
+    int64_t target = (int64_t)clock_hz * duration_us + *p_error;
+    if (target < (int64_t)US_PER_S)
+    {
+        target = US_PER_S;
+    }
+
+    /* Durations of the table: the entry is the nearest one for the nominal duration, so the carried error, within
+     * half a prescaled count, moves ARR by a count at most. No division is needed */
+    const buzzer_timer_config_t *p_entry = ((duration_us % US_PER_MS) == 0) ? _find_duration(clock_hz, duration_us / US_PER_MS) : NULL;
+    if (p_entry != NULL)
+    {
+        *p_config = *p_entry;
+        int64_t step = (int64_t)(p_config->psc + 1U) * US_PER_S;
+        int64_t diff = target - step * (p_config->arr + 1U);
+        while ((2 * diff > step) && (p_config->arr < BUZZER_TIMER_MAX_COUNT - 1U))
+        {
+            p_config->arr++;
+            diff -= step;
+        }
+        while ((2 * diff < -step) && (p_config->arr > 0))
+        {
+            p_config->arr--;
+            diff += step;
+        }
+        *p_error = diff;
+        return true;
+    }
+
+    uint64_t cycles = buzzer_timer_solve((uint64_t)target, US_PER_S, p_config);
+    p_config->ccr1 = 0;
+    *p_error = target - (int64_t)(cycles * US_PER_S);
+    return false;
+}
+
+uint64_t buzzer_timer_solve(uint64_t cycles_num, uint64_t cycles_den, buzzer_timer_config_t *p_config)
+{
+    uint64_t psc = (cycles_num > 0) ? _TABLE_PSC(cycles_num, cycles_den) : 0;
+    uint64_t counts;
+    if (psc >= BUZZER_TIMER_MAX_COUNT)
+    {
+        /* Longer than the longest period of the timer: saturate */
+        psc = BUZZER_TIMER_MAX_COUNT - 1U;
+        counts = BUZZER_TIMER_MAX_COUNT;
+    }
+    else
+    {
+        counts = _TABLE_COUNTS(cycles_num, cycles_den, psc);
+        counts = (counts == 0) ? 1U : counts;
+    }
+    p_config->psc = (uint16_t)psc;
+    p_config->arr = (uint16_t)(counts - 1U);
+    p_config->ccr1 = (uint16_t)_TABLE_CCR1(counts - 1U);
+    return (psc + 1U) * counts;
+}
+
+uint32_t buzzer_timer_solve_frequency(uint32_t clock_hz, uint32_t frequency_mhz, buzzer_timer_config_t *p_config)
+{
+    uint64_t num = (uint64_t)clock_hz * MHZ_PER_HZ;
+    uint64_t cycles = buzzer_timer_solve(num, frequency_mhz, p_config);
+    return (uint32_t)((num + cycles / 2U) / cycles);
+}
+
+uint32_t buzzer_timer_solve_duration(uint32_t clock_hz, uint32_t duration_us, buzzer_timer_config_t *p_config)
+{
+    uint64_t cycles = buzzer_timer_solve((uint64_t)clock_hz * duration_us, US_PER_S, p_config);
+    p_config->ccr1 = 0;
+    return (uint32_t)((cycles * US_PER_S + clock_hz / 2U) / clock_hz);
+}
+
+void buzzer_timer_compute_duration(uint32_t clock_hz, uint32_t duration_ms, buzzer_timer_config_t *p_config)
+{
+    buzzer_timer_solve_duration(clock_hz, duration_ms * US_PER_MS, p_config);
+}
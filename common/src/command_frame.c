@@ -0,0 +1,193 @@
+/**
+ * @file command_frame.c
+ * @brief Binary frames of the control protocol: SLIP framing adapted to the line channel, opcode, fixed-width
+ * little-endian arguments and CRC-16.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "command_frame.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define CRC16_POLYNOMIAL 0x1021U /*!< Polynomial of the CRC-16/CCITT */
+#define CRC16_INITIAL 0xFFFFU    /*!< Initial value of the CRC-16/CCITT */
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Append a byte to an encoded frame, escaped if it is one of the reserved bytes.
+ *
+ * @param c Byte to append
+ * @param p_out Buffer of the encoded frame
+ * @param size Size of the buffer
+ * @param p_length Pointer to the number of bytes already stored. It is set to size + 1 if the byte does not fit
+ */
+static void _put_escaped(uint8_t c, char *p_out, uint32_t size, uint32_t *p_length)
+{
+    uint8_t escaped;
+    switch (c)
+    {
+    case COMMAND_FRAME_START:
+        escaped = COMMAND_FRAME_ESC_START;
+        break;
+    case COMMAND_FRAME_ESC:
+        escaped = COMMAND_FRAME_ESC_ESC;
+        break;
+    case COMMAND_FRAME_END:
+        escaped = COMMAND_FRAME_ESC_END;
+        break;
+    case '\0':
+        escaped = COMMAND_FRAME_ESC_NUL;
+        break;
+    default:
+        escaped = 0;
+        break;
+    }
+    if (*p_length + ((escaped != 0) ? 2U : 1U) > size)
+    {
+        *p_length = size + 1U;
+        return;
+    }
+    if (escaped != 0)
+    {
+        p_out[(*p_length)++] = (char)COMMAND_FRAME_ESC;
+        c = escaped;
+    }
+    p_out[(*p_length)++] = (char)c;
+}
+
+/* Public functions ----------------------------------------------------------*/
+bool command_frame_is_frame(const char *p_line)
+{
+    return (uint8_t)p_line[0] == COMMAND_FRAME_START;
+}
+
+uint32_t command_frame_get_le(const uint8_t *p_data, uint32_t width)
+{
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < width; i++)
+    {
+        value |= (uint32_t)p_data[i] << (8U * i);
+    }
+    return value;
+}
+
+uint16_t command_frame_crc16(const uint8_t *p_data, uint32_t length)
+{
+    uint16_t crc = CRC16_INITIAL;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)((uint16_t)p_data[i] << 8);
+        for (uint32_t bit = 0; bit < 8U; bit++)
+        {
+            crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ CRC16_POLYNOMIAL) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+uint32_t command_frame_encode(const command_frame_t *p_frame, char *p_out, uint32_t size)
+{
+    uint8_t raw[1U + COMMAND_FRAME_MAX_DATA + COMMAND_FRAME_CRC_LENGTH];
+    if ((p_frame->length > COMMAND_FRAME_MAX_DATA) || (size < 2U))
+    {
+        return 0;
+    }
+    raw[0] = p_frame->opcode;
+    memcpy(&raw[1], p_frame->data, p_frame->length);
+    uint32_t raw_length = 1U + p_frame->length;
+    uint16_t crc = command_frame_crc16(raw, raw_length);
+    raw[raw_length++] = (uint8_t)(crc & 0xFFU);
+    raw[raw_length++] = (uint8_t)(crc >> 8);
+
+    /* One byte is kept for the end of the frame */
+    uint32_t length = 0;
+    p_out[length++] = (char)COMMAND_FRAME_START;
+    for (uint32_t i = 0; (i < raw_length) && (length <= size - 1U); i++)
+    {
+        _put_escaped(raw[i], p_out, size - 1U, &length);
+    }
+    if (length > size - 1U)
+    {
+        return 0;
+    }
+    p_out[length++] = COMMAND_FRAME_END;
+    return length;
+}
+
+uint32_t command_frame_encode_request(uint8_t opcode, uint32_t arg, uint32_t width, char *p_out, uint32_t size)
+{
+    command_frame_t frame = {.opcode = opcode, .length = (width > 4U) ? 4U : width};
+    for (uint32_t i = 0; i < frame.length; i++)
+    {
+        frame.data[i] = (uint8_t)(arg >> (8U * i));
+    }
+    return command_frame_encode(&frame, p_out, size);
+}
+
+command_frame_status_t command_frame_decode(const char *p_line, uint32_t length, command_frame_t *p_frame)
+{
+    uint8_t raw[1U + COMMAND_FRAME_MAX_DATA + COMMAND_FRAME_CRC_LENGTH];
+    uint32_t raw_length = 0;
+    if ((length > 0) && (p_line[length - 1U] == COMMAND_FRAME_END))
+    {
+        length--;
+    }
+    if ((length == 0) || !command_frame_is_frame(p_line))
+    {
+        return COMMAND_FRAME_ERROR_FORMAT;
+    }
+
+    for (uint32_t i = 1; i < length; i++)
+    {
+        uint8_t c = (uint8_t)p_line[i];
+        if ((c == COMMAND_FRAME_START) || (c == (uint8_t)COMMAND_FRAME_END) || (raw_length >= sizeof(raw)))
+        {
+            return COMMAND_FRAME_ERROR_FORMAT;
+        }
+        if (c == COMMAND_FRAME_ESC)
+        {
+            if (++i >= length)
+            {
+                return COMMAND_FRAME_ERROR_FORMAT;
+            }
+            switch ((uint8_t)p_line[i])
+            {
+            case COMMAND_FRAME_ESC_START:
+                c = COMMAND_FRAME_START;
+                break;
+            case COMMAND_FRAME_ESC_ESC:
+                c = COMMAND_FRAME_ESC;
+                break;
+            case COMMAND_FRAME_ESC_END:
+                c = COMMAND_FRAME_END;
+                break;
+            case COMMAND_FRAME_ESC_NUL:
+                c = '\0';
+                break;
+            default:
+                return COMMAND_FRAME_ERROR_FORMAT;
+            }
+        }
+        raw[raw_length++] = c;
+    }
+    if (raw_length < 1U + COMMAND_FRAME_CRC_LENGTH)
+    {
+        return COMMAND_FRAME_ERROR_FORMAT;
+    }
+
+    raw_length -= COMMAND_FRAME_CRC_LENGTH;
+    if (command_frame_crc16(raw, raw_length) != (uint16_t)command_frame_get_le(&raw[raw_length], COMMAND_FRAME_CRC_LENGTH))
+    {
+        return COMMAND_FRAME_ERROR_CRC;
+    }
+    p_frame->opcode = raw[0];
+    p_frame->length = raw_length - 1U;
+    memcpy(p_frame->data, &raw[1], p_frame->length);
+    return COMMAND_FRAME_OK;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file commands.c
+ * @brief Table-driven registry of the commands received by the USART.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "commands.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define FNV_OFFSET_BASIS 2166136261U /*!< Initial value of the FNV-1a hash */
+#define FNV_PRIME 16777619U          /*!< Multiplier of the FNV-1a hash */
+
+/* Global variables */
+static command_t commands[COMMANDS_HASH_SIZE];   /*!< Hash table of commands. A slot is empty if its name is NULL */
+static uint8_t name_lengths[COMMANDS_HASH_SIZE]; /*!< Length of the name of each slot, to avoid calling strlen() */
+static uint32_t num_commands = 0;                /*!< Number of commands registered */
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Compute the FNV-1a hash of a name.
+ *
+ * @param p_name Name (it does not need to be null-terminated)
+ * @param length Length of the name
+ * @return uint32_t Hash of the name
+ */
+static uint32_t _hash(const char *p_name, uint32_t length)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        hash ^= (uint8_t)p_name[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Find the slot of a name: the slot where it is stored or the empty slot where it would be stored.
+ *
+ * @param p_name Name (it does not need to be null-terminated)
+ * @param length Length of the name
+ * @return uint32_t Index of the slot
+ */
+static uint32_t _find_slot(const char *p_name, uint32_t length)
+{
+    uint32_t slot = _hash(p_name, length) & (COMMANDS_HASH_SIZE - 1);
+    /* The table is never full (COMMANDS_MAX < COMMANDS_HASH_SIZE), so linear probing always ends */
+    while (commands[slot].p_name != NULL)
+    {
+        if ((name_lengths[slot] == length) && (memcmp(commands[slot].p_name, p_name, length) == 0))
+        {
+            break;
+        }
+        slot = (slot + 1) & (COMMANDS_HASH_SIZE - 1);
+    }
+    return slot;
+}
+
+/**
+ * @brief Convert a decimal number. The text must only contain digits, an optional sign and an optional decimal point.
+ *
+ * @param p_text Text (it does not need to be null-terminated)
+ * @param length Length of the text
+ * @param p_value Pointer to store the value
+ * @return true if the text is a valid number, false otherwise
+ */
+static bool _parse_float(const char *p_text, uint32_t length, double *p_value)
+{
+    uint32_t i = 0;
+    bool negative = false;
+    bool digits = false;
+    double value = 0.0;
+    double scale = 1.0;
+    bool decimals = false;
+
+    if ((length > 0) && ((p_text[0] == '-') || (p_text[0] == '+')))
+    {
+        negative = (p_text[0] == '-');
+        i++;
+    }
+    for (; i < length; i++)
+    {
+        char c = p_text[i];
+        if ((c >= '0') && (c <= '9'))
+        {
+            digits = true;
+            if (decimals)
+            {
+                scale /= 10.0;
+                value += (c - '0') * scale;
+            }
+            else
+            {
+                value = value * 10.0 + (c - '0');
+            }
+        }
+        else if ((c == '.') && !decimals)
+        {
+            decimals = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    *p_value = negative ? -value : value;
+    return digits;
+}
+
+/**
+ * @brief Convert a non-negative integer number.
+ *
+ * @param p_text Text (it does not need to be null-terminated)
+ * @param length Length of the text
+ * @param p_value Pointer to store the value
+ * @return true if the text is a valid number, false otherwise
+ */
+static bool _parse_int(const char *p_text, uint32_t length, uint32_t *p_value)
+{
+    uint32_t value = 0;
+    if ((length == 0) || (length > 9))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if ((p_text[i] < '0') || (p_text[i] > '9'))
+        {
+            return false;
+        }
+        value = value * 10U + (uint32_t)(p_text[i] - '0');
+    }
+    *p_value = value;
+    return true;
+}
+
+/**
+ * @brief Register a command entry. If a command with the same name is already registered, it is replaced.
+ *
+ * @param p_command Entry of the command. It is copied into the registry
+ * @return true if the command has been registered, false if the name is too long or the registry is full
+ */
+static bool _register(const command_t *p_command)
+{
+    uint32_t length = strlen(p_command->p_name);
+    if ((length == 0) || (length > COMMANDS_NAME_MAX_LENGTH))
+    {
+        return false;
+    }
+    uint32_t slot = _find_slot(p_command->p_name, length);
+    if (commands[slot].p_name == NULL)
+    {
+        if (num_commands >= COMMANDS_MAX)
+        {
+            return false;
+        }
+        num_commands++;
+    }
+    commands[slot] = *p_command;
+    name_lengths[slot] = (uint8_t)length;
+    return true;
+}
+
+/* Public functions ----------------------------------------------------------*/
+void commands_init(void)
+{
+    memset(commands, 0, sizeof(commands));
+    memset(name_lengths, 0, sizeof(name_lengths));
+    num_commands = 0;
+}
+
+bool commands_register(const char *p_name, command_handler_t handler, command_arg_spec_t arg_spec)
+{
+    command_t command = {.p_name = p_name, .handler = handler, .arg_spec = arg_spec, .validate = NULL};
+    return _register(&command);
+}
+
+bool commands_register_table(const command_t *p_commands, uint32_t count)
+{
+    bool ok = true;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ok &= _register(&p_commands[i]);
+    }
+    return ok;
+}
+
+const command_t *commands_find(const char *p_name, uint32_t length)
+{
+    if ((length == 0) || (length > COMMANDS_NAME_MAX_LENGTH))
+    {
+        return NULL;
+    }
+    uint32_t slot = _find_slot(p_name, length);
+    if (commands[slot].p_name == NULL)
+    {
+        return NULL;
+    }
+    return &commands[slot];
+}
+
+bool commands_parse_arg(const command_t *p_command, const token_t *p_args, uint32_t num_args, command_arg_t *p_arg)
+{
+    memset(p_arg, 0, sizeof(command_arg_t));
+    p_arg->p_args = p_args;
+    p_arg->num_args = num_args;
+    if (num_args > 0)
+    {
+        p_arg->p_text = p_args[0].p_start;
+        p_arg->length = p_args[0].length;
+    }
+    switch (p_command->arg_spec)
+    {
+    case COMMAND_ARG_INT:
+        return (num_args > 0) && _parse_int(p_arg->p_text, p_arg->length, &p_arg->int_value);
+    case COMMAND_ARG_FLOAT:
+        return (num_args > 0) && _parse_float(p_arg->p_text, p_arg->length, &p_arg->float_value);
+    case COMMAND_ARG_STRING:
+        return (num_args > 0) && (p_arg->length > 0);
+    case COMMAND_ARG_NONE:
+    default:
+        return true;
+    }
+}
+
+bool commands_validate(const command_t *p_command, fsm_t *p_this, const command_arg_t *p_arg)
+{
+    return (p_command->validate == NULL) || p_command->validate(p_this, p_arg);
+}
+
+uint32_t commands_get_count(void)
+{
+    return num_commands;
+}
@@ -9,6 +9,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "fsm_button.h"
 #include "port_button.h"
+#include "time_base.h"
 
 
 /* State machine input or transition functions */
@@ -49,12 +50,7 @@ static bool check_button_released (fsm_t *p_this){
  */
 static bool check_timeout (fsm_t *p_this){
     fsm_button_t *p_fsm = (fsm_button_t *)(p_this);
-    uint32_t tick = port_button_get_tick();
-    if(tick > p_fsm -> next_timeout){
-        return true;
-    } else {
-        return false;
-    }
+    return time_base_reached(port_button_get_tick(), p_fsm -> next_timeout);
 }
 
 /**
@@ -64,10 +60,11 @@ static bool check_timeout (fsm_t *p_this){
  */
 static void do_set_duration (fsm_t *p_this){
     fsm_button_t *p_fsm = (fsm_button_t *)(p_this);
-    uint32_t tick = port_button_get_tick();
+    uint64_t tick = port_button_get_tick();
     //p_fsm->duration = p_fsm -> duration + p_fsm -> tick_pressed;
-    p_fsm->duration = tick - p_fsm -> tick_pressed;
-    p_fsm -> next_timeout = tick + port_button_get_debouncetime(p_fsm -> button_id);
+    p_fsm->duration = (uint32_t)(tick - p_fsm -> tick_pressed);
+    /* The timeout expires once the debounce time has fully elapsed */
+    p_fsm -> next_timeout = tick + port_button_get_debouncetime(p_fsm -> button_id) + 1;
 }
 /**
  * @brief Almacena el tiempo del sistema cuando se presionó el botón.
@@ -76,10 +73,10 @@ static void do_set_duration (fsm_t *p_this){
  */
 static void do_store_tick_pressed (fsm_t *p_this){
      fsm_button_t *p_fsm = (fsm_button_t *)(p_this);
-     uint32_t tick = port_button_get_tick();
+     uint64_t tick = port_button_get_tick();
 
      p_fsm -> tick_pressed = tick;
-     p_fsm -> next_timeout = tick + port_button_get_debouncetime(p_fsm -> button_id);
+     p_fsm -> next_timeout = tick + port_button_get_debouncetime(p_fsm -> button_id) + 1;
 
 }
 /**
@@ -157,3 +154,14 @@ bool fsm_button_check_activity(fsm_t *p_this)
      return true;
 }
 
+bool fsm_button_get_next_timeout(fsm_t *p_this, uint64_t *p_deadline_ms)
+{
+    fsm_button_t *p_fsm = (fsm_button_t *)(p_this);
+    if ((p_fsm->f.current_state != BUTTON_PRESSED_WAIT) && (p_fsm->f.current_state != BUTTON_RELEASED_WAIT))
+    {
+        return false;
+    }
+    *p_deadline_ms = p_fsm->next_timeout;
+    return true;
+}
+
@@ -23,19 +23,98 @@
 
 /* Public functions */
 /**
- * @brief  Inicia la reproducción de una nota en el buzzer
+ * @brief  Escala una duración con la velocidad de reproducción.
+ *
+ * La duración se escala con la velocidad en coma fija Q16.16 y se pasa a microsegundos, sin operaciones en coma
+ * flotante. El resto de la división se suma a la nota siguiente en lugar de descartarse: la posición en la melodía
+ * nunca se separa más de 1 µs de la ideal a la velocidad Q16.16, por larga que sea. Esa velocidad es la pedida
+ * redondeada a 2^-16, así que respecto de la pedida el tiempo reproducido tiene además un error relativo de hasta
+ * 2^-17 / velocidad (con 1.7 se guarda 1.6999969: unos 108 µs de más en 60 s).
+ *
+ * @param p_fsm
+ * @param duration_ms Duración en la melodía en milisegundos
+ * @return uint32_t Duración a la velocidad de reproducción en microsegundos
+ */
+static uint32_t _scale_duration(fsm_buzzer_t *p_fsm, uint32_t duration_ms)
+{
+    uint64_t scaled = (((uint64_t)duration_ms * FSM_BUZZER_US_PER_MS) << FSM_BUZZER_SPEED_SHIFT) + p_fsm->duration_remainder;
+    p_fsm->duration_remainder = (uint32_t)(scaled % p_fsm->player_speed);
+    return (uint32_t)(scaled / p_fsm->player_speed);
+}
+/**
+ * @brief  Añade una nota a la cola del buzzer.
+ *
+ * Si el buzzer está parado la nota empieza a sonar ya; si no, sonará justo al terminar la anterior.
  *
  * @param p_this
- * @param freq
- * @param duration
+ * @param p_event Evento de la melodía: nota MIDI y duración
  */
-static void _start_note(fsm_t *p_this, double freq, uint32_t duration)
+static void _start_note(fsm_t *p_this, const melody_event_t *p_event)
 {
     fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
-    double duration_double=(double)duration;
-    duration_double /= p_fsm->player_speed;
-    port_buzzer_set_note_frequency(p_fsm->buzzer_id,freq);
-    port_buzzer_set_note_duration(p_fsm->buzzer_id,duration_double);
+    port_buzzer_queue_note(p_fsm->buzzer_id, p_event->note, _scale_duration(p_fsm, MELODY_EVENT_DURATION_MS(p_event)));
+}
+/**
+ * @brief  Añade un acorde de una melodía de varias voces a la cola del buzzer.
+ *
+ * @param p_this
+ * @param p_frame Acorde: nota de cada voz y duración
+ */
+static void _start_frame(fsm_t *p_this, const melody_frame_t *p_frame)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    port_buzzer_queue_chord(p_fsm->buzzer_id, p_frame->notes, p_frame->num_voices, _scale_duration(p_fsm, p_frame->duration_ms));
+}
+/**
+ * @brief  Encola la siguiente nota de la melodía o del flujo.
+ *
+ * Con un flujo, el siguiente bloque se precarga después de encolar la nota, mientras suena la actual.
+ *
+ * @param p_this
+ */
+static void _start_next_note(fsm_t *p_this)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    if (p_fsm->p_poly != NULL)
+    {
+        melody_frame_t frame;
+        if (melody_poly_next(&p_fsm->poly_cursor, &frame))
+        {
+            _start_frame(p_this, &frame);
+        }
+    }
+    else if (p_fsm->p_stream != NULL)
+    {
+        melody_event_t event;
+        if (melody_stream_next(p_fsm->p_stream, &event))
+        {
+            _start_note(p_this, &event);
+            melody_stream_prefetch(p_fsm->p_stream);
+        }
+    }
+    else
+    {
+        _start_note(p_this, &p_fsm->p_melody->p_events[p_fsm->note_index]);
+    }
+    p_fsm->note_index++;
+}
+/**
+ * @brief  Vuelve al principio de la melodía o del flujo.
+ *
+ * @param p_fsm
+ */
+static void _rewind(fsm_buzzer_t *p_fsm)
+{
+    p_fsm->note_index = 0;
+    p_fsm->duration_remainder = 0;
+    if (p_fsm->p_poly != NULL)
+    {
+        melody_poly_rewind(&p_fsm->poly_cursor, p_fsm->p_poly);
+    }
+    if (p_fsm->p_stream != NULL)
+    {
+        melody_stream_rewind(p_fsm->p_stream);
+    }
 }
 /**
  * @brief  Comprueba si la melodía debe comenzar.
@@ -47,6 +126,14 @@ static void _start_note(fsm_t *p_this, double freq, uint32_t duration)
 static bool check_melody_start(fsm_t *p_this)
 {
     fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    if (p_fsm->p_poly != NULL)
+    {
+        return (p_fsm->user_action == PLAY) && melody_poly_has_next(&p_fsm->poly_cursor);
+    }
+    if (p_fsm->p_stream != NULL)
+    {
+        return (p_fsm->user_action == PLAY) && melody_stream_has_next(p_fsm->p_stream);
+    }
     if (p_fsm->p_melody != NULL && p_fsm->user_action == PLAY)
     {
         return true;
@@ -74,6 +161,14 @@ static bool check_player_start(fsm_t *p_this)
 static bool check_end_melody(fsm_t *p_this)
 {
     fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    if (p_fsm->p_poly != NULL)
+    {
+        return !melody_poly_has_next(&p_fsm->poly_cursor);
+    }
+    if (p_fsm->p_stream != NULL)
+    {
+        return !melody_stream_has_next(p_fsm->p_stream);
+    }
     if (p_fsm->note_index >= p_fsm->p_melody->melody_length)
     {
         return true;
@@ -144,7 +239,25 @@ static bool check_play_note(fsm_t *p_this)
     return false;
 }
 /**
- * @brief Comprueba si la nota actual ha terminado.
+ * @brief Comprueba si hay que encolar la siguiente nota mientras suena la actual.
+ *
+ * Se mantiene la cola del buzzer llena para que la ISR del temporizador de duración encadene las notas sin hueco.
+ *
+ * @param p_this
+ * @return true
+ * @return false
+ */
+static bool check_queue_note(fsm_t *p_this)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    if ((p_fsm->p_melody == NULL) && (p_fsm->p_stream == NULL) && (p_fsm->p_poly == NULL))
+    {
+        return false;
+    }
+    return check_play_note(p_this) && (port_buzzer_get_queue_free(p_fsm->buzzer_id) > 0);
+}
+/**
+ * @brief Comprueba si la última nota de la cola ha terminado.
  *
  * @param p_this
  * @return true
@@ -163,9 +276,7 @@ static bool check_note_end(fsm_t *p_this)
  */
 static void do_melody_start(fsm_t *p_this)
 {
-    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
-    _start_note(p_this, p_fsm->p_melody->p_notes[p_fsm->note_index], p_fsm->p_melody->p_durations[p_fsm->note_index]);
-    p_fsm->note_index++;
+    _start_next_note(p_this);
 }
 /**
  * @brief Inicia el reproductor.
@@ -185,7 +296,7 @@ static void do_end_melody(fsm_t *p_this)
 {
     fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
     port_buzzer_stop(p_fsm->buzzer_id);
-    p_fsm->note_index=0;
+    _rewind(p_fsm);
     p_fsm->user_action=STOP;
     
 }
@@ -208,8 +319,8 @@ static void do_player_stop(fsm_t *p_this)
 {
     fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
     port_buzzer_stop(p_fsm->buzzer_id);
-    p_fsm->note_index=0;
-    
+    _rewind(p_fsm);
+
 }
 /**
  * @brief Termina la reproducción de la nota actual.
@@ -218,9 +329,16 @@ static void do_player_stop(fsm_t *p_this)
  */
 static void do_play_note(fsm_t *p_this)
 {
-    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
-    _start_note(p_this,p_fsm->p_melody->p_notes[p_fsm->note_index],p_fsm->p_melody->p_durations[p_fsm->note_index]);
-    p_fsm->note_index++;
+    _start_next_note(p_this);
+}
+/**
+ * @brief Encola la siguiente nota sin esperar a que termine la actual.
+ *
+ * @param p_this
+ */
+static void do_queue_note(fsm_t *p_this)
+{
+    _start_next_note(p_this);
 }
 /**
  * @brief
@@ -233,9 +351,29 @@ static void do_note_end(fsm_t *p_this)
     port_buzzer_stop(p_fsm->buzzer_id);
 }
 
+/**
+ * @brief  Vacía la cola del buzzer al cambiar de melodía.
+ *
+ * Si la máquina esperaba el fin de la última nota encolada, ese fin ya no llegará: pasa a PLAY_NOTE como si la nota
+ * hubiera terminado, y desde ahí sigue con la melodía nueva, se pausa o se detiene según la acción del usuario.
+ *
+ * @param p_this
+ */
+static void _drop_queue(fsm_t *p_this)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    port_buzzer_stop(p_fsm->buzzer_id);
+    if (fsm_get_state(p_this) == WAIT_NOTE)
+    {
+        fsm_set_state(p_this, PLAY_NOTE);
+    }
+}
+
 static fsm_trans_t fsm_trans_buzzer[] = {
     {WAIT_START, check_player_start, WAIT_NOTE, do_player_start},
     {WAIT_NOTE, check_note_end, PLAY_NOTE, do_note_end},
+    {WAIT_NOTE, check_player_stop, WAIT_START, do_player_stop},
+    {WAIT_NOTE, check_queue_note, WAIT_NOTE, do_queue_note},
     {PLAY_NOTE, check_play_note, WAIT_NOTE, do_play_note},
     {PLAY_NOTE, check_player_stop, WAIT_START, do_player_stop},
     {PLAY_NOTE, check_pause, PAUSE_NOTE, do_pause},
@@ -260,12 +398,38 @@ void fsm_buzzer_set_melody(fsm_t *p_this, const melody_t *p_melody)
      fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
      melody_t *p= (melody_t *)p_melody;
      p_fsm->p_melody=p;
+     p_fsm->p_stream=NULL;
+     p_fsm->p_poly=NULL;
+     //Las notas de la melodia anterior que quedaban en la cola ya no deben sonar
+     _drop_queue(p_this);
+}
+
+void fsm_buzzer_set_stream(fsm_t *p_this, melody_stream_t *p_stream)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    p_fsm->p_stream = p_stream;
+    p_fsm->p_poly = NULL;
+    p_fsm->note_index = 0;
+    p_fsm->duration_remainder = 0;
+    _drop_queue(p_this);
+}
+
+void fsm_buzzer_set_poly(fsm_t *p_this, const melody_poly_t *p_poly)
+{
+    fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
+    p_fsm->p_poly = p_poly;
+    p_fsm->p_stream = NULL;
+    _rewind(p_fsm);
+    _drop_queue(p_this);
 }
 
 void fsm_buzzer_set_speed(fsm_t *p_this, double speed)
 {
     fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
-    p_fsm->player_speed=speed;
+    uint32_t speed_q16 = (uint32_t)(speed * FSM_BUZZER_SPEED_ONE + 0.5);
+    p_fsm->player_speed = (speed_q16 > 0) ? speed_q16 : 1U;
+    /* El resto está en unidades de la velocidad anterior */
+    p_fsm->duration_remainder = 0;
 }
 
 void fsm_buzzer_set_action(fsm_t *p_this, uint8_t action)
@@ -273,7 +437,7 @@ void fsm_buzzer_set_action(fsm_t *p_this, uint8_t action)
     fsm_buzzer_t *p_fsm = (fsm_buzzer_t *)(p_this);
     p_fsm->user_action=action;
     if(action==STOP){
-        p_fsm->note_index=0;
+        _rewind(p_fsm);
     }
 }
 uint8_t fsm_buzzer_get_action(fsm_t *p_this)
@@ -296,8 +460,11 @@ void fsm_buzzer_init(fsm_t *p_this, uint32_t buzzer_id)
     /* TO-DO alumnos */
     p_fsm->buzzer_id=buzzer_id;
     p_fsm->p_melody=NULL;
+    p_fsm->p_stream=NULL;
+    p_fsm->p_poly=NULL;
     p_fsm->note_index=0;
     p_fsm->user_action=STOP;
-    p_fsm->player_speed=1.0;
+    p_fsm->player_speed=FSM_BUZZER_SPEED_ONE;
+    p_fsm->duration_remainder=0;
     port_buzzer_init(p_fsm->buzzer_id);
 }
\ No newline at end of file
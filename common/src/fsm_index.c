@@ -0,0 +1,169 @@
+/**
+ * @file fsm_index.c
+ * @brief Compiled index of the transition tables of the FSMs.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "fsm_index.h"
+
+/* Global variables */
+static fsm_index_t indexes[FSM_INDEX_MAX_TABLES]; /*!< Indexes of the transition tables */
+static uint32_t num_indexes = 0;                  /*!< Number of indexed tables */
+
+/* Public functions ----------------------------------------------------------*/
+void fsm_index_init(void)
+{
+    memset(indexes, 0, sizeof(indexes));
+    num_indexes = 0;
+}
+
+const fsm_index_t *fsm_index_find(const fsm_trans_t *p_tt)
+{
+    for (uint32_t i = 0; i < num_indexes; i++)
+    {
+        if (indexes[i].p_tt == p_tt)
+        {
+            return &indexes[i];
+        }
+    }
+    return NULL;
+}
+
+const fsm_index_t *fsm_index_build(const fsm_trans_t *p_tt)
+{
+    const fsm_index_t *p_found = fsm_index_find(p_tt);
+    if (p_found != NULL)
+    {
+        return p_found;
+    }
+    if (num_indexes >= FSM_INDEX_MAX_TABLES)
+    {
+        return NULL;
+    }
+
+    /* Count the rows of each state */
+    fsm_index_t *p_index = &indexes[num_indexes];
+    memset(p_index, 0, sizeof(*p_index));
+    uint32_t num_trans = 0;
+    for (; p_tt[num_trans].orig_state >= 0; num_trans++)
+    {
+        if ((num_trans >= FSM_INDEX_MAX_TRANSITIONS) || (p_tt[num_trans].orig_state >= FSM_INDEX_MAX_STATES))
+        {
+            return NULL;
+        }
+        p_index->count[p_tt[num_trans].orig_state]++;
+    }
+
+    /* Place the rows of each state after those of the previous states, in table order */
+    uint8_t next[FSM_INDEX_MAX_STATES];
+    uint32_t position = 0;
+    for (uint32_t s = 0; s < FSM_INDEX_MAX_STATES; s++)
+    {
+        p_index->first[s] = (uint8_t)position;
+        next[s] = (uint8_t)position;
+        position += p_index->count[s];
+    }
+    for (uint32_t i = 0; i < num_trans; i++)
+    {
+        p_index->rows[next[p_tt[i].orig_state]++] = (uint8_t)i;
+    }
+    p_index->p_tt = p_tt;
+    p_index->num_trans = num_trans;
+    num_indexes++;
+    return p_index;
+}
+
+uint32_t fsm_index_get_rows(const fsm_index_t *p_index, int state, const uint8_t **pp_rows)
+{
+    if ((state < 0) || (state >= FSM_INDEX_MAX_STATES))
+    {
+        *pp_rows = NULL;
+        return 0;
+    }
+    *pp_rows = &p_index->rows[p_index->first[state]];
+    return p_index->count[state];
+}
+
+const fsm_trans_t *fsm_index_fire(fsm_t *p_fsm)
+{
+    int state = fsm_get_state(p_fsm);
+    const fsm_index_t *p_index = fsm_index_find(p_fsm->p_tt);
+    const uint8_t *p_rows = NULL;
+    uint32_t num_rows = 0;
+    if (p_index != NULL)
+    {
+        num_rows = fsm_index_get_rows(p_index, state, &p_rows);
+    }
+    else
+    {
+        /* Not indexed: scan the whole table as fsm_fire() does */
+        while (p_fsm->p_tt[num_rows].orig_state >= 0)
+        {
+            num_rows++;
+        }
+    }
+
+    for (uint32_t k = 0; k < num_rows; k++)
+    {
+        const fsm_trans_t *p_t = &p_fsm->p_tt[(p_rows != NULL) ? p_rows[k] : k];
+        if ((p_t->orig_state == state) && ((p_t->in == NULL) || p_t->in(p_fsm)))
+        {
+            fsm_set_state(p_fsm, p_t->dest_state);
+            if (p_t->out != NULL)
+            {
+                p_t->out(p_fsm);
+            }
+            return p_t;
+        }
+    }
+    return NULL;
+}
+
+uint32_t fsm_index_reorder(const fsm_profile_t *p_profile, uint32_t exclusive_states)
+{
+    fsm_index_t *p_index = (fsm_index_t *)fsm_index_find(p_profile->p_tt);
+    if (p_index == NULL)
+    {
+        return 0;
+    }
+
+    uint32_t reordered = 0;
+    for (uint32_t s = 0; s < FSM_INDEX_MAX_STATES; s++)
+    {
+        if (!(exclusive_states & (1UL << s)) || (p_index->count[s] < 2))
+        {
+            continue;
+        }
+
+        /* Stable insertion sort by fires, most frequent first */
+        uint8_t *p_rows = &p_index->rows[p_index->first[s]];
+        bool changed = false;
+        for (uint32_t k = 1; k < p_index->count[s]; k++)
+        {
+            uint8_t row = p_rows[k];
+            uint32_t j = k;
+            while ((j > 0) && (p_profile->trans[p_rows[j - 1]].fires < p_profile->trans[row].fires))
+            {
+                p_rows[j] = p_rows[j - 1];
+                j--;
+            }
+            if (j != k)
+            {
+                p_rows[j] = row;
+                changed = true;
+            }
+        }
+        if (changed)
+        {
+            reordered++;
+        }
+    }
+    return reordered;
+}
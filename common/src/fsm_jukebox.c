@@ -8,7 +8,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 // Standard C includes
-#include <string.h> // strcmp
+#include <string.h>
 #include <stdio.h>  // sprintf
 
 // Other includes
@@ -24,6 +24,14 @@
 #include "port_system.h"
 #include "port_usart.h"
 #include "melodies.h"
+#include "commands.h"
+#include "tokenizer.h"
+#include "fsm_profile.h"
+#include "power_policy.h"
+#include "synth.h"
+#include "port_audio.h"
+#include "log_ring.h"
+#include "command_frame.h"
 
 /* Defines ------------------------------------------------------------------*/
 #define MAX(a, b) ((a) > (b) ? (a) : (b)) /*!< Macro to get the maximum of two values. */
@@ -32,53 +40,36 @@
 /**
  * @brief Parse the message received by the USART.
  *
- * Given data received by the USART, this function parses the message and extracts the command and the parameter (if available).
+ * Given data received by the USART, this function splits the message into the command and its arguments. The tokens
+ * are views {pointer, length} into the message, which is not modified nor copied.
  *
- * > 1. Split the message by space using function strtok() \n
- * > 2. If there's a token (command), copy it to the p_command variable. Otherwise, return false \n
- * > 3. Extract the parameter (if available). To do so, get the next token using function strtok(). If there's a token, copy it to the p_param variable. Otherwise, copy an empty string to the p_param variable \n
+ * > 1. Split the message into tokens using function tokenizer_split() \n
+ * > 2. If there's no token (command), return false \n
+ * > 3. The first token is the command and the rest (if available) are the arguments \n
  * > 4. Return true indicating that the message has been parsed correctly \n
  *
  * @param p_message Pointer to the message received by the USART.
- * @param p_command Pointer to store the command extracted from the message.
- * @param p_param Pointer to store the parameter extracted from the message.
+ * @param length Size of the buffer of the message.
+ * @param p_command Pointer to store the view of the command.
+ * @param p_args Array to store the views of the arguments (JUKEBOX_MAX_ARGS elements).
+ * @param p_num_args Pointer to store the number of arguments.
  * @return true if the message has been parsed correctly
  * @return false if the message has not been parsed correctly
  */
-
-/**
- * @brief Parsea un mensaje para extraer el comando y el parámetro asociado.
- * 
- * @param p_message Mensaje a parsear.
- * @param p_command Puntero al buffer donde se almacenará el comando extraído.
- * @param p_param Puntero al buffer donde se almacenará el parámetro extraído.
- * @return true Si se pudo parsear el mensaje correctamente.
- * @return false Si no se encontró un comando válido en el mensaje.
- */
-bool _parse_message(char *p_message, char *p_command, char *p_param)
+bool _parse_message(const char *p_message, uint32_t length, token_t *p_command, token_t *p_args, uint32_t *p_num_args)
 {
-    char *p_token = strtok(p_message, " "); // Divide el mensaje por espacios
+    token_t tokens[JUKEBOX_MAX_ARGS + 1];
+    uint32_t num_tokens = tokenizer_split(p_message, length, tokens, JUKEBOX_MAX_ARGS + 1);
 
-    if (p_token != NULL)
+    if (num_tokens == 0)
     {
-        strcpy(p_command, p_token);
-    }
-    else
-    {
-
         return false;
     }
-
-    // Extraer el parámetro (si está disponible)
-    p_token = strtok(NULL, " "); // Obtener el siguiente token
-
-    if (p_token != NULL)
-    {
-        strcpy(p_param, p_token);
-    }
-    else
+    *p_command = tokens[0];
+    *p_num_args = num_tokens - 1;
+    for (uint32_t i = 1; i < num_tokens; i++)
     {
-        strcpy(p_param, " "); // NO se encontró ningún parámetro
+        p_args[i - 1] = tokens[i];
     }
     return true;
 }
@@ -112,88 +103,548 @@ void _set_next_song(fsm_jukebox_t *p_fsm_jukebox)
     // Actualiza la melodía actual
     p_fsm_jukebox->p_melody = p_fsm_jukebox->melodies[p_fsm_jukebox->melody_idx].p_name;
 
-    // Imprime el nombre de la melodía que se está reproduciendo
-    printf("Reproduciendo: %s\n", p_fsm_jukebox->p_melody);
+    // Registra el nombre de la melodía que se está reproduciendo; el texto se envía cuando el bucle principal esté ocioso
+    log_ring_write(LOG_PLAYING, p_fsm_jukebox->p_melody, 0);
 
     // Establece la melodía y comienza la reproducción
     fsm_buzzer_set_melody(p_fsm_jukebox->p_fsm_buzzer, &p_fsm_jukebox->melodies[p_fsm_jukebox->melody_idx]);
     fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PLAY);
 }
 /**
- * @brief Ejecuta un comando recibido por el jukebox.
- * 
- * @param p_fsm_jukebox Puntero a la estructura de la máquina de estados del jukebox.
- * @param p_command Comando recibido.
- * @param p_param Parámetro del comando (si lo hay).
+ * @brief Comando "play": reanuda o inicia la reproducción de la melodía actual.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando (no se usa).
  */
-void _execute_command(fsm_jukebox_t *p_fsm_jukebox, char *p_command, char *p_param)
+static void _command_play(fsm_t *p_this, const command_arg_t *p_arg)
 {
-    // Comprueba el comando recibido y realiza la acción correspondiente
-    if (strcmp(p_command, "play") == 0)
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PLAY);
+}
+
+/**
+ * @brief Comando "stop": detiene la reproducción.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando (no se usa).
+ */
+static void _command_stop(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, STOP);
+    synth_stop();
+}
+
+/**
+ * @brief Comando "pause": pausa la reproducción.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando (no se usa).
+ */
+static void _command_pause(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PAUSE);
+}
+
+/**
+ * @brief Comando "speed": cambia la velocidad de reproducción (mínimo 0.1).
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Velocidad de reproducción.
+ */
+static void _command_speed(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    fsm_buzzer_set_speed(p_fsm_jukebox->p_fsm_buzzer, MAX(p_arg->float_value, 0.1));
+}
+
+/**
+ * @brief Validador del comando "speed": la velocidad debe ser mayor que 0.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Velocidad de reproducción.
+ * @return true si la velocidad es válida, false si no.
+ */
+static bool _validate_speed(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    return p_arg->float_value > 0;
+}
+
+/**
+ * @brief Comando "next": pasa a la siguiente canción de la lista de reproducción.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando (no se usa).
+ */
+static void _command_next(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    _set_next_song((fsm_jukebox_t *)(p_this));
+}
+
+/**
+ * @brief Validador del comando "select": el índice debe ser el de una melodía cargada.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Índice de la melodía.
+ * @return true si la melodía existe, false si no.
+ */
+static bool _validate_select(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    return (p_arg->int_value < MELODIES_MEMORY_SIZE) && (p_fsm_jukebox->melodies[p_arg->int_value].melody_length != 0);
+}
+
+/**
+ * @brief Comando "select": selecciona una melodía específica de la lista de reproducción.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Índice de la melodía.
+ */
+static void _command_select(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    uint32_t melody_selected = p_arg->int_value;
+    if (_validate_select(p_this, p_arg))
     {
+        fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, STOP);
+        p_fsm_jukebox->melody_idx = melody_selected;
+        fsm_buzzer_set_melody(p_fsm_jukebox->p_fsm_buzzer, &p_fsm_jukebox->melodies[melody_selected]);
+        p_fsm_jukebox->p_melody = p_fsm_jukebox->melodies[melody_selected].p_name;
+        log_ring_write(LOG_PLAYING, p_fsm_jukebox->melodies[melody_selected].p_name, 0);
         fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PLAY);
     }
-    else if (strcmp(p_command, "stop") == 0)
+    else
     {
-        fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, STOP);
+        // Si no se encuentra la melodía especificada, envía un mensaje de error
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Error:Melody not found\n");
     }
-    else if (strcmp(p_command, "pause") == 0)
+}
+
+/**
+ * @brief Comando "lista": imprime la lista de melodías disponibles.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando (no se usa).
+ */
+static void _command_list(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    log_ring_write(LOG_LIST_HEADER, NULL, 0);
+    for (int i = 0; i < MELODIES_MEMORY_SIZE; i++)
     {
-        fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PAUSE);
+        if (p_fsm_jukebox->melodies[i].melody_length != 0)
+        {
+            log_ring_write(LOG_LIST_ITEM, p_fsm_jukebox->melodies[i].p_name, 1, (uint32_t)i);
+        }
     }
-    else if (strcmp(p_command, "speed") == 0)
+}
+
+/**
+ * @brief Comando "info": envía el nombre de la melodía actualmente en reproducción.
+ *
+ * Con "info profile" imprime por printf los contadores de las tablas de transiciones perfiladas y envía por la USART
+ * la transición cuya guarda ha consumido más ciclos.
+ *
+ * Con "info power" envía por la USART el tiempo que el sistema ha pasado en cada estado de consumo (power_policy.h).
+ *
+ * Con "info log" envía por la USART los registros del log diferido, los descartados y el coste de cada llamada.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando: ninguno, "profile", "power", "audio" o "log".
+ */
+static void _command_info(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    char msg[USART_OUTPUT_BUFFER_LENGTH];
+    if ((p_arg->length == 7) && (strncmp(p_arg->p_text, "profile", 7) == 0))
     {
-        double param = atof(p_param);
-        fsm_buzzer_set_speed(p_fsm_jukebox->p_fsm_buzzer, MAX(param, 0.1));
+        fsm_profile_print();
+        if (fsm_profile_format_hottest(msg, sizeof(msg)) == 0)
+        {
+            fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Error:Profiler off\n");
+            return;
+        }
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
+        return;
+    }
+    if ((p_arg->length == 5) && (strncmp(p_arg->p_text, "power", 5) == 0))
+    {
+        power_policy_format(msg, sizeof(msg));
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
+        return;
     }
-    else if (strcmp(p_command, "next") == 0)
+    if ((p_arg->length == 5) && (strncmp(p_arg->p_text, "audio", 5) == 0))
+    {
+        port_audio_stats_t stats;
+        port_audio_get_stats(&stats);
+        uint32_t samples = stats.halves * PORT_AUDIO_HALF_SAMPLES;
+        sprintf(msg, "Audio: %lu cycles/sample, max %lu of %lu per half, %lu overruns\n",
+                (unsigned long)((samples > 0) ? stats.total_cycles / samples : 0), (unsigned long)stats.max_cycles,
+                (unsigned long)stats.budget_cycles, (unsigned long)stats.overruns);
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
+        return;
+    }
+    if ((p_arg->length == 3) && (strncmp(p_arg->p_text, "log", 3) == 0))
+    {
+        log_ring_stats_t stats;
+        log_ring_get_stats(&stats);
+        sprintf(msg, "Log: %lu records, %lu dropped, %lu cycles/call, max %lu\n", (unsigned long)stats.records,
+                (unsigned long)stats.dropped,
+                (unsigned long)((stats.records + stats.dropped > 0) ? stats.total_cycles / (stats.records + stats.dropped) : 0),
+                (unsigned long)stats.max_cycles);
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
+        return;
+    }
+    sprintf(msg, "Reproduciendo: %s\n", p_fsm_jukebox->p_melody);
+    fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
+}
+
+/**
+ * @brief Comando "upload": añade eventos a la melodía recibida por la USART, o la termina con "upload end".
+ *
+ * Cada evento son 4 dígitos hexadecimales: la nota MIDI y la duración en unidades de MELODY_DURATION_UNIT_MS. Una
+ * subida que empieza después de "upload end" empieza una melodía nueva. Si los eventos no caben en el buffer de
+ * subida se responde con un error y hay que reenviarlos cuando avance la reproducción.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Eventos en hexadecimal, o "end".
+ */
+static void _command_upload(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    melody_stream_upload_t *p_upload = &p_fsm_jukebox->upload;
+    if ((p_arg->length == 3) && (strncmp(p_arg->p_text, "end", 3) == 0))
+    {
+        melody_stream_upload_close(p_upload);
+        return;
+    }
+    if (p_upload->closed)
+    {
+        melody_stream_upload_init(p_upload);
+    }
+    if (!melody_stream_upload_put_hex(p_upload, p_arg->p_text, p_arg->length))
+    {
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Error:Upload rejected\n");
+    }
+}
+
+/**
+ * @brief Comando "stream": reproduce la melodía recibida con "upload" mientras se sigue recibiendo.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando (no se usa).
+ */
+static void _command_stream(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, STOP);
+    melody_stream_open(&p_fsm_jukebox->stream, melody_stream_read_upload, &p_fsm_jukebox->upload);
+    fsm_buzzer_set_stream(p_fsm_jukebox->p_fsm_buzzer, &p_fsm_jukebox->stream);
+    p_fsm_jukebox->p_melody = "upload";
+    fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PLAY);
+}
+
+/**
+ * @brief Comando "poly": reproduce la melodía de varias voces (tetris con bajo), una voz por salida del buzzer.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando (no se usa).
+ */
+static void _command_poly(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, STOP);
+    fsm_buzzer_set_poly(p_fsm_jukebox->p_fsm_buzzer, &tetris_poly_melody);
+    p_fsm_jukebox->p_melody = tetris_poly_melody.p_name;
+    log_ring_write(LOG_PLAYING, p_fsm_jukebox->p_melody, 0);
+    fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PLAY);
+}
+
+/**
+ * @brief Comando "synth": reproduce la melodía de varias voces (tetris con bajo) con el sintetizador por el DAC, a la
+ * velocidad del reproductor.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando (no se usa).
+ */
+static void _command_synth(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, STOP);
+    /* El secuenciador no se puede cambiar mientras la ISR del DMA calcula muestras */
+    port_audio_stop();
+    synth_play(&tetris_poly_melody, ((fsm_buzzer_t *)p_fsm_jukebox->p_fsm_buzzer)->player_speed);
+    p_fsm_jukebox->p_melody = tetris_poly_melody.p_name;
+    log_ring_write(LOG_SYNTH, p_fsm_jukebox->p_melody, 0);
+    port_audio_start();
+}
+
+/**
+ * @brief Comando "baud": consulta o cambia la velocidad de la USART por la que llegan los comandos.
+ *
+ * Sin argumento envía la velocidad actual. Con un número cambia a esa velocidad al terminar de enviar la respuesta,
+ * que todavía sale a la velocidad antigua. Con "auto" arranca la detección automática: el siguiente carácter recibido
+ * (por ejemplo una línea "U") fija la velocidad estándar más cercana.
+ *
+ * @param p_this Puntero a la máquina de estados del jukebox.
+ * @param p_arg Argumento del comando: ninguno, "auto" o la velocidad en baudios.
+ */
+static void _command_baud(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
+    uint32_t usart_id = ((fsm_usart_t *)p_fsm_jukebox->p_fsm_usart)->usart_id;
+    char msg[USART_OUTPUT_BUFFER_LENGTH];
+    if ((p_arg->length == 4) && (strncmp(p_arg->p_text, "auto", 4) == 0))
     {
-        // Establece la siguiente canción en la lista de reproducción
-        _set_next_song(p_fsm_jukebox);
+        port_usart_start_autobaud(usart_id);
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Baud: auto\n");
+        return;
     }
-    else if (strcmp(p_command, "select") == 0)
+    if (p_arg->length > 0)
     {
-        // Selecciona una melodía específica en la lista de reproducción
-        uint32_t melody_selected = atoi(p_param);
-        if (p_fsm_jukebox->melodies[melody_selected].melody_length != 0)
+        uint32_t baudrate = 0;
+        for (uint32_t i = 0; i < p_arg->length; i++)
         {
-            fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, STOP);
-            p_fsm_jukebox->melody_idx = melody_selected;
-            fsm_buzzer_set_melody(p_fsm_jukebox->p_fsm_buzzer, &p_fsm_jukebox->melodies[melody_selected]);
-            p_fsm_jukebox->p_melody = p_fsm_jukebox->melodies[melody_selected].p_name;
-            printf("Reproduciendo: %s\n", p_fsm_jukebox->melodies[melody_selected].p_name);
-            fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PLAY);
+            char c = p_arg->p_text[i];
+            baudrate = ((c >= '0') && (c <= '9') && (baudrate <= USART_BAUD_MAX)) ? baudrate * 10U + (uint32_t)(c - '0') : UINT32_MAX;
         }
-        else if (strcmp(p_command, "lista"))
+        if ((baudrate == UINT32_MAX) || !port_usart_set_baudrate(usart_id, baudrate, true))
         {
-            // Imprime la lista de melodías disponibles
-            printf("Lista de melodías: \n");
-            for (int i = 0; i < MELODIES_MEMORY_SIZE; i++)
+            fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Error:Baud rate not available\n");
+            return;
+        }
+        sprintf(msg, "Baud: %lu\n", (unsigned long)baudrate);
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
+        return;
+    }
+    sprintf(msg, "Baud: %lu\n", (unsigned long)port_usart_get_baudrate(usart_id));
+    fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
+}
+
+/**
+ * @brief Comandos propios del jukebox. Se registran al inicializar la máquina de estados.
+ */
+static const command_t jukebox_commands[] = {
+    {"play", _command_play, COMMAND_ARG_NONE, NULL},
+    {"stop", _command_stop, COMMAND_ARG_NONE, NULL},
+    {"pause", _command_pause, COMMAND_ARG_NONE, NULL},
+    {"speed", _command_speed, COMMAND_ARG_FLOAT, _validate_speed},
+    {"next", _command_next, COMMAND_ARG_NONE, NULL},
+    {"select", _command_select, COMMAND_ARG_INT, _validate_select},
+    {"lista", _command_list, COMMAND_ARG_NONE, NULL},
+    {"info", _command_info, COMMAND_ARG_NONE, NULL},
+    {"upload", _command_upload, COMMAND_ARG_STRING, NULL},
+    {"stream", _command_stream, COMMAND_ARG_NONE, NULL},
+    {"poly", _command_poly, COMMAND_ARG_NONE, NULL},
+    {"synth", _command_synth, COMMAND_ARG_NONE, NULL},
+    {"baud", _command_baud, COMMAND_ARG_NONE, NULL},
+};
+
+/**
+ * @brief Forma binaria de un comando: su manejador y el ancho de su argumento en las tramas (command_frame.h).
+ */
+typedef struct
+{
+    command_handler_t handler;   /*!< Función que ejecuta el comando, NULL si el código de operación no se usa */
+    command_arg_spec_t arg_spec; /*!< Argumento que espera el manejador */
+    uint8_t arg_width;           /*!< Bytes del argumento en la trama */
+} jukebox_opcode_t;
+
+/**
+ * @brief Comandos que se aceptan en tramas binarias, indexados por su código de operación.
+ */
+static const jukebox_opcode_t jukebox_opcodes[COMMAND_NUM_OPS] = {
+    [COMMAND_OP_PLAY] = {_command_play, COMMAND_ARG_NONE, 0},
+    [COMMAND_OP_STOP] = {_command_stop, COMMAND_ARG_NONE, 0},
+    [COMMAND_OP_PAUSE] = {_command_pause, COMMAND_ARG_NONE, 0},
+    [COMMAND_OP_SPEED] = {_command_speed, COMMAND_ARG_FLOAT, 2},
+    [COMMAND_OP_NEXT] = {_command_next, COMMAND_ARG_NONE, 0},
+    [COMMAND_OP_SELECT] = {_command_select, COMMAND_ARG_INT, 1},
+    [COMMAND_OP_LIST] = {_command_list, COMMAND_ARG_NONE, 0},
+    [COMMAND_OP_INFO] = {_command_info, COMMAND_ARG_NONE, 0},
+    [COMMAND_OP_STREAM] = {_command_stream, COMMAND_ARG_NONE, 0},
+    [COMMAND_OP_POLY] = {_command_poly, COMMAND_ARG_NONE, 0},
+    [COMMAND_OP_SYNTH] = {_command_synth, COMMAND_ARG_NONE, 0},
+};
+
+/**
+ * @brief Ejecuta un comando recibido por el jukebox.
+ *
+ * Busca el comando en el registro de comandos (tabla hash), comprueba sus argumentos y llama a su manejador.
+ *
+ * @param p_fsm_jukebox Puntero a la estructura de la máquina de estados del jukebox.
+ * @param p_command Vista del comando recibido.
+ * @param p_args Vistas de los argumentos del comando.
+ * @param num_args Número de argumentos.
+ */
+void _execute_command(fsm_jukebox_t *p_fsm_jukebox, const token_t *p_command, const token_t *p_args, uint32_t num_args)
+{
+    const command_t *p_cmd = commands_find(p_command->p_start, p_command->length);
+    if (p_cmd == NULL)
+    {
+        // Si el comando no se reconoce, envía un mensaje de error
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Error:Command not found\n");
+        return;
+    }
+
+    command_arg_t arg;
+    if (!commands_parse_arg(p_cmd, p_args, num_args, &arg))
+    {
+        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Error:Invalid argument\n");
+        return;
+    }
+    p_cmd->handler(&p_fsm_jukebox->f, &arg);
+}
+
+/**
+ * @brief Añade la respuesta de un comando de un lote a la respuesta conjunta, sin su fin de línea.
+ *
+ * @param p_out Respuesta conjunta.
+ * @param p_length Puntero al número de caracteres ya escritos.
+ * @param p_reply Respuesta del comando.
+ */
+static void _append_reply(char *p_out, uint32_t *p_length, const char *p_reply)
+{
+    // Se reserva un carácter para el fin de línea
+    while ((*p_length < USART_OUTPUT_BUFFER_LENGTH - 1) && (*p_reply != EMPTY_BUFFER_CONSTANT) && (*p_reply != END_CHAR_CONSTANT))
+    {
+        p_out[(*p_length)++] = *p_reply++;
+    }
+}
+
+/**
+ * @brief Ejecuta un lote de comandos separados por JUKEBOX_BATCH_SEPARATOR, como "select 2; speed 1.5; play".
+ *
+ * Primero se buscan todos los comandos, se comprueban sus argumentos y se pasan sus validadores con el estado actual:
+ * si alguno no es válido no se ejecuta ninguno y se responde con la posición del primero que falla. Después se ejecutan todos seguidos, en el mismo disparo, y se
+ * envía una sola línea con la respuesta de cada uno separada por "; " ("OK" si el comando no responde nada).
+ *
+ * @param p_fsm_jukebox Puntero a la estructura de la máquina de estados del jukebox.
+ * @param p_message Línea recibida.
+ * @param length Tamaño del buffer de la línea.
+ */
+void _execute_batch(fsm_jukebox_t *p_fsm_jukebox, const char *p_message, uint32_t length)
+{
+    const command_t *p_commands[JUKEBOX_MAX_BATCH_COMMANDS];
+    command_arg_t command_args[JUKEBOX_MAX_BATCH_COMMANDS];
+    token_t args[JUKEBOX_MAX_BATCH_COMMANDS + 1][JUKEBOX_MAX_ARGS]; // La última fila solo detecta un lote demasiado largo
+    uint32_t num_commands = 0;
+    char msg[USART_OUTPUT_BUFFER_LENGTH];
+    const char *p_nul = memchr(p_message, EMPTY_BUFFER_CONSTANT, length);
+    const char *p_end = (p_nul != NULL) ? p_nul : p_message + length;
+
+    for (const char *p_segment = p_message; p_segment < p_end;)
+    {
+        const char *p_separator = memchr(p_segment, JUKEBOX_BATCH_SEPARATOR, (size_t)(p_end - p_segment));
+        const char *p_segment_end = (p_separator != NULL) ? p_separator : p_end;
+        token_t command;
+        uint32_t num_args;
+        if (_parse_message(p_segment, (uint32_t)(p_segment_end - p_segment), &command, args[num_commands], &num_args))
+        {
+            if (num_commands == JUKEBOX_MAX_BATCH_COMMANDS)
             {
-                if (p_fsm_jukebox->melodies[i].melody_length != 0)
-                {
-                    printf("%d. %s\n", i, p_fsm_jukebox->melodies[i].p_name);
-                }
+                fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Error:Batch too long\n");
+                return;
             }
+            p_commands[num_commands] = commands_find(command.p_start, command.length);
+            if ((p_commands[num_commands] == NULL) ||
+                !commands_parse_arg(p_commands[num_commands], args[num_commands], num_args, &command_args[num_commands]) ||
+                !commands_validate(p_commands[num_commands], &p_fsm_jukebox->f, &command_args[num_commands]))
+            {
+                sprintf(msg, "Error:Batch rejected at command %lu\n", (unsigned long)(num_commands + 1));
+                fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
+                return;
+            }
+            num_commands++;
+        }
+        p_segment = p_segment_end + 1;
+    }
+
+    uint32_t msg_length = 0;
+    for (uint32_t i = 0; i < num_commands; i++)
+    {
+        p_commands[i]->handler(&p_fsm_jukebox->f, &command_args[i]);
+        if (i > 0)
+        {
+            _append_reply(msg, &msg_length, "; ");
+        }
+        if (fsm_usart_check_out_data_pending(p_fsm_jukebox->p_fsm_usart))
+        {
+            _append_reply(msg, &msg_length, ((fsm_usart_t *)p_fsm_jukebox->p_fsm_usart)->out_data);
+            fsm_usart_reset_output_data(p_fsm_jukebox->p_fsm_usart);
         }
         else
         {
-            // Si no se encuentra la melodía especificada, envía un mensaje de error
-            fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Error:Melody not found\n");
+            _append_reply(msg, &msg_length, "OK");
         }
     }
-    else if (strcmp(p_command, "info") == 0)
+    if (num_commands > 0)
     {
-        // Envía información sobre la melodía actualmente en reproducción
-        char msg[USART_OUTPUT_BUFFER_LENGTH];
-        sprintf(msg, "Reproduciendo: %s\n", p_fsm_jukebox->p_melody);
+        msg[msg_length++] = END_CHAR_CONSTANT;
+        memset(&msg[msg_length], EMPTY_BUFFER_CONSTANT, USART_OUTPUT_BUFFER_LENGTH - msg_length);
         fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
     }
-    else
+}
+
+/**
+ * @brief Ejecuta una trama binaria recibida por el jukebox y deja su respuesta para enviar.
+ *
+ * El código de operación indexa directamente la tabla de comandos binarios, y el argumento se lee con su ancho fijo,
+ * sin convertir texto. La respuesta es otra trama con el código de operación, el estado y el texto que haya dejado el
+ * comando para enviar (sin el fin de línea), o solo el estado si no ha dejado ninguno.
+ *
+ * @param p_fsm_jukebox Puntero a la estructura de la máquina de estados del jukebox.
+ * @param p_line Línea recibida, que empieza por COMMAND_FRAME_START.
+ * @param length Número de bytes de la línea.
+ */
+void _execute_frame(fsm_jukebox_t *p_fsm_jukebox, const char *p_line, uint32_t length)
+{
+    fsm_usart_t *p_fsm_usart = (fsm_usart_t *)p_fsm_jukebox->p_fsm_usart;
+    command_frame_t frame;
+    frame.opcode = 0;
+    command_frame_status_t status = command_frame_decode(p_line, length, &frame);
+    const jukebox_opcode_t *p_op = (frame.opcode < COMMAND_NUM_OPS) ? &jukebox_opcodes[frame.opcode] : NULL;
+    if ((status == COMMAND_FRAME_OK) && ((p_op == NULL) || (p_op->handler == NULL)))
     {
-        // Si el comando no se reconoce, envía un mensaje de error
-        fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, "Error:Command not found\n");
+        status = COMMAND_FRAME_ERROR_OPCODE;
     }
+    else if ((status == COMMAND_FRAME_OK) && (frame.length != p_op->arg_width))
+    {
+        status = COMMAND_FRAME_ERROR_ARG;
+    }
+
+    if (status == COMMAND_FRAME_OK)
+    {
+        command_arg_t arg;
+        memset(&arg, 0, sizeof(arg));
+        arg.num_args = (p_op->arg_width > 0) ? 1 : 0;
+        arg.int_value = command_frame_get_le(frame.data, p_op->arg_width);
+        if (p_op->arg_spec == COMMAND_ARG_FLOAT)
+        {
+            arg.float_value = (double)arg.int_value / COMMAND_FRAME_SPEED_SCALE;
+        }
+        p_op->handler(&p_fsm_jukebox->f, &arg);
+    }
+
+    command_frame_t reply = {.opcode = (uint8_t)(frame.opcode | COMMAND_FRAME_REPLY_FLAG), .length = 1};
+    reply.data[0] = (uint8_t)status;
+    if (fsm_usart_check_out_data_pending(p_fsm_jukebox->p_fsm_usart))
+    {
+        const char *p_text = p_fsm_usart->out_data;
+        while ((reply.length < COMMAND_FRAME_MAX_DATA) && (*p_text != EMPTY_BUFFER_CONSTANT) && (*p_text != END_CHAR_CONSTANT))
+        {
+            reply.data[reply.length++] = (uint8_t)*p_text++;
+        }
+    }
+    char msg[USART_OUTPUT_BUFFER_LENGTH] = {0};
+    if (command_frame_encode(&reply, msg, sizeof(msg)) == 0)
+    {
+        // El texto escapado no cabe en el buffer de salida: se responde solo con el estado
+        reply.length = 1;
+        command_frame_encode(&reply, msg, sizeof(msg));
+    }
+    fsm_usart_set_out_data(p_fsm_jukebox->p_fsm_usart, msg);
 }
 
 /**
@@ -285,7 +736,7 @@ static bool check_command_received(fsm_t *p_this)
 static bool check_activity(fsm_t *p_this)
 {
     fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
-    if (fsm_buzzer_check_activity(p_fsm_jukebox->p_fsm_buzzer) || fsm_button_check_activity(p_fsm_jukebox->p_fsm_button) || fsm_usart_check_activity(p_fsm_jukebox->p_fsm_usart))
+    if (fsm_buzzer_check_activity(p_fsm_jukebox->p_fsm_buzzer) || fsm_button_check_activity(p_fsm_jukebox->p_fsm_button) || fsm_usart_check_activity(p_fsm_jukebox->p_fsm_usart) || port_audio_is_running())
     {
         return true;
     }
@@ -315,7 +766,7 @@ static void do_start_up(fsm_t *p_this)
     fsm_usart_t *p_fsm_usart = (fsm_usart_t *)p_fsm_jukebox->p_fsm_usart;
     fsm_button_reset_duration(p_fsm_jukebox->p_fsm_button);
     port_usart_enable_rx_interrupt(p_fsm_usart->usart_id);
-    printf("Jukebox ON\n");
+    log_ring_write(LOG_JUKEBOX_ON, NULL, 0);
     fsm_buzzer_set_speed(p_fsm_jukebox->p_fsm_buzzer, 1.0);
     fsm_buzzer_set_melody(p_fsm_jukebox->p_fsm_buzzer, p_fsm_jukebox->melodies);
     fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PLAY);
@@ -343,10 +794,12 @@ static void do_stop_jukebox(fsm_t *p_this)
 {
     fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
     fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, STOP);
+    port_audio_stop();
+    synth_stop();
     fsm_button_reset_duration(p_fsm_jukebox->p_fsm_button);
     fsm_usart_disable_rx_interrupt(p_fsm_jukebox->p_fsm_usart);
     fsm_usart_disable_tx_interrupt(p_fsm_jukebox->p_fsm_usart);
-    printf("Jukebox OFF\n");
+    log_ring_write(LOG_JUKEBOX_OFF, NULL, 0);
     fsm_buzzer_set_melody(p_fsm_jukebox->p_fsm_buzzer, &p_fsm_jukebox->melodies[4]);
     fsm_buzzer_set_action(p_fsm_jukebox->p_fsm_buzzer, PLAY);
 }
@@ -364,77 +817,65 @@ static void do_load_next_song(fsm_t *p_this)
 }
 
 /**
- * @brief Lee el comando recibido por la jukebox.
+ * @brief Lee y ejecuta los comandos recibidos por la jukebox.
+ *
+ * Procesa varias líneas seguidas (hasta JUKEBOX_MAX_COMMANDS_PER_FIRE) si ya estaban recibidas. Se detiene antes si un
+ * comando deja una respuesta pendiente de enviar, para no sobrescribirla; el resto se procesa en el siguiente disparo.
+ * Cada línea se reconoce por su primer byte como comando de texto o como trama binaria (command_frame.h), y una línea
+ * de texto con JUKEBOX_BATCH_SEPARATOR es un lote de comandos. Las tramas y los lotes siempre tienen respuesta, así que
+ * esperan a que se haya enviado la anterior.
  * 
  * @param p_this Puntero a la instancia de la máquina de estados.
  */
 static void do_read_command(fsm_t *p_this)
 {
     fsm_jukebox_t *p_fsm_jukebox = (fsm_jukebox_t *)(p_this);
-    char p_message[USART_INPUT_BUFFER_LENGTH];
-    char p_command[USART_INPUT_BUFFER_LENGTH];
-    char p_param[USART_INPUT_BUFFER_LENGTH];
-    fsm_usart_get_in_data(p_fsm_jukebox->p_fsm_usart, p_message);
-    bool valid = _parse_message(p_message, p_command, p_param);
-    if (valid) {
-        _execute_command(p_fsm_jukebox, p_command, p_param);
-    }
-    fsm_usart_reset_input_data(p_fsm_jukebox->p_fsm_usart);
-    p_message[0] = '\0';
-}
-/**
- * @brief Pone la máquina de estados en modo de suspensión mientras la jukebox está apagada.
- * 
- * @param p_this Puntero a la instancia de la máquina de estados.
- */
-static void do_sleep_while_off(fsm_t *p_this)
-{
-    port_system_sleep();
-}
-
-/**
- * @brief Pone la máquina de estados en modo de suspensión mientras la jukebox está encendida.
- * 
- * @param p_this Puntero a la instancia de la máquina de estados.
- */
-static void do_sleep_while_on(fsm_t *p_this)
-{
-    port_system_sleep();
-}
-
-/**
- * @brief Pone la máquina de estados en modo de suspensión mientras espera un comando.
- * 
- * @param p_this Puntero a la instancia de la máquina de estados.
- */
-static void do_sleep_wait_command(fsm_t *p_this)
-{
-    port_system_sleep();
-}
-
-/**
- * @brief Pone la máquina de estados en modo de suspensión cuando la jukebox está apagada.
- * 
- * @param p_this Puntero a la instancia de la máquina de estados.
- */
-static void do_sleep_off(fsm_t *p_this)
-{
-    port_system_sleep();
+    token_t command;
+    token_t args[JUKEBOX_MAX_ARGS];
+    uint32_t num_args;
+    uint32_t num_commands = 0;
+    do
+    {
+        // El mensaje se analiza directamente en el buffer de la USART, sin copiarlo
+        const char *p_message = fsm_usart_peek_in_data(p_fsm_jukebox->p_fsm_usart);
+        bool frame = command_frame_is_frame(p_message);
+        bool batch = !frame && (memchr(p_message, JUKEBOX_BATCH_SEPARATOR, USART_INPUT_BUFFER_LENGTH) != NULL);
+        if ((frame || batch) && fsm_usart_check_out_data_pending(p_fsm_jukebox->p_fsm_usart))
+        {
+            // La respuesta anterior todavía se está enviando: la línea se procesa en otro disparo
+            break;
+        }
+        if (frame)
+        {
+            const char *p_end = memchr(p_message, EMPTY_BUFFER_CONSTANT, USART_INPUT_BUFFER_LENGTH);
+            _execute_frame(p_fsm_jukebox, p_message, (p_end != NULL) ? (uint32_t)(p_end - p_message) : USART_INPUT_BUFFER_LENGTH);
+        }
+        else if (batch)
+        {
+            _execute_batch(p_fsm_jukebox, p_message, USART_INPUT_BUFFER_LENGTH);
+        }
+        else if (_parse_message(p_message, USART_INPUT_BUFFER_LENGTH, &command, args, &num_args))
+        {
+            _execute_command(p_fsm_jukebox, &command, args, num_args);
+        }
+        fsm_usart_reset_input_data(p_fsm_jukebox->p_fsm_usart);
+        num_commands++;
+    } while ((num_commands < JUKEBOX_MAX_COMMANDS_PER_FIRE) && !fsm_usart_check_out_data_pending(p_fsm_jukebox->p_fsm_usart) && fsm_usart_get_next_line(p_fsm_jukebox->p_fsm_usart));
 }
 
 
 /* State machine input or transition functions */
 fsm_trans_t fsm_trans_jukebox[] = {
     {OFF,check_on,START_UP,do_start_up},
-    {OFF,check_no_activity,SLEEP_WHILE_OFF,do_sleep_off},
-    {SLEEP_WHILE_OFF,check_no_activity,SLEEP_WHILE_OFF,do_sleep_while_off},
+    {OFF,check_no_activity,SLEEP_WHILE_OFF,NULL},
+    {SLEEP_WHILE_OFF,check_no_activity,SLEEP_WHILE_OFF,NULL},
     {SLEEP_WHILE_OFF,check_activity,OFF,NULL},
     {START_UP,check_melody_finished,WAIT_COMMAND,do_start_jukebox},
     {WAIT_COMMAND,check_next_song_button,WAIT_COMMAND,do_load_next_song},
     {WAIT_COMMAND,check_command_received,WAIT_COMMAND,do_read_command},
-    {WAIT_COMMAND,check_no_activity,SLEEP_WHILE_ON,do_sleep_wait_command},
+    {WAIT_COMMAND,check_no_activity,SLEEP_WHILE_ON,NULL},
     {WAIT_COMMAND,check_off,OFF,do_stop_jukebox},
-    {SLEEP_WHILE_ON,check_no_activity,SLEEP_WHILE_ON,do_sleep_while_on},
+    {SLEEP_WHILE_ON,check_no_activity,SLEEP_WHILE_ON,NULL},
     {SLEEP_WHILE_ON,check_activity,WAIT_COMMAND,NULL},
     {-1, NULL,-1,NULL}
 };
@@ -464,4 +905,12 @@ void fsm_jukebox_init(fsm_t *p_this, fsm_t *p_fsm_button, uint32_t on_off_press_
     p_fsm_jukebox->melodies[2] = tetris_melody;
     p_fsm_jukebox->melodies[3] = himno_madrid_melody;
     p_fsm_jukebox->melodies[4] = windows_shutdown_melody;
-}
\ No newline at end of file
+    melody_stream_upload_init(&p_fsm_jukebox->upload);
+    commands_register_table(jukebox_commands, sizeof(jukebox_commands) / sizeof(jukebox_commands[0]));
+}
+
+bool fsm_jukebox_check_standby(fsm_t *p_this)
+{
+    int state = fsm_get_state(p_this);
+    return ((state == OFF) || (state == SLEEP_WHILE_OFF)) && check_no_activity(p_this);
+}
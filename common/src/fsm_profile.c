@@ -0,0 +1,215 @@
+/**
+ * @file fsm_profile.c
+ * @brief Opt-in profiler of the transition tables of the FSMs.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <string.h>
+
+/* Other libraries */
+#include "fsm_profile.h"
+#include "fsm_index.h"
+#include "port_system.h"
+
+/* Global variables */
+static fsm_profile_t profiles[FSM_PROFILE_MAX_FSMS]; /*!< Profiles of the attached FSMs */
+static uint32_t num_profiles = 0;                    /*!< Number of attached FSMs */
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Find the profile of an FSM.
+ *
+ * @param p_fsm Pointer to the FSM
+ * @return fsm_profile_t* Profile, or NULL if the FSM is not attached
+ */
+static fsm_profile_t *_find(const fsm_t *p_fsm)
+{
+    for (uint32_t i = 0; i < num_profiles; i++)
+    {
+        if (profiles[i].p_fsm == p_fsm)
+        {
+            return &profiles[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Reset the counters of a profile.
+ *
+ * @param p_profile Pointer to the profile
+ */
+static void _reset(fsm_profile_t *p_profile)
+{
+    p_profile->fires = 0;
+    p_profile->rows = 0;
+    memset(p_profile->trans, 0, sizeof(p_profile->trans));
+    for (uint32_t i = 0; i < FSM_PROFILE_MAX_TRANSITIONS; i++)
+    {
+        p_profile->trans[i].min_cycles = UINT32_MAX;
+    }
+}
+
+/**
+ * @brief Record the duration of an action.
+ *
+ * @param p_trans Counters of the transition
+ * @param cycles Duration of the action
+ */
+static void _record_action(fsm_profile_trans_t *p_trans, uint32_t cycles)
+{
+    p_trans->total_cycles += cycles;
+    if (cycles < p_trans->min_cycles)
+    {
+        p_trans->min_cycles = cycles;
+    }
+    if (cycles > p_trans->max_cycles)
+    {
+        p_trans->max_cycles = cycles;
+    }
+}
+
+/* Public functions ----------------------------------------------------------*/
+void fsm_profile_init(void)
+{
+    memset(profiles, 0, sizeof(profiles));
+    num_profiles = 0;
+}
+
+bool fsm_profile_attach(fsm_t *p_fsm, const char *p_name)
+{
+    if ((num_profiles >= FSM_PROFILE_MAX_FSMS) || (_find(p_fsm) != NULL))
+    {
+        return false;
+    }
+    uint32_t num_trans = 0;
+    while (p_fsm->p_tt[num_trans].orig_state >= 0)
+    {
+        num_trans++;
+        if (num_trans > FSM_PROFILE_MAX_TRANSITIONS)
+        {
+            return false;
+        }
+    }
+    fsm_profile_t *p_profile = &profiles[num_profiles];
+    p_profile->p_fsm = p_fsm;
+    p_profile->p_name = p_name;
+    p_profile->p_tt = p_fsm->p_tt;
+    p_profile->num_trans = num_trans;
+    _reset(p_profile);
+    num_profiles++;
+    return true;
+}
+
+const fsm_trans_t *fsm_profile_fire(fsm_t *p_fsm)
+{
+    fsm_profile_t *p_profile = (num_profiles > 0) ? _find(p_fsm) : NULL;
+    if (p_profile == NULL)
+    {
+        return fsm_index_fire(p_fsm);
+    }
+
+    /* Same semantics as fsm_fire(): the first transition of the current state whose guard is true is taken. If the
+     * table is indexed only the rows of the current state are visited, as fsm_index_fire() does */
+    p_profile->fires++;
+    int state = fsm_get_state(p_fsm);
+    const uint8_t *p_rows = NULL;
+    uint32_t num_rows = p_profile->num_trans;
+    const fsm_index_t *p_index = fsm_index_find(p_profile->p_tt);
+    if (p_index != NULL)
+    {
+        num_rows = fsm_index_get_rows(p_index, state, &p_rows);
+    }
+    for (uint32_t k = 0; k < num_rows; k++)
+    {
+        uint32_t i = (p_rows != NULL) ? p_rows[k] : k;
+        fsm_trans_t *p_t = &p_profile->p_tt[i];
+        p_profile->rows++;
+        if (p_t->orig_state != state)
+        {
+            continue;
+        }
+        fsm_profile_trans_t *p_trans = &p_profile->trans[i];
+        uint32_t start = port_system_get_cycles();
+        bool fire = (p_t->in == NULL) || p_t->in(p_fsm);
+        p_trans->guard_cycles += port_system_get_cycles() - start;
+        p_trans->guard_evals++;
+        if (fire)
+        {
+            p_trans->fires++;
+            fsm_set_state(p_fsm, p_t->dest_state);
+            if (p_t->out != NULL)
+            {
+                start = port_system_get_cycles();
+                p_t->out(p_fsm);
+                _record_action(p_trans, port_system_get_cycles() - start);
+            }
+            return p_t;
+        }
+    }
+    return NULL;
+}
+
+const fsm_profile_t *fsm_profile_get(const fsm_t *p_fsm)
+{
+    return _find(p_fsm);
+}
+
+void fsm_profile_reset(void)
+{
+    for (uint32_t i = 0; i < num_profiles; i++)
+    {
+        _reset(&profiles[i]);
+    }
+}
+
+void fsm_profile_print(void)
+{
+    for (uint32_t i = 0; i < num_profiles; i++)
+    {
+        const fsm_profile_t *p_profile = &profiles[i];
+        printf("FSM %s: %u fires, %u rows visited\n", p_profile->p_name, (unsigned)p_profile->fires,
+               (unsigned)p_profile->rows);
+        printf("  t   from->to      evals  guard avg       fires   action min/avg/max (cycles)\n");
+        for (uint32_t t = 0; t < p_profile->num_trans; t++)
+        {
+            const fsm_profile_trans_t *p_trans = &p_profile->trans[t];
+            uint32_t guard_avg = p_trans->guard_evals ? (uint32_t)(p_trans->guard_cycles / p_trans->guard_evals) : 0;
+            uint32_t actions = (p_profile->p_tt[t].out != NULL) ? p_trans->fires : 0;
+            uint32_t action_avg = actions ? (uint32_t)(p_trans->total_cycles / actions) : 0;
+            printf("  %-3u %4d->%-4d %10u %10u %10u   %u/%u/%u\n", (unsigned)t, p_profile->p_tt[t].orig_state,
+                   p_profile->p_tt[t].dest_state, (unsigned)p_trans->guard_evals, (unsigned)guard_avg,
+                   (unsigned)p_trans->fires, (unsigned)(actions ? p_trans->min_cycles : 0), (unsigned)action_avg,
+                   (unsigned)p_trans->max_cycles);
+        }
+    }
+}
+
+uint32_t fsm_profile_format_hottest(char *p_msg, uint32_t size)
+{
+    const fsm_profile_t *p_hot = NULL;
+    uint32_t hot_t = 0;
+    for (uint32_t i = 0; i < num_profiles; i++)
+    {
+        for (uint32_t t = 0; t < profiles[i].num_trans; t++)
+        {
+            if ((p_hot == NULL) || (profiles[i].trans[t].guard_cycles > p_hot->trans[hot_t].guard_cycles))
+            {
+                p_hot = &profiles[i];
+                hot_t = t;
+            }
+        }
+    }
+    if ((p_hot == NULL) || (size == 0))
+    {
+        return 0;
+    }
+    int length = snprintf(p_msg, size, "Hot: %s t%u %u evals %u fires\n", p_hot->p_name, (unsigned)hot_t,
+                          (unsigned)p_hot->trans[hot_t].guard_evals, (unsigned)p_hot->trans[hot_t].fires);
+    return (length < (int)size) ? (uint32_t)length : size - 1U;
+}
@@ -22,7 +22,7 @@
 
 
 /**
- * @brief Comprueba si hay datos recibidos en USART.
+ * @brief Comprueba si hay líneas recibidas en USART y la anterior ya se ha procesado.
  * 
  * @param p_this Puntero a la instancia de la FSM.
  * @return true si hay datos recibidos, false en caso contrario.
@@ -30,7 +30,7 @@
 
 static bool check_data_rx (fsm_t *p_this){
     fsm_usart_t*p_fsm=(fsm_usart_t*)(p_this);
-    return port_usart_rx_done(p_fsm->usart_id);
+    return !p_fsm->data_received && port_usart_rx_done(p_fsm->usart_id);
 }
 /**
  * @brief Comprueba si hay datos de transmisión en USART.
@@ -58,30 +58,30 @@ static bool check_tx_end (fsm_t *p_this){
     fsm_usart_t*p_fsm=(fsm_usart_t*)(p_this);
     return port_usart_tx_done(p_fsm->usart_id);
 }/**
- * @brief Obtiene los datos recibidos desde el buffer de entrada USART.
+ * @brief Obtiene la siguiente línea recibida desde el anillo de recepción USART.
  * 
  * @param p_this 
  */
 static void do_get_data_rx (fsm_t *p_this){
-    fsm_usart_t*p_fsm=(fsm_usart_t*)(p_this);
-    port_usart_get_from_input_buffer(p_fsm->usart_id,p_fsm->in_data);
-    port_usart_reset_input_buffer(p_fsm->usart_id);
-    p_fsm->data_received = true; 
+    fsm_usart_get_next_line(p_this);
 }
 /**
- * @brief Establece los datos de transmisión en el buffer de salida USART y envía.
+ * @brief Inicia la transmisión por DMA de los datos de salida, hasta el carácter de fin de línea incluido.
+ *
+ * No se copian los datos ni se espera a que el USART esté libre: el DMA los envía directamente desde out_data y
+ * solo hay una interrupción al final del mensaje.
  * 
  * @param p_this 
  */
 static void do_set_data_tx (fsm_t *p_this){
     fsm_usart_t*p_fsm=(fsm_usart_t*)(p_this);
-    port_usart_reset_output_buffer(p_fsm->usart_id);
-    port_usart_copy_to_output_buffer(p_fsm->usart_id,p_fsm->out_data,USART_OUTPUT_BUFFER_LENGTH);
-    while(port_usart_get_txr_status(p_fsm->usart_id)!=1){
-
+    uint32_t length = 0;
+    while ((length < USART_OUTPUT_BUFFER_LENGTH) && (p_fsm->out_data[length] != EMPTY_BUFFER_CONSTANT)){
+        if (p_fsm->out_data[length++] == END_CHAR_CONSTANT){
+            break;
+        }
     }
-    port_usart_write_data(p_fsm->usart_id);
-    port_usart_enable_tx_interrupt(p_fsm->usart_id);
+    port_usart_tx_start(p_fsm->usart_id, p_fsm->out_data, length);
 }
 /**
  * @brief  Realiza acciones necesarias cuando ha finalizado la transmisión USART.
@@ -125,8 +125,22 @@ void fsm_usart_get_in_data(fsm_t *p_this, char *p_data)
     fsm_usart_t *p_fsm = (fsm_usart_t *)(p_this);
     memcpy(p_data, p_fsm->in_data, USART_INPUT_BUFFER_LENGTH);
 }
+/**
+ * @brief Devuelve un puntero de solo lectura a los datos de entrada, sin copiarlos.
+ * 
+ * @param p_this 
+ * @return const char* 
+ */
+const char *fsm_usart_peek_in_data(fsm_t *p_this)
+{
+    fsm_usart_t *p_fsm = (fsm_usart_t *)(p_this);
+    return p_fsm->in_data;
+}
 /**
  * @brief Establece los datos de salida en el buffer de datos USART.
+ *
+ * Se copian los caracteres de p_data hasta su '\0' (como mucho USART_OUTPUT_BUFFER_LENGTH) y el resto del buffer
+ * queda vacío.
  * 
  * @param p_this 
  * @param p_data 
@@ -136,7 +150,46 @@ void fsm_usart_set_out_data(fsm_t *p_this, char *p_data)
     fsm_usart_t *p_fsm = (fsm_usart_t *)(p_this);
     // Ensure to reset the output data before setting a new one
     memset(p_fsm->out_data, EMPTY_BUFFER_CONSTANT, USART_OUTPUT_BUFFER_LENGTH);
-    memcpy(p_fsm->out_data, p_data, USART_OUTPUT_BUFFER_LENGTH);
+    // Copy only up to the terminator: p_data is usually a short literal
+    memcpy(p_fsm->out_data, p_data, strnlen(p_data, USART_OUTPUT_BUFFER_LENGTH));
+}
+/**
+ * @brief Carga en los datos de entrada la siguiente línea recibida, si la hay.
+ *
+ * Permite procesar varias líneas seguidas en un mismo disparo de la máquina de estados.
+ * 
+ * @param p_this 
+ * @return true si se ha cargado una línea, false si no había ninguna pendiente.
+ */
+bool fsm_usart_get_next_line (fsm_t *p_this){
+    fsm_usart_t *p_fsm = (fsm_usart_t *)(p_this);
+    if (!port_usart_rx_done(p_fsm->usart_id)){
+        return false;
+    }
+    port_usart_get_from_input_buffer(p_fsm->usart_id,p_fsm->in_data);
+    p_fsm->data_received = true;
+    return true;
+}
+/**
+ * @brief Obtiene el número de líneas recibidas pendientes de procesar (sin contar la de los datos de entrada).
+ * 
+ * @param p_this 
+ * @return uint32_t 
+ */
+uint32_t fsm_usart_get_lines_pending (fsm_t *p_this){
+    fsm_usart_t *p_fsm = (fsm_usart_t *)(p_this);
+    return port_usart_get_lines_pending(p_fsm->usart_id);
+}
+/**
+ * @brief Comprueba si hay datos de salida esperando a ser transmitidos o transmitiéndose.
+ * 
+ * @param p_this 
+ * @return true 
+ * @return false 
+ */
+bool fsm_usart_check_out_data_pending (fsm_t *p_this){
+    fsm_usart_t *p_fsm = (fsm_usart_t *)(p_this);
+    return p_fsm->out_data[0] != EMPTY_BUFFER_CONSTANT;
 }
 /**
  * @brief Restablece los datos de entrada recibidos en USART.
@@ -148,6 +201,15 @@ void fsm_usart_reset_input_data (fsm_t *p_this){
     memset(p_fsm->in_data,EMPTY_BUFFER_CONSTANT,USART_INPUT_BUFFER_LENGTH);
     p_fsm->data_received = 0;
 }
+/**
+ * @brief Descarta los datos de salida que todavía no se han empezado a transmitir.
+ * 
+ * @param p_this 
+ */
+void fsm_usart_reset_output_data (fsm_t *p_this){
+    fsm_usart_t *p_fsm = (fsm_usart_t *)(p_this);
+    memset(p_fsm->out_data,EMPTY_BUFFER_CONSTANT,USART_OUTPUT_BUFFER_LENGTH);
+}
 /**
  * @brief Habilita la interrupción de recepción USART.
  * 
@@ -216,7 +278,7 @@ void fsm_usart_init(fsm_t *p_this, uint32_t usart_id)
 bool fsm_usart_check_activity(fsm_t *p_this)
 {
     fsm_usart_t *p_fsm = (fsm_usart_t *)(p_this);
-    if (p_fsm->f.current_state == SEND_DATA || p_fsm->data_received == true)
+    if (p_fsm->f.current_state == SEND_DATA || p_fsm->data_received == true || port_usart_rx_done(p_fsm->usart_id))
     {
         return true;    
     }
@@ -0,0 +1,151 @@
+/**
+ * @file line_ring.c
+ * @brief Lock-free single-producer/single-consumer ring buffer of text lines.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "line_ring.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define RING_MASK (LINE_RING_LENGTH - 1U) /*!< Mask to wrap the indexes of the ring */
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Publish an index to the other side of the ring. The data written before must be visible before the index.
+ *
+ * @param p_index Pointer to the index
+ * @param value New value
+ */
+static inline void _publish(volatile uint32_t *p_index, uint32_t value)
+{
+    __atomic_store_n(p_index, value, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Read an index written by the other side of the ring.
+ *
+ * @param p_index Pointer to the index
+ * @return uint32_t Value of the index
+ */
+static inline uint32_t _acquire(const volatile uint32_t *p_index)
+{
+    return __atomic_load_n(p_index, __ATOMIC_ACQUIRE);
+}
+
+/* Public functions ----------------------------------------------------------*/
+void line_ring_init(line_ring_t *p_ring, uint32_t max_line_length)
+{
+    memset(p_ring, 0, sizeof(line_ring_t));
+    p_ring->max_line_length = max_line_length;
+}
+
+void line_ring_put(line_ring_t *p_ring, char c)
+{
+    uint32_t head = p_ring->head;
+
+    if (c == '\0')
+    {
+        /* '\0' ends the lines inside the ring, so it is not accepted as part of a line */
+        return;
+    }
+    if (c == LINE_RING_END_CHAR)
+    {
+        if (p_ring->discarding)
+        {
+            /* End of a discarded line: start again from the last complete line */
+            p_ring->discarding = false;
+            p_ring->write = head;
+            return;
+        }
+        if (p_ring->write == head)
+        {
+            /* Empty lines are ignored */
+            return;
+        }
+        if (((p_ring->write + 1U) - _acquire(&p_ring->tail)) > LINE_RING_LENGTH)
+        {
+            p_ring->overruns++;
+            p_ring->write = head;
+            return;
+        }
+        p_ring->data[p_ring->write & RING_MASK] = '\0';
+        p_ring->write++;
+        _publish(&p_ring->head, p_ring->write);
+        _publish(&p_ring->lines_in, p_ring->lines_in + 1U);
+        return;
+    }
+
+    if (p_ring->discarding)
+    {
+        return;
+    }
+    /* One byte is kept for the '\0' that ends the line */
+    uint32_t line_length = p_ring->write - head;
+    if ((line_length >= p_ring->max_line_length) || (((p_ring->write + 2U) - _acquire(&p_ring->tail)) > LINE_RING_LENGTH))
+    {
+        p_ring->overruns++;
+        p_ring->discarding = true;
+        p_ring->write = head;
+        return;
+    }
+    p_ring->data[p_ring->write & RING_MASK] = c;
+    p_ring->write++;
+}
+
+void line_ring_discard_line(line_ring_t *p_ring)
+{
+    p_ring->write = p_ring->head;
+    p_ring->discarding = true;
+}
+
+uint32_t line_ring_lines_pending(const line_ring_t *p_ring)
+{
+    return _acquire(&p_ring->lines_in) - p_ring->lines_out;
+}
+
+int32_t line_ring_get_line(line_ring_t *p_ring, char *p_line, uint32_t size)
+{
+    if (line_ring_lines_pending(p_ring) == 0)
+    {
+        return -1;
+    }
+    uint32_t tail = p_ring->tail;
+    uint32_t length = 0;
+    uint32_t copied = 0;
+    char c;
+    while ((c = p_ring->data[(tail + length) & RING_MASK]) != '\0')
+    {
+        if (copied + 1U < size)
+        {
+            p_line[copied++] = c;
+        }
+        length++;
+    }
+    if (p_line != NULL)
+    {
+        memset(&p_line[copied], '\0', size - copied);
+    }
+
+    _publish(&p_ring->tail, tail + length + 1U);
+    _publish(&p_ring->lines_out, p_ring->lines_out + 1U);
+    return (int32_t)copied;
+}
+
+void line_ring_flush(line_ring_t *p_ring)
+{
+    while (line_ring_get_line(p_ring, NULL, 0) >= 0)
+    {
+    }
+}
+
+uint32_t line_ring_get_overruns(const line_ring_t *p_ring)
+{
+    return p_ring->overruns;
+}
@@ -0,0 +1,336 @@
+/**
+ * @file log_ring.c
+ * @brief Deferred logging with binary records in a lock-free single-producer/single-consumer ring.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+
+/* Other libraries */
+#include "log_ring.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define RING_MASK (LOG_RING_LENGTH - 1U) /*!< Mask to wrap the indexes of the ring */
+#define LOG_FORMAT_SPEC_LENGTH 16U       /*!< Maximum length of one conversion of a format string */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Ring buffer of records. Each index is written by only one side.
+ */
+typedef struct
+{
+    uint32_t data[LOG_RING_LENGTH]; /*!< Words of the records */
+    volatile uint32_t head;         /*!< Index after the last complete record. Written only by the producer */
+    volatile uint32_t tail;         /*!< Index of the first word not read. Written only by the consumer */
+} log_ring_t;
+
+/* Global variables */
+#define LOG_RING_FORMAT(id, format) format,
+static const char *const formats[LOG_NUM_MESSAGES] = {LOG_RING_MESSAGES(LOG_RING_FORMAT)}; /*!< Format strings by identifier */
+#undef LOG_RING_FORMAT
+
+static log_ring_t ring;         /*!< Ring of records */
+static log_ring_stats_t stats;  /*!< Counters of the log */
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Publish an index to the other side of the ring. The data written before must be visible before the index.
+ *
+ * @param p_index Pointer to the index
+ * @param value New value
+ */
+static inline void _publish(volatile uint32_t *p_index, uint32_t value)
+{
+    __atomic_store_n(p_index, value, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Read an index written by the other side of the ring.
+ *
+ * @param p_index Pointer to the index
+ * @return uint32_t Value of the index
+ */
+static inline uint32_t _acquire(const volatile uint32_t *p_index)
+{
+    return __atomic_load_n(p_index, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Number of words of a record from its first word.
+ *
+ * @param header First word of the record
+ * @return uint32_t Number of words
+ */
+static inline uint32_t _record_words(uint32_t header)
+{
+    uint32_t num_args = (header >> 8) & 0xFFU;
+    uint32_t length = (header >> 16) & 0xFFU;
+    return LOG_RING_HEADER_WORDS + num_args + (length + 3U) / 4U;
+}
+
+/**
+ * @brief Append some characters to a buffer, always keeping the final '\0'.
+ *
+ * @param p_out Buffer
+ * @param size Size of the buffer
+ * @param p_length Pointer to the number of characters already stored
+ * @param p_text Characters to append
+ * @param length Number of characters to append
+ */
+static void _append(char *p_out, uint32_t size, uint32_t *p_length, const char *p_text, uint32_t length)
+{
+    while ((length > 0) && (*p_length + 1U < size))
+    {
+        p_out[(*p_length)++] = *p_text++;
+        length--;
+    }
+    p_out[*p_length] = '\0';
+}
+
+/* Public functions ----------------------------------------------------------*/
+void log_ring_init(void)
+{
+    memset(&ring, 0, sizeof(ring));
+    memset(&stats, 0, sizeof(stats));
+}
+
+void log_ring_write(log_id_t id, const char *p_text, uint32_t num_args, ...)
+{
+    uint32_t start = port_system_get_cycles();
+    uint32_t length = 0;
+    if (p_text != NULL)
+    {
+        while ((length < LOG_RING_MAX_STRING) && (p_text[length] != '\0'))
+        {
+            length++;
+        }
+    }
+    num_args = (num_args > LOG_RING_MAX_ARGS) ? LOG_RING_MAX_ARGS : num_args;
+
+    uint32_t header = ((uint32_t)LOG_RING_SYNC << 24) | (length << 16) | (num_args << 8) | ((uint32_t)id & 0xFFU);
+    uint32_t head = ring.head;
+    if ((head + _record_words(header) - _acquire(&ring.tail)) > LOG_RING_LENGTH)
+    {
+        stats.dropped++;
+    }
+    else
+    {
+        ring.data[head++ & RING_MASK] = header;
+        ring.data[head++ & RING_MASK] = port_system_get_millis();
+
+        va_list args;
+        va_start(args, num_args);
+        for (uint32_t i = 0; i < num_args; i++)
+        {
+            ring.data[head++ & RING_MASK] = va_arg(args, uint32_t);
+        }
+        va_end(args);
+
+        /* The string is packed 4 characters per word, the first one in the lowest byte */
+        for (uint32_t i = 0; i < length; i += 4U)
+        {
+            uint32_t word = 0;
+            for (uint32_t j = 0; (j < 4U) && (i + j < length); j++)
+            {
+                word |= (uint32_t)(uint8_t)p_text[i + j] << (8U * j);
+            }
+            ring.data[head++ & RING_MASK] = word;
+        }
+        stats.records++;
+        _publish(&ring.head, head);
+    }
+
+    uint32_t cycles = port_system_get_cycles() - start;
+    stats.total_cycles += cycles;
+    if (cycles > stats.max_cycles)
+    {
+        stats.max_cycles = cycles;
+    }
+}
+
+uint32_t log_ring_pending(void)
+{
+    return stats.records - stats.drained;
+}
+
+int32_t log_ring_read(uint32_t *p_words, uint32_t max_words)
+{
+    uint32_t tail = ring.tail;
+    if (tail == _acquire(&ring.head))
+    {
+        return -1;
+    }
+    uint32_t num_words = _record_words(ring.data[tail & RING_MASK]);
+    if (num_words > max_words)
+    {
+        return -1;
+    }
+    for (uint32_t i = 0; i < num_words; i++)
+    {
+        p_words[i] = ring.data[(tail + i) & RING_MASK];
+    }
+    stats.drained++;
+    _publish(&ring.tail, tail + num_words);
+    return (int32_t)num_words;
+}
+
+uint32_t log_ring_parse(const uint32_t *p_words, uint32_t num_words, log_record_t *p_record)
+{
+    if (num_words < LOG_RING_HEADER_WORDS)
+    {
+        return 0;
+    }
+    uint32_t header = p_words[0];
+    uint32_t words = _record_words(header);
+    uint32_t num_args = (header >> 8) & 0xFFU;
+    uint32_t length = (header >> 16) & 0xFFU;
+    if (((header >> 24) != LOG_RING_SYNC) || ((header & 0xFFU) >= LOG_NUM_MESSAGES) || (num_args > LOG_RING_MAX_ARGS) ||
+        (length > LOG_RING_MAX_STRING) || (words > num_words))
+    {
+        return 0;
+    }
+
+    p_record->id = (log_id_t)(header & 0xFFU);
+    p_record->timestamp_ms = p_words[1];
+    p_record->num_args = num_args;
+    for (uint32_t i = 0; i < num_args; i++)
+    {
+        p_record->args[i] = p_words[LOG_RING_HEADER_WORDS + i];
+    }
+    const uint32_t *p_text = &p_words[LOG_RING_HEADER_WORDS + num_args];
+    for (uint32_t i = 0; i < length; i++)
+    {
+        p_record->text[i] = (char)((p_text[i / 4U] >> (8U * (i % 4U))) & 0xFFU);
+    }
+    p_record->text[length] = '\0';
+    return words;
+}
+
+uint32_t log_ring_format(const log_record_t *p_record, char *p_out, uint32_t size)
+{
+    const char *p_format = log_ring_get_format(p_record->id);
+    uint32_t length = 0;
+    uint32_t arg = 0;
+    if (size == 0)
+    {
+        return 0;
+    }
+    p_out[0] = '\0';
+    if (p_format == NULL)
+    {
+        return 0;
+    }
+
+    while (*p_format != '\0')
+    {
+        const char *p_percent = strchr(p_format, '%');
+        if (p_percent == NULL)
+        {
+            _append(p_out, size, &length, p_format, (uint32_t)strlen(p_format));
+            break;
+        }
+        _append(p_out, size, &length, p_format, (uint32_t)(p_percent - p_format));
+
+        /* One conversion: flags and width are kept, the length modifier is removed (all arguments are 32-bit) */
+        char spec[LOG_FORMAT_SPEC_LENGTH];
+        uint32_t spec_length = 0;
+        const char *p = p_percent + 1;
+        spec[spec_length++] = '%';
+        while ((strchr("-+ #0123456789.l", *p) != NULL) && (*p != '\0') && (spec_length < LOG_FORMAT_SPEC_LENGTH - 2U))
+        {
+            if (*p != 'l')
+            {
+                spec[spec_length++] = *p;
+            }
+            p++;
+        }
+        char conversion = *p;
+        spec[spec_length++] = conversion;
+        spec[spec_length] = '\0';
+        p_format = (conversion != '\0') ? p + 1 : p;
+
+        char value[LOG_RING_MAX_STRING + 16U];
+        int written = 0;
+        uint32_t number = (arg < p_record->num_args) ? p_record->args[arg] : 0U;
+        switch (conversion)
+        {
+        case '%':
+            written = snprintf(value, sizeof(value), "%%");
+            break;
+        case 's':
+            written = snprintf(value, sizeof(value), spec, p_record->text);
+            break;
+        case 'd':
+        case 'i':
+            written = snprintf(value, sizeof(value), spec, (int)(int32_t)number);
+            arg++;
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'c':
+            written = snprintf(value, sizeof(value), spec, (unsigned)number);
+            arg++;
+            break;
+        default:
+            /* Unknown conversion: copied as it is */
+            written = snprintf(value, sizeof(value), "%s", spec);
+            break;
+        }
+        if (written > 0)
+        {
+            _append(p_out, size, &length, value, ((uint32_t)written < sizeof(value)) ? (uint32_t)written : sizeof(value) - 1U);
+        }
+    }
+    return length;
+}
+
+uint32_t log_ring_drain(uint32_t max_records)
+{
+    uint32_t words[LOG_RING_MAX_RECORD_WORDS];
+    uint32_t sent = 0;
+    while (sent < max_records)
+    {
+        int32_t num_words = log_ring_read(words, LOG_RING_MAX_RECORD_WORDS);
+        if (num_words < 0)
+        {
+            break;
+        }
+#if LOG_RING_DRAIN_BINARY
+        fwrite(words, sizeof(uint32_t), (size_t)num_words, stdout);
+#else
+        log_record_t record;
+        char text[128];
+        if (log_ring_parse(words, (uint32_t)num_words, &record) > 0)
+        {
+            log_ring_format(&record, text, sizeof(text));
+            fputs(text, stdout);
+        }
+#endif
+        sent++;
+    }
+    if (sent > 0)
+    {
+        fflush(stdout);
+    }
+    return sent;
+}
+
+const char *log_ring_get_format(log_id_t id)
+{
+    return ((uint32_t)id < LOG_NUM_MESSAGES) ? formats[id] : NULL;
+}
+
+void log_ring_get_stats(log_ring_stats_t *p_stats)
+{
+    *p_stats = stats;
+}
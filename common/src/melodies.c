@@ -8,27 +8,33 @@
 /* Includes ------------------------------------------------------------------*/
 #include "melodies.h"
 
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief Frequencies of the 9th octave in millihertz, to get the frequency of any note by shifting.
+ */
+static const uint32_t octave9_mhz[12] = {
+    _MELODY_OCTAVE9_MHZ(0), _MELODY_OCTAVE9_MHZ(1), _MELODY_OCTAVE9_MHZ(2), _MELODY_OCTAVE9_MHZ(3),
+    _MELODY_OCTAVE9_MHZ(4), _MELODY_OCTAVE9_MHZ(5), _MELODY_OCTAVE9_MHZ(6), _MELODY_OCTAVE9_MHZ(7),
+    _MELODY_OCTAVE9_MHZ(8), _MELODY_OCTAVE9_MHZ(9), _MELODY_OCTAVE9_MHZ(10), _MELODY_OCTAVE9_MHZ(11)};
+
 /* Melodies ------------------------------------------------------------------*/
 // Melody Happy Birthday
 #define HAPPY_BIRTHDAY_LENGTH 25 /*!< Happy Birthday melody length */
 
 /**
- * @brief Happy Birthday melody notes.
- *
- * This array contains the frequencies of the notes for the Happy Birthday song.
- * The notes are defined as frequency values in Hertz, and they are arranged in the order they are played in the song.
- */
-static const double happy_birthday_notes[HAPPY_BIRTHDAY_LENGTH] = {
-    DO4, DO4, RE4, DO4, FA4, MI4, DO4, DO4, RE4, DO4, SOL4, FA4, DO4, DO4, DO5, LA4, FA4, MI4, RE4, LAs4, LAs4, LA4, FA4, SOL4, FA4};
-
-/**
- * @brief Happy Birthday melody durations in miliseconds.
+ * @brief Happy Birthday melody events.
  *
- * This array contains the duration of each note in the Happy Birthday song.
- * The durations are defined in milliseconds, and they are arranged in the order they are played in the song.
+ * This array contains the packed events of the Happy Birthday song: MIDI note number and duration in milliseconds.
+ * The events are arranged in the order they are played in the song.
  */
-static const uint16_t happy_birthday_durations[HAPPY_BIRTHDAY_LENGTH] = {
-    300, 100, 400, 400, 400, 800, 300, 100, 400, 400, 400, 800, 300, 100, 400, 400, 400, 400, 400, 300, 100, 400, 400, 400, 800};
+static const melody_event_t happy_birthday_events[HAPPY_BIRTHDAY_LENGTH] = {
+    MELODY_EVENT(DO4, 300), MELODY_EVENT(DO4, 100), MELODY_EVENT(RE4, 400), MELODY_EVENT(DO4, 400),
+    MELODY_EVENT(FA4, 400), MELODY_EVENT(MI4, 800), MELODY_EVENT(DO4, 300), MELODY_EVENT(DO4, 100),
+    MELODY_EVENT(RE4, 400), MELODY_EVENT(DO4, 400), MELODY_EVENT(SOL4, 400), MELODY_EVENT(FA4, 800),
+    MELODY_EVENT(DO4, 300), MELODY_EVENT(DO4, 100), MELODY_EVENT(DO5, 400), MELODY_EVENT(LA4, 400),
+    MELODY_EVENT(FA4, 400), MELODY_EVENT(MI4, 400), MELODY_EVENT(RE4, 400), MELODY_EVENT(LAs4, 300),
+    MELODY_EVENT(LAs4, 100), MELODY_EVENT(LA4, 400), MELODY_EVENT(FA4, 400), MELODY_EVENT(SOL4, 400),
+    MELODY_EVENT(FA4, 800)};
 
 /**
  * @brief Happy Birthday melody struct.
@@ -37,128 +43,105 @@ static const uint16_t happy_birthday_durations[HAPPY_BIRTHDAY_LENGTH] = {
  * It is used to play the melody using the buzzer.
  */
 const melody_t happy_birthday_melody = {.p_name = "happy_birthday",
-                                        .p_notes = (double *)happy_birthday_notes,
-                                        .p_durations = (uint16_t *)happy_birthday_durations,
+                                        .p_events = happy_birthday_events,
                                         .melody_length = HAPPY_BIRTHDAY_LENGTH};
 
 // Tetris melody
 #define TETRIS_LENGTH 40 /*!< Tetris melody length */
 
 /**
- * @brief Tetris melody notes.
+ * @brief Tetris melody events.
  *
- * This array contains the frequencies of the notes for the Tetris song.
- * The notes are defined as frequency values in Hertz, and they are arranged in the order they are played in the song.
+ * This array contains the packed events of the Tetris song: MIDI note number and duration in milliseconds.
+ * The events are arranged in the order they are played in the song.
  */
-static const double tetris_notes[TETRIS_LENGTH] = {
-    MI5, SI4, DO5, RE5, DO5, SI4, LA4, LA4, DO5, MI5, RE5, DO5, SI4, DO5, RE5, MI5, DO5, LA4,
-    LA4, LA4, SI4, DO5, RE5, FA4, LA5, SOL5, FA5, MI5, DO5, MI5, RE5, DO5, SI4, SI4, LA4, RE5,
-    MI5, DO5, LA4, LA4};
-
-/** 
- * @brief Tetris melody durations in miliseconds.
- *
- * This array contains the duration of each note in the Tetris song.
- * The durations are defined in milliseconds, and they are arranged in the order they are played in the song.
- */
-static const uint16_t tetris_durations[TETRIS_LENGTH] = {
-    400, 200, 200, 400, 200, 200, 400, 200, 200, 400, 200, 200, 600, 200, 400, 400, 400, 400, 200, 200, 200, 200,
-    600, 200, 400, 200, 200, 600, 200, 400, 200, 200, 400, 200, 200, 400, 400, 400, 400, 400};
+static const melody_event_t tetris_events[TETRIS_LENGTH] = {
+    MELODY_EVENT(MI5, 400), MELODY_EVENT(SI4, 200), MELODY_EVENT(DO5, 200), MELODY_EVENT(RE5, 400),
+    MELODY_EVENT(DO5, 200), MELODY_EVENT(SI4, 200), MELODY_EVENT(LA4, 400), MELODY_EVENT(LA4, 200),
+    MELODY_EVENT(DO5, 200), MELODY_EVENT(MI5, 400), MELODY_EVENT(RE5, 200), MELODY_EVENT(DO5, 200),
+    MELODY_EVENT(SI4, 600), MELODY_EVENT(DO5, 200), MELODY_EVENT(RE5, 400), MELODY_EVENT(MI5, 400),
+    MELODY_EVENT(DO5, 400), MELODY_EVENT(LA4, 400), MELODY_EVENT(LA4, 200), MELODY_EVENT(LA4, 200),
+    MELODY_EVENT(SI4, 200), MELODY_EVENT(DO5, 200), MELODY_EVENT(RE5, 600), MELODY_EVENT(FA4, 200),
+    MELODY_EVENT(LA5, 400), MELODY_EVENT(SOL5, 200), MELODY_EVENT(FA5, 200), MELODY_EVENT(MI5, 600),
+    MELODY_EVENT(DO5, 200), MELODY_EVENT(MI5, 400), MELODY_EVENT(RE5, 200), MELODY_EVENT(DO5, 200),
+    MELODY_EVENT(SI4, 400), MELODY_EVENT(SI4, 200), MELODY_EVENT(LA4, 200), MELODY_EVENT(RE5, 400),
+    MELODY_EVENT(MI5, 400), MELODY_EVENT(DO5, 400), MELODY_EVENT(LA4, 400), MELODY_EVENT(LA4, 400)};
 
 /**
  * @brief Tetris melody struct.
- * 
+ *
  * This struct contains the information of the Tetris melody.
  * It is used to play the melody using the buzzer.
  */
 const melody_t tetris_melody = {.p_name = "tetris",
-                                .p_notes = (double *)tetris_notes,
-                                .p_durations = (uint16_t *)tetris_durations,
+                                .p_events = tetris_events,
                                 .melody_length = TETRIS_LENGTH};
 
 // Scale Melody
-#define SCALE_MELODY_LENGTH 8   /*!< Scale melody length */
+#define SCALE_MELODY_LENGTH 8 /*!< Scale melody length */
 
 /**
- * @brief Scale melody notes.
+ * @brief Scale melody events.
  *
- * This array contains the frequencies of the notes for the scale song.
- * The notes are defined as frequency values in Hertz, and they are arranged in the order they are played in the song.
+ * This array contains the packed events of the Scale song: MIDI note number and duration in milliseconds.
+ * The events are arranged in the order they are played in the song.
  */
-static const double scale_melody_notes[SCALE_MELODY_LENGTH] = {
-    DO4, RE4, MI4, FA4, SOL4, LA4, SI4, DO5};
-
-/**
- * @brief Scale melody durations in miliseconds.
- * 
- * This array contains the duration of each note in the scale song.
- * The durations are defined in milliseconds, and they are arranged in the order they are played in the song.
- */
-static const uint16_t scale_melody_durations[SCALE_MELODY_LENGTH] = {
-    250, 250, 250, 250, 250, 250, 250, 250};
+static const melody_event_t scale_melody_events[SCALE_MELODY_LENGTH] = {
+    MELODY_EVENT(DO4, 250), MELODY_EVENT(RE4, 250), MELODY_EVENT(MI4, 250), MELODY_EVENT(FA4, 250),
+    MELODY_EVENT(SOL4, 250), MELODY_EVENT(LA4, 250), MELODY_EVENT(SI4, 250), MELODY_EVENT(DO5, 250)};
 
 /**
  * @brief Scale melody struct.
- * 
- * This struct contains the information of the scale melody.
+ *
+ * This struct contains the information of the Scale melody.
  * It is used to play the melody using the buzzer.
  */
 const melody_t scale_melody = {.p_name = "scale",
-                               .p_notes = (double *)scale_melody_notes,
-                               .p_durations = (uint16_t *)scale_melody_durations,
+                               .p_events = scale_melody_events,
                                .melody_length = SCALE_MELODY_LENGTH};
 
-// Melodies ------------------------------------------------------------------/
 // Himno del Real Madrid
-#define HIMNO_MADRID_LENGTH 26
+#define HIMNO_MADRID_LENGTH 26 /*!< Himno del Real Madrid melody length */
 
 /**
+ * @brief Himno del Real Madrid melody events.
+ *
+ * This array contains the packed events of the Himno del Real Madrid song: MIDI note number and duration in milliseconds.
+ * The events are arranged in the order they are played in the song.
+ */
+static const melody_event_t himno_madrid_events[HIMNO_MADRID_LENGTH] = {
+    MELODY_EVENT(MI4, 400), MELODY_EVENT(SOL4, 400), MELODY_EVENT(LA4, 800), MELODY_EVENT(LA4, 400),
+    MELODY_EVENT(SOL4, 400), MELODY_EVENT(FA4, 800), MELODY_EVENT(MI4, 400), MELODY_EVENT(RE4, 400),
+    MELODY_EVENT(RE4, 800), MELODY_EVENT(RE4, 400), MELODY_EVENT(MI4, 400), MELODY_EVENT(FA4, 400),
+    MELODY_EVENT(SOL4, 800), MELODY_EVENT(MI4, 400), MELODY_EVENT(DO4, 400), MELODY_EVENT(RE4, 400),
+    MELODY_EVENT(MI4, 800), MELODY_EVENT(MI4, 400), MELODY_EVENT(RE4, 400), MELODY_EVENT(DO4, 800),
+    MELODY_EVENT(SI3, 400), MELODY_EVENT(RE4, 400), MELODY_EVENT(MI4, 800), MELODY_EVENT(FA4, 400),
+    MELODY_EVENT(MI4, 400), MELODY_EVENT(DO4, 800)};
 
-@brief Himno del Real Madrid melody notes.
-This array contains the frequencies of the notes for the Himno del Real Madrid song.
-The notes are defined as frequency values in Hertz, and they are arranged in the order they are played in the song.
-*/
-static const double himno_madrid_notes[HIMNO_MADRID_LENGTH] = {
-MI4, SOL4, LA4, LA4, SOL4, FA4, MI4, RE4, RE4, RE4, MI4, FA4, SOL4, MI4, DO4, RE4, MI4, MI4, RE4, DO4, SI3, RE4, MI4, FA4, MI4, DO4};
-/**
-
-@brief Himno del Real Madrid melody durations in miliseconds.
-This array contains the duration of each note in the Himno del Real Madrid song.
-The durations are defined in milliseconds, and they are arranged in the order they are played in the song.
-*/
-static const uint16_t himno_madrid_durations[HIMNO_MADRID_LENGTH] = {
-400, 400, 800, 400, 400, 800, 400, 400, 800, 400, 400, 400, 800, 400, 400, 400, 800, 400, 400, 800, 400, 400, 800, 400, 400, 800};
 /**
-
-@brief Himno del Real Madrid melody struct.
-This struct contains the information of the Himno del Real Madrid melody.
-It is used to play the melody using the buzzer.
-*/
+ * @brief Himno del Real Madrid melody struct.
+ *
+ * This struct contains the information of the Himno del Real Madrid melody.
+ * It is used to play the melody using the buzzer.
+ */
 const melody_t himno_madrid_melody = {.p_name = "himno_madrid",
-.p_notes = (double *)himno_madrid_notes,
-.p_durations = (uint16_t *)himno_madrid_durations,
-.melody_length = HIMNO_MADRID_LENGTH};
-/* Melodies ------------------------------------------------------------------*/
+                                      .p_events = himno_madrid_events,
+                                      .melody_length = HIMNO_MADRID_LENGTH};
+
 // Windows Shutdown melody
 #define WINDOWS_SHUTDOWN_LENGTH 14 /*!< Windows Shutdown melody length */
 
 /**
- * @brief Windows Shutdown melody notes.
- *
- * This array contains the frequencies of the notes for the Windows Shutdown sound.
- * The notes are defined as frequency values in Hertz, and they are arranged in the order they are played in the song.
- */
-static const double windows_shutdown_notes[WINDOWS_SHUTDOWN_LENGTH] = {
-    SOL4, MI4, DO4, RE4, DO4, SOL4, MI4, DO4, RE4, DO4, SOL4, MI4, DO4};
-
-/**
- * @brief Windows Shutdown melody durations in miliseconds.
+ * @brief Windows Shutdown melody events.
  *
- * This array contains the duration of each note in the Windows Shutdown sound.
- * The durations are defined in milliseconds, and they are arranged in the order they are played in the song.
+ * This array contains the packed events of the Windows Shutdown sound: MIDI note number and duration in milliseconds.
+ * The events are arranged in the order they are played in the sound.
  */
-static const uint16_t windows_shutdown_durations[WINDOWS_SHUTDOWN_LENGTH] = {
-    400, 400, 400, 400, 800, 400, 400, 400, 400, 800, 400, 400, 800};
+static const melody_event_t windows_shutdown_events[WINDOWS_SHUTDOWN_LENGTH] = {
+    MELODY_EVENT(SOL4, 400), MELODY_EVENT(MI4, 400), MELODY_EVENT(DO4, 400), MELODY_EVENT(RE4, 400),
+    MELODY_EVENT(DO4, 800), MELODY_EVENT(SOL4, 400), MELODY_EVENT(MI4, 400), MELODY_EVENT(DO4, 400),
+    MELODY_EVENT(RE4, 400), MELODY_EVENT(DO4, 800), MELODY_EVENT(SOL4, 400), MELODY_EVENT(MI4, 400),
+    MELODY_EVENT(DO4, 800)};
 
 /**
  * @brief Windows Shutdown melody struct.
@@ -167,6 +150,16 @@ static const uint16_t windows_shutdown_durations[WINDOWS_SHUTDOWN_LENGTH] = {
  * It is used to play the melody using the buzzer.
  */
 const melody_t windows_shutdown_melody = {.p_name = "windows_shutdown",
-                                          .p_notes = (double *)windows_shutdown_notes,
-                                          .p_durations = (uint16_t *)windows_shutdown_durations,
-                                          .melody_length = WINDOWS_SHUTDOWN_LENGTH};
\ No newline at end of file
+                                          .p_events = windows_shutdown_events,
+                                          .melody_length = WINDOWS_SHUTDOWN_LENGTH};
+
+/* Public functions ----------------------------------------------------------*/
+uint32_t melody_get_note_mhz(uint8_t note)
+{
+    if ((note == MIDI_SILENCE) || (note > MIDI_MAX_NOTE))
+    {
+        return 0;
+    }
+    uint32_t shift = _MELODY_OCTAVE_SHIFT(note);
+    return (octave9_mhz[note % 12U] + ((1U << shift) >> 1)) >> shift;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file melody_poly.c
+ * @brief Merge of the voices of a melody into a stream of chords.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "melody_poly.h"
+
+/* Melodies ------------------------------------------------------------------*/
+#define TETRIS_BASS_LENGTH 31 /*!< Tetris bass line length */
+
+/**
+ * @brief Bass line of the Tetris melody: root and fifth of each chord, in quarter notes.
+ */
+static const melody_event_t tetris_bass_events[TETRIS_BASS_LENGTH] = {
+    MELODY_EVENT(MI3, 400), MELODY_EVENT(SI3, 400), MELODY_EVENT(MI3, 400), MELODY_EVENT(SI3, 400),
+    MELODY_EVENT(LA3, 400), MELODY_EVENT(MI3, 400), MELODY_EVENT(LA3, 400), MELODY_EVENT(MI3, 400),
+    MELODY_EVENT(MI3, 400), MELODY_EVENT(SI3, 400), MELODY_EVENT(MI3, 400), MELODY_EVENT(SI3, 400),
+    MELODY_EVENT(LA3, 400), MELODY_EVENT(MI3, 400), MELODY_EVENT(LA3, 400), MELODY_EVENT(LA3, 400),
+    MELODY_EVENT(RE3, 400), MELODY_EVENT(LA3, 400), MELODY_EVENT(RE3, 400), MELODY_EVENT(LA3, 400),
+    MELODY_EVENT(DO3, 400), MELODY_EVENT(SOL3, 400), MELODY_EVENT(DO3, 400), MELODY_EVENT(SOL3, 400),
+    MELODY_EVENT(MI3, 400), MELODY_EVENT(SI3, 400), MELODY_EVENT(MI3, 400), MELODY_EVENT(SI3, 400),
+    MELODY_EVENT(LA3, 400), MELODY_EVENT(MI3, 400), MELODY_EVENT(LA3, 400)};
+
+static const melody_t tetris_bass_melody = {.p_name = "tetris bass",
+                                            .p_events = tetris_bass_events,
+                                            .melody_length = TETRIS_BASS_LENGTH};
+
+const melody_poly_t tetris_poly_melody = {.p_name = "tetris2",
+                                          .p_voices = {&tetris_melody, &tetris_bass_melody},
+                                          .num_voices = 2};
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Load the time left of the current event of a voice. Events of zero duration are skipped.
+ *
+ * @param p_cursor Pointer to the cursor
+ * @param voice Index of the voice
+ */
+static void _load_event(melody_poly_cursor_t *p_cursor, uint32_t voice)
+{
+    const melody_t *p_melody = p_cursor->p_poly->p_voices[voice];
+    p_cursor->remaining_ms[voice] = 0;
+    while (p_cursor->index[voice] < p_melody->melody_length)
+    {
+        p_cursor->remaining_ms[voice] = MELODY_EVENT_DURATION_MS(&p_melody->p_events[p_cursor->index[voice]]);
+        if (p_cursor->remaining_ms[voice] > 0)
+        {
+            return;
+        }
+        p_cursor->index[voice]++;
+    }
+}
+
+/* Public functions ----------------------------------------------------------*/
+void melody_poly_rewind(melody_poly_cursor_t *p_cursor, const melody_poly_t *p_poly)
+{
+    memset(p_cursor, 0, sizeof(melody_poly_cursor_t));
+    p_cursor->p_poly = p_poly;
+    if (p_poly == NULL)
+    {
+        return;
+    }
+    for (uint32_t v = 0; v < p_poly->num_voices; v++)
+    {
+        _load_event(p_cursor, v);
+    }
+    p_cursor->starting = (uint8_t)((1U << p_poly->num_voices) - 1U);
+}
+
+bool melody_poly_has_next(const melody_poly_cursor_t *p_cursor)
+{
+    if (p_cursor->p_poly == NULL)
+    {
+        return false;
+    }
+    for (uint32_t v = 0; v < p_cursor->p_poly->num_voices; v++)
+    {
+        if (p_cursor->remaining_ms[v] > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool melody_poly_next(melody_poly_cursor_t *p_cursor, melody_frame_t *p_frame)
+{
+    if (!melody_poly_has_next(p_cursor))
+    {
+        return false;
+    }
+    const melody_poly_t *p_poly = p_cursor->p_poly;
+
+    /* The frame ends when the first of the current notes ends */
+    uint32_t duration_ms = UINT32_MAX;
+    for (uint32_t v = 0; v < p_poly->num_voices; v++)
+    {
+        if ((p_cursor->remaining_ms[v] > 0) && (p_cursor->remaining_ms[v] < duration_ms))
+        {
+            duration_ms = p_cursor->remaining_ms[v];
+        }
+    }
+
+    p_frame->num_voices = p_poly->num_voices;
+    p_frame->onsets = p_cursor->starting;
+    p_frame->duration_ms = duration_ms;
+    p_cursor->starting = 0;
+    for (uint32_t v = 0; v < p_poly->num_voices; v++)
+    {
+        if (p_cursor->remaining_ms[v] == 0)
+        {
+            p_frame->notes[v] = MIDI_SILENCE;
+            continue;
+        }
+        p_frame->notes[v] = p_poly->p_voices[v]->p_events[p_cursor->index[v]].note;
+        p_cursor->remaining_ms[v] -= duration_ms;
+        if (p_cursor->remaining_ms[v] == 0)
+        {
+            p_cursor->index[v]++;
+            _load_event(p_cursor, v);
+            p_cursor->starting |= (uint8_t)(1U << v);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file melody_stream.c
+ * @brief Double-buffered streaming of melody events from a source.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "melody_stream.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define UPLOAD_MASK (MELODY_STREAM_UPLOAD_EVENTS - 1U) /*!< Mask to wrap the indexes of the FIFO of an upload source */
+#define HEX_DIGITS_PER_EVENT 4U                       /*!< Hexadecimal digits of an uploaded event */
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Read the next chunk of the source into the back buffer.
+ *
+ * @param p_stream Pointer to the stream
+ */
+static void _load_back(melody_stream_t *p_stream)
+{
+    uint8_t back = p_stream->front ^ 1U;
+    uint32_t length = p_stream->read(p_stream->p_source, p_stream->read_offset, p_stream->chunks[back], MELODY_STREAM_CHUNK_EVENTS);
+    if (length == 0)
+    {
+        p_stream->source_end = true;
+        return;
+    }
+    p_stream->chunk_length[back] = (uint16_t)length;
+    p_stream->read_offset += length;
+    p_stream->chunks_loaded++;
+    p_stream->back_ready = true;
+}
+
+/**
+ * @brief Value of a hexadecimal digit.
+ *
+ * @param c Character
+ * @return int Value of the digit, or -1 if it is not a hexadecimal digit
+ */
+static int _hex_value(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/* Public functions ----------------------------------------------------------*/
+void melody_stream_open(melody_stream_t *p_stream, melody_stream_read_t read, void *p_source)
+{
+    memset(p_stream, 0, sizeof(melody_stream_t));
+    p_stream->read = read;
+    p_stream->p_source = p_source;
+
+    /* The first chunk is read into the back buffer and swapped in by the first melody_stream_next() */
+    _load_back(p_stream);
+}
+
+void melody_stream_rewind(melody_stream_t *p_stream)
+{
+    if (p_stream->position > 0)
+    {
+        /* The counters are kept: they describe the whole life of the stream */
+        uint32_t chunks_loaded = p_stream->chunks_loaded;
+        uint32_t underruns = p_stream->underruns;
+        melody_stream_open(p_stream, p_stream->read, p_stream->p_source);
+        p_stream->chunks_loaded += chunks_loaded;
+        p_stream->underruns = underruns;
+    }
+}
+
+bool melody_stream_has_next(melody_stream_t *p_stream)
+{
+    if (p_stream->index < p_stream->chunk_length[p_stream->front])
+    {
+        return true;
+    }
+    if (!p_stream->back_ready && !p_stream->source_end)
+    {
+        /* The next chunk has not been prefetched: read it now */
+        _load_back(p_stream);
+        p_stream->underruns += p_stream->back_ready ? 1U : 0U;
+    }
+    return p_stream->back_ready;
+}
+
+bool melody_stream_next(melody_stream_t *p_stream, melody_event_t *p_event)
+{
+    if (!melody_stream_has_next(p_stream))
+    {
+        return false;
+    }
+    if (p_stream->index >= p_stream->chunk_length[p_stream->front])
+    {
+        /* Swap the buffers: the prefetched chunk is played and the old one is free for the next prefetch */
+        p_stream->chunk_length[p_stream->front] = 0;
+        p_stream->front ^= 1U;
+        p_stream->index = 0;
+        p_stream->back_ready = false;
+    }
+    *p_event = p_stream->chunks[p_stream->front][p_stream->index];
+    p_stream->index++;
+    p_stream->position++;
+    return true;
+}
+
+bool melody_stream_prefetch(melody_stream_t *p_stream)
+{
+    if (p_stream->back_ready || p_stream->source_end)
+    {
+        return false;
+    }
+    _load_back(p_stream);
+    return p_stream->back_ready;
+}
+
+uint32_t melody_stream_read_blob(void *p_source, uint32_t offset, melody_event_t *p_events, uint32_t max_events)
+{
+    const melody_stream_blob_t *p_blob = (const melody_stream_blob_t *)p_source;
+    uint32_t num_events = p_blob->size / sizeof(melody_event_t);
+    if (offset >= num_events)
+    {
+        return 0;
+    }
+    uint32_t count = ((num_events - offset) < max_events) ? (num_events - offset) : max_events;
+    const uint8_t *p_data = &p_blob->p_data[offset * sizeof(melody_event_t)];
+    for (uint32_t i = 0; i < count; i++)
+    {
+        p_events[i].note = p_data[2U * i];
+        p_events[i].duration = p_data[2U * i + 1U];
+    }
+    return count;
+}
+
+void melody_stream_upload_init(melody_stream_upload_t *p_upload)
+{
+    memset(p_upload, 0, sizeof(melody_stream_upload_t));
+}
+
+bool melody_stream_upload_put_hex(melody_stream_upload_t *p_upload, const char *p_hex, uint32_t length)
+{
+    uint32_t num_events = length / HEX_DIGITS_PER_EVENT;
+    if ((length == 0) || ((length % HEX_DIGITS_PER_EVENT) != 0) || p_upload->closed)
+    {
+        return false;
+    }
+    if ((p_upload->head - p_upload->tail) + num_events > MELODY_STREAM_UPLOAD_EVENTS)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (_hex_value(p_hex[i]) < 0)
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < num_events; i++)
+    {
+        const char *p_digits = &p_hex[i * HEX_DIGITS_PER_EVENT];
+        melody_event_t *p_event = &p_upload->events[(p_upload->head + i) & UPLOAD_MASK];
+        p_event->note = (uint8_t)((_hex_value(p_digits[0]) << 4) | _hex_value(p_digits[1]));
+        p_event->duration = (uint8_t)((_hex_value(p_digits[2]) << 4) | _hex_value(p_digits[3]));
+    }
+    p_upload->head += num_events;
+    return true;
+}
+
+void melody_stream_upload_close(melody_stream_upload_t *p_upload)
+{
+    p_upload->closed = true;
+}
+
+uint32_t melody_stream_read_upload(void *p_source, uint32_t offset, melody_event_t *p_events, uint32_t max_events)
+{
+    melody_stream_upload_t *p_upload = (melody_stream_upload_t *)p_source;
+    uint32_t available = p_upload->head - p_upload->tail;
+    if (available == 0)
+    {
+        if (p_upload->closed)
+        {
+            return 0;
+        }
+        p_upload->waits++;
+        p_events[0] = (melody_event_t)MELODY_EVENT(SILENCE, MELODY_STREAM_WAIT_MS);
+        return 1;
+    }
+    uint32_t count = (available < max_events) ? available : max_events;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        p_events[i] = p_upload->events[(p_upload->tail + i) & UPLOAD_MASK];
+    }
+    p_upload->tail += count;
+    return count;
+}
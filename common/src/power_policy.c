@@ -0,0 +1,93 @@
+/**
+ * @file power_policy.c
+ * @brief Power policy of the main loop: Stop mode in standby, tickless Sleep mode otherwise.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <stdio.h>
+#include <string.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_usart.h"
+
+/* Other libraries */
+#include "power_policy.h"
+#include "tickless.h"
+
+/* Global variables */
+static fsm_t *p_fsm_policy = NULL;                                  /*!< FSM that decides when Stop mode is allowed */
+static power_policy_check_t stop_allowed = NULL;                    /*!< Function that checks if the FSM allows Stop mode */
+static uint32_t usart_id = 0;                                       /*!< USART whose RX pin wakes up the core */
+static uint64_t init_ms = 0;                                        /*!< System tick (64 bits) at the initialization */
+static power_policy_residency_t residency[POWER_POLICY_NUM_STATES]; /*!< Residency of the low power states */
+
+/* Public functions ----------------------------------------------------------*/
+void power_policy_init(fsm_t *p_fsm, power_policy_check_t check_stop, uint32_t wakeup_usart_id)
+{
+    p_fsm_policy = p_fsm;
+    stop_allowed = check_stop;
+    usart_id = wakeup_usart_id;
+    init_ms = port_system_get_millis64();
+    memset(residency, 0, sizeof(residency));
+}
+
+uint8_t power_policy_select(void)
+{
+    /* A timeout pending needs the tick, that does not run in Stop mode */
+    if ((stop_allowed != NULL) && stop_allowed(p_fsm_policy) && (tickless_get_sleep_ms() == TICKLESS_MAX_SLEEP_MS))
+    {
+        return POWER_POLICY_STOP;
+    }
+    return POWER_POLICY_SLEEP;
+}
+
+void power_policy_idle(void)
+{
+    /* If the RX pin of the USART cannot wake up the core, Stop mode would not hear the commands: sleep with the tick */
+    if ((power_policy_select() == POWER_POLICY_STOP) && port_usart_set_rx_wakeup(usart_id, true))
+    {
+        uint32_t slept_ms = port_system_stop_sleep();
+        port_usart_set_rx_wakeup(usart_id, false);
+        residency[POWER_POLICY_STOP].entries++;
+        residency[POWER_POLICY_STOP].residency_ms += slept_ms;
+        return;
+    }
+
+    tickless_stats_t before;
+    tickless_stats_t after;
+    tickless_get_stats(&before);
+    tickless_idle();
+    tickless_get_stats(&after);
+    residency[POWER_POLICY_SLEEP].entries += after.sleeps - before.sleeps;
+    residency[POWER_POLICY_SLEEP].residency_ms += after.slept_ms - before.slept_ms;
+}
+
+void power_policy_get_residency(power_policy_residency_t *p_residency)
+{
+    /* The core runs between the sleeps: once at the start and once after each wake-up */
+    uint64_t elapsed_ms = port_system_get_millis64() - init_ms;
+    p_residency[POWER_POLICY_SLEEP] = residency[POWER_POLICY_SLEEP];
+    p_residency[POWER_POLICY_STOP] = residency[POWER_POLICY_STOP];
+    p_residency[POWER_POLICY_RUN].entries = 1 + residency[POWER_POLICY_SLEEP].entries + residency[POWER_POLICY_STOP].entries;
+    p_residency[POWER_POLICY_RUN].residency_ms = elapsed_ms - residency[POWER_POLICY_SLEEP].residency_ms - residency[POWER_POLICY_STOP].residency_ms;
+}
+
+uint32_t power_policy_format(char *p_buffer, uint32_t length)
+{
+    power_policy_residency_t r[POWER_POLICY_NUM_STATES];
+    power_policy_get_residency(r);
+    int written = snprintf(p_buffer, length, "Power: run %llu ms, sleep %llu ms (%lu), stop %llu ms (%lu)\n",
+                           (unsigned long long)r[POWER_POLICY_RUN].residency_ms,
+                           (unsigned long long)r[POWER_POLICY_SLEEP].residency_ms, (unsigned long)r[POWER_POLICY_SLEEP].entries,
+                           (unsigned long long)r[POWER_POLICY_STOP].residency_ms, (unsigned long)r[POWER_POLICY_STOP].entries);
+    if ((written < 0) || (length == 0))
+    {
+        return 0;
+    }
+    return ((uint32_t)written < length) ? (uint32_t)written : length - 1;
+}
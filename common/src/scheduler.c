@@ -0,0 +1,118 @@
+/**
+ * @file scheduler.c
+ * @brief Event-driven scheduler of the FSMs of the system.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "scheduler.h"
+#include "port_system.h"
+#include "fsm_profile.h"
+#include "fsm_index.h"
+
+/* Typedefs ------------------------------------------------------------------*/
+/**
+ * @brief FSM subscribed to the scheduler.
+ */
+typedef struct
+{
+    fsm_t *p_fsm;    /*!< Pointer to the FSM */
+    uint32_t events; /*!< Mask of events that make the FSM be fired */
+} scheduler_task_t;
+
+/* Global variables */
+static scheduler_task_t tasks[SCHEDULER_MAX_TASKS]; /*!< FSMs subscribed, in order of subscription */
+static uint32_t num_tasks = 0;                      /*!< Number of FSMs subscribed */
+static scheduler_stats_t stats;                     /*!< Counters of the scheduler */
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Count the number of bits set in a mask of events.
+ *
+ * @param events Mask of events
+ * @return uint32_t Number of events
+ */
+static uint32_t _count_events(uint32_t events)
+{
+    uint32_t count = 0;
+    while (events)
+    {
+        events &= events - 1;
+        count++;
+    }
+    return count;
+}
+
+/* Public functions ----------------------------------------------------------*/
+void scheduler_init(void)
+{
+    memset(tasks, 0, sizeof(tasks));
+    num_tasks = 0;
+    scheduler_reset_stats();
+}
+
+bool scheduler_subscribe(fsm_t *p_fsm, uint32_t events)
+{
+    if (num_tasks >= SCHEDULER_MAX_TASKS)
+    {
+        return false;
+    }
+    tasks[num_tasks].p_fsm = p_fsm;
+    tasks[num_tasks].events = events;
+    fsm_index_build(p_fsm->p_tt);
+    num_tasks++;
+    return true;
+}
+
+bool scheduler_dispatch(void)
+{
+    stats.iterations++;
+    uint32_t events = port_system_take_events();
+    if (events == 0)
+    {
+        stats.idle_iterations++;
+        return false;
+    }
+    stats.events += _count_events(events);
+
+    uint32_t start = port_system_get_cycles();
+    bool state_changed = false;
+    for (uint32_t i = 0; i < num_tasks; i++)
+    {
+        if (tasks[i].events & events)
+        {
+            int state = fsm_get_state(tasks[i].p_fsm);
+            const fsm_trans_t *p_t = fsm_profile_fire(tasks[i].p_fsm);
+            stats.fires++;
+            /* An action may have changed the inputs of other FSMs (e.g. the jukebox sets the action of the buzzer)
+             * without changing the state, and with tickless idle there is no periodic tick to evaluate them */
+            if ((fsm_get_state(tasks[i].p_fsm) != state) || ((p_t != NULL) && (p_t->out != NULL)))
+            {
+                state_changed = true;
+            }
+        }
+    }
+    stats.active_cycles += port_system_get_cycles() - start;
+
+    if (state_changed)
+    {
+        port_system_post_event(SCHEDULER_EVENT_STATE_CHANGE);
+    }
+    return true;
+}
+
+void scheduler_get_stats(scheduler_stats_t *p_stats)
+{
+    *p_stats = stats;
+}
+
+void scheduler_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
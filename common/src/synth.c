@@ -0,0 +1,444 @@
+/**
+ * @file synth.c
+ * @brief Software wavetable synthesizer with ADSR envelopes and a sequencer of melodies of several voices.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "synth.h"
+
+#if defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>
+#endif
+
+/* Defines ------------------------------------------------------------------*/
+#define SYNTH_FRAC_BITS 15U                                            /*!< Bits of the interpolation weight between two samples of a table */
+#define SYNTH_FRAC_SHIFT (32U - SYNTH_TABLE_BITS - SYNTH_FRAC_BITS)    /*!< Shift of the phase to get the interpolation weight */
+#define SYNTH_FRAC_MASK ((1U << SYNTH_FRAC_BITS) - 1U)                 /*!< Mask of the interpolation weight */
+#define SYNTH_LEVEL_SHIFT 8U                                           /*!< Extra fractional bits of the envelope levels (Q23) */
+#define SYNTH_LEVEL_FULL ((int32_t)SYNTH_LEVEL_ONE << SYNTH_LEVEL_SHIFT) /*!< Full level of an envelope in Q23 */
+#define SYNTH_MS_PER_S 1000U                                           /*!< Milliseconds per second */
+
+/* Global variables ------------------------------------------------------------*/
+static int16_t tables[SYNTH_NUM_WAVES][SYNTH_TABLE_SIZE + 1U]; /*!< Wavetables, with the first sample repeated at the end */
+static synth_voice_t voices[SYNTH_NUM_VOICES];                 /*!< Voices of the synthesizer */
+static uint8_t voice_wave[SYNTH_NUM_VOICES];                   /*!< Waveform of the next note of each voice */
+static synth_adsr_t voice_adsr[SYNTH_NUM_VOICES];              /*!< Envelope of the next note of each voice */
+static uint32_t sample_rate = 16000U;                          /*!< Sample rate of the output in Hz */
+
+/**
+ * @brief Envelope of the voices if none is set: short attack, a decay to 60 % and a short release.
+ */
+static const synth_adsr_t default_adsr = {.attack_ms = 5, .decay_ms = 120, .sustain = 19660, .release_ms = 80};
+
+/**
+ * @brief Sequencer of the melodies of several voices.
+ */
+static struct
+{
+    melody_poly_cursor_t cursor; /*!< Position in the melody */
+    uint32_t speed;              /*!< Speed in Q16.16 */
+    uint64_t remainder;          /*!< Remainder of the division of the last frame into samples */
+    uint32_t frame_samples;      /*!< Samples left of the current frame */
+    bool playing;                /*!< The melody has frames left */
+    synth_stats_t stats;         /*!< Statistics */
+} sequencer;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Saturate a mix to a 16-bit sample.
+ *
+ * @param value Sum of the voices
+ * @return int32_t Value clamped to the range of int16_t
+ */
+static inline int32_t _saturate16(int32_t value)
+{
+#if defined(__ARM_FEATURE_DSP)
+    return __ssat(value, 16);
+#else
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return value;
+#endif
+}
+
+/**
+ * @brief Interpolate linearly between two consecutive samples of a table.
+ *
+ * The result is t0 * (1 - frac) + t1 * frac in Q15. On the Cortex-M4 both products and the sum are one `SMLAD` of the
+ * pair of samples (loaded as one word) and the pair of weights.
+ *
+ * @param p_sample Pointer to the first of the two samples
+ * @param frac Weight of the second sample in Q15
+ * @return int32_t Interpolated sample in Q15
+ */
+static inline int32_t _interpolate(const int16_t *p_sample, uint32_t frac)
+{
+#if defined(__ARM_FEATURE_DSP)
+    uint32_t pair;
+    memcpy(&pair, p_sample, sizeof(pair));
+    uint32_t weights = (frac << 16) | ((uint32_t)SYNTH_LEVEL_ONE - frac);
+    return __smlad(pair, weights, 0) >> SYNTH_FRAC_BITS;
+#else
+    return ((int32_t)p_sample[0] * (SYNTH_LEVEL_ONE - (int32_t)frac) + (int32_t)p_sample[1] * (int32_t)frac) >> SYNTH_FRAC_BITS;
+#endif
+}
+
+/**
+ * @brief Sine of a position in the table with Bhaskara's approximation, in integers (error below 0.2 %).
+ *
+ * For a position u in [0, 1) of the half cycle, sin(pi u) ~ 16 u (1 - u) / (5 - 4 u (1 - u)).
+ *
+ * @param index Index of the sample in the table
+ * @return int16_t Sample in Q15
+ */
+static int16_t _sine(uint32_t index)
+{
+    uint32_t half = SYNTH_TABLE_SIZE / 2U;
+    uint64_t u = ((uint64_t)(index % half) << 16) / half;  /* Q16 */
+    uint64_t v = (u * ((1U << 16) - u)) >> 16;               /* u (1 - u) in Q16 */
+    int32_t value = (int32_t)((16U * v * SYNTH_LEVEL_ONE) / ((5U << 16) - 4U * v));
+    return (int16_t)((index < half) ? value : -value);
+}
+
+/**
+ * @brief Fill the wavetables.
+ *
+ */
+static void _fill_tables(void)
+{
+    const int32_t size = (int32_t)SYNTH_TABLE_SIZE;
+    for (int32_t i = 0; i < size; i++)
+    {
+        int32_t triangle;
+        if (i < size / 4)
+        {
+            triangle = 4 * i * SYNTH_LEVEL_ONE / size;
+        }
+        else if (i < 3 * size / 4)
+        {
+            triangle = 2 * SYNTH_LEVEL_ONE - 4 * i * SYNTH_LEVEL_ONE / size;
+        }
+        else
+        {
+            triangle = 4 * i * SYNTH_LEVEL_ONE / size - 4 * SYNTH_LEVEL_ONE;
+        }
+        tables[SYNTH_WAVE_SINE][i] = _sine((uint32_t)i);
+        tables[SYNTH_WAVE_TRIANGLE][i] = (int16_t)triangle;
+        tables[SYNTH_WAVE_SAW][i] = (int16_t)(2 * i * SYNTH_LEVEL_ONE / size - SYNTH_LEVEL_ONE);
+        tables[SYNTH_WAVE_SQUARE][i] = (int16_t)((i < size / 2) ? SYNTH_LEVEL_ONE : -SYNTH_LEVEL_ONE);
+    }
+    for (uint32_t w = 0; w < SYNTH_NUM_WAVES; w++)
+    {
+        tables[w][SYNTH_TABLE_SIZE] = tables[w][0];
+    }
+}
+
+/**
+ * @brief Increment of an envelope level per sample to cover a range in some time.
+ *
+ * @param range Range of the level in Q23
+ * @param time_ms Time to cover the range. Zero covers it in one sample
+ * @return int32_t Increment per sample in Q23
+ */
+static int32_t _envelope_step(int32_t range, uint32_t time_ms)
+{
+    uint32_t samples = (time_ms * sample_rate) / SYNTH_MS_PER_S;
+    if (samples == 0)
+    {
+        samples = 1;
+    }
+    int32_t step = range / (int32_t)samples;
+    return (step > 0) ? step : 1;
+}
+
+/**
+ * @brief Advance the envelope of a voice some samples.
+ *
+ * The stage changes at the end of the block in which its level is reached, so the timing of the envelope has the
+ * resolution of a control block.
+ *
+ * @param p_voice Pointer to the voice
+ * @param num_samples Samples to advance
+ */
+static void _advance_envelope(synth_voice_t *p_voice, uint32_t num_samples)
+{
+    switch (p_voice->stage)
+    {
+    case SYNTH_STAGE_ATTACK:
+        p_voice->level += p_voice->attack_step * (int32_t)num_samples;
+        if (p_voice->level >= SYNTH_LEVEL_FULL)
+        {
+            p_voice->level = SYNTH_LEVEL_FULL;
+            p_voice->stage = SYNTH_STAGE_DECAY;
+        }
+        break;
+    case SYNTH_STAGE_DECAY:
+        p_voice->level -= p_voice->decay_step * (int32_t)num_samples;
+        if (p_voice->level <= p_voice->sustain)
+        {
+            p_voice->level = p_voice->sustain;
+            p_voice->stage = SYNTH_STAGE_SUSTAIN;
+        }
+        break;
+    case SYNTH_STAGE_RELEASE:
+        p_voice->level -= p_voice->release_step * (int32_t)num_samples;
+        if (p_voice->level <= 0)
+        {
+            p_voice->level = 0;
+            p_voice->stage = SYNTH_STAGE_IDLE;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Add the samples of a voice to the mix. This is the inner loop of the synthesizer.
+ *
+ * @param p_voice Pointer to the voice
+ * @param p_mix Pointer to the mix of the block
+ * @param num_samples Samples of the block
+ * @param gain Gain of the voice in Q15 during the block
+ */
+static void _mix_voice(synth_voice_t *p_voice, int32_t *p_mix, uint32_t num_samples, int32_t gain)
+{
+    const int16_t *p_table = p_voice->p_table;
+    uint32_t phase = p_voice->phase;
+    uint32_t increment = p_voice->increment;
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        int32_t sample = _interpolate(&p_table[phase >> (32U - SYNTH_TABLE_BITS)], (phase >> SYNTH_FRAC_SHIFT) & SYNTH_FRAC_MASK);
+        p_mix[i] += (sample * gain) >> SYNTH_FRAC_BITS;
+        phase += increment;
+    }
+    p_voice->phase = phase;
+}
+
+/**
+ * @brief Start the next frame of the melody: apply the notes that start in it and count its samples.
+ *
+ * The duration of the frame in samples is divided by the speed with the remainder carried to the next frame, so the
+ * position of each frame is the ideal one truncated to the sample. Frames shorter than one sample are skipped. At
+ * the end of the melody the sequencer stops and the voices are released.
+ *
+ */
+static void _next_frame(void)
+{
+    melody_frame_t frame;
+    while (sequencer.frame_samples == 0)
+    {
+        if (!melody_poly_next(&sequencer.cursor, &frame))
+        {
+            synth_stop();
+            return;
+        }
+        for (uint32_t v = 0; (v < frame.num_voices) && (v < SYNTH_NUM_VOICES); v++)
+        {
+            if (frame.onsets & (1U << v))
+            {
+                synth_note_on(v, frame.notes[v]);
+            }
+        }
+        uint64_t scaled = (((uint64_t)frame.duration_ms * sample_rate) << SYNTH_SPEED_SHIFT) + sequencer.remainder;
+        uint64_t divisor = (uint64_t)SYNTH_MS_PER_S * sequencer.speed;
+        sequencer.frame_samples = (uint32_t)(scaled / divisor);
+        sequencer.remainder = scaled % divisor;
+        sequencer.stats.frames++;
+    }
+}
+
+/**
+ * @brief Mix the next block of samples.
+ *
+ * @param p_mix Pointer where the mix of the block is stored
+ * @param max_samples Maximum samples of the block
+ * @return uint32_t Samples of the block, up to `SYNTH_BLOCK_SAMPLES` and never beyond the end of a frame
+ */
+static uint32_t _mix_block(int32_t *p_mix, uint32_t max_samples)
+{
+    if (sequencer.playing && (sequencer.frame_samples == 0))
+    {
+        _next_frame();
+    }
+    uint32_t num_samples = (max_samples < SYNTH_BLOCK_SAMPLES) ? max_samples : SYNTH_BLOCK_SAMPLES;
+    if (sequencer.playing && (num_samples > sequencer.frame_samples))
+    {
+        num_samples = sequencer.frame_samples;
+    }
+
+    memset(p_mix, 0, num_samples * sizeof(int32_t));
+    for (uint32_t v = 0; v < SYNTH_NUM_VOICES; v++)
+    {
+        synth_voice_t *p_voice = &voices[v];
+        if (p_voice->stage == SYNTH_STAGE_IDLE)
+        {
+            continue;
+        }
+        int32_t gain = ((p_voice->level >> SYNTH_LEVEL_SHIFT) * SYNTH_VOICE_GAIN) >> SYNTH_FRAC_BITS;
+        _mix_voice(p_voice, p_mix, num_samples, gain);
+        _advance_envelope(p_voice, num_samples);
+    }
+
+    if (sequencer.playing)
+    {
+        sequencer.frame_samples -= num_samples;
+    }
+    sequencer.stats.samples += num_samples;
+    sequencer.stats.blocks++;
+    return num_samples;
+}
+
+/* Public functions ----------------------------------------------------------*/
+void synth_init(uint32_t sample_rate_hz)
+{
+    sample_rate = sample_rate_hz;
+    _fill_tables();
+    memset(voices, 0, sizeof(voices));
+    memset(&sequencer, 0, sizeof(sequencer));
+    for (uint32_t v = 0; v < SYNTH_NUM_VOICES; v++)
+    {
+        synth_set_voice(v, (v == 0) ? SYNTH_WAVE_TRIANGLE : ((v == 1) ? SYNTH_WAVE_SAW : SYNTH_WAVE_SINE), NULL);
+        voices[v].p_table = tables[voice_wave[v]];
+    }
+}
+
+uint32_t synth_get_sample_rate(void)
+{
+    return sample_rate;
+}
+
+const int16_t *synth_get_table(uint32_t wave)
+{
+    return (wave < SYNTH_NUM_WAVES) ? tables[wave] : NULL;
+}
+
+void synth_set_voice(uint32_t voice, uint32_t wave, const synth_adsr_t *p_adsr)
+{
+    if ((voice >= SYNTH_NUM_VOICES) || (wave >= SYNTH_NUM_WAVES))
+    {
+        return;
+    }
+    voice_wave[voice] = (uint8_t)wave;
+    voice_adsr[voice] = (p_adsr != NULL) ? *p_adsr : default_adsr;
+}
+
+void synth_note_on(uint32_t voice, uint8_t note)
+{
+    if (voice >= SYNTH_NUM_VOICES)
+    {
+        return;
+    }
+    uint32_t frequency_mhz = melody_get_note_mhz(note);
+    if (frequency_mhz == 0)
+    {
+        synth_note_off(voice);
+        return;
+    }
+    synth_voice_t *p_voice = &voices[voice];
+    const synth_adsr_t *p_adsr = &voice_adsr[voice];
+    int32_t sustain = (int32_t)p_adsr->sustain << SYNTH_LEVEL_SHIFT;
+    p_voice->p_table = tables[voice_wave[voice]];
+    p_voice->increment = (uint32_t)(((uint64_t)frequency_mhz << 32) / ((uint64_t)sample_rate * SYNTH_MS_PER_S));
+    p_voice->sustain = (sustain < SYNTH_LEVEL_FULL) ? sustain : SYNTH_LEVEL_FULL;
+    p_voice->attack_step = _envelope_step(SYNTH_LEVEL_FULL, p_adsr->attack_ms);
+    p_voice->decay_step = _envelope_step(SYNTH_LEVEL_FULL - p_voice->sustain, p_adsr->decay_ms);
+    p_voice->release_step = _envelope_step(SYNTH_LEVEL_FULL, p_adsr->release_ms);
+    /* The attack starts from the current level and the phase is kept, so a new note does not click */
+    p_voice->stage = SYNTH_STAGE_ATTACK;
+}
+
+void synth_note_off(uint32_t voice)
+{
+    if ((voice < SYNTH_NUM_VOICES) && (voices[voice].stage != SYNTH_STAGE_IDLE))
+    {
+        voices[voice].stage = SYNTH_STAGE_RELEASE;
+    }
+}
+
+void synth_play(const melody_poly_t *p_poly, uint32_t speed)
+{
+    memset(&sequencer, 0, sizeof(sequencer));
+    melody_poly_rewind(&sequencer.cursor, p_poly);
+    sequencer.speed = (speed > 0) ? speed : SYNTH_SPEED_ONE;
+    sequencer.playing = melody_poly_has_next(&sequencer.cursor);
+}
+
+void synth_stop(void)
+{
+    sequencer.playing = false;
+    sequencer.frame_samples = 0;
+    for (uint32_t v = 0; v < SYNTH_NUM_VOICES; v++)
+    {
+        synth_note_off(v);
+    }
+}
+
+bool synth_is_playing(void)
+{
+    return sequencer.playing;
+}
+
+bool synth_is_active(void)
+{
+    if (sequencer.playing)
+    {
+        return true;
+    }
+    for (uint32_t v = 0; v < SYNTH_NUM_VOICES; v++)
+    {
+        if (voices[v].stage != SYNTH_STAGE_IDLE)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void synth_render(int16_t *p_samples, uint32_t num_samples)
+{
+    int32_t mix[SYNTH_BLOCK_SAMPLES];
+    while (num_samples > 0)
+    {
+        uint32_t block = _mix_block(mix, num_samples);
+        for (uint32_t i = 0; i < block; i++)
+        {
+            p_samples[i] = (int16_t)_saturate16(mix[i]);
+        }
+        p_samples += block;
+        num_samples -= block;
+    }
+}
+
+void synth_render_dac(uint16_t *p_codes, uint32_t num_samples)
+{
+    int32_t mix[SYNTH_BLOCK_SAMPLES];
+    while (num_samples > 0)
+    {
+        uint32_t block = _mix_block(mix, num_samples);
+        for (uint32_t i = 0; i < block; i++)
+        {
+            p_codes[i] = (uint16_t)((_saturate16(mix[i]) + 32768) >> (16U - SYNTH_DAC_BITS));
+        }
+        p_codes += block;
+        num_samples -= block;
+    }
+}
+
+void synth_get_stats(synth_stats_t *p_stats)
+{
+    *p_stats = sequencer.stats;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file tickless.c
+ * @brief Tickless idle of the main loop.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "tickless.h"
+#include "time_base.h"
+#include "port_system.h"
+
+/* Typedefs ------------------------------------------------------------------*/
+/**
+ * @brief FSM with timeouts.
+ */
+typedef struct
+{
+    fsm_t *p_fsm;                     /*!< FSM */
+    tickless_deadline_t get_deadline; /*!< Function that returns its next timeout */
+} tickless_task_t;
+
+/* Global variables */
+static tickless_task_t tasks[TICKLESS_MAX_FSMS];            /*!< Registered FSMs */
+static uint32_t num_tasks = 0;                              /*!< Number of registered FSMs */
+static tickless_stats_t stats;                              /*!< Counters of the tickless idle */
+static tickless_log_entry_t power_log[TICKLESS_LOG_LENGTH]; /*!< Last sleeps, circular */
+static uint32_t log_count = 0;                              /*!< Number of sleeps logged since the initialization */
+
+/* Public functions ----------------------------------------------------------*/
+void tickless_init(void)
+{
+    memset(tasks, 0, sizeof(tasks));
+    num_tasks = 0;
+    memset(&stats, 0, sizeof(stats));
+    log_count = 0;
+}
+
+bool tickless_register(fsm_t *p_fsm, tickless_deadline_t get_deadline)
+{
+    if (num_tasks >= TICKLESS_MAX_FSMS)
+    {
+        return false;
+    }
+    tasks[num_tasks].p_fsm = p_fsm;
+    tasks[num_tasks].get_deadline = get_deadline;
+    num_tasks++;
+    return true;
+}
+
+uint32_t tickless_get_sleep_ms(void)
+{
+    uint64_t now = port_system_get_millis64();
+    uint32_t sleep_ms = TICKLESS_MAX_SLEEP_MS;
+    for (uint32_t i = 0; i < num_tasks; i++)
+    {
+        uint64_t deadline;
+        if (tasks[i].get_deadline(tasks[i].p_fsm, &deadline))
+        {
+            uint64_t remaining = time_base_remaining(now, deadline);
+            if (remaining == 0)
+            {
+                return 0;
+            }
+            if (remaining < sleep_ms)
+            {
+                sleep_ms = (uint32_t)remaining;
+            }
+        }
+    }
+    return sleep_ms;
+}
+
+void tickless_idle(void)
+{
+    uint32_t sleep_ms = tickless_get_sleep_ms();
+    if (sleep_ms == 0)
+    {
+        stats.expired++;
+        port_system_post_event(PORT_SYSTEM_EVENT_TICK);
+        return;
+    }
+
+    uint32_t start_ms = port_system_get_millis();
+    uint32_t slept_ms = port_system_tickless_sleep(sleep_ms);
+
+    tickless_log_entry_t *p_entry = &power_log[log_count % TICKLESS_LOG_LENGTH];
+    p_entry->start_ms = start_ms;
+    p_entry->requested_ms = sleep_ms;
+    p_entry->slept_ms = slept_ms;
+    p_entry->timeout = (slept_ms >= sleep_ms);
+    log_count++;
+
+    stats.sleeps++;
+    stats.slept_ms += slept_ms;
+    if (p_entry->timeout)
+    {
+        stats.timeout_wakeups++;
+    }
+}
+
+void tickless_get_stats(tickless_stats_t *p_stats)
+{
+    *p_stats = stats;
+}
+
+uint32_t tickless_get_log(tickless_log_entry_t *p_log, uint32_t max_entries)
+{
+    uint32_t available = (log_count < TICKLESS_LOG_LENGTH) ? log_count : TICKLESS_LOG_LENGTH;
+    uint32_t num_entries = (available < max_entries) ? available : max_entries;
+    for (uint32_t i = 0; i < num_entries; i++)
+    {
+        p_log[i] = power_log[(log_count - num_entries + i) % TICKLESS_LOG_LENGTH];
+    }
+    return num_entries;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file time_base.c
+ * @brief Wrap-safe deadlines of the 64-bit time base and the 32-bit tick.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW dependent libraries */
+#include "port_system.h"
+
+/* Other libraries */
+#include "time_base.h"
+
+/* Public functions ----------------------------------------------------------*/
+uint64_t time_base_deadline_ms(uint32_t delay_ms)
+{
+    return port_system_get_millis64() + delay_ms;
+}
+
+bool time_base_reached(uint64_t now, uint64_t deadline)
+{
+    return now >= deadline;
+}
+
+uint64_t time_base_remaining(uint64_t now, uint64_t deadline)
+{
+    return (now >= deadline) ? 0 : deadline - now;
+}
+
+bool time_base_reached32(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+uint32_t time_base_remaining32(uint32_t now, uint32_t deadline)
+{
+    int32_t remaining = (int32_t)(deadline - now);
+    return (remaining > 0) ? (uint32_t)remaining : 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file tokenizer.c
+ * @brief Reentrant, allocation-free tokenizer of the commands received by the USART.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+
+/* Other libraries */
+#include "tokenizer.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define QUOTE_CHAR '"' /*!< Delimiter of the tokens with blanks */
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Check if a character separates tokens.
+ *
+ * @param c Character
+ * @return true if the character is a blank, false otherwise
+ */
+static bool _is_blank(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+/* Public functions ----------------------------------------------------------*/
+void tokenizer_init(tokenizer_t *p_tokenizer, const char *p_buffer, uint32_t max_length)
+{
+    const char *p_nul = memchr(p_buffer, '\0', max_length);
+    p_tokenizer->p_next = p_buffer;
+    p_tokenizer->p_end = (p_nul != NULL) ? p_nul : p_buffer + max_length;
+}
+
+bool tokenizer_next(tokenizer_t *p_tokenizer, token_t *p_token)
+{
+    const char *p = p_tokenizer->p_next;
+    const char *p_end = p_tokenizer->p_end;
+
+    while ((p < p_end) && _is_blank(*p))
+    {
+        p++;
+    }
+    if (p >= p_end)
+    {
+        p_tokenizer->p_next = p_end;
+        return false;
+    }
+
+    if (*p == QUOTE_CHAR)
+    {
+        /* Quoted token: up to the closing quote, or up to the end of the buffer if it is missing */
+        const char *p_start = ++p;
+        while ((p < p_end) && (*p != QUOTE_CHAR))
+        {
+            p++;
+        }
+        p_token->p_start = p_start;
+        p_token->length = (uint32_t)(p - p_start);
+        p_tokenizer->p_next = (p < p_end) ? p + 1 : p_end;
+        return true;
+    }
+
+    const char *p_start = p;
+    while ((p < p_end) && !_is_blank(*p))
+    {
+        p++;
+    }
+    p_token->p_start = p_start;
+    p_token->length = (uint32_t)(p - p_start);
+    p_tokenizer->p_next = p;
+    return true;
+}
+
+uint32_t tokenizer_split(const char *p_buffer, uint32_t max_length, token_t *p_tokens, uint32_t max_tokens)
+{
+    tokenizer_t tokenizer;
+    uint32_t num_tokens = 0;
+    tokenizer_init(&tokenizer, p_buffer, max_length);
+    while ((num_tokens < max_tokens) && tokenizer_next(&tokenizer, &p_tokens[num_tokens]))
+    {
+        num_tokens++;
+    }
+    return num_tokens;
+}
+
+bool tokenizer_equals(const token_t *p_token, const char *p_string)
+{
+    return (strncmp(p_token->p_start, p_string, p_token->length) == 0) && (p_string[p_token->length] == '\0');
+}
@@ -0,0 +1,72 @@
+/**
+ * @file usart_baud.c
+ * @brief Baud rate arithmetic of the USART: BRR with oversampling by 16 or 8, and autobaud detection.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "usart_baud.h"
+
+/* Defines ------------------------------------------------------------------*/
+#define PPM 1000000ULL /*!< Parts per million of a ratio */
+
+/* Global variables */
+static const uint32_t standard_rates[] = {1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600}; /*!< Standard baud rates */
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Difference between two rates relative to the second one.
+ *
+ * @param rate Rate obtained
+ * @param reference Reference rate
+ * @return uint32_t Difference in parts per million
+ */
+static uint32_t _error_ppm(uint64_t rate, uint64_t reference)
+{
+    uint64_t difference = (rate > reference) ? rate - reference : reference - rate;
+    return (uint32_t)((difference * PPM + reference / 2U) / reference);
+}
+
+/* Public functions ----------------------------------------------------------*/
+bool usart_baud_compute(uint32_t pclk_hz, uint32_t baudrate, usart_baud_t *p_baud)
+{
+    if ((baudrate < USART_BAUD_MIN) || (baudrate > USART_BAUD_MAX))
+    {
+        return false;
+    }
+
+    /* Divider in sixteenths (OVER8 = 0) or eighths (OVER8 = 1) of the USARTDIV of each mode: the same integer */
+    uint32_t divider = (pclk_hz + baudrate / 2U) / baudrate;
+    if (divider < 8U)
+    {
+        return false;
+    }
+    p_baud->over8 = (divider < 16U);
+    p_baud->brr = p_baud->over8 ? (((divider >> 3) << 4) | (divider & 0x7U)) : divider;
+    p_baud->actual = (pclk_hz + divider / 2U) / divider;
+    p_baud->error_ppm = _error_ppm(p_baud->actual, baudrate);
+    return p_baud->error_ppm <= USART_BAUD_MAX_ERROR_PPM;
+}
+
+uint32_t usart_baud_detect(uint32_t clock_hz, uint32_t start_bit_cycles)
+{
+    if (start_bit_cycles == 0)
+    {
+        return 0;
+    }
+    uint32_t measured = (uint32_t)(((uint64_t)clock_hz + start_bit_cycles / 2U) / start_bit_cycles);
+    uint32_t best = 0;
+    uint32_t best_error = USART_BAUD_DETECT_TOLERANCE_PPM + 1U;
+    for (uint32_t i = 0; i < sizeof(standard_rates) / sizeof(standard_rates[0]); i++)
+    {
+        uint32_t error = _error_ppm(measured, standard_rates[i]);
+        if (error < best_error)
+        {
+            best = standard_rates[i];
+            best_error = error;
+        }
+    }
+    return best;
+}
@@ -18,9 +18,18 @@
 #include "port_usart.h"
 #include "fsm_buzzer.h"
 #include "port_buzzer.h"
+#include "port_audio.h"
 #include "melodies.h"
 #include <string.h>
 #include "fsm_jukebox.h"
+#include "scheduler.h"
+#include "fsm_profile.h"
+#include "tickless.h"
+#include "power_policy.h"
+#include "log_ring.h"
+#if FSM_PROFILE
+#include <stdlib.h> // atexit
+#endif
 
 /* Defines ------------------------------------------------------------------*/
 #define 	ON_OFF_PRESS_TIME_MS 1500
@@ -34,20 +43,49 @@ int main(void)
 {
     /* Init board */
     port_system_init(); //Inicializa el sitema
+    log_ring_init(); //Log diferido: las FSMs escriben registros binarios y el bucle principal los expande en reposo
     //Creamos las maquinas de estados
     fsm_t * p_fsm_user_button = fsm_button_new(BUTTON_0_ID); 
     fsm_t *p_fsm_usart = fsm_usart_new(USART_0_ID);
     fsm_t *p_fsm_buzzer = fsm_buzzer_new(BUZZER_0_ID);
+    port_audio_init(); //DAC y DMA del sintetizador (comando "synth")
     fsm_t *p_fsm_jukebox = fsm_jukebox_new(p_fsm_user_button,ON_OFF_PRESS_TIME_MS,p_fsm_usart,p_fsm_buzzer,NEXT_SONG_BUTTON_TIME_MS);
 
+    //Suscribimos cada maquina de estados a los eventos que pueden hacerla cambiar
+    scheduler_init();
+    scheduler_subscribe(p_fsm_user_button, PORT_SYSTEM_EVENT_BUTTON | PORT_SYSTEM_EVENT_TICK);
+    scheduler_subscribe(p_fsm_usart, PORT_SYSTEM_EVENT_USART | PORT_SYSTEM_EVENT_TICK | SCHEDULER_EVENT_STATE_CHANGE);
+    scheduler_subscribe(p_fsm_buzzer, PORT_SYSTEM_EVENT_NOTE | PORT_SYSTEM_EVENT_TICK | SCHEDULER_EVENT_STATE_CHANGE);
+    scheduler_subscribe(p_fsm_jukebox, SCHEDULER_EVENT_ALL);
+
+    //Sin eventos pendientes se duerme sin SysTick hasta el siguiente timeout (antirrebote del boton) o interrupcion
+    tickless_init();
+    tickless_register(p_fsm_user_button, fsm_button_get_next_timeout);
+    //Con el jukebox apagado y en reposo se entra en modo Stop: solo despiertan el boton y el pin RX de la USART
+    power_policy_init(p_fsm_jukebox, fsm_jukebox_check_standby, USART_0_ID);
+#if FSM_PROFILE
+    //Perfilado de las tablas de transiciones: "info profile" por la USART, y volcado completo al salir
+    fsm_profile_init();
+    fsm_profile_attach(p_fsm_user_button, "button");
+    fsm_profile_attach(p_fsm_usart, "usart");
+    fsm_profile_attach(p_fsm_buzzer, "buzzer");
+    fsm_profile_attach(p_fsm_jukebox, "jukebox");
+    atexit(fsm_profile_print);
+#endif
+    port_system_post_event(SCHEDULER_EVENT_STATE_CHANGE); //Primera evaluacion de todas las maquinas
+
     /* Infinite loop */
     while (1)
     {
-        //Utilizamos las maquinass de estados
-        fsm_fire(p_fsm_user_button);
-        fsm_fire(p_fsm_usart);
-        fsm_fire(p_fsm_buzzer);
-        fsm_fire(p_fsm_jukebox);
+        //Solo se disparan las maquinas de estados con eventos pendientes; si no hay ninguno se duerme hasta la siguiente interrupcion o timeout
+        if (!scheduler_dispatch())
+        {
+            //El log se vacia antes de dormir; con registros enviados se vuelve a mirar si han llegado eventos
+            if (log_ring_drain(LOG_RING_DRAIN_RECORDS) == 0)
+            {
+                power_policy_idle();
+            }
+        }
 
     } // End of while(1)
     //Destruimos las maquinas de estados
@@ -0,0 +1,113 @@
+/**
+ * @file port_audio.h
+ * @brief Header for port_audio.c file (native host port).
+ *
+ * Simulated audio output of the synthesizer. A simulated timer plays the role of the DMA: every
+ * `PORT_AUDIO_HALF_SAMPLES` samples of simulated time it "sends" one half of the double buffer and calls the ISR of
+ * the DMA stream, which renders that half again, as in the target. The samples sent can be written to a WAV file with
+ * the 12-bit resolution of the DAC.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+#ifndef PORT_AUDIO_H_
+#define PORT_AUDIO_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* HW dependent includes */
+#include "port_system.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PORT_AUDIO_SAMPLE_RATE_HZ 16000U /*!< Sample rate, the same as in the target */
+#define PORT_AUDIO_HALF_SAMPLES 128U     /*!< Samples of each half of the double buffer (8 ms) */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Cost of the synthesizer in the ISR of the DMA. In the native port the "cycles" are nanoseconds of the host.
+ */
+typedef struct
+{
+    uint32_t halves;        /*!< Halves of the buffer rendered */
+    uint32_t overruns;      /*!< Halves that took longer than the budget */
+    uint32_t max_cycles;    /*!< Maximum cost of a half */
+    uint64_t total_cycles;  /*!< Cost of all the halves */
+    uint32_t budget_cycles; /*!< Budget of a half: the time the DMA takes to send the other one */
+} port_audio_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize the simulated audio output and the synthesizer.
+ *
+ */
+void port_audio_init(void);
+
+/**
+ * @brief Start the audio output: render both halves of the buffer and start the simulated DMA.
+ *
+ * The output stops by itself when the synthesizer has been silent for a whole turn of the buffer.
+ */
+void port_audio_start(void);
+
+/**
+ * @brief Stop the simulated DMA.
+ *
+ */
+void port_audio_stop(void);
+
+/**
+ * @brief Check if the audio output is running.
+ *
+ * @return true while the simulated DMA is sending samples
+ */
+bool port_audio_is_running(void);
+
+/**
+ * @brief Render one half of the buffer. Called from the ISR of the DMA.
+ *
+ * @param half 0 for the first half (half transfer), 1 for the second one (transfer complete)
+ */
+void port_audio_fill_half(uint32_t half);
+
+/**
+ * @brief Get the cost of the synthesizer.
+ *
+ * @param p_stats Pointer where the statistics are stored
+ */
+void port_audio_get_stats(port_audio_stats_t *p_stats);
+
+/**
+ * @brief Get the half of the buffer that the simulated DMA has just sent. Used by the ISR of the DMA.
+ *
+ * @return uint32_t 0 after a half transfer, 1 after a transfer complete
+ */
+uint32_t port_audio_native_get_sent_half(void);
+
+/**
+ * @brief Write the samples sent from now on to a WAV file (mono, 16 bits, `PORT_AUDIO_SAMPLE_RATE_HZ`).
+ *
+ * @param p_path Path of the file
+ * @return true if the file has been created
+ */
+bool port_audio_native_open_wav(const char *p_path);
+
+/**
+ * @brief Complete the header of the WAV file and close it.
+ *
+ * @return uint32_t Number of samples written
+ */
+uint32_t port_audio_native_close_wav(void);
+
+/**
+ * @brief Get the number of samples sent since the last call to `port_audio_start()`.
+ *
+ * @return uint64_t Number of samples
+ */
+uint64_t port_audio_native_get_samples_sent(void);
+
+#endif /* PORT_AUDIO_H_ */
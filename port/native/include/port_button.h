@@ -0,0 +1,75 @@
+/**
+ * @file port_button.h
+ * @brief Header for port_button.c file (native host port).
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef PORT_BUTTON_H_
+#define PORT_BUTTON_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include "port_system.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define 	BUTTON_0_ID 0
+ 
+#define 	BUTTON_0_GPIO GPIOC
+ 
+#define 	BUTTON_0_PIN 13
+ 
+#define 	BUTTON_0_DEBOUNCE_TIME_MS 150
+/* Defines */
+
+
+/* Typedefs --------------------------------------------------------------------*/
+typedef struct
+{
+    GPIO_TypeDef *p_port;
+    uint32_t debounce_time;
+    uint8_t pin;
+    bool flag_pressed;
+} port_button_hw_t;
+
+/* Global variables */
+extern port_button_hw_t buttons_arr[];
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Configura el botón simulado.
+ * 
+ * @param button_id 
+ */
+void port_button_init (uint32_t button_id);
+/**
+ * @brief Retorna el estado del botón (presionado o no).
+ *
+ * @param button_id 
+ * @return true 
+ * @return false 
+ */
+bool port_button_is_pressed (uint32_t button_id);
+/**
+ * @brief Retorna el tiempo anti-rebotes del botón.
+ * 
+ * @param button_id 
+ * @return uint32_t 
+ */
+uint32_t port_button_get_debouncetime(uint32_t button_id);
+/**
+ * @brief Retorna el contador del tick del sistema en milisegundos, en 64 bits (no desborda).
+ * 
+ * @return uint64_t 
+ */
+uint64_t port_button_get_tick ();
+/**
+ * @brief Simula la pulsación o liberación del botón: cambia el nivel del pin y lanza la ISR de la EXTI si está habilitada.
+ * 
+ * @param button_id 
+ * @param pressed true para pulsar el botón, false para soltarlo
+ */
+void port_button_native_set_pressed (uint32_t button_id, bool pressed);
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file port_buzzer.h
+ * @brief Header for port_buzzer.c file (native host port).
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+#ifndef PORT_BUZZER_H_
+#define PORT_BUZZER_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "port_system.h"
+#include "melodies.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define BUZZER_0_ID 0
+
+#define BUZZER_0_GPIO GPIOA
+
+#define BUZZER_0_PIN 6
+
+#define BUZZER_PWM_DC 0.5
+
+#define PORT_BUZZER_NATIVE_TIMELINE_LENGTH 1024 /*!< Maximum number of notes recorded in the timeline */
+#define PORT_BUZZER_NOTE_QUEUE_LENGTH 2 /*!< Notas que pueden esperar en la cola del buzzer (potencia de 2) */
+#define PORT_BUZZER_NUM_VOICES 3 /*!< Voces que pueden sonar a la vez, cada una con su temporizador PWM simulado */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Nota (o acorde) de la cola del buzzer simulado.
+ *
+ */
+typedef struct
+{
+    uint32_t frequency_mhz[PORT_BUZZER_NUM_VOICES]; /*!< Frecuencia de cada voz en milihercios (0 para silencio) */
+    uint8_t num_voices;     /*!< Voces que suenan: las demás se silencian sin grabarse en su línea de tiempo */
+    uint32_t duration_us;   /*!< Duración de la nota en microsegundos */
+} port_buzzer_note_t;
+
+/**
+ * @brief Estructura que representa el hardware simulado del buzzer.
+ *
+ */
+typedef struct
+{
+    GPIO_TypeDef *p_port;
+    uint8_t pin;
+    uint8_t alt_func;
+    bool note_end;
+    bool playing[PORT_BUZZER_NUM_VOICES];        /*!< Hay una nota abierta en la línea de tiempo de cada voz */
+    uint32_t frequency_mhz[PORT_BUZZER_NUM_VOICES]; /*!< Frecuencia de la nota actual de cada voz en milihercios */
+    port_buzzer_note_t queue[PORT_BUZZER_NOTE_QUEUE_LENGTH]; /*!< Notas pendientes de sonar */
+    uint32_t head;          /*!< Índice tras la última nota encolada */
+    uint32_t tail;          /*!< Índice de la siguiente nota que sonará */
+    bool running;           /*!< El temporizador de duración simulado está contando una nota */
+    uint64_t note_deadline_us; /*!< Instante simulado en el que termina la nota actual */
+} port_buzzer_hw_t;
+
+/**
+ * @brief Nota grabada en la línea de tiempo del buzzer simulado.
+ *
+ */
+typedef struct
+{
+    uint64_t start_us;      /*!< Instante simulado en el que empieza a sonar la nota */
+    uint64_t end_us;        /*!< Instante simulado en el que se detiene la nota */
+    uint32_t frequency_mhz; /*!< Frecuencia de la nota en milihercios (0 para silencio) */
+    uint32_t duration_us;   /*!< Duración programada en el temporizador de duración, en microsegundos */
+} port_buzzer_native_event_t;
+
+/* Global variables */
+/**
+ * @brief Matriz que contiene las configuraciones de hardware para los buzzers.
+ *
+ */
+extern port_buzzer_hw_t buzzers_arr[];
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Inicializa el buzzer simulado y borra su línea de tiempo.
+ * 
+ * @param buzzer_id 
+ */
+void port_buzzer_init(uint32_t buzzer_id);
+/**
+ * @brief Configura la duración de la nota: programa un temporizador simulado que llamará a la ISR del TIM2.
+ * 
+ * @param buzzer_id 
+ * @param duration_ms 
+ */
+void port_buzzer_set_note_duration(uint32_t buzzer_id, uint32_t duration_ms);
+/**
+ * @brief Configura la frecuencia de la nota y abre una nueva entrada en la línea de tiempo.
+ * 
+ * @param buzzer_id 
+ * @param frequency_hz 
+ */
+void port_buzzer_set_note_frequency(uint32_t buzzer_id, double frequency_hz);
+/**
+ * @brief Configura la nota a partir de su número MIDI, sin coma flotante, y abre una nueva entrada en la línea de tiempo.
+ * 
+ * @param buzzer_id 
+ * @param note Número MIDI de la nota (MIDI_SILENCE para silencio)
+ */
+void port_buzzer_set_note(uint32_t buzzer_id, uint8_t note);
+/**
+ * @brief  Obtiene el estado de finalización de la nota del buzzer especificado.
+ * 
+ * @param buzzer_id 
+ * @return true 
+ * @return false 
+ */
+bool port_buzzer_get_note_timeout(uint32_t buzzer_id);
+/**
+ * @brief Detiene la reproducción de la nota, cierra su entrada en la línea de tiempo y vacía la cola de notas.
+ * 
+ * @param buzzer_id 
+ */
+void port_buzzer_stop(uint32_t buzzer_id);
+/**
+ * @brief Añade una nota a la cola del buzzer.
+ *
+ * Si el buzzer está parado la nota empieza a sonar inmediatamente. Si no, la ISR del TIM2 simulada la arranca
+ * exactamente en el instante en que termina la nota anterior, como hace la precarga de registros en el target.
+ * 
+ * @param buzzer_id 
+ * @param note Número MIDI de la nota (MIDI_SILENCE para silencio)
+ * @param duration_us Duración de la nota en microsegundos
+ * @return true si la nota se ha encolado, false si la cola está llena
+ */
+bool port_buzzer_queue_note(uint32_t buzzer_id, uint8_t note, uint32_t duration_us);
+/**
+ * @brief Añade un acorde a la cola del buzzer: una nota por voz, todas con la misma duración.
+ *
+ * Las voces a partir de num_voices se silencian. Las voces a partir de PORT_BUZZER_NUM_VOICES se ignoran.
+ * 
+ * @param buzzer_id 
+ * @param p_notes Número MIDI de la nota de cada voz (MIDI_SILENCE para silencio)
+ * @param num_voices Número de notas de p_notes
+ * @param duration_us Duración del acorde en microsegundos
+ * @return true si el acorde se ha encolado, false si la cola está llena
+ */
+bool port_buzzer_queue_chord(uint32_t buzzer_id, const uint8_t *p_notes, uint32_t num_voices, uint32_t duration_us);
+/**
+ * @brief Obtiene el número de huecos libres de la cola de notas del buzzer.
+ * 
+ * @param buzzer_id 
+ * @return uint32_t 
+ */
+uint32_t port_buzzer_get_queue_free(uint32_t buzzer_id);
+/**
+ * @brief Fin de la nota actual. Arranca la siguiente nota de la cola o, si está vacía, detiene el buzzer y activa note_end.
+ * @warning Solo debe llamarse desde la ISR del TIM2 simulada en `interr.c`.
+ * 
+ * @param buzzer_id 
+ */
+void port_buzzer_update_note(uint32_t buzzer_id);
+/**
+ * @brief Devuelve la línea de tiempo grabada de la primera voz.
+ * 
+ * @param buzzer_id 
+ * @param p_length Puntero donde se guarda el número de notas grabadas
+ * @return const port_buzzer_native_event_t* 
+ */
+const port_buzzer_native_event_t *port_buzzer_native_get_timeline(uint32_t buzzer_id, uint32_t *p_length);
+/**
+ * @brief Devuelve la línea de tiempo grabada de una voz.
+ * 
+ * @param buzzer_id 
+ * @param voice Voz (0 a PORT_BUZZER_NUM_VOICES - 1)
+ * @param p_length Puntero donde se guarda el número de notas grabadas
+ * @return const port_buzzer_native_event_t* 
+ */
+const port_buzzer_native_event_t *port_buzzer_native_get_voice_timeline(uint32_t buzzer_id, uint32_t voice, uint32_t *p_length);
+/**
+ * @brief Borra las líneas de tiempo grabadas de todas las voces.
+ * 
+ * @param buzzer_id 
+ */
+void port_buzzer_native_reset_timeline(uint32_t buzzer_id);
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @file port_melody_file.h
+ * @brief Header for port_melody_file.c file (native host port only).
+ *
+ * File source of a melody stream (`melody_stream.h`). The file holds packed events {note, duration code}, 2 bytes
+ * each, as a memory blob. Only one chunk is in RAM at a time, whatever the length of the file.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+#ifndef PORT_MELODY_FILE_H_
+#define PORT_MELODY_FILE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdbool.h>
+#include "melody_stream.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief File source of a melody stream.
+ */
+typedef struct
+{
+    FILE *p_file;   /*!< File opened for reading */
+    uint32_t reads; /*!< Number of reads of the file */
+} port_melody_file_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Open a file of packed events.
+ *
+ * @param p_source Pointer to the file source
+ * @param p_path Path of the file
+ * @return true if the file has been opened
+ */
+bool port_melody_file_native_open(port_melody_file_t *p_source, const char *p_path);
+
+/**
+ * @brief Close the file of a file source.
+ *
+ * @param p_source Pointer to the file source
+ */
+void port_melody_file_native_close(port_melody_file_t *p_source);
+
+/**
+ * @brief Read function of a file source (`port_melody_file_t`) for melody_stream_open().
+ */
+uint32_t port_melody_file_native_read(void *p_source, uint32_t offset, melody_event_t *p_events, uint32_t max_events);
+
+#endif
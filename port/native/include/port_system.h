@@ -0,0 +1,368 @@
+/**
+ * @file port_system.h
+ * @brief Header for port_system.c file (native host port).
+ *
+ * The native port replaces the STM32F4 peripherals by a simulated machine that runs on the build host.
+ * Time is a simulated clock in microseconds: the SysTick ISR is called once per simulated millisecond and
+ * the simulated timers (note duration, USART transfers...) are processed in chronological order.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+#ifndef PORT_SYSTEM_H_
+#define PORT_SYSTEM_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define BIT_POS_TO_MASK(x) (0x01 << (x))                    /*!< Convert the index of a bit into a mask by left shifting */
+#define BASE_MASK_TO_POS(m, p) ((m) << (p))                 /*!< Move a mask defined in the LSBs to upper positions by shifting left p bits */
+
+/* Simulated microcontroller */
+#define HSI_VALUE ((uint32_t)16000000) /*!< Value of the simulated internal oscillator in Hz */
+#define PORT_NATIVE_GPIO_PORTS 3       /*!< Number of simulated GPIO ports (GPIOA, GPIOB and GPIOC) */
+#define PORT_NATIVE_MAX_TIMERS 8       /*!< Maximum number of simulated timers pending at the same time */
+
+/* GPIOs */
+#define HIGH true /*!< Logic 1 */
+#define LOW false /*!< Logic 0 */
+
+#define GPIO_MODE_IN 0x00        /*!< GPIO as input */
+#define GPIO_MODE_OUT 0x01       /*!< GPIO as output */
+#define GPIO_MODE_ALTERNATE 0x02 /*!< GPIO as alternate function */
+#define GPIO_MODE_ANALOG 0x03    /*!< GPIO as analog */
+
+#define GPIO_PUPDR_NOPULL 0x00 /*!< GPIO no pull up or down */
+#define GPIO_PUPDR_PUP 0x01    /*!< GPIO pull up */
+#define GPIO_PUPDR_PDOWN 0x02  /*!< GPIO pull down */
+
+/* Interruption */
+#define TRIGGER_RISING_EDGE 0x01U                                      /*!< Interrupt mask for detecting rising edge */
+#define TRIGGER_FALLING_EDGE 0x02U                                     /*!< Interrupt mask for detecting falling edge */
+#define TRIGGER_BOTH_EDGE (TRIGGER_RISING_EDGE | TRIGGER_FALLING_EDGE) /*!< Interrupt mask for detecting both rising and falling edges */
+#define TRIGGER_ENABLE_EVENT_REQ 0x04U                                 /*!< Interrupt mask to enable event requests */
+#define TRIGGER_ENABLE_INTERR_REQ 0x08U                                /*!< Interrupt mask to enable interrupt request */
+
+/* Events posted by the ISRs */
+#define PORT_SYSTEM_EVENT_TICK BIT_POS_TO_MASK(0)   /*!< SysTick: one millisecond has elapsed */
+#define PORT_SYSTEM_EVENT_BUTTON BIT_POS_TO_MASK(1) /*!< EXTI15_10: the user button has changed */
+#define PORT_SYSTEM_EVENT_USART BIT_POS_TO_MASK(2)  /*!< USART3: a byte has been received or transmitted */
+#define PORT_SYSTEM_EVENT_NOTE BIT_POS_TO_MASK(3)   /*!< TIM2: the duration of a note has elapsed */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Simulated GPIO port. It only keeps the registers used by the drivers of the project.
+ */
+typedef struct
+{
+    uint32_t MODER;  /*!< Mode register */
+    uint32_t PUPDR;  /*!< Pull-up/pull-down register */
+    uint32_t IDR;    /*!< Input data register */
+    uint32_t ODR;    /*!< Output data register */
+    uint32_t AFR[2]; /*!< Alternate function registers */
+    uint32_t EXTI;   /*!< Lines of this port with the external interrupt enabled */
+} GPIO_TypeDef;
+
+/**
+ * @brief Callback of a simulated timer. It is called from the simulated clock, as an ISR would be.
+ */
+typedef void (*port_system_native_timer_cb_t)(uint32_t arg);
+
+/* Global variables */
+extern GPIO_TypeDef native_gpio_ports[PORT_NATIVE_GPIO_PORTS]; /*!< Simulated GPIO ports */
+extern uint32_t SystemCoreClock;                               /*!< Frequency of the simulated system clock */
+
+#define GPIOA (&native_gpio_ports[0]) /*!< Simulated GPIOA */
+#define GPIOB (&native_gpio_ports[1]) /*!< Simulated GPIOB */
+#define GPIOC (&native_gpio_ports[2]) /*!< Simulated GPIOC */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize the simulated machine: reset the simulated clock, the GPIOs and the pending timers.
+ *
+ * @retval Init status
+ */
+size_t port_system_init(void);
+
+/**
+ * @brief Get the count of the System tick in milliseconds.
+ *
+ * @note As in the target, this value only advances while the SysTick interrupt is enabled. It wraps after 2^32 ms
+ * (49.7 days): compare its values with a signed difference, or use port_system_get_millis64().
+ *
+ * @return uint32_t
+ */
+uint32_t port_system_get_millis(void);
+
+/**
+ * @brief Sets the number of milliseconds since the system started.
+ * @warning This function must be used only by the SysTick_Handler() ISR in file `interr.c`.
+ *
+ * @note Only the low 32 bits are set. A value lower than the current one is a wrap of the 32-bit tick and increments the
+ * high 32 bits, so the 64-bit tick stays monotonic.
+ *
+ * @param ms New number of milliseconds since the system started.
+ */
+void port_system_set_millis(uint32_t ms);
+
+/**
+ * @brief Get the count of the System tick in milliseconds, in 64 bits. It never wraps.
+ *
+ * @return uint64_t
+ */
+uint64_t port_system_get_millis64(void);
+
+/**
+ * @brief Set the 64-bit count of the System tick in milliseconds. The tests use it to fast-forward the tick.
+ *
+ * @param ms New number of milliseconds since the system started.
+ */
+void port_system_set_millis64(uint64_t ms);
+
+/**
+ * @brief Get the time since the system started in microseconds: the System tick plus the position of the simulated
+ * SysTick counter in the current millisecond. It never wraps.
+ *
+ * @return uint64_t
+ */
+uint64_t port_system_get_micros64(void);
+
+/**
+ * @brief Wait for some milliseconds. On the host the simulated clock is advanced instead of busy waiting.
+ *
+ * @param ms Number of milliseconds to wait
+ */
+void port_system_delay_ms(uint32_t ms);
+
+/**
+ * @brief Wait for some milliseconds from a time reference.
+ *
+ * @note It also updates the time reference to the system time at return.
+ *
+ * @param p_t Pointer to the time reference
+ * @param ms Number of milliseconds to wait
+ */
+void port_system_delay_until_ms(uint32_t *p_t, uint32_t ms);
+
+/**
+ * @brief Configure the mode and pull of a simulated GPIO.
+ *
+ * @param p_port Port of the GPIO
+ * @param pin Pin/line of the GPIO (index from 0 to 15)
+ * @param mode Input, output, alternate, or analog
+ * @param pupd Pull-up, pull-down, or no-pull
+ */
+void port_system_gpio_config(GPIO_TypeDef *p_port, uint8_t pin, uint8_t mode, uint8_t pupd);
+
+/**
+ * @brief Configure the alternate function of a simulated GPIO.
+ *
+ * @param p_port Port of the GPIO
+ * @param pin Pin/line of the GPIO (index from 0 to 15)
+ * @param alternate Alternate function number (values from 0 to 15)
+ */
+void port_system_gpio_config_alternate(GPIO_TypeDef *p_port, uint8_t pin, uint8_t alternate);
+
+/**
+ * @brief Configure the external interruption of a simulated GPIO.
+ *
+ * @param p_port Port of the GPIO
+ * @param pin Pin/line of the GPIO (index from 0 to 15)
+ * @param mode Trigger mode (see TRIGGER_* defines)
+ */
+void port_system_gpio_config_exti(GPIO_TypeDef *p_port, uint8_t pin, uint32_t mode);
+
+/**
+ * @brief Enable interrupts of a GPIO line (pin). Priorities are ignored on the host.
+ *
+ * @param pin Pin/line of the GPIO (index from 0 to 15)
+ * @param priority Priority level
+ * @param subpriority Subpriority level
+ */
+void port_system_gpio_exti_enable(uint8_t pin, uint8_t priority, uint8_t subpriority);
+
+/**
+ * @brief Disable interrupts of a GPIO line (pin).
+ *
+ * @param pin Pin/line of the GPIO (index from 0 to 15)
+ */
+void port_system_gpio_exti_disable(uint8_t pin);
+
+/**
+ * @brief Check if the interrupts of a GPIO line (pin) are enabled.
+ *
+ * @param pin Pin/line of the GPIO (index from 0 to 15)
+ * @return true if the line is enabled, false otherwise
+ */
+bool port_system_gpio_exti_is_enabled(uint8_t pin);
+
+/**
+ * @brief Read the digital value of a simulated pin.
+ *
+ * @param p_port
+ * @param pin
+ * @return true
+ * @return false
+ */
+bool port_system_gpio_read(GPIO_TypeDef *p_port, uint8_t pin);
+
+/**
+ * @brief Write the digital value of a simulated pin.
+ *
+ * @param p_port
+ * @param pin
+ * @param value
+ */
+void port_system_gpio_write(GPIO_TypeDef *p_port, uint8_t pin, bool value);
+
+/**
+ * @brief Toggle the digital value of a simulated pin.
+ *
+ * @param p_port
+ * @param pin
+ */
+void port_system_gpio_toggle(GPIO_TypeDef *p_port, uint8_t pin);
+
+/**
+ * @brief Simulated Stop mode: the clock runs until the next pending event.
+ */
+void port_system_power_stop();
+
+/**
+ * @brief Simulated Sleep mode: the clock runs until the next pending event.
+ */
+void port_system_power_sleep();
+
+/**
+ * @brief Enable the SysTick interrupt.
+ */
+void port_system_systick_resume();
+
+/**
+ * @brief Disable the SysTick interrupt. The simulated clock keeps running but `msTicks` does not advance.
+ */
+void port_system_systick_suspend();
+
+/**
+ * @brief Suspend the SysTick and enter the simulated Sleep mode.
+ */
+void port_system_sleep();
+
+/**
+ * @brief Tickless sleep: suspend the SysTick and enter the simulated Sleep mode until the next simulated interrupt or,
+ * at most, `max_ms` milliseconds. The milliseconds slept are added to `msTicks` on wake-up.
+ *
+ * If the wake-up timer expires the event PORT_SYSTEM_EVENT_TICK is posted. The sleep is skipped if there are events
+ * pending.
+ *
+ * @param max_ms Maximum time to sleep in milliseconds
+ * @return uint32_t Number of SysTick periods slept, already added to `msTicks`
+ */
+uint32_t port_system_tickless_sleep(uint32_t max_ms);
+
+/**
+ * @brief Deep sleep: suspend the SysTick and enter the simulated Stop mode until a simulated interrupt posts an
+ * event. The milliseconds slept are added to `msTicks` on wake-up.
+ *
+ * The sleep is skipped if there are events pending.
+ *
+ * @return uint32_t Milliseconds spent in Stop mode, already added to `msTicks`
+ */
+uint32_t port_system_stop_sleep(void);
+
+/**
+ * @brief Post events to be processed by the main loop. It can be called from any simulated ISR.
+ *
+ * @param events Mask of events (see PORT_SYSTEM_EVENT_*)
+ */
+void port_system_post_event(uint32_t events);
+
+/**
+ * @brief Get and clear the pending events.
+ *
+ * @return uint32_t Mask of the events posted since the last call
+ */
+uint32_t port_system_take_events(void);
+
+/**
+ * @brief Wait in the simulated Sleep mode until the next simulated interrupt, unless there are events pending.
+ */
+void port_system_wait_for_event(void);
+
+/**
+ * @brief Get the value of the cycle counter. On the host it counts nanoseconds of the host monotonic clock.
+ *
+ * @return uint32_t Counter value (wraps around)
+ */
+uint32_t port_system_get_cycles(void);
+
+/* Native port only -------------------------------------------------------------------*/
+/**
+ * @brief Get the simulated time in microseconds. Unlike `msTicks`, it never stops.
+ *
+ * @return uint64_t
+ */
+uint64_t port_system_native_get_micros(void);
+
+/**
+ * @brief Advance the simulated clock, calling the SysTick ISR and the expired simulated timers in order.
+ *
+ * @param us Number of microseconds to advance
+ */
+void port_system_native_advance_us(uint64_t us);
+
+/**
+ * @brief Advance the simulated clock some milliseconds.
+ *
+ * @param ms Number of milliseconds to advance
+ */
+void port_system_native_advance_ms(uint32_t ms);
+
+/**
+ * @brief Select whether the simulated clock follows the host monotonic clock.
+ *
+ * In real-time mode the simulated clock is synchronized with the host clock every time the drivers are polled, so
+ * `main.c` behaves as in the target. Unit tests and benchmarks disable it to have full control of the time.
+ *
+ * @param realtime true to follow the host clock, false to only advance it explicitly
+ */
+void port_system_native_set_realtime(bool realtime);
+
+/**
+ * @brief Synchronize the simulated clock with the host clock if the real-time mode is enabled.
+ */
+void port_system_native_poll(void);
+
+/**
+ * @brief Program a simulated timer that will call `cb` when the simulated clock reaches `deadline_us`.
+ *
+ * @param deadline_us Absolute simulated time in microseconds
+ * @param cb Callback to be called
+ * @param arg Argument passed to the callback
+ * @return int Index of the timer, or -1 if there are no free timers
+ */
+int port_system_native_timer_start(uint64_t deadline_us, port_system_native_timer_cb_t cb, uint32_t arg);
+
+/**
+ * @brief Cancel all the pending simulated timers with the given callback and argument.
+ *
+ * @param cb Callback of the timer
+ * @param arg Argument of the timer
+ */
+void port_system_native_timer_cancel(port_system_native_timer_cb_t cb, uint32_t arg);
+
+/**
+ * @brief Get the number of times the system has entered a simulated low power mode.
+ *
+ * @return uint32_t
+ */
+uint32_t port_system_native_get_sleep_count(void);
+
+#endif /* PORT_SYSTEM_H_ */
@@ -0,0 +1,318 @@
+/**
+ * @file port_usart.h
+ * @brief Header for port_usart.c file (native host port).
+ * @author Mariano Lorenzo Kayser
+ * @author Alejandro Gómez Ruiz
+ * @date 17/10/2026
+ */
+#ifndef PORT_USART_H_
+#define PORT_USART_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <string.h>
+#include <stdlib.h>
+#include "port_system.h"
+#include "line_ring.h"
+#include "usart_baud.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define USART_0_ID 0
+#define USART_0_GPIO_TX GPIOB
+#define USART_0_GPIO_RX GPIOC
+#define USART_0_PIN_TX 10
+#define USART_0_PIN_RX 11
+#define USART_0_AF_TX 7
+#define USART_0_AF_RX 7
+#define USART_0_BAUDRATE 9600 /*!< Baud rate of the control console */
+#define USART_1_ID 1          /*!< Telemetry link (USART2 on the target) */
+#define USART_1_GPIO_TX GPIOA
+#define USART_1_GPIO_RX GPIOA
+#define USART_1_PIN_TX 2
+#define USART_1_PIN_RX 3
+#define USART_1_AF_TX 7
+#define USART_1_AF_RX 7
+#define USART_1_BAUDRATE 115200 /*!< Baud rate of the telemetry link */
+#define USART_NUM_INSTANCES 2   /*!< Number of entries of usart_arr */
+#define USART_INPUT_BUFFER_LENGTH 64
+#define USART_OUTPUT_BUFFER_LENGTH 100
+#define EMPTY_BUFFER_CONSTANT 0x0
+#define END_CHAR_CONSTANT 0xA
+#define USART_NATIVE_FIFO_LENGTH 4096 /*!< Size of the simulated RX and TX FIFOs of the host side */
+#define USART_NATIVE_BYTE_TIME_US 1042 /*!< Time to transmit a byte of USART_0 at 9600 bauds with 8N1 frames (10 bits) */
+#define USART_NATIVE_BITS_PER_BYTE 10U /*!< Bits of a 8N1 frame: start, 8 data bits and stop */
+#define USART_NATIVE_PCLK_HZ 16000000U /*!< Simulated clock of the bus of the USARTs (HSI of the target) */
+#define USART_NATIVE_LINE_TOLERANCE_PPM 30000U /*!< Largest difference between the rates of the host and the USART that receives without framing errors */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief In-memory FIFO that models the serial line between the host and the simulated USART.
+ */
+typedef struct
+{
+char data[USART_NATIVE_FIFO_LENGTH];
+uint32_t head;
+uint32_t tail;
+} port_usart_native_fifo_t;
+
+typedef struct
+{
+GPIO_TypeDef *p_port_tx;
+GPIO_TypeDef *p_port_rx;
+uint8_t pin_tx;
+uint8_t pin_rx;
+uint8_t alt_func_tx;
+uint8_t alt_func_rx;
+line_ring_t rx_ring;              /*!< Lines received by the ISR and not yet taken by the FSM */
+char output_buffer[USART_OUTPUT_BUFFER_LENGTH];
+uint8_t o_idx;
+bool write_complete;
+char dr;                          /*!< Simulated data register: last byte received or transmitted */
+bool rxne;                        /*!< Simulated RXNE flag: a received byte is waiting in the data register */
+bool rx_interrupt_enabled;        /*!< Simulated RXNEIE bit */
+bool tx_interrupt_enabled;        /*!< Simulated TXEIE bit */
+port_usart_native_fifo_t rx_fifo; /*!< Bytes sent by the host that have not been received yet */
+port_usart_native_fifo_t tx_fifo; /*!< Bytes transmitted by the USART that the host has not read yet */
+const char *p_dma_data;           /*!< Simulated DMA: message being transmitted */
+uint32_t dma_length;              /*!< Simulated DMA: number of bytes of the message */
+uint32_t irq_count;               /*!< Number of interrupts of the USART and its DMA stream */
+bool rx_wakeup;                    /*!< The RX pin is armed to wake up from Stop mode */
+uint32_t baudrate;                /*!< Baud rate: sets the simulated time of the DMA transfers */
+void (*p_irq_vector)(void);       /*!< ISR of the USART in interr.c, called by the simulated line */
+void (*p_dma_irq_vector)(void);   /*!< ISR of the DMA stream in interr.c, called at the end of a simulated transfer */
+uint32_t pending_baudrate;        /*!< Baud rate to apply at the end of the current DMA transmission, or 0 */
+bool autobaud;                    /*!< The next character sent by the host sets the baud rate */
+uint32_t line_baudrate;           /*!< Baud rate of the host side of the line, or 0 for the same as the USART */
+uint32_t framing_errors;          /*!< Bytes lost because the host and the USART have different baud rates */
+}port_usart_hw_t;
+
+
+/* Global variables */
+extern port_usart_hw_t usart_arr [];
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Resetea un buffer dado a un valor específico.
+ * 
+ * @param buffer 
+ * @param length 
+ */
+void _reset_buffer (char *buffer, uint32_t length);
+/**
+ * @brief Almacena el byte del registro de datos simulado en el anillo de líneas de recepción.
+ * 
+ * @param usart_id 
+ */
+void port_usart_store_data (uint32_t usart_id);
+/**
+ * @brief Escribe el siguiente byte del buffer de salida en la FIFO de transmisión simulada.
+ * 
+ * @param usart_id 
+ */
+void port_usart_write_data (uint32_t usart_id);
+/**
+ * @brief Verifica si la transmisión se ha completado.
+ * 
+ */
+bool port_usart_tx_done (uint32_t usart_id);
+/**
+ * @brief Verifica si hay alguna línea completa recibida.
+ * 
+ */
+bool port_usart_rx_done (uint32_t usart_id);
+/**
+ * @brief Saca la línea más antigua del anillo de recepción.
+ * 
+ * @param usart_id 
+ * @param p_input_data 
+ */
+void 	port_usart_get_from_input_buffer (uint32_t usart_id, char *p_input_data);
+/**
+ * @brief Obtiene el estado de transmisión. La línea simulada siempre está lista para transmitir.
+ * 
+ * @param usart_id 
+ * @return true 
+ * @return false 
+ */
+bool 	port_usart_get_txr_status (uint32_t usart_id);
+/**
+ * @brief Copia datos al buffer de salida.
+ * 
+ */
+void 	port_usart_copy_to_output_buffer (uint32_t usart_id, char *p_out_data, uint32_t nBytes);
+/**
+ * @brief Descarta todas las líneas pendientes.
+ * 
+ * @param usart_id 
+ */
+void 	port_usart_reset_input_buffer (uint32_t usart_id);
+/**
+ * @brief Reinicia el buffer de salida.
+ * 
+ * @param usart_id 
+ */
+void 	port_usart_reset_output_buffer (uint32_t usart_id);
+/**
+ * @brief Habilita la interrupción de recepción y entrega los bytes pendientes de la FIFO de recepción.
+ * 
+ * @param usart_id 
+ */
+void 	port_usart_enable_rx_interrupt (uint32_t usart_id);
+/**
+ * @brief Habilita la interrupción de transmisión. La ISR simulada se ejecuta hasta que se deshabilita.
+ * 
+ * @param usart_id 
+ */
+void 	port_usart_enable_tx_interrupt (uint32_t usart_id);
+/**
+ * @brief Deshabilita la interrupción de recepción.
+ * 
+ * @param usart_id 
+ */
+void 	port_usart_disable_rx_interrupt (uint32_t usart_id);
+/**
+ * @brief Deshabilita la interrupción de transmisión.
+ * 
+ * @param usart_id 
+ */
+void 	port_usart_disable_tx_interrupt (uint32_t usart_id);
+/**
+ * @brief Inicializa el USART simulado y vacía sus FIFOs.
+ * 
+ * @param usart_id 
+ */
+void 	port_usart_init (uint32_t usart_id);
+/**
+ * @brief Inicia la transmisión simulada de un mensaje por DMA.
+ *
+ * Los bytes llegan a la FIFO de transmisión y se llama a la ISR del DMA cuando ha pasado el tiempo de transmitir el
+ * mensaje (USART_NATIVE_BYTE_TIME_US por byte), igual que la interrupción de transferencia completa del target.
+ * 
+ * @param usart_id 
+ * @param p_data Puntero al mensaje (debe mantenerse sin cambios hasta el final de la transmisión)
+ * @param length Número de bytes a transmitir
+ */
+void port_usart_tx_start (uint32_t usart_id, const char *p_data, uint32_t length);
+/**
+ * @brief Finaliza la transmisión por DMA. Se llama desde la ISR simulada del stream de DMA.
+ * 
+ * @param usart_id 
+ */
+void port_usart_tx_complete (uint32_t usart_id);
+/**
+ * @brief Obtiene el número de líneas completas recibidas que aún no se han leído.
+ * 
+ * @param usart_id 
+ * @return uint32_t 
+ */
+uint32_t port_usart_get_lines_pending (uint32_t usart_id);
+/**
+ * @brief Obtiene el número de líneas descartadas porque no cabían en el buffer de recepción.
+ * 
+ * @param usart_id 
+ * @return uint32_t 
+ */
+uint32_t port_usart_get_rx_overruns (uint32_t usart_id);
+/**
+ * @brief Arma o desarma el pin RX como fuente de despertar del modo Stop. Con el despertar armado, los bytes enviados
+ * con port_usart_native_inject_rx() publican PORT_SYSTEM_EVENT_USART, como la línea EXTI del pin en la placa.
+ * 
+ * @param usart_id 
+ * @param enable true para armar el despertar, false para desarmarlo
+ * @return true (en el host todos los pines RX pueden despertar al sistema)
+ */
+bool port_usart_set_rx_wakeup (uint32_t usart_id, bool enable);
+/**
+ * @brief Envía bytes desde el host al USART simulado. Si la interrupción de recepción está habilitada se
+ * entregan inmediatamente a la ISR; si no, quedan en la FIFO hasta que se habilite.
+ * 
+ * @param usart_id 
+ * @param p_data Bytes a enviar
+ * @param length Número de bytes
+ * @return uint32_t Número de bytes aceptados por la FIFO
+ */
+uint32_t port_usart_native_inject_rx (uint32_t usart_id, const char *p_data, uint32_t length);
+/**
+ * @brief Lee desde el host los bytes transmitidos por el USART simulado.
+ * 
+ * @param usart_id 
+ * @param p_data Buffer donde se copian los bytes
+ * @param max_length Tamaño del buffer
+ * @return uint32_t Número de bytes leídos
+ */
+uint32_t port_usart_native_read_tx (uint32_t usart_id, char *p_data, uint32_t max_length);
+/**
+ * @brief Obtiene el número de interrupciones simuladas del USART y de su stream de DMA.
+ * 
+ * @param usart_id 
+ * @return uint32_t 
+ */
+uint32_t port_usart_native_get_irq_count (uint32_t usart_id);
+/**
+ * @brief Cambia la velocidad de un USART. Se comprueba con la aritmética de BRR del target a USART_NATIVE_PCLK_HZ.
+ *
+ * Con after_tx, el cambio se aplica al terminar la transmisión por DMA en curso o la siguiente.
+ * 
+ * @param usart_id 
+ * @param baudrate Velocidad en baudios
+ * @param after_tx true para aplicarla al terminar la siguiente transmisión, false para aplicarla ya
+ * @return true si la velocidad se puede obtener, false si no
+ */
+bool port_usart_set_baudrate (uint32_t usart_id, uint32_t baudrate, bool after_tx);
+/**
+ * @brief Obtiene la velocidad actual de un USART.
+ * 
+ * @param usart_id 
+ * @return uint32_t Velocidad en baudios
+ */
+uint32_t port_usart_get_baudrate (uint32_t usart_id);
+/**
+ * @brief Arranca la detección automática de la velocidad. El siguiente carácter enviado por el host fija la velocidad
+ * estándar más cercana a la de su lado de la línea, y el resto de esa línea se descarta, como en el target.
+ * 
+ * @param usart_id 
+ */
+void port_usart_start_autobaud (uint32_t usart_id);
+/**
+ * @brief Indica si la detección automática de la velocidad sigue esperando un carácter.
+ * 
+ * @param usart_id 
+ * @return true si está esperando, false si no
+ */
+bool port_usart_autobaud_pending (uint32_t usart_id);
+/**
+ * @brief Fija la velocidad del lado del host de la línea simulada. Si difiere de la del USART en más de
+ * USART_NATIVE_LINE_TOLERANCE_PPM, los bytes enviados se pierden con error de trama.
+ * 
+ * @param usart_id 
+ * @param baudrate Velocidad en baudios, o 0 para usar siempre la del USART
+ */
+void port_usart_native_set_line_baudrate (uint32_t usart_id, uint32_t baudrate);
+/**
+ * @brief Obtiene el número de bytes perdidos por error de trama.
+ * 
+ * @param usart_id 
+ * @return uint32_t 
+ */
+uint32_t port_usart_native_get_framing_errors (uint32_t usart_id);
+/**
+ * @brief Atiende la interrupción simulada de un USART: guarda el byte recibido y envía el siguiente del buffer de salida.
+ * 
+ * @param usart_id 
+ */
+void port_usart_irq_handler (uint32_t usart_id);
+/**
+ * @brief Atiende la interrupción simulada del stream de DMA de transmisión de un USART.
+ * 
+ * @param usart_id 
+ */
+void port_usart_dma_irq_handler (uint32_t usart_id);
+/**
+ * @brief Obtiene el tiempo de un byte en la línea simulada, con la velocidad del USART y tramas 8N1.
+ * 
+ * @param usart_id 
+ * @return uint32_t Microsegundos por byte, redondeados hacia arriba
+ */
+uint32_t port_usart_native_get_byte_time_us (uint32_t usart_id);
+#endif
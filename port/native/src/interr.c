@@ -0,0 +1,91 @@
+/**
+ * @file interr.c
+ * @brief Interrupt service routines of the native host port.
+ *
+ * There are no interrupts on the host: these functions are called by the simulated machine (simulated clock,
+ * simulated timers and host injections) at the moment the target would call the ISR.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+// Include HW dependencies:
+#include "port_system.h"
+#include "port_button.h"
+#include "port_usart.h"
+#include "port_buzzer.h"
+#include "port_audio.h"
+
+//------------------------------------------------------
+// INTERRUPT SERVICE ROUTINES
+//------------------------------------------------------
+/**
+ * @brief Incrementa el contador de milisegundos del sistema en 1 cada milisegundo simulado.
+ */
+void SysTick_Handler(void)
+{
+    uint32_t millis = port_system_get_millis();
+    port_system_set_millis(millis+1);
+    port_system_post_event(PORT_SYSTEM_EVENT_TICK);
+}
+/**
+ * @brief Detecta y maneja el flanco simulado del botón de usuario.
+ * 
+ */
+void EXTI15_10_IRQHandler(void) {
+    /* ISR user button */
+    port_system_systick_resume();
+    uint8_t pin = buttons_arr[BUTTON_0_ID].pin;
+    GPIO_TypeDef *p_port = buttons_arr[BUTTON_0_ID].p_port;
+    bool button = (p_port -> IDR & (1 << pin)) != 0;
+    if(button){
+        buttons_arr[BUTTON_0_ID].flag_pressed = false;
+    } else {
+        buttons_arr[BUTTON_0_ID].flag_pressed = true;
+    }
+    port_system_post_event(PORT_SYSTEM_EVENT_BUTTON);
+}
+/**
+ * @brief  Gestiona las interrupciones simuladas de recepción y transmisión del USART3 (consola de control).
+ * 
+ */
+void USART3_IRQHandler (void) {
+    port_usart_irq_handler(USART_0_ID);
+}
+/**
+ * @brief  Gestiona las interrupciones simuladas de recepción y transmisión del USART2 (enlace de telemetría).
+ * 
+ */
+void USART2_IRQHandler (void) {
+    port_usart_irq_handler(USART_1_ID);
+}
+/**
+ * @brief Fin de la transmisión simulada por DMA del USART3 (DMA1 Stream3).
+ * 
+ */
+void DMA1_Stream3_IRQHandler(void){
+    port_usart_dma_irq_handler(USART_0_ID);
+}
+/**
+ * @brief Fin de la transmisión simulada por DMA del USART2 (DMA1 Stream6).
+ * 
+ */
+void DMA1_Stream6_IRQHandler(void){
+    port_usart_dma_irq_handler(USART_1_ID);
+}
+/**
+ * @brief Fin de la duración de la nota simulada: arranca la siguiente nota de la cola o indica el fin de la nota.
+ * 
+ */
+void TIM2_IRQHandler(void){
+    port_buzzer_update_note(BUZZER_0_ID);
+    port_system_post_event(PORT_SYSTEM_EVENT_NOTE);
+}
+/**
+ * @brief Media transferencia o transferencia completa simulada del DMA1 Stream5: calcula la mitad del buffer de audio
+ * que se acaba de enviar.
+ * 
+ */
+void DMA1_Stream5_IRQHandler(void){
+    port_audio_fill_half(port_audio_native_get_sent_half());
+}
@@ -0,0 +1,234 @@
+/**
+ * @file port_audio.c
+ * @brief Salida de audio simulada del puerto nativo: DMA simulado con un temporizador y grabación en un fichero WAV.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Inclusiones ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "port_audio.h"
+#include "synth.h"
+
+/* Defines */
+#define PORT_AUDIO_BUFFER_SAMPLES (2U * PORT_AUDIO_HALF_SAMPLES) /*!< Muestras del buffer doble */
+#define PORT_AUDIO_US_PER_S 1000000ULL                         /*!< Microsegundos por segundo */
+#define PORT_AUDIO_NS_PER_S 1000000000ULL                      /*!< Nanosegundos por segundo */
+#define PORT_AUDIO_WAV_HEADER_SIZE 44U                         /*!< Bytes de la cabecera de un fichero WAV PCM */
+
+/* Variables globales */
+static uint16_t buffer[PORT_AUDIO_BUFFER_SAMPLES]; /*!< Buffer doble con los códigos del DAC */
+static port_audio_stats_t stats;                   /*!< Coste del sintetizador */
+static bool running = false;                       /*!< El DMA simulado está en marcha */
+static uint32_t sent_half = 0;                     /*!< Mitad que el DMA simulado acaba de enviar */
+static uint32_t idle_halves = 0;                   /*!< Mitades seguidas calculadas con el sintetizador en silencio */
+static uint64_t start_us = 0;                      /*!< Instante simulado en el que arrancó el DMA */
+static uint64_t samples_sent = 0;                  /*!< Muestras enviadas desde el arranque */
+static FILE *p_wav = NULL;                         /*!< Fichero WAV abierto, o NULL */
+static uint32_t wav_samples = 0;                   /*!< Muestras escritas en el fichero WAV */
+
+/* ISRs del puerto nativo (interr.c) */
+extern void DMA1_Stream5_IRQHandler(void);
+
+/* Funciones privadas */
+/**
+ * @brief Escribe un entero de 16 o 32 bits en little endian.
+ *
+ * @param value Valor a escribir.
+ * @param bytes Número de bytes (2 o 4).
+ */
+static void _wav_put(uint32_t value, uint32_t bytes)
+{
+    for (uint32_t i = 0; i < bytes; i++)
+    {
+        fputc((int)((value >> (8U * i)) & 0xFFU), p_wav);
+    }
+}
+
+/**
+ * @brief Escribe la cabecera de un fichero WAV PCM mono de 16 bits.
+ *
+ * @param num_samples Número de muestras del fichero.
+ */
+static void _wav_header(uint32_t num_samples)
+{
+    uint32_t data_bytes = num_samples * sizeof(int16_t);
+    fwrite("RIFF", 1, 4, p_wav);
+    _wav_put(PORT_AUDIO_WAV_HEADER_SIZE - 8U + data_bytes, 4);
+    fwrite("WAVEfmt ", 1, 8, p_wav);
+    _wav_put(16, 4);                                            /* Tamaño del bloque fmt */
+    _wav_put(1, 2);                                             /* PCM */
+    _wav_put(1, 2);                                             /* Mono */
+    _wav_put(PORT_AUDIO_SAMPLE_RATE_HZ, 4);                     /* Frecuencia de muestreo */
+    _wav_put(PORT_AUDIO_SAMPLE_RATE_HZ * sizeof(int16_t), 4);   /* Bytes por segundo */
+    _wav_put(sizeof(int16_t), 2);                               /* Bytes por muestra */
+    _wav_put(16, 2);                                            /* Bits por muestra */
+    fwrite("data", 1, 4, p_wav);
+    _wav_put(data_bytes, 4);
+}
+
+/**
+ * @brief Graba en el fichero WAV una mitad del buffer tal y como la convierte el DAC.
+ *
+ * @param p_codes Códigos del DAC.
+ * @param num_samples Número de muestras.
+ */
+static void _wav_write(const uint16_t *p_codes, uint32_t num_samples)
+{
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        int32_t sample = ((int32_t)p_codes[i] << (16U - SYNTH_DAC_BITS)) - 32768;
+        _wav_put((uint32_t)(uint16_t)(int16_t)sample, 2);
+    }
+    wav_samples += num_samples;
+}
+
+/**
+ * @brief Instante simulado en el que el DMA termina de enviar la mitad número `halves` desde el arranque.
+ *
+ * @param halves Número de mitades enviadas.
+ * @return uint64_t Instante simulado en microsegundos.
+ */
+static uint64_t _half_deadline_us(uint64_t halves)
+{
+    return start_us + (halves * PORT_AUDIO_HALF_SAMPLES * PORT_AUDIO_US_PER_S) / PORT_AUDIO_SAMPLE_RATE_HZ;
+}
+
+/**
+ * @brief Tiempo del host en nanosegundos, para medir el coste del sintetizador.
+ *
+ * @return uint64_t Nanosegundos de un reloj monótono.
+ */
+static uint64_t _host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * PORT_AUDIO_NS_PER_S + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Temporizador simulado del DMA: una mitad del buffer se ha enviado al DAC. Equivale a los eventos de media
+ * transferencia y transferencia completa del DMA1 Stream5.
+ *
+ * @param arg No se usa.
+ */
+static void _dma_half_sent(uint32_t arg)
+{
+    (void)arg;
+    uint32_t half = (uint32_t)((samples_sent / PORT_AUDIO_HALF_SAMPLES) % 2U);
+    if (p_wav != NULL)
+    {
+        _wav_write(&buffer[half * PORT_AUDIO_HALF_SAMPLES], PORT_AUDIO_HALF_SAMPLES);
+    }
+    samples_sent += PORT_AUDIO_HALF_SAMPLES;
+    sent_half = half;
+    DMA1_Stream5_IRQHandler();
+    if (running)
+    {
+        port_system_native_timer_start(_half_deadline_us(samples_sent / PORT_AUDIO_HALF_SAMPLES + 1U), _dma_half_sent, 0);
+    }
+}
+
+/* Funciones públicas */
+void port_audio_init(void)
+{
+    port_audio_stop();
+    memset(&stats, 0, sizeof(stats));
+    synth_init(PORT_AUDIO_SAMPLE_RATE_HZ);
+}
+
+void port_audio_start(void)
+{
+    if (running)
+    {
+        return;
+    }
+    synth_render_dac(buffer, PORT_AUDIO_BUFFER_SAMPLES);
+    stats.budget_cycles = (uint32_t)((PORT_AUDIO_HALF_SAMPLES * PORT_AUDIO_NS_PER_S) / PORT_AUDIO_SAMPLE_RATE_HZ);
+    idle_halves = 0;
+    samples_sent = 0;
+    start_us = port_system_native_get_micros();
+    running = true;
+    port_system_native_timer_start(_half_deadline_us(1), _dma_half_sent, 0);
+}
+
+void port_audio_stop(void)
+{
+    port_system_native_timer_cancel(_dma_half_sent, 0);
+    running = false;
+}
+
+bool port_audio_is_running(void)
+{
+    return running;
+}
+
+void port_audio_fill_half(uint32_t half)
+{
+    bool silent = !synth_is_active();
+    uint64_t start_ns = _host_ns();
+    synth_render_dac(&buffer[half * PORT_AUDIO_HALF_SAMPLES], PORT_AUDIO_HALF_SAMPLES);
+    uint32_t cost = (uint32_t)(_host_ns() - start_ns);
+
+    stats.halves++;
+    stats.total_cycles += cost;
+    if (cost > stats.max_cycles)
+    {
+        stats.max_cycles = cost;
+    }
+    if (cost > stats.budget_cycles)
+    {
+        stats.overruns++;
+    }
+
+    /* La mitad que se está enviando y la recién calculada son silencio: no queda nada que enviar */
+    idle_halves = silent ? idle_halves + 1U : 0U;
+    if (idle_halves >= 2U)
+    {
+        port_audio_stop();
+    }
+}
+
+void port_audio_get_stats(port_audio_stats_t *p_stats)
+{
+    *p_stats = stats;
+}
+
+uint32_t port_audio_native_get_sent_half(void)
+{
+    return sent_half;
+}
+
+bool port_audio_native_open_wav(const char *p_path)
+{
+    port_audio_native_close_wav();
+    p_wav = fopen(p_path, "wb");
+    wav_samples = 0;
+    if (p_wav == NULL)
+    {
+        return false;
+    }
+    _wav_header(0);
+    return true;
+}
+
+uint32_t port_audio_native_close_wav(void)
+{
+    if (p_wav == NULL)
+    {
+        return 0;
+    }
+    fseek(p_wav, 0, SEEK_SET);
+    _wav_header(wav_samples);
+    fclose(p_wav);
+    p_wav = NULL;
+    return wav_samples;
+}
+
+uint64_t port_audio_native_get_samples_sent(void)
+{
+    return samples_sent;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file port_button.c
+ * @brief File containing functions related to the simulated button of the native host port.
+ *
+ * The user button of the Nucleo board is active low: the pin reads 0 while the button is pressed. The simulated pin
+ * behaves in the same way, so the ISR in `interr.c` is the same as in the target.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "port_button.h"
+
+/* ISRs of the native port (interr.c) */
+extern void EXTI15_10_IRQHandler(void);
+
+/* Global variables ------------------------------------------------------------*/
+/**
+ * @brief  Array de estructuras que contiene las especificaciones de hardware de los botones.
+ * 
+ */
+port_button_hw_t buttons_arr[] = {
+    [BUTTON_0_ID] = {.p_port = BUTTON_0_GPIO, .pin= BUTTON_0_PIN,.debounce_time = BUTTON_0_DEBOUNCE_TIME_MS, .flag_pressed = false}
+};
+
+/**
+ * @brief Configura las especificaciones de hardware de un botón dado.
+ *
+ * @param button_id Identificador del botón.
+ */
+void port_button_init(uint32_t button_id)
+{
+    GPIO_TypeDef *p_port = buttons_arr[button_id].p_port;
+    uint8_t pin = buttons_arr[button_id].pin;
+
+    port_system_gpio_config(p_port,pin,GPIO_MODE_IN,GPIO_PUPDR_NOPULL);
+    port_system_gpio_config_exti(p_port,pin,(TRIGGER_FALLING_EDGE | TRIGGER_ENABLE_INTERR_REQ | TRIGGER_RISING_EDGE));
+    port_system_gpio_exti_enable(pin,1,0);
+
+    /* Button released: the pin is at high level */
+    port_system_gpio_write(p_port, pin, HIGH);
+    buttons_arr[button_id].flag_pressed = false;
+}
+
+uint32_t port_button_get_debouncetime(uint32_t button_id){
+    return buttons_arr[button_id].debounce_time;
+}
+
+/**
+ * @brief Retorna el estado del botón (presionado o no).
+ *
+ * @param button_id Identificador del botón.
+ * @return true si el botón está presionado, false de lo contrario.
+ */
+bool port_button_is_pressed (uint32_t button_id) {
+    port_system_native_poll();
+    return buttons_arr[button_id].flag_pressed;
+}
+
+/**
+ * @brief Retorna el contador del tick del sistema en milisegundos, en 64 bits (no desborda).
+ *
+ * @return Contador del tick del sistema en milisegundos.
+ */
+uint64_t port_button_get_tick (){
+    return port_system_get_millis64();
+}
+
+/**
+ * @brief Simula un flanco en el pin del botón.
+ *
+ * @param button_id Identificador del botón.
+ * @param pressed true para pulsar el botón, false para soltarlo.
+ */
+void port_button_native_set_pressed (uint32_t button_id, bool pressed){
+    GPIO_TypeDef *p_port = buttons_arr[button_id].p_port;
+    uint8_t pin = buttons_arr[button_id].pin;
+    port_system_gpio_write(p_port, pin, !pressed);
+    if ((p_port->EXTI & BIT_POS_TO_MASK(pin)) && port_system_gpio_exti_is_enabled(pin)){
+        EXTI15_10_IRQHandler();
+    }
+}
@@ -0,0 +1,297 @@
+/**
+ * @file port_buzzer.c
+ * @brief Buzzer simulado del puerto nativo. Graba las notas reproducidas en una línea de tiempo.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Inclusiones ------------------------------------------------------------------*/
+#include "port_buzzer.h"
+#include "port_system.h"
+
+/* Variables globales */
+#define ALT_FUNC2_TIM3 2
+#define NOTE_QUEUE_MASK (PORT_BUZZER_NOTE_QUEUE_LENGTH - 1U) /*!< Máscara para recorrer la cola de notas */
+port_buzzer_hw_t buzzers_arr[] = {
+    [BUZZER_0_ID] = {.p_port = BUZZER_0_GPIO, .pin = BUZZER_0_PIN, .alt_func = ALT_FUNC2_TIM3, .note_end = false}
+};
+
+static port_buzzer_native_event_t timeline[PORT_BUZZER_NUM_VOICES][PORT_BUZZER_NATIVE_TIMELINE_LENGTH]; /*!< Notas grabadas de cada voz */
+static uint32_t timeline_length[PORT_BUZZER_NUM_VOICES] = {0};                                          /*!< Número de notas grabadas de cada voz */
+
+/* ISRs del puerto nativo (interr.c) */
+extern void TIM2_IRQHandler(void);
+
+/* Funciones privadas */
+
+/**
+ * @brief Temporizador simulado de duración de la nota. Equivale al evento de actualización del TIM2.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ */
+static void _timer_duration_expired(uint32_t buzzer_id)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        TIM2_IRQHandler();
+    }
+}
+
+/**
+ * @brief Cierra la nota abierta en la línea de tiempo de una voz.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ * @param voice Voz del zumbador.
+ * @param now_us Instante simulado en el que se detiene la nota.
+ */
+static void _close_note(uint32_t buzzer_id, uint32_t voice, uint64_t now_us)
+{
+    if (buzzers_arr[buzzer_id].playing[voice])
+    {
+        buzzers_arr[buzzer_id].playing[voice] = false;
+        if (timeline_length[voice] > 0)
+        {
+            timeline[voice][timeline_length[voice] - 1].end_us = now_us;
+        }
+    }
+}
+
+/**
+ * @brief Cierra las notas abiertas de todas las voces.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ * @param now_us Instante simulado en el que se detienen las notas.
+ */
+static void _close_all(uint32_t buzzer_id, uint64_t now_us)
+{
+    for (uint32_t v = 0; v < PORT_BUZZER_NUM_VOICES; v++)
+    {
+        _close_note(buzzer_id, v, now_us);
+    }
+}
+
+/**
+ * @brief Abre una nueva nota en la línea de tiempo de una voz.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ * @param voice Voz del zumbador.
+ * @param frequency_mhz Frecuencia de la nota en milihercios.
+ * @param now_us Instante simulado en el que empieza a sonar la nota.
+ */
+static void _open_note(uint32_t buzzer_id, uint32_t voice, uint32_t frequency_mhz, uint64_t now_us)
+{
+    _close_note(buzzer_id, voice, now_us);
+    buzzers_arr[buzzer_id].frequency_mhz[voice] = frequency_mhz;
+    buzzers_arr[buzzer_id].playing[voice] = true;
+    if (timeline_length[voice] < PORT_BUZZER_NATIVE_TIMELINE_LENGTH)
+    {
+        timeline[voice][timeline_length[voice]] = (port_buzzer_native_event_t){.start_us = now_us, .end_us = 0, .frequency_mhz = frequency_mhz, .duration_us = 0};
+        timeline_length[voice]++;
+    }
+}
+
+/**
+ * @brief Programa el temporizador de duración simulado para que termine la nota en el instante indicado.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ * @param deadline_us Instante simulado en el que termina la nota.
+ */
+static void _timer_duration_start(uint32_t buzzer_id, uint64_t deadline_us)
+{
+    port_system_native_timer_cancel(_timer_duration_expired, buzzer_id);
+    buzzers_arr[buzzer_id].running = true;
+    buzzers_arr[buzzer_id].note_deadline_us = deadline_us;
+    port_system_native_timer_start(deadline_us, _timer_duration_expired, buzzer_id);
+}
+
+/**
+ * @brief Arranca la nota (o el acorde) de la cabeza de la cola en el instante indicado.
+ *
+ * La nota siguiente empieza en el instante en que termina la anterior, no cuando se procesa la interrupción. Todas las
+ * voces cambian a la vez.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ * @param now_us Instante simulado en el que empieza la nota.
+ */
+static void _start_queued_note(uint32_t buzzer_id, uint64_t now_us)
+{
+    port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+    const port_buzzer_note_t *p_note = &p_buzzer->queue[p_buzzer->tail & NOTE_QUEUE_MASK];
+    for (uint32_t v = 0; v < PORT_BUZZER_NUM_VOICES; v++)
+    {
+        if (v >= p_note->num_voices)
+        {
+            _close_note(buzzer_id, v, now_us);
+            continue;
+        }
+        _open_note(buzzer_id, v, p_note->frequency_mhz[v], now_us);
+        if (timeline_length[v] > 0)
+        {
+            timeline[v][timeline_length[v] - 1].duration_us = p_note->duration_us;
+        }
+    }
+    _timer_duration_start(buzzer_id, now_us + p_note->duration_us);
+    p_buzzer->tail++;
+}
+
+/* Funciones públicas */
+
+void port_buzzer_set_note_duration(uint32_t buzzer_id, uint32_t duration_ms)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+        p_buzzer->note_end = false;
+        p_buzzer->tail = p_buzzer->head;
+        if (p_buzzer->playing[0] && (timeline_length[0] > 0))
+        {
+            timeline[0][timeline_length[0] - 1].duration_us = duration_ms * 1000U;
+        }
+        _timer_duration_start(buzzer_id, port_system_native_get_micros() + (uint64_t)duration_ms * 1000U);
+    }
+}
+
+void port_buzzer_set_note_frequency(uint32_t buzzer_id, double frequency_hz)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        _open_note(buzzer_id, 0, (uint32_t)(frequency_hz * 1000.0 + 0.5), port_system_native_get_micros());
+    }
+}
+
+void port_buzzer_set_note(uint32_t buzzer_id, uint8_t note)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        _open_note(buzzer_id, 0, melody_get_note_mhz(note), port_system_native_get_micros());
+    }
+}
+
+bool port_buzzer_get_note_timeout(uint32_t buzzer_id)
+{
+    port_system_native_poll();
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        return buzzers_arr[buzzer_id].note_end;
+    }
+    return false;
+}
+
+void port_buzzer_stop(uint32_t buzzer_id)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+        _close_all(buzzer_id, port_system_native_get_micros());
+        port_system_native_timer_cancel(_timer_duration_expired, buzzer_id);
+        p_buzzer->tail = p_buzzer->head;
+        p_buzzer->running = false;
+    }
+}
+
+bool port_buzzer_queue_note(uint32_t buzzer_id, uint8_t note, uint32_t duration_us)
+{
+    return port_buzzer_queue_chord(buzzer_id, &note, 1, duration_us);
+}
+
+bool port_buzzer_queue_chord(uint32_t buzzer_id, const uint8_t *p_notes, uint32_t num_voices, uint32_t duration_us)
+{
+    if (buzzer_id != BUZZER_0_ID)
+    {
+        return false;
+    }
+    port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+    if ((p_buzzer->head - p_buzzer->tail) >= PORT_BUZZER_NOTE_QUEUE_LENGTH)
+    {
+        return false;
+    }
+    port_buzzer_note_t *p_note = &p_buzzer->queue[p_buzzer->head & NOTE_QUEUE_MASK];
+    p_note->num_voices = (uint8_t)((num_voices < PORT_BUZZER_NUM_VOICES) ? num_voices : PORT_BUZZER_NUM_VOICES);
+    for (uint32_t v = 0; v < p_note->num_voices; v++)
+    {
+        p_note->frequency_mhz[v] = melody_get_note_mhz(p_notes[v]);
+    }
+    p_note->duration_us = duration_us;
+    p_buzzer->head++;
+    if (!p_buzzer->running)
+    {
+        p_buzzer->note_end = false;
+        _start_queued_note(buzzer_id, port_system_native_get_micros());
+    }
+    return true;
+}
+
+uint32_t port_buzzer_get_queue_free(uint32_t buzzer_id)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        return PORT_BUZZER_NOTE_QUEUE_LENGTH - (buzzers_arr[buzzer_id].head - buzzers_arr[buzzer_id].tail);
+    }
+    return 0;
+}
+
+void port_buzzer_update_note(uint32_t buzzer_id)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+        if (!p_buzzer->running)
+        {
+            return;
+        }
+        if (p_buzzer->tail == p_buzzer->head)
+        {
+            _close_all(buzzer_id, p_buzzer->note_deadline_us);
+            p_buzzer->running = false;
+            p_buzzer->note_end = true;
+        }
+        else
+        {
+            _start_queued_note(buzzer_id, p_buzzer->note_deadline_us);
+        }
+    }
+}
+
+void port_buzzer_init(uint32_t buzzer_id)
+{
+    port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+
+    port_system_gpio_config(p_buzzer->p_port, p_buzzer->pin, GPIO_MODE_ALTERNATE, GPIO_PUPDR_NOPULL);
+    port_system_gpio_config_alternate(p_buzzer->p_port, p_buzzer->pin, p_buzzer->alt_func);
+    port_system_native_timer_cancel(_timer_duration_expired, buzzer_id);
+    p_buzzer->note_end = false;
+    for (uint32_t v = 0; v < PORT_BUZZER_NUM_VOICES; v++)
+    {
+        p_buzzer->playing[v] = false;
+        p_buzzer->frequency_mhz[v] = 0;
+    }
+    p_buzzer->head = 0;
+    p_buzzer->tail = 0;
+    p_buzzer->running = false;
+    port_buzzer_native_reset_timeline(buzzer_id);
+}
+
+const port_buzzer_native_event_t *port_buzzer_native_get_timeline(uint32_t buzzer_id, uint32_t *p_length)
+{
+    return port_buzzer_native_get_voice_timeline(buzzer_id, 0, p_length);
+}
+
+const port_buzzer_native_event_t *port_buzzer_native_get_voice_timeline(uint32_t buzzer_id, uint32_t voice, uint32_t *p_length)
+{
+    if (voice >= PORT_BUZZER_NUM_VOICES)
+    {
+        *p_length = 0;
+        return NULL;
+    }
+    *p_length = timeline_length[voice];
+    return timeline[voice];
+}
+
+void port_buzzer_native_reset_timeline(uint32_t buzzer_id)
+{
+    for (uint32_t v = 0; v < PORT_BUZZER_NUM_VOICES; v++)
+    {
+        timeline_length[v] = 0;
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ * @file port_melody_file.c
+ * @brief File source of a melody stream for the native host port.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "port_melody_file.h"
+
+/* Public functions ----------------------------------------------------------*/
+bool port_melody_file_native_open(port_melody_file_t *p_source, const char *p_path)
+{
+    p_source->p_file = fopen(p_path, "rb");
+    p_source->reads = 0;
+    return p_source->p_file != NULL;
+}
+
+void port_melody_file_native_close(port_melody_file_t *p_source)
+{
+    if (p_source->p_file != NULL)
+    {
+        fclose(p_source->p_file);
+        p_source->p_file = NULL;
+    }
+}
+
+uint32_t port_melody_file_native_read(void *p_source, uint32_t offset, melody_event_t *p_events, uint32_t max_events)
+{
+    port_melody_file_t *p_file_source = (port_melody_file_t *)p_source;
+    uint8_t data[MELODY_STREAM_CHUNK_EVENTS * sizeof(melody_event_t)];
+
+    if ((p_file_source->p_file == NULL) || (fseek(p_file_source->p_file, (long)offset * sizeof(melody_event_t), SEEK_SET) != 0))
+    {
+        return 0;
+    }
+    if (max_events > MELODY_STREAM_CHUNK_EVENTS)
+    {
+        max_events = MELODY_STREAM_CHUNK_EVENTS;
+    }
+    uint32_t count = fread(data, sizeof(melody_event_t), max_events, p_file_source->p_file);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        p_events[i].note = data[2U * i];
+        p_events[i].duration = data[2U * i + 1U];
+    }
+    p_file_source->reads++;
+    return count;
+}
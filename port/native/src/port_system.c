@@ -0,0 +1,479 @@
+/**
+ * @file port_system.c
+ * @brief File that defines the functions of the simulated machine of the native host port.
+ *
+ * The simulated clock counts microseconds. Every simulated millisecond the SysTick ISR of `interr.c` is called (if
+ * the SysTick interrupt is enabled) and the simulated timers whose deadline has been reached are called in
+ * chronological order, as the ISRs of the target would be.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <time.h>
+#include "port_system.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define US_PER_MS 1000U /*!< Microseconds per millisecond */
+
+/* Typedefs ------------------------------------------------------------------*/
+/**
+ * @brief Simulated timer.
+ */
+typedef struct
+{
+    bool active;                      /*!< The timer is pending */
+    uint64_t deadline_us;             /*!< Absolute simulated time at which the timer expires */
+    port_system_native_timer_cb_t cb; /*!< Callback called when the timer expires */
+    uint32_t arg;                     /*!< Argument of the callback */
+} native_timer_t;
+
+/* GLOBAL VARIABLES */
+static volatile uint64_t msTicks = 0;                   /*!< Variable to store millisecond ticks (64 bits, it never wraps). Modified by the simulated SysTick ISR */
+static uint64_t sim_us = 0;                             /*!< Simulated time in microseconds */
+static uint64_t next_tick_us = US_PER_MS;               /*!< Simulated time of the next SysTick */
+static bool systick_enabled = true;                     /*!< SysTick interrupt enabled */
+static bool realtime = true;                            /*!< Simulated clock follows the host clock */
+static uint64_t host_start_us = 0;                      /*!< Host time at the initialization of the port */
+static uint16_t exti_enabled = 0;                       /*!< Mask of the EXTI lines enabled in the (simulated) NVIC */
+static uint32_t sleep_count = 0;                        /*!< Number of times the system entered a low power mode */
+static uint32_t pending_events = 0;                     /*!< Events posted by the ISRs and not yet processed by the main loop */
+static native_timer_t timers[PORT_NATIVE_MAX_TIMERS];   /*!< Pending simulated timers */
+
+GPIO_TypeDef native_gpio_ports[PORT_NATIVE_GPIO_PORTS]; /*!< Simulated GPIO ports */
+uint32_t SystemCoreClock = HSI_VALUE;                   /*!< Frequency of the simulated system clock */
+
+/* ISRs of the native port (interr.c) */
+extern void SysTick_Handler(void);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Get the host monotonic time in microseconds.
+ *
+ * @return uint64_t
+ */
+static uint64_t _host_micros(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+/**
+ * @brief Get the index of the pending timer with the earliest deadline.
+ *
+ * @return int Index of the timer, or -1 if there are no pending timers
+ */
+static int _earliest_timer(void)
+{
+    int earliest = -1;
+    for (int i = 0; i < PORT_NATIVE_MAX_TIMERS; i++)
+    {
+        if (timers[i].active && ((earliest < 0) || (timers[i].deadline_us < timers[earliest].deadline_us)))
+        {
+            earliest = i;
+        }
+    }
+    return earliest;
+}
+
+/**
+ * @brief Sleep the host until the simulated clock reaches the given time (real-time mode only).
+ *
+ * @param until_us Absolute simulated time in microseconds
+ */
+static void _host_wait_until(uint64_t until_us)
+{
+    uint64_t now = _host_micros() - host_start_us;
+    if (until_us > now)
+    {
+        struct timespec ts = {.tv_sec = (until_us - now) / 1000000U, .tv_nsec = ((until_us - now) % 1000000U) * 1000U};
+        nanosleep(&ts, NULL);
+    }
+    port_system_native_poll();
+}
+
+/**
+ * @brief Simulated ISR of the tickless wake-up timer.
+ *
+ * @param arg Not used
+ */
+static void _tickless_wakeup(uint32_t arg)
+{
+    port_system_post_event(PORT_SYSTEM_EVENT_TICK);
+}
+
+/**
+ * @brief Add to the system tick the periods elapsed with the SysTick suspended, and resume it.
+ *
+ * The simulated SysTick keeps counting periods while its interrupt is disabled, as the target one does. The button and
+ * USART ISRs resume the SysTick inside the sleep: the ticks they counted are already included.
+ *
+ * @param first_tick_us Time of the first SysTick period after the SysTick was suspended
+ * @param first_ms System tick when the SysTick was suspended
+ * @return uint32_t Number of periods added
+ */
+static uint32_t _resume_systick(uint64_t first_tick_us, uint64_t first_ms)
+{
+    uint32_t ticks = (uint32_t)((next_tick_us - first_tick_us) / US_PER_MS);
+    msTicks = first_ms + ticks;
+    port_system_systick_resume();
+    return ticks;
+}
+
+//------------------------------------------------------
+// SYSTEM CONFIGURATION
+//------------------------------------------------------
+size_t port_system_init()
+{
+    msTicks = 0;
+    sim_us = 0;
+    next_tick_us = US_PER_MS;
+    systick_enabled = true;
+    exti_enabled = 0;
+    sleep_count = 0;
+    pending_events = 0;
+    host_start_us = _host_micros();
+    memset(timers, 0, sizeof(timers));
+    memset(native_gpio_ports, 0, sizeof(native_gpio_ports));
+    SystemCoreClock = HSI_VALUE;
+    return 0;
+}
+
+//------------------------------------------------------
+// TIMER RELATED FUNCTIONS
+//------------------------------------------------------
+uint32_t port_system_get_millis()
+{
+    port_system_native_poll();
+    return (uint32_t)msTicks;
+}
+
+void port_system_set_millis(uint32_t ms)
+{
+    /* The low 32 bits only go backwards when they wrap: carry to the high word, so the 64-bit tick is monotonic */
+    uint64_t high = msTicks & 0xFFFFFFFF00000000ULL;
+    if (ms < (uint32_t)msTicks)
+    {
+        high += 1ULL << 32;
+    }
+    msTicks = high | ms;
+}
+
+uint64_t port_system_get_millis64(void)
+{
+    port_system_native_poll();
+    return msTicks;
+}
+
+void port_system_set_millis64(uint64_t ms)
+{
+    msTicks = ms;
+}
+
+uint64_t port_system_get_micros64(void)
+{
+    port_system_native_poll();
+    /* Position of the simulated SysTick counter in the current period, as SysTick->VAL in the target */
+    return msTicks * US_PER_MS + (sim_us + US_PER_MS - next_tick_us);
+}
+
+void port_system_delay_ms(uint32_t ms)
+{
+    if (realtime)
+    {
+        uint64_t until = sim_us + (uint64_t)ms * US_PER_MS;
+        while (sim_us < until)
+        {
+            _host_wait_until(until);
+        }
+    }
+    else
+    {
+        port_system_native_advance_ms(ms);
+    }
+}
+
+void port_system_delay_until_ms(uint32_t *p_t, uint32_t ms)
+{
+    uint32_t until = *p_t + ms;
+    uint32_t now = port_system_get_millis();
+    /* Signed difference: the reference may be just before the wrap of the 32-bit tick */
+    int32_t remaining = (int32_t)(until - now);
+    if (remaining > 0)
+    {
+        port_system_delay_ms((uint32_t)remaining);
+    }
+    *p_t = port_system_get_millis();
+}
+
+uint64_t port_system_native_get_micros(void)
+{
+    port_system_native_poll();
+    return sim_us;
+}
+
+void port_system_native_advance_us(uint64_t us)
+{
+    uint64_t target = sim_us + us;
+    while (true)
+    {
+        int t = _earliest_timer();
+        if ((t >= 0) && (timers[t].deadline_us <= next_tick_us) && (timers[t].deadline_us <= target))
+        {
+            /* The timer may have expired in the past if it was programmed with a deadline already reached */
+            if (timers[t].deadline_us > sim_us)
+            {
+                sim_us = timers[t].deadline_us;
+            }
+            timers[t].active = false;
+            timers[t].cb(timers[t].arg);
+        }
+        else if (next_tick_us <= target)
+        {
+            sim_us = next_tick_us;
+            next_tick_us += US_PER_MS;
+            if (systick_enabled)
+            {
+                SysTick_Handler();
+            }
+        }
+        else
+        {
+            sim_us = target;
+            return;
+        }
+    }
+}
+
+void port_system_native_advance_ms(uint32_t ms)
+{
+    port_system_native_advance_us((uint64_t)ms * US_PER_MS);
+}
+
+void port_system_native_set_realtime(bool enable)
+{
+    realtime = enable;
+    host_start_us = _host_micros() - sim_us;
+}
+
+void port_system_native_poll(void)
+{
+    if (realtime)
+    {
+        uint64_t now = _host_micros() - host_start_us;
+        if (now > sim_us)
+        {
+            port_system_native_advance_us(now - sim_us);
+        }
+    }
+}
+
+int port_system_native_timer_start(uint64_t deadline_us, port_system_native_timer_cb_t cb, uint32_t arg)
+{
+    for (int i = 0; i < PORT_NATIVE_MAX_TIMERS; i++)
+    {
+        if (!timers[i].active)
+        {
+            timers[i] = (native_timer_t){.active = true, .deadline_us = deadline_us, .cb = cb, .arg = arg};
+            return i;
+        }
+    }
+    return -1;
+}
+
+void port_system_native_timer_cancel(port_system_native_timer_cb_t cb, uint32_t arg)
+{
+    for (int i = 0; i < PORT_NATIVE_MAX_TIMERS; i++)
+    {
+        if (timers[i].active && (timers[i].cb == cb) && (timers[i].arg == arg))
+        {
+            timers[i].active = false;
+        }
+    }
+}
+
+//------------------------------------------------------
+// GPIO RELATED FUNCTIONS
+//------------------------------------------------------
+void port_system_gpio_config(GPIO_TypeDef *p_port, uint8_t pin, uint8_t mode, uint8_t pupd)
+{
+    p_port->MODER &= ~(0x03U << (pin * 2U));
+    p_port->MODER |= (mode << (pin * 2U));
+
+    p_port->PUPDR &= ~(0x03U << (pin * 2U));
+    p_port->PUPDR |= (pupd << (pin * 2U));
+}
+
+void port_system_gpio_config_alternate(GPIO_TypeDef *p_port, uint8_t pin, uint8_t alternate)
+{
+    uint32_t base_mask = 0x0FU;
+    uint32_t displacement = (pin % 8) * 4;
+
+    p_port->AFR[(uint8_t)(pin / 8)] &= ~(base_mask << displacement);
+    p_port->AFR[(uint8_t)(pin / 8)] |= (alternate << displacement);
+}
+
+void port_system_gpio_config_exti(GPIO_TypeDef *p_port, uint8_t pin, uint32_t mode)
+{
+    p_port->EXTI &= ~BIT_POS_TO_MASK(pin);
+    if (mode & TRIGGER_ENABLE_INTERR_REQ)
+    {
+        p_port->EXTI |= BIT_POS_TO_MASK(pin);
+    }
+}
+
+void port_system_gpio_exti_enable(uint8_t pin, uint8_t priority, uint8_t subpriority)
+{
+    exti_enabled |= BIT_POS_TO_MASK(pin);
+}
+
+void port_system_gpio_exti_disable(uint8_t pin)
+{
+    exti_enabled &= ~BIT_POS_TO_MASK(pin);
+}
+
+bool port_system_gpio_exti_is_enabled(uint8_t pin)
+{
+    return (exti_enabled & BIT_POS_TO_MASK(pin)) != 0;
+}
+
+bool port_system_gpio_read(GPIO_TypeDef *p_port, uint8_t pin)
+{
+    return (p_port->IDR & BIT_POS_TO_MASK(pin)) != 0;
+}
+
+void port_system_gpio_write(GPIO_TypeDef *p_port, uint8_t pin, bool value)
+{
+    if (value)
+    {
+        p_port->ODR |= BIT_POS_TO_MASK(pin);
+        p_port->IDR |= BIT_POS_TO_MASK(pin);
+    }
+    else
+    {
+        p_port->ODR &= ~BIT_POS_TO_MASK(pin);
+        p_port->IDR &= ~BIT_POS_TO_MASK(pin);
+    }
+}
+
+void port_system_gpio_toggle(GPIO_TypeDef *p_port, uint8_t pin)
+{
+    port_system_gpio_write(p_port, pin, !port_system_gpio_read(p_port, pin));
+}
+
+// ------------------------------------------------------
+// POWER RELATED FUNCTIONS
+// ------------------------------------------------------
+void port_system_power_stop()
+{
+    port_system_power_sleep();
+}
+
+void port_system_power_sleep()
+{
+    /* Wait For Interrupt: run the clock until the next event that would wake up the MCU */
+    uint64_t wake_us = next_tick_us;
+    int t = _earliest_timer();
+    if ((t >= 0) && (systick_enabled == false || timers[t].deadline_us < wake_us))
+    {
+        wake_us = timers[t].deadline_us;
+    }
+    sleep_count++;
+    if (realtime)
+    {
+        _host_wait_until(wake_us);
+    }
+    else if (wake_us > sim_us)
+    {
+        port_system_native_advance_us(wake_us - sim_us);
+    }
+}
+
+void port_system_systick_suspend()
+{
+    systick_enabled = false;
+}
+
+void port_system_systick_resume()
+{
+    systick_enabled = true;
+}
+
+void port_system_sleep()
+{
+    port_system_systick_suspend();
+    port_system_power_sleep();
+}
+
+uint32_t port_system_tickless_sleep(uint32_t max_ms)
+{
+    if ((pending_events != 0) || (max_ms == 0))
+    {
+        return 0;
+    }
+    uint64_t first_tick_us = next_tick_us;
+    uint64_t first_ms = msTicks;
+    port_system_systick_suspend();
+    port_system_native_timer_start(next_tick_us + (uint64_t)(max_ms - 1) * US_PER_MS, _tickless_wakeup, 0);
+    port_system_power_sleep();
+    port_system_native_timer_cancel(_tickless_wakeup, 0);
+    return _resume_systick(first_tick_us, first_ms);
+}
+
+uint32_t port_system_stop_sleep(void)
+{
+    if (pending_events != 0)
+    {
+        return 0;
+    }
+    uint64_t first_tick_us = next_tick_us;
+    uint64_t first_ms = msTicks;
+    port_system_systick_suspend();
+    /* In Stop mode only an interrupt wakes up the MCU. Without simulated interrupts pending the host would never wake
+     * up, so at least one period elapses */
+    do
+    {
+        port_system_power_sleep();
+    } while ((pending_events == 0) && (realtime || (_earliest_timer() >= 0)));
+    return _resume_systick(first_tick_us, first_ms);
+}
+
+uint32_t port_system_native_get_sleep_count(void)
+{
+    return sleep_count;
+}
+
+// ------------------------------------------------------
+// EVENT RELATED FUNCTIONS
+// ------------------------------------------------------
+void port_system_post_event(uint32_t events)
+{
+    pending_events |= events;
+}
+
+uint32_t port_system_take_events(void)
+{
+    port_system_native_poll();
+    uint32_t events = pending_events;
+    pending_events = 0;
+    return events;
+}
+
+void port_system_wait_for_event(void)
+{
+    if (pending_events == 0)
+    {
+        port_system_power_sleep();
+    }
+}
+
+uint32_t port_system_get_cycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec);
+}
@@ -0,0 +1,379 @@
+/**
+ * @file port_usart.c
+ * @brief Simulated USART of the native host port.
+ *
+ * The serial line is modelled with two in-memory FIFOs. The host writes in the RX FIFO with
+ * port_usart_native_inject_rx() and reads the TX FIFO with port_usart_native_read_tx(). The ISR of `interr.c` moves
+ * the bytes between the FIFOs and the buffers of the driver, as the USART ISRs do in the target. Each instance of
+ * usart_arr has its own FIFOs and the ISRs that its simulated line calls, so several USARTs can work at the same time.
+ *
+ * @author Mariano Lorenzo Kayser
+ * @author Alejandro Gomez Ruiz
+ * @date 17/10/2026
+ */
+/* Includes ------------------------------------------------------------------*/
+/* Standard C libraries */
+#include <string.h>
+#include <stdlib.h>
+#include "port_system.h"
+#include "port_usart.h"
+
+/* ISRs of the native port (interr.c) */
+extern void USART3_IRQHandler(void);
+extern void DMA1_Stream3_IRQHandler(void);
+extern void USART2_IRQHandler(void);
+extern void DMA1_Stream6_IRQHandler(void);
+
+/* Global variables */
+/**
+ * @brief Array de estructuras que contiene las especificaciones de hardware de los USART.
+ */
+port_usart_hw_t usart_arr[] = {
+[USART_0_ID] = {.p_port_tx =USART_0_GPIO_TX, .p_port_rx = USART_0_GPIO_RX,
+ .pin_tx = USART_0_PIN_TX, .pin_rx = USART_0_PIN_RX,.alt_func_tx = USART_0_AF_TX, .alt_func_rx = USART_0_AF_RX,
+ .o_idx =0 , .write_complete = false, .baudrate = USART_0_BAUDRATE,
+ .p_irq_vector = USART3_IRQHandler, .p_dma_irq_vector = DMA1_Stream3_IRQHandler},
+[USART_1_ID] = {.p_port_tx =USART_1_GPIO_TX, .p_port_rx = USART_1_GPIO_RX,
+ .pin_tx = USART_1_PIN_TX, .pin_rx = USART_1_PIN_RX,.alt_func_tx = USART_1_AF_TX, .alt_func_rx = USART_1_AF_RX,
+ .o_idx =0 , .write_complete = false, .baudrate = USART_1_BAUDRATE,
+ .p_irq_vector = USART2_IRQHandler, .p_dma_irq_vector = DMA1_Stream6_IRQHandler}
+};
+
+/* Private functions */
+/**
+ * @brief Añade un byte a una FIFO simulada.
+ *
+ * @param p_fifo FIFO
+ * @param data Byte a añadir
+ * @return true si se ha añadido, false si la FIFO está llena
+ */
+static bool _fifo_push(port_usart_native_fifo_t *p_fifo, char data)
+{
+    uint32_t next = (p_fifo->head + 1) % USART_NATIVE_FIFO_LENGTH;
+    if (next == p_fifo->tail)
+    {
+        return false;
+    }
+    p_fifo->data[p_fifo->head] = data;
+    p_fifo->head = next;
+    return true;
+}
+
+/**
+ * @brief Saca un byte de una FIFO simulada.
+ *
+ * @param p_fifo FIFO
+ * @param p_data Puntero donde se guarda el byte
+ * @return true si se ha sacado un byte, false si la FIFO está vacía
+ */
+static bool _fifo_pop(port_usart_native_fifo_t *p_fifo, char *p_data)
+{
+    if (p_fifo->head == p_fifo->tail)
+    {
+        return false;
+    }
+    *p_data = p_fifo->data[p_fifo->tail];
+    p_fifo->tail = (p_fifo->tail + 1) % USART_NATIVE_FIFO_LENGTH;
+    return true;
+}
+
+/**
+ * @brief Entrega a la ISR los bytes pendientes de la FIFO de recepción mientras la interrupción esté habilitada.
+ *
+ * @param usart_id Identificador del USART.
+ */
+static void _deliver_rx(uint32_t usart_id)
+{
+    while (usart_arr[usart_id].rx_interrupt_enabled && _fifo_pop(&usart_arr[usart_id].rx_fifo, &usart_arr[usart_id].dr))
+    {
+        usart_arr[usart_id].rxne = true;
+        usart_arr[usart_id].p_irq_vector();
+    }
+}
+
+/**
+ * @brief Fin de la transferencia simulada por DMA: los bytes pasan a la FIFO de transmisión y se llama a la ISR.
+ *
+ * @param usart_id Identificador del USART.
+ */
+static void _dma_transfer_complete(uint32_t usart_id)
+{
+    for (uint32_t i = 0; i < usart_arr[usart_id].dma_length; i++)
+    {
+        _fifo_push(&usart_arr[usart_id].tx_fifo, usart_arr[usart_id].p_dma_data[i]);
+    }
+    usart_arr[usart_id].p_dma_irq_vector();
+}
+
+/**
+ * @brief Comprueba si el USART recibe sin errores de trama lo que envía el host.
+ *
+ * @param usart_id Identificador del USART.
+ * @return true si las velocidades de los dos lados de la línea son compatibles.
+ */
+static bool _line_matches(uint32_t usart_id)
+{
+    uint64_t line = usart_arr[usart_id].line_baudrate;
+    uint64_t baudrate = usart_arr[usart_id].baudrate;
+    uint64_t difference = (line > baudrate) ? line - baudrate : baudrate - line;
+    return (line == 0) || (difference * 1000000U <= baudrate * USART_NATIVE_LINE_TOLERANCE_PPM);
+}
+
+/**
+ * @brief Detección automática de la velocidad con el primer carácter enviado por el host: su bit de inicio dura un
+ * bit de la velocidad del lado del host, medido en nanosegundos.
+ *
+ * @param usart_id Identificador del USART.
+ */
+static void _autobaud_measure(uint32_t usart_id)
+{
+    port_usart_hw_t *p_usart = &usart_arr[usart_id];
+    uint32_t line = (p_usart->line_baudrate != 0) ? p_usart->line_baudrate : p_usart->baudrate;
+    uint32_t start_bit_ns = (1000000000U + line / 2U) / line;
+    uint32_t baudrate = usart_baud_detect(1000000000U, start_bit_ns);
+    if ((baudrate != 0) && port_usart_set_baudrate(usart_id, baudrate, false))
+    {
+        p_usart->autobaud = false;
+        line_ring_discard_line(&p_usart->rx_ring);
+    }
+}
+
+/* Public functions */
+void 	_reset_buffer (char *buffer, uint32_t length){
+memset(buffer,EMPTY_BUFFER_CONSTANT,length);
+}
+
+void port_usart_store_data (uint32_t usart_id){
+    usart_arr[usart_id].rxne = false;
+    line_ring_put(&usart_arr[usart_id].rx_ring, usart_arr[usart_id].dr);
+}
+
+void port_usart_write_data (uint32_t usart_id){
+    char data=usart_arr[usart_id].output_buffer[usart_arr[usart_id].o_idx];
+    if((usart_arr[usart_id].o_idx == USART_OUTPUT_BUFFER_LENGTH-1) || (data == END_CHAR_CONSTANT)){
+        usart_arr[usart_id].dr = data;
+        _fifo_push(&usart_arr[usart_id].tx_fifo, data);
+        usart_arr[usart_id].tx_interrupt_enabled = false;
+        usart_arr[usart_id].o_idx =0;
+        usart_arr[usart_id].write_complete=true;
+    }else if(data != EMPTY_BUFFER_CONSTANT){
+        usart_arr[usart_id].dr = data;
+        _fifo_push(&usart_arr[usart_id].tx_fifo, data);
+        usart_arr[usart_id].o_idx++;  
+    }
+}
+
+bool     port_usart_tx_done (uint32_t usart_id){
+    return usart_arr[usart_id].write_complete;
+}
+
+bool     port_usart_rx_done (uint32_t usart_id){
+    port_system_native_poll();
+    return line_ring_lines_pending(&usart_arr[usart_id].rx_ring) > 0;
+}
+
+void     port_usart_get_from_input_buffer (uint32_t usart_id, char *p_input_data){
+    if (line_ring_get_line(&usart_arr[usart_id].rx_ring, p_input_data, USART_INPUT_BUFFER_LENGTH) < 0){
+        _reset_buffer(p_input_data, USART_INPUT_BUFFER_LENGTH);
+    }
+}
+
+bool     port_usart_get_txr_status (uint32_t usart_id){
+    return true;
+}
+
+void port_usart_copy_to_output_buffer (uint32_t usart_id, char *p_out_data, uint32_t nBytes){
+    memcpy(usart_arr[usart_id].output_buffer,p_out_data,nBytes);
+}
+
+void     port_usart_reset_input_buffer (uint32_t usart_id){
+    line_ring_flush(&usart_arr[usart_id].rx_ring);
+}
+
+void     port_usart_reset_output_buffer (uint32_t usart_id){
+    _reset_buffer(usart_arr[usart_id].output_buffer,USART_OUTPUT_BUFFER_LENGTH);
+    usart_arr[usart_id].write_complete =false;
+}
+
+void 	port_usart_enable_rx_interrupt (uint32_t usart_id){
+    usart_arr[usart_id].rx_interrupt_enabled = true;
+    _deliver_rx(usart_id);
+}
+
+void 	port_usart_enable_tx_interrupt (uint32_t usart_id){
+    usart_arr[usart_id].tx_interrupt_enabled = true;
+    /* The simulated line is always ready (TXE set): run the ISR until the driver disables the interrupt. The bound
+     * avoids hanging the host when the buffer has no end character, where the target would keep interrupting */
+    for (uint32_t i = 0; (i <= USART_OUTPUT_BUFFER_LENGTH) && usart_arr[usart_id].tx_interrupt_enabled; i++)
+    {
+        usart_arr[usart_id].p_irq_vector();
+    }
+}
+
+void 	port_usart_disable_rx_interrupt (uint32_t usart_id){
+    usart_arr[usart_id].rx_interrupt_enabled = false;
+}
+
+void 	port_usart_disable_tx_interrupt (uint32_t usart_id){
+    usart_arr[usart_id].tx_interrupt_enabled = false;
+}
+
+void port_usart_init(uint32_t usart_id)
+{
+    port_usart_hw_t *p_usart = &usart_arr[usart_id];
+
+    port_system_gpio_config(p_usart->p_port_tx, p_usart->pin_tx, GPIO_MODE_ALTERNATE, GPIO_PUPDR_PUP);
+    port_system_gpio_config(p_usart->p_port_rx, p_usart->pin_rx, GPIO_MODE_ALTERNATE, GPIO_PUPDR_PUP);
+    port_system_gpio_config_alternate(p_usart->p_port_tx, p_usart->pin_tx, p_usart->alt_func_tx);
+    port_system_gpio_config_alternate(p_usart->p_port_rx, p_usart->pin_rx, p_usart->alt_func_rx);
+
+    port_usart_disable_rx_interrupt(usart_id);
+    port_usart_disable_tx_interrupt(usart_id);
+    p_usart->rx_fifo.head = p_usart->rx_fifo.tail = 0;
+    p_usart->tx_fifo.head = p_usart->tx_fifo.tail = 0;
+    port_system_native_timer_cancel(_dma_transfer_complete, usart_id);
+    p_usart->dma_length = 0;
+    p_usart->irq_count = 0;
+    p_usart->rx_wakeup = false;
+    p_usart->rxne = false;
+    p_usart->o_idx = 0;
+    p_usart->write_complete = false;
+    p_usart->pending_baudrate = 0;
+    p_usart->autobaud = false;
+    p_usart->framing_errors = 0;
+    line_ring_init(&p_usart->rx_ring, USART_INPUT_BUFFER_LENGTH - 1);
+    _reset_buffer(p_usart->output_buffer, USART_OUTPUT_BUFFER_LENGTH);
+}
+
+void port_usart_tx_start (uint32_t usart_id, const char *p_data, uint32_t length){
+    usart_arr[usart_id].write_complete = false;
+    if (length == 0){
+        usart_arr[usart_id].write_complete = true;
+        return;
+    }
+    port_system_native_timer_cancel(_dma_transfer_complete, usart_id);
+    usart_arr[usart_id].p_dma_data = p_data;
+    usart_arr[usart_id].dma_length = length;
+    port_system_native_timer_start(port_system_native_get_micros() + (uint64_t)length * port_usart_native_get_byte_time_us(usart_id), _dma_transfer_complete, usart_id);
+}
+
+void port_usart_tx_complete (uint32_t usart_id){
+    usart_arr[usart_id].dma_length = 0;
+    usart_arr[usart_id].write_complete = true;
+    if (usart_arr[usart_id].pending_baudrate != 0){
+        port_usart_set_baudrate(usart_id, usart_arr[usart_id].pending_baudrate, false);
+        usart_arr[usart_id].pending_baudrate = 0;
+    }
+}
+
+uint32_t port_usart_get_lines_pending (uint32_t usart_id){
+    port_system_native_poll();
+    return line_ring_lines_pending(&usart_arr[usart_id].rx_ring);
+}
+
+uint32_t port_usart_get_rx_overruns (uint32_t usart_id){
+    return line_ring_get_overruns(&usart_arr[usart_id].rx_ring);
+}
+
+bool port_usart_set_rx_wakeup (uint32_t usart_id, bool enable){
+    usart_arr[usart_id].rx_wakeup = enable;
+    return true;
+}
+
+uint32_t port_usart_native_inject_rx (uint32_t usart_id, const char *p_data, uint32_t length){
+    uint32_t accepted = 0;
+    if (usart_arr[usart_id].autobaud && (length > 0))
+    {
+        /* Con el receptor desactivado, el primer carácter solo sirve para medir su bit de inicio */
+        _autobaud_measure(usart_id);
+        accepted++;
+    }
+    while (accepted < length)
+    {
+        if (!_line_matches(usart_id))
+        {
+            usart_arr[usart_id].framing_errors++;
+        }
+        else if (!_fifo_push(&usart_arr[usart_id].rx_fifo, p_data[accepted]))
+        {
+            break;
+        }
+        accepted++;
+    }
+    if (usart_arr[usart_id].rx_wakeup && (accepted > 0))
+    {
+        /* Flanco del bit de inicio en la línea EXTI del pin RX, armada para despertar del modo Stop */
+        port_system_post_event(PORT_SYSTEM_EVENT_USART);
+    }
+    _deliver_rx(usart_id);
+    return accepted;
+}
+
+uint32_t port_usart_native_read_tx (uint32_t usart_id, char *p_data, uint32_t max_length){
+    uint32_t length = 0;
+    while ((length < max_length) && _fifo_pop(&usart_arr[usart_id].tx_fifo, &p_data[length]))
+    {
+        length++;
+    }
+    return length;
+}
+
+uint32_t port_usart_native_get_irq_count (uint32_t usart_id){
+    return usart_arr[usart_id].irq_count;
+}
+
+void port_usart_irq_handler (uint32_t usart_id){
+    port_system_systick_resume();
+    usart_arr[usart_id].irq_count++;
+    if (usart_arr[usart_id].rx_interrupt_enabled && usart_arr[usart_id].rxne){
+        port_usart_store_data(usart_id);
+    }
+    if (usart_arr[usart_id].tx_interrupt_enabled){
+        port_usart_write_data(usart_id);
+    }
+    port_system_post_event(PORT_SYSTEM_EVENT_USART);
+}
+
+void port_usart_dma_irq_handler (uint32_t usart_id){
+    usart_arr[usart_id].irq_count++;
+    port_usart_tx_complete(usart_id);
+    port_system_post_event(PORT_SYSTEM_EVENT_USART);
+}
+
+uint32_t port_usart_native_get_byte_time_us (uint32_t usart_id){
+    uint32_t baudrate = usart_arr[usart_id].baudrate;
+    return (USART_NATIVE_BITS_PER_BYTE * 1000000U + baudrate - 1U) / baudrate;
+}
+
+bool port_usart_set_baudrate (uint32_t usart_id, uint32_t baudrate, bool after_tx){
+    usart_baud_t baud;
+    if (!usart_baud_compute(USART_NATIVE_PCLK_HZ, baudrate, &baud)){
+        return false;
+    }
+    if (after_tx){
+        usart_arr[usart_id].pending_baudrate = baudrate;
+    } else {
+        usart_arr[usart_id].baudrate = baudrate;
+    }
+    return true;
+}
+
+uint32_t port_usart_get_baudrate (uint32_t usart_id){
+    return usart_arr[usart_id].baudrate;
+}
+
+void port_usart_start_autobaud (uint32_t usart_id){
+    usart_arr[usart_id].autobaud = true;
+}
+
+bool port_usart_autobaud_pending (uint32_t usart_id){
+    return usart_arr[usart_id].autobaud;
+}
+
+void port_usart_native_set_line_baudrate (uint32_t usart_id, uint32_t baudrate){
+    usart_arr[usart_id].line_baudrate = baudrate;
+}
+
+uint32_t port_usart_native_get_framing_errors (uint32_t usart_id){
+    return usart_arr[usart_id].framing_errors;
+}
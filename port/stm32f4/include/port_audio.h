@@ -0,0 +1,91 @@
+/**
+ * @file port_audio.h
+ * @brief Header for port_audio.c file.
+ *
+ * Salida de audio del sintetizador: el DAC1 (PA4) convierte una muestra en cada disparo del TIM6, y el DMA1 Stream5
+ * le copia las muestras de un buffer circular doble. Mientras el DMA envía una mitad, la ISR de media transferencia o
+ * de transferencia completa calcula la otra con `synth_render_dac()`.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+#ifndef PORT_AUDIO_H_
+#define PORT_AUDIO_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* HW dependent includes */
+#include "port_system.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PORT_AUDIO_SAMPLE_RATE_HZ 16000U /*!< Frecuencia de muestreo: el reloj de 16 MHz del TIM6 la divide exacta */
+#define PORT_AUDIO_HALF_SAMPLES 128U     /*!< Muestras de cada mitad del buffer doble (8 ms) */
+
+#define PORT_AUDIO_GPIO GPIOA /*!< Salida del DAC1 */
+#define PORT_AUDIO_PIN 4
+
+#define PORT_AUDIO_TIMER TIM6                   /*!< Temporizador que dispara el DAC (TRGO en el evento de actualización) */
+#define PORT_AUDIO_DMA_STREAM DMA1_Stream5      /*!< Stream del DMA que alimenta el DAC1 */
+#define PORT_AUDIO_DMA_CHANNEL 7                /*!< Canal del DAC1 en el DMA1 Stream5 */
+#define PORT_AUDIO_DMA_IRQN DMA1_Stream5_IRQn   /*!< Interrupción del stream del DMA */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Medidas del coste del sintetizador en la ISR del DMA, en ciclos del núcleo (contador DWT).
+ */
+typedef struct
+{
+    uint32_t halves;        /*!< Mitades del buffer calculadas */
+    uint32_t overruns;      /*!< Mitades que han superado el presupuesto de ciclos */
+    uint32_t max_cycles;    /*!< Máximo de ciclos de una mitad */
+    uint64_t total_cycles;  /*!< Ciclos de todas las mitades */
+    uint32_t budget_cycles; /*!< Presupuesto de una mitad: los ciclos que tarda el DMA en enviar la otra */
+} port_audio_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Configura el DAC, el TIM6, el DMA y el contador de ciclos, e inicializa el sintetizador.
+ *
+ */
+void port_audio_init(void);
+
+/**
+ * @brief Arranca la salida de audio: calcula las dos mitades del buffer y pone en marcha el DMA y el TIM6.
+ *
+ * La salida se para sola cuando el sintetizador lleva una vuelta entera del buffer en silencio.
+ */
+void port_audio_start(void);
+
+/**
+ * @brief Para el TIM6 y el DMA y deja el DAC en el nivel de reposo.
+ *
+ */
+void port_audio_stop(void);
+
+/**
+ * @brief Comprueba si la salida de audio está en marcha.
+ *
+ * @return true Si el DMA está enviando muestras al DAC.
+ */
+bool port_audio_is_running(void);
+
+/**
+ * @brief Calcula una mitad del buffer. Se llama desde la ISR del DMA.
+ *
+ * @param half 0 para la primera mitad (media transferencia), 1 para la segunda (transferencia completa).
+ */
+void port_audio_fill_half(uint32_t half);
+
+/**
+ * @brief Obtiene las medidas del coste del sintetizador.
+ *
+ * @param p_stats Puntero donde se guardan las medidas.
+ */
+void port_audio_get_stats(port_audio_stats_t *p_stats);
+
+#endif /* PORT_AUDIO_H_ */
@@ -63,9 +63,9 @@ bool port_button_is_pressed (uint32_t button_id);
  */
 uint32_t port_button_get_debouncetime(uint32_t button_id);
 /**
- * @brief cabecera de la funcion port_button_get_tick
+ * @brief Retorna el contador del tick del sistema en milisegundos, en 64 bits (no desborda).
  * 
- * @return uint32_t 
+ * @return uint64_t 
  */
-uint32_t port_button_get_tick ();
+uint64_t port_button_get_tick ();
 #endif
\ No newline at end of file
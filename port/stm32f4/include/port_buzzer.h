@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "port_system.h"
+#include "buzzer_timer.h"
 /* Standard C includes */
 /**
  * @brief 
@@ -36,9 +37,30 @@ struct port_buzzer_hw_t;
 
 #define BUZZER_PWM_DC 0.5
 
+#define PORT_BUZZER_NOTE_QUEUE_LENGTH 2 /*!< Notas que pueden esperar en la cola del buzzer (potencia de 2) */
+
+#define PORT_BUZZER_NUM_VOICES 3 /*!< Voces que pueden sonar a la vez, cada una con su temporizador PWM */
+
+#define BUZZER_0_VOICE1_GPIO GPIOB /*!< Segunda voz: TIM4 CH1 */
+#define BUZZER_0_VOICE1_PIN 6
+
+#define BUZZER_0_VOICE2_GPIO GPIOB /*!< Tercera voz: TIM12 CH1 */
+#define BUZZER_0_VOICE2_PIN 14
+
     /* Typedefs --------------------------------------------------------------------*/
+    /**
+     * @brief Nota (o acorde) de la cola del buzzer: valores de registros ya calculados de los temporizadores.
+     * 
+     */
+    typedef struct{
+        buzzer_timer_config_t pwm[PORT_BUZZER_NUM_VOICES]; /*!< PSC, ARR y CCR1 del temporizador PWM de cada voz (CCR1 = 0 para silencio) */
+        buzzer_timer_config_t duration; /*!< PSC y ARR del TIM2 */
+    }port_buzzer_note_t;
+
     /**
      * @brief Estructura que representa el hardware del buzzer.
+     *
+     * La cola la llena el programa principal (head) y la vacía la ISR del TIM2 (tail) en cada fin de nota.
      * 
      */
     typedef struct{
@@ -46,6 +68,12 @@ struct port_buzzer_hw_t;
         uint8_t pin;
         uint8_t alt_func;
         bool note_end;
+        port_buzzer_note_t queue[PORT_BUZZER_NOTE_QUEUE_LENGTH]; /*!< Notas pendientes de sonar */
+        volatile uint32_t head;      /*!< Índice tras la última nota encolada. Solo lo escribe el programa principal */
+        volatile uint32_t tail;      /*!< Índice de la siguiente nota que sonará. Solo lo escribe la ISR */
+        volatile bool preloaded;     /*!< La duración de la nota de tail ya está en los registros de precarga del TIM2 */
+        volatile bool running;       /*!< Hay una nota sonando */
+        int64_t duration_error;      /*!< Diferencia acumulada entre las duraciones pedidas y las que cuenta el TIM2, en millonésimas de ciclo */
     }port_buzzer_hw_t;
 
     /* Global variables */
@@ -78,6 +106,13 @@ void port_buzzer_set_note_duration(uint32_t buzzer_id, uint32_t duration_ms);
  * @param frequency_hz 
  */
 void port_buzzer_set_note_frequency(uint32_t buzzer_id, double frequency_hz);
+/**
+ * @brief Configura la nota del buzzer especificado a partir de su número MIDI, sin coma flotante.
+ * 
+ * @param buzzer_id 
+ * @param note Número MIDI de la nota (MIDI_SILENCE para silencio)
+ */
+void port_buzzer_set_note(uint32_t buzzer_id, uint8_t note);
 /**
  * @brief  Obtiene el estado de finalización de la nota del buzzer especificado.
  * 
@@ -87,10 +122,51 @@ void port_buzzer_set_note_frequency(uint32_t buzzer_id, double frequency_hz);
  */
 bool port_buzzer_get_note_timeout(uint32_t buzzer_id);
 /**
- * @brief Detiene la reproducción de la nota del buzzer especificado.
+ * @brief Detiene la reproducción de la nota del buzzer especificado y vacía su cola de notas.
  * 
  * @param buzzer_id 
  */
 void port_buzzer_stop(uint32_t buzzer_id);
+/**
+ * @brief Añade una nota a la cola del buzzer.
+ *
+ * Si el buzzer está parado la nota empieza a sonar inmediatamente. Si no, la ISR del TIM2 la arranca al terminar la
+ * nota anterior: su duración se escribe en los registros de precarga del TIM2 (ARPE), de modo que el cambio de nota lo
+ * hace el hardware en el evento de actualización, sin hueco y sin depender del bucle principal.
+ * 
+ * @param buzzer_id 
+ * @param note Número MIDI de la nota (MIDI_SILENCE para silencio)
+ * @param duration_us Duración de la nota en microsegundos
+ * @return true si la nota se ha encolado, false si la cola está llena
+ */
+bool port_buzzer_queue_note(uint32_t buzzer_id, uint8_t note, uint32_t duration_us);
+/**
+ * @brief Añade un acorde a la cola del buzzer: una nota por voz, todas con la misma duración.
+ *
+ * Cada voz tiene su propio temporizador PWM, porque los canales del TIM3 comparten el contador y el ARR, y por tanto
+ * la frecuencia. La ISR del TIM2 cambia todas las voces en el mismo evento de actualización. Las voces a partir de
+ * num_voices se silencian y las voces a partir de PORT_BUZZER_NUM_VOICES se ignoran.
+ * 
+ * @param buzzer_id 
+ * @param p_notes Número MIDI de la nota de cada voz (MIDI_SILENCE para silencio)
+ * @param num_voices Número de notas de p_notes
+ * @param duration_us Duración del acorde en microsegundos
+ * @return true si el acorde se ha encolado, false si la cola está llena
+ */
+bool port_buzzer_queue_chord(uint32_t buzzer_id, const uint8_t *p_notes, uint32_t num_voices, uint32_t duration_us);
+/**
+ * @brief Obtiene el número de huecos libres de la cola de notas del buzzer.
+ * 
+ * @param buzzer_id 
+ * @return uint32_t 
+ */
+uint32_t port_buzzer_get_queue_free(uint32_t buzzer_id);
+/**
+ * @brief Fin de la nota actual. Arranca la siguiente nota de la cola o, si está vacía, detiene el buzzer y activa note_end.
+ * @warning Solo debe llamarse desde la ISR del TIM2 en `interr.c`.
+ * 
+ * @param buzzer_id 
+ */
+void port_buzzer_update_note(uint32_t buzzer_id);
 
 #endif
\ No newline at end of file
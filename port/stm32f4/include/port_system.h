@@ -55,6 +55,12 @@
 #define TRIGGER_ENABLE_EVENT_REQ 0x04U                                 /*!< Interrupt mask to enable event requests */
 #define TRIGGER_ENABLE_INTERR_REQ 0x08U                                /*!< Interrupt mask to enable interrupt request */
 
+/* Events posted by the ISRs */
+#define PORT_SYSTEM_EVENT_TICK BIT_POS_TO_MASK(0)   /*!< SysTick: one millisecond has elapsed */
+#define PORT_SYSTEM_EVENT_BUTTON BIT_POS_TO_MASK(1) /*!< EXTI15_10: the user button has changed */
+#define PORT_SYSTEM_EVENT_USART BIT_POS_TO_MASK(2)  /*!< USART3: a byte has been received or transmitted */
+#define PORT_SYSTEM_EVENT_NOTE BIT_POS_TO_MASK(3)   /*!< TIM2: the duration of a note has elapsed */
+
 /* Function prototypes and explanation -------------------------------------------------*/
 
 /**
@@ -84,10 +90,35 @@ size_t port_system_init(void);
  * >
  * > ✅ 1. Return System tick \n
  *
+ * @note It wraps after 2^32 ms (49.7 days): compare its values with a signed difference, or use
+ * port_system_get_millis64().
+ *
  * @return uint32_t
  */
 uint32_t port_system_get_millis(void);
 
+/**
+ * @brief Get the count of the System tick in milliseconds, in 64 bits. It never wraps.
+ *
+ * @return uint64_t
+ */
+uint64_t port_system_get_millis64(void);
+
+/**
+ * @brief Set the 64-bit count of the System tick in milliseconds.
+ *
+ * @param ms New number of milliseconds since the system started.
+ */
+void port_system_set_millis64(uint64_t ms);
+
+/**
+ * @brief Get the time since the system started in microseconds: the System tick plus the position of the SysTick
+ * counter (SysTick->VAL) in the current millisecond. It never wraps.
+ *
+ * @return uint64_t
+ */
+uint64_t port_system_get_micros64(void);
+
 /**
  * @brief Sets the number of milliseconds since the system started.
  * @warning This function must be used only by the SysTick_Handler() ISR in file `interr.c`.
@@ -96,6 +127,9 @@ uint32_t port_system_get_millis(void);
  * >
  * > ✅ 1. Set System tick to the value received \n
  * 
+ * @note Only the low 32 bits are set. A value lower than the current one is a wrap of the 32-bit tick and increments the
+ * high 32 bits, so the 64-bit tick stays monotonic.
+ *
  * @param ms New number of milliseconds since the system started.
 º */
 void port_system_set_millis(uint32_t ms);
@@ -295,4 +329,61 @@ void port_system_systick_suspend();
  * 
  */
 void port_system_sleep();
+
+/**
+ * @brief Tickless sleep: suspend the SysTick and enter Sleep mode until the next interrupt or, at most, `max_ms`
+ * milliseconds, measured by TIM5 as a one-shot wake-up timer. The milliseconds slept are added to `msTicks` on
+ * wake-up, before the ISR that woke up the core runs.
+ *
+ * If the wake-up timer expires the event PORT_SYSTEM_EVENT_TICK is posted. The sleep is skipped if there are events
+ * pending.
+ *
+ * @param max_ms Maximum time to sleep in milliseconds
+ * @return uint32_t Number of SysTick periods slept, already added to `msTicks`
+ */
+uint32_t port_system_tickless_sleep(uint32_t max_ms);
+
+/**
+ * @brief Deep sleep: suspend the SysTick and enter Stop mode until an EXTI line wakes up the core (user button, or
+ * the RX pin of a USART armed with port_usart_set_rx_wakeup()).
+ *
+ * On wake-up the system clock is restored with system_clock_config() and the time spent in Stop mode, measured by the
+ * RTC running from the LSI, is added to `msTicks` before the ISR that woke up the core runs. The accuracy of that time
+ * is the one of the LSI. The sleep is skipped if there are events pending.
+ *
+ * @return uint32_t Milliseconds spent in Stop mode, already added to `msTicks`
+ */
+uint32_t port_system_stop_sleep(void);
+
+/**
+ * @brief Post events to be processed by the main loop. It can be called from any ISR.
+ *
+ * @note The events are OR-ed in the pending mask with an exclusive access (LDREX/STREX) so ISRs of different
+ * priorities do not lose each other's events.
+ *
+ * @param events Mask of events (see PORT_SYSTEM_EVENT_*)
+ */
+void port_system_post_event(uint32_t events);
+
+/**
+ * @brief Get and clear the pending events.
+ *
+ * @return uint32_t Mask of the events posted since the last call
+ */
+uint32_t port_system_take_events(void);
+
+/**
+ * @brief Wait in Sleep mode until an interrupt arrives, unless there are events pending.
+ *
+ * @note The check and the WFI are done with the interrupts masked, so an event posted just before the WFI wakes up
+ * the core immediately instead of waiting for the next interrupt.
+ */
+void port_system_wait_for_event(void);
+
+/**
+ * @brief Get the value of the cycle counter of the core (DWT->CYCCNT).
+ *
+ * @return uint32_t Number of core clock cycles since the initialization (wraps around)
+ */
+uint32_t port_system_get_cycles(void);
 #endif /* PORT_SYSTEM_H_ */
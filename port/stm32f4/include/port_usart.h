@@ -13,6 +13,8 @@
 #include <string.h>
 #include <stdlib.h>
 #include "port_system.h"
+#include "line_ring.h"
+#include "usart_baud.h"
 #include "port_usart.h"
 
 /* HW dependent includes */
@@ -28,7 +30,34 @@
 #define USART_0_PIN_RX 11
 #define USART_0_AF_TX 7
 #define USART_0_AF_RX 7
-#define USART_INPUT_BUFFER_LENGTH 10
+#define USART_0_DMA_STREAM DMA1_Stream3    /*!< DMA stream used to transmit with USART3 */
+#define USART_0_DMA_STREAM_IDX 3           /*!< Index of the DMA stream (to locate its flags in LISR/HISR) */
+#define USART_0_DMA_CHANNEL 4              /*!< DMA channel of USART3_TX in DMA1 Stream3 */
+#define USART_0_DMA_IRQN DMA1_Stream3_IRQn /*!< Interrupt of the DMA stream */
+#define USART_0_IRQN USART3_IRQn           /*!< Interrupt of the USART */
+#define USART_0_RCC_EN RCC_APB1ENR_USART3EN /*!< Clock enable bit of the USART (APB1) */
+#define USART_0_APB2 false                 /*!< USART3 is in the APB1 bus */
+#define USART_0_BAUDRATE 9600              /*!< Baud rate of the control console */
+#define USART_1_ID 1                       /*!< Telemetry link: USART2, the virtual COM port of the ST-LINK */
+#define USART_1 USART2
+#define USART_1_GPIO_TX GPIOA
+#define USART_1_GPIO_RX GPIOA
+#define USART_1_PIN_TX 2
+#define USART_1_PIN_RX 3
+#define USART_1_AF_TX 7
+#define USART_1_AF_RX 7
+#define USART_1_DMA_STREAM DMA1_Stream6    /*!< DMA stream used to transmit with USART2 */
+#define USART_1_DMA_STREAM_IDX 6           /*!< Index of the DMA stream (to locate its flags in LISR/HISR) */
+#define USART_1_DMA_CHANNEL 4              /*!< DMA channel of USART2_TX in DMA1 Stream6 */
+#define USART_1_DMA_IRQN DMA1_Stream6_IRQn /*!< Interrupt of the DMA stream */
+#define USART_1_IRQN USART2_IRQn           /*!< Interrupt of the USART */
+#define USART_1_RCC_EN RCC_APB1ENR_USART2EN /*!< Clock enable bit of the USART (APB1) */
+#define USART_1_APB2 false                 /*!< USART2 is in the APB1 bus */
+#define USART_1_BAUDRATE 115200            /*!< Baud rate of the telemetry link */
+#define USART_NUM_INSTANCES 2              /*!< Number of entries of usart_arr */
+#define USART_RX_EXTI_LINES 0x0000FC08U   /*!< EXTI lines whose ISR calls port_usart_exti_dispatch(): EXTI3 and EXTI15_10 */
+#define USART_NUM_IRQS 97                  /*!< Number of interrupts of the STM32F446 (size of the IRQ routing table) */
+#define USART_INPUT_BUFFER_LENGTH 64
 #define USART_OUTPUT_BUFFER_LENGTH 100
 #define EMPTY_BUFFER_CONSTANT 0x0
 #define END_CHAR_CONSTANT 0xA
@@ -43,12 +72,22 @@ uint8_t pin_tx;
 uint8_t pin_rx;
 uint8_t alt_func_tx;
 uint8_t alt_func_rx;
-char input_buffer[USART_INPUT_BUFFER_LENGTH];
-uint8_t i_idx;
-bool read_complete; 
+line_ring_t rx_ring; /*!< Lines received by the ISR and not yet taken by the FSM */
 char output_buffer[USART_OUTPUT_BUFFER_LENGTH];
 uint8_t o_idx;
 bool write_complete;
+DMA_Stream_TypeDef *p_dma_stream; /*!< DMA stream for the transmission */
+uint8_t dma_stream_idx; /*!< Index of the DMA stream */
+uint8_t dma_channel; /*!< DMA channel of the USART TX request */
+IRQn_Type dma_irqn; /*!< Interrupt of the DMA stream */
+IRQn_Type irqn; /*!< Interrupt of the USART */
+uint32_t rcc_en_mask; /*!< Clock enable bit of the USART in APB1ENR or APB2ENR */
+bool apb2; /*!< The USART is in the APB2 bus (USART1 and USART6), else in APB1 */
+uint32_t baudrate; /*!< Baud rate. BRR is computed from SystemCoreClock and the prescaler of the bus */
+uint32_t pending_baudrate; /*!< Baud rate to apply at the end of the current DMA transmission, or 0 */
+volatile bool autobaud; /*!< The next start bit on the RX pin sets the baud rate */
+bool autobaud_started; /*!< The falling edge of the start bit has been seen */
+uint32_t autobaud_start; /*!< Cycle counter at the falling edge of the start bit */
 }port_usart_hw_t;
 
 
@@ -147,4 +186,116 @@ void 	port_usart_disable_tx_interrupt (uint32_t usart_id);
  * @param usart_id 
  */
 void 	port_usart_init (uint32_t usart_id);
+/**
+ * @brief Inicia la transmisión de un mensaje por DMA. Se produce una única interrupción al terminar.
+ *
+ * El mensaje no se copia: el buffer debe mantenerse sin cambios hasta que port_usart_tx_done() devuelva true.
+ * 
+ * @param usart_id 
+ * @param p_data Puntero al mensaje
+ * @param length Número de bytes a transmitir
+ */
+void port_usart_tx_start (uint32_t usart_id, const char *p_data, uint32_t length);
+/**
+ * @brief Finaliza la transmisión por DMA. Se llama desde la ISR del stream de DMA.
+ *
+ * Con un cambio de velocidad pendiente, habilita la interrupción TC del USART, que termina la transmisión.
+ * 
+ * @param usart_id 
+ */
+void port_usart_tx_complete (uint32_t usart_id);
+/**
+ * @brief Obtiene el número de líneas completas recibidas que aún no se han leído.
+ * 
+ * @param usart_id 
+ * @return uint32_t 
+ */
+uint32_t port_usart_get_lines_pending (uint32_t usart_id);
+/**
+ * @brief Obtiene el número de líneas descartadas porque no cabían en el buffer de recepción.
+ * 
+ * @param usart_id 
+ * @return uint32_t 
+ */
+uint32_t port_usart_get_rx_overruns (uint32_t usart_id);
+/**
+ * @brief Arma o desarma el pin RX como fuente de despertar del modo Stop (línea EXTI del pin, flanco de bajada).
+ *
+ * El byte que despierta al micro puede perderse mientras se restablece el reloj. Solo se arman los pines RX cuya línea
+ * EXTI está en USART_RX_EXTI_LINES, las que tienen una ISR que la atiende.
+ * 
+ * @param usart_id 
+ * @param enable true para armar el despertar, false para desarmarlo
+ * @return true si el despertar se ha armado o desarmado, false si la línea del pin RX no tiene ISR (no se arma)
+ */
+bool port_usart_set_rx_wakeup (uint32_t usart_id, bool enable);
+/**
+ * @brief Cambia la velocidad de un USART. BRR y OVER8 se calculan con SystemCoreClock y el preescalado del bus.
+ *
+ * Con after_tx, el cambio se aplica al terminar la transmisión por DMA en curso o la siguiente, para que la respuesta
+ * a quien pidió el cambio salga todavía a la velocidad antigua.
+ * 
+ * @param usart_id 
+ * @param baudrate Velocidad en baudios (USART_BAUD_MIN a USART_BAUD_MAX)
+ * @param after_tx true para aplicarla al terminar la siguiente transmisión, false para aplicarla ya
+ * @return true si la velocidad se puede obtener con un error menor que USART_BAUD_MAX_ERROR_PPM, false si no
+ */
+bool port_usart_set_baudrate (uint32_t usart_id, uint32_t baudrate, bool after_tx);
+/**
+ * @brief Obtiene la velocidad actual de un USART.
+ * 
+ * @param usart_id 
+ * @return uint32_t Velocidad en baudios
+ */
+uint32_t port_usart_get_baudrate (uint32_t usart_id);
+/**
+ * @brief Arranca la detección automática de la velocidad (autobaud).
+ *
+ * El receptor se desactiva y la línea EXTI del pin RX mide con el contador de ciclos el bit de inicio del siguiente
+ * carácter, que debe tener a 1 su bit menos significativo (por ejemplo 'U'). La velocidad estándar más cercana se
+ * aplica, el receptor se vuelve a activar y el resto de esa línea se descarta. Solo es fiable hasta 115200 baudios:
+ * a más velocidad el bit de inicio dura menos que la entrada a la ISR.
+ * 
+ * @param usart_id 
+ */
+void port_usart_start_autobaud (uint32_t usart_id);
+/**
+ * @brief Indica si la detección automática de la velocidad sigue esperando un bit de inicio.
+ * 
+ * @param usart_id 
+ * @return true si está esperando, false si no
+ */
+bool port_usart_autobaud_pending (uint32_t usart_id);
+/**
+ * @brief Flanco en el pin RX durante la detección automática de la velocidad. Se llama desde
+ * port_usart_exti_dispatch().
+ * 
+ * @param usart_id 
+ */
+void port_usart_autobaud_edge (uint32_t usart_id);
+/**
+ * @brief Atiende la interrupción de un USART: guarda el byte recibido, envía el siguiente del buffer de salida y
+ * aplica la velocidad pendiente al terminar la transmisión por DMA.
+ * 
+ * @param usart_id 
+ */
+void port_usart_irq_handler (uint32_t usart_id);
+/**
+ * @brief Atiende la interrupción del stream de DMA de transmisión de un USART.
+ * 
+ * @param usart_id 
+ */
+void port_usart_dma_irq_handler (uint32_t usart_id);
+/**
+ * @brief Despacha la interrupción activa al USART al que pertenece, con la tabla de rutas que rellena
+ * port_usart_init(). Los vectores de los USART y de sus streams de DMA solo llaman a esta función.
+ * 
+ */
+void port_usart_irq_dispatch (void);
+/**
+ * @brief Despacha los flancos de las líneas EXTI de los pines RX (despertar del modo Stop y detección automática de
+ * la velocidad) al USART al que pertenecen. La llaman las ISR de las líneas EXTI de los pines RX.
+ * 
+ */
+void port_usart_exti_dispatch (void);
 #endif
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "port_button.h"
 #include "port_usart.h"
 #include "port_buzzer.h"
+#include "port_audio.h"
 // Include headers of different port elements:
 
 //------------------------------------------------------
@@ -35,9 +36,10 @@ void SysTick_Handler(void)
 {
     uint32_t millis = port_system_get_millis();
     port_system_set_millis(millis+1);
+    port_system_post_event(PORT_SYSTEM_EVENT_TICK);
 }
 /**
- * @brief Detecta y maneja la interrupción generada por el botón de usuario.
+ * @brief Detecta y maneja la interrupción generada por el botón de usuario y el despertar por el pin RX del USART.
  * 
  */
 void EXTI15_10_IRQHandler(void) {
@@ -53,23 +55,83 @@ void EXTI15_10_IRQHandler(void) {
             buttons_arr[BUTTON_0_ID].flag_pressed = true;
         }
         EXTI -> PR |= BIT_POS_TO_MASK(pin);
+        port_system_post_event(PORT_SYSTEM_EVENT_BUTTON);
     }
+    /* Pin RX del USART3 (PC11): el byte, si llega a recibirse, lo trata USART3_IRQHandler */
+    port_usart_exti_dispatch();
 }
 /**
- * @brief  Gestiona las interrupciones de recepción y transmisión del USART3.
+ * @brief Flancos del pin RX del USART2 (PA3): despertar del modo Stop y detección automática de la velocidad.
  * 
  */
-void USART3_IRQHandler (void) {
+void EXTI3_IRQHandler(void) {
     port_system_systick_resume();
-if ((USART3 ->CR1 & USART_CR1_RXNEIE) && (USART3->SR & USART_SR_RXNE)){
-    port_usart_store_data(USART_0_ID);
+    port_usart_exti_dispatch();
+}
+/**
+ * @brief  Gestiona las interrupciones de recepción y transmisión del USART3 (consola de control, USART_0_ID).
+ * 
+ */
+void USART3_IRQHandler (void) {
+    port_usart_irq_dispatch();
+}
+/**
+ * @brief  Gestiona las interrupciones de recepción y transmisión del USART2 (enlace de telemetría, USART_1_ID).
+ * 
+ */
+void USART2_IRQHandler (void) {
+    port_usart_irq_dispatch();
 }
-if ((USART3->CR1 & USART_CR1_TXEIE) && (USART3->SR & USART_SR_TXE)){
-    port_usart_write_data(USART_0_ID);
+/**
+ * @brief Fin de la transmisión por DMA del USART3 (DMA1 Stream3).
+ * 
+ */
+void DMA1_Stream3_IRQHandler(void)
+{
+    port_usart_irq_dispatch();
 }
+/**
+ * @brief Fin de la transmisión por DMA del USART2 (DMA1 Stream6).
+ * 
+ */
+void DMA1_Stream6_IRQHandler(void)
+{
+    port_usart_irq_dispatch();
 }
+/**
+ * @brief Fin de la nota del TIM2: arranca la siguiente nota de la cola del zumbador o indica el fin de la nota.
+ * 
+ */
 void TIM2_IRQHandler(void){
-    TIM2->SR &= ~TIM_SR_UIF;
-    port_buzzer_hw_t *p_buzzer = &buzzers_arr[BUZZER_0_ID];
-    p_buzzer->note_end = true;
-}
\ No newline at end of file
+    if (TIM2->SR & TIM_SR_UIF){
+        TIM2->SR = ~TIM_SR_UIF;
+        port_buzzer_update_note(BUZZER_0_ID);
+        port_system_post_event(PORT_SYSTEM_EVENT_NOTE);
+    }
+}
+/**
+ * @brief Fin del temporizador de despertar del modo tickless (TIM5).
+ * 
+ * Normalmente lo atiende port_system_tickless_sleep() con las interrupciones enmascaradas; esta ISR solo limpia el
+ * flag si la interrupción llega a ejecutarse.
+ */
+void TIM5_IRQHandler(void){
+    if (TIM5->SR & TIM_SR_UIF){
+        TIM5->SR = ~TIM_SR_UIF;
+        port_system_post_event(PORT_SYSTEM_EVENT_TICK);
+    }
+}
+/**
+ * @brief Media transferencia o transferencia completa del DMA1 Stream5: calcula la mitad del buffer de audio que el
+ * DMA acaba de enviar al DAC mientras envía la otra.
+ */
+void DMA1_Stream5_IRQHandler(void){
+    if (DMA1->HISR & DMA_HISR_HTIF5){
+        DMA1->HIFCR = DMA_HIFCR_CHTIF5;
+        port_audio_fill_half(0);
+    }
+    if (DMA1->HISR & DMA_HISR_TCIF5){
+        DMA1->HIFCR = DMA_HIFCR_CTCIF5;
+        port_audio_fill_half(1);
+    }
+}
\ No newline at end of file
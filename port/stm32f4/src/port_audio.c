@@ -0,0 +1,130 @@
+/**
+ * @file port_audio.c
+ * @brief Salida de audio del sintetizador por el DAC1 con DMA circular y buffer doble.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "port_audio.h"
+#include "synth.h"
+
+/* Defines */
+#define PORT_AUDIO_BUFFER_SAMPLES (2U * PORT_AUDIO_HALF_SAMPLES) /*!< Muestras del buffer doble */
+#define PORT_AUDIO_DMA_FLAGS (DMA_HIFCR_CFEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTCIF5) /*!< Flags del DMA1 Stream5 */
+
+/* Global variables */
+static uint16_t buffer[PORT_AUDIO_BUFFER_SAMPLES]; /*!< Buffer doble con los códigos del DAC */
+static port_audio_stats_t stats;                   /*!< Coste del sintetizador */
+static volatile bool running = false;              /*!< El DMA está enviando muestras */
+static uint32_t idle_halves = 0;                   /*!< Mitades seguidas calculadas con el sintetizador en silencio */
+
+/* Public functions */
+void port_audio_init(void)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_DACEN | RCC_APB1ENR_TIM6EN;
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+    port_system_gpio_config(PORT_AUDIO_GPIO, PORT_AUDIO_PIN, GPIO_MODE_ANALOG, GPIO_PUPDR_NOPULL);
+
+    /* TIM6: un evento de actualización (TRGO) por muestra */
+    PORT_AUDIO_TIMER->CR1 &= ~TIM_CR1_CEN;
+    PORT_AUDIO_TIMER->PSC = 0;
+    PORT_AUDIO_TIMER->ARR = SystemCoreClock / PORT_AUDIO_SAMPLE_RATE_HZ - 1U;
+    PORT_AUDIO_TIMER->CR2 = (PORT_AUDIO_TIMER->CR2 & ~TIM_CR2_MMS) | TIM_CR2_MMS_1;
+    PORT_AUDIO_TIMER->EGR = TIM_EGR_UG;
+
+    /* DAC1: disparo por el TRGO del TIM6 (TSEL1 = 000), en reposo a media escala */
+    DAC->CR &= ~(DAC_CR_EN1 | DAC_CR_TEN1 | DAC_CR_TSEL1 | DAC_CR_DMAEN1);
+    DAC->DHR12R1 = SYNTH_DAC_MID;
+    DAC->CR |= DAC_CR_EN1;
+
+    /* Contador de ciclos del núcleo para medir el coste del sintetizador */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* Por encima de la USART y del fin de nota: una mitad tarde es un corte en el sonido */
+    NVIC_SetPriority(PORT_AUDIO_DMA_IRQN, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 1, 0));
+    NVIC_EnableIRQ(PORT_AUDIO_DMA_IRQN);
+
+    memset(&stats, 0, sizeof(stats));
+    synth_init(PORT_AUDIO_SAMPLE_RATE_HZ);
+}
+
+void port_audio_start(void)
+{
+    if (running)
+    {
+        return;
+    }
+    DMA_Stream_TypeDef *p_stream = PORT_AUDIO_DMA_STREAM;
+    p_stream->CR &= ~DMA_SxCR_EN;
+    while (p_stream->CR & DMA_SxCR_EN)
+    {
+    }
+    DMA1->HIFCR = PORT_AUDIO_DMA_FLAGS;
+
+    synth_render_dac(buffer, PORT_AUDIO_BUFFER_SAMPLES);
+    stats.budget_cycles = (SystemCoreClock / PORT_AUDIO_SAMPLE_RATE_HZ) * PORT_AUDIO_HALF_SAMPLES;
+    idle_halves = 0;
+
+    /* Memoria a periférico, 16 bits, circular, con interrupción en cada mitad */
+    p_stream->PAR = (uint32_t)&DAC->DHR12R1;
+    p_stream->M0AR = (uint32_t)buffer;
+    p_stream->NDTR = PORT_AUDIO_BUFFER_SAMPLES;
+    p_stream->CR = ((uint32_t)PORT_AUDIO_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DIR_0 | DMA_SxCR_MINC |
+                   DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+    p_stream->CR |= DMA_SxCR_EN;
+
+    DAC->CR |= DAC_CR_TEN1 | DAC_CR_DMAEN1;
+    running = true;
+    PORT_AUDIO_TIMER->CNT = 0;
+    PORT_AUDIO_TIMER->CR1 |= TIM_CR1_CEN;
+}
+
+void port_audio_stop(void)
+{
+    PORT_AUDIO_TIMER->CR1 &= ~TIM_CR1_CEN;
+    PORT_AUDIO_DMA_STREAM->CR &= ~DMA_SxCR_EN;
+    DAC->CR &= ~(DAC_CR_TEN1 | DAC_CR_DMAEN1);
+    DAC->DHR12R1 = SYNTH_DAC_MID;
+    running = false;
+}
+
+bool port_audio_is_running(void)
+{
+    return running;
+}
+
+void port_audio_fill_half(uint32_t half)
+{
+    bool silent = !synth_is_active();
+    uint32_t start = DWT->CYCCNT;
+    synth_render_dac(&buffer[half * PORT_AUDIO_HALF_SAMPLES], PORT_AUDIO_HALF_SAMPLES);
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    stats.halves++;
+    stats.total_cycles += cycles;
+    if (cycles > stats.max_cycles)
+    {
+        stats.max_cycles = cycles;
+    }
+    if (cycles > stats.budget_cycles)
+    {
+        stats.overruns++;
+    }
+
+    /* La mitad que se está enviando y la recién calculada son silencio: no queda nada que enviar */
+    idle_halves = silent ? idle_halves + 1U : 0U;
+    if (idle_halves >= 2U)
+    {
+        port_audio_stop();
+    }
+}
+
+void port_audio_get_stats(port_audio_stats_t *p_stats)
+{
+    *p_stats = stats;
+}
@@ -48,11 +48,11 @@ bool port_button_is_pressed (uint32_t button_id) {
     return buttons_arr[button_id].flag_pressed;
 }
 /**
- * @brief Retorna el contador del tick del sistema en milisegundos.
+ * @brief Retorna el contador del tick del sistema en milisegundos, en 64 bits (no desborda).
  *
  * @return Contador del tick del sistema en milisegundos.
  */
 
-uint32_t port_button_get_tick (){
-    return port_system_get_millis();
+uint64_t port_button_get_tick (){
+    return port_system_get_millis64();
 }
\ No newline at end of file
@@ -7,9 +7,9 @@
  */
 
 /* Inclusiones ------------------------------------------------------------------*/
-#include <math.h>
 #include "port_buzzer.h"
 #include "port_system.h"
+#include "buzzer_timer.h"
 
 /* Bibliotecas estándar de C */
 
@@ -17,11 +17,35 @@
 
 /* Variables globales */
 #define ALT_FUNC2_TIM3 2
+#define ALT_FUNC2_TIM4 2
+#define ALT_FUNC9_TIM12 9
 #define TIM_AS_PWM1_MASK 0x0060
+#define NOTE_QUEUE_MASK (PORT_BUZZER_NOTE_QUEUE_LENGTH - 1U) /*!< Máscara para recorrer la cola de notas */
 port_buzzer_hw_t buzzers_arr[] = {
     [BUZZER_0_ID] = {.p_port = BUZZER_0_GPIO, .pin = BUZZER_0_PIN, .alt_func = ALT_FUNC2_TIM3, .note_end = false}
 };
 
+/* Silencio: CCR1 = 0 mantiene la salida PWM1 a nivel bajo durante todo el periodo */
+static const buzzer_timer_config_t silence_config = {.psc = 0, .arr = 0xFFFF, .ccr1 = 0};
+
+/**
+ * @brief Temporizador PWM y pin de una voz del zumbador.
+ */
+typedef struct
+{
+    TIM_TypeDef *p_timer; /*!< Temporizador PWM (canal 1) */
+    uint32_t rcc_mask;    /*!< Bit del temporizador en RCC->APB1ENR */
+    GPIO_TypeDef *p_port; /*!< Puerto del pin de salida */
+    uint8_t pin;          /*!< Pin de salida */
+    uint8_t alt_func;     /*!< Función alternativa del pin */
+} port_buzzer_voice_t;
+
+/* Voces del BUZZER_0_ID. La primera es la salida de siempre (TIM3 CH1 en PA6) */
+static const port_buzzer_voice_t voices[PORT_BUZZER_NUM_VOICES] = {
+    {.p_timer = TIM3, .rcc_mask = RCC_APB1ENR_TIM3EN, .p_port = BUZZER_0_GPIO, .pin = BUZZER_0_PIN, .alt_func = ALT_FUNC2_TIM3},
+    {.p_timer = TIM4, .rcc_mask = RCC_APB1ENR_TIM4EN, .p_port = BUZZER_0_VOICE1_GPIO, .pin = BUZZER_0_VOICE1_PIN, .alt_func = ALT_FUNC2_TIM4},
+    {.p_timer = TIM12, .rcc_mask = RCC_APB1ENR_TIM12EN, .p_port = BUZZER_0_VOICE2_GPIO, .pin = BUZZER_0_VOICE2_PIN, .alt_func = ALT_FUNC9_TIM12}};
+
 /* Funciones privadas */
 
 /**
@@ -46,7 +70,9 @@ static void _timer_duration_setup(uint32_t buzzer_id)
 }
 
 /**
- * @brief Configura el temporizador para la generación de PWM.
+ * @brief Configura los temporizadores de las voces para la generación de PWM.
+ *
+ * El pin de la primera voz lo configura port_buzzer_init(); los de las demás voces, esta función.
  * 
  * @param buzzer_id Identificador del zumbador.
  */
@@ -54,17 +80,145 @@ static void _timer_pwm_setup(uint32_t buzzer_id)
 {
     if (buzzer_id == BUZZER_0_ID)
     {
-        RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
-        TIM3->CR1 &= ~TIM_CR1_CEN;
-        TIM3->CR1 |= TIM_CR1_ARPE;
-        TIM3->CNT = 0;
-        TIM3->ARR = 0;
-        TIM3->PSC = 0;
-        TIM3->EGR |= TIM_EGR_UG;
-        TIM3->CCER &= ~TIM_CCER_CC1E;
-        TIM3->CCMR1 |= TIM_AS_PWM1_MASK;
-        TIM3->CCMR1 |= TIM_CCMR1_OC1PE;
-        TIM3->CR1 &= ~TIM_CR1_CEN;
+        for (uint32_t v = 0; v < PORT_BUZZER_NUM_VOICES; v++)
+        {
+            TIM_TypeDef *p_timer = voices[v].p_timer;
+            if (v > 0)
+            {
+                port_system_gpio_config(voices[v].p_port, voices[v].pin, GPIO_MODE_ALTERNATE, GPIO_PUPDR_NOPULL);
+                port_system_gpio_config_alternate(voices[v].p_port, voices[v].pin, voices[v].alt_func);
+            }
+            RCC->APB1ENR |= voices[v].rcc_mask;
+            p_timer->CR1 &= ~TIM_CR1_CEN;
+            p_timer->CR1 |= TIM_CR1_ARPE;
+            p_timer->CNT = 0;
+            p_timer->ARR = 0;
+            p_timer->PSC = 0;
+            p_timer->EGR |= TIM_EGR_UG;
+            p_timer->CCER &= ~TIM_CCER_CC1E;
+            p_timer->CCMR1 |= TIM_AS_PWM1_MASK;
+            p_timer->CCMR1 |= TIM_CCMR1_OC1PE;
+            p_timer->CR1 &= ~TIM_CR1_CEN;
+        }
+    }
+}
+
+/**
+ * @brief Arranca la señal PWM de una voz con los valores de registros indicados.
+ * 
+ * @param p_timer Temporizador PWM de la voz.
+ * @param p_config Valores de PSC, ARR y CCR1 del temporizador.
+ */
+static void _timer_pwm_start(TIM_TypeDef *p_timer, const buzzer_timer_config_t *p_config)
+{
+    p_timer->CR1 &= ~TIM_CR1_CEN;
+    p_timer->CNT = 0;
+    p_timer->ARR = p_config->arr;
+    p_timer->PSC = p_config->psc;
+    p_timer->CCR1 = p_config->ccr1;
+    p_timer->EGR = TIM_EGR_UG;
+    p_timer->CCER |= TIM_CCER_CC1E;
+    p_timer->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief Arranca el temporizador de duración desde cero con los valores de registros indicados.
+ *
+ * El evento de actualización forzado (UG) activa UIF; se borra antes de habilitar el contador para que la ISR no lo
+ * tome por el fin de la nota. Debe llamarse con la interrupción de actualización del TIM2 enmascarada.
+ * 
+ * @param p_config Valores de PSC y ARR del temporizador.
+ */
+static void _timer_duration_start(const buzzer_timer_config_t *p_config)
+{
+    TIM2->CR1 &= ~TIM_CR1_CEN;
+    TIM2->CNT = 0;
+    TIM2->ARR = p_config->arr;
+    TIM2->PSC = p_config->psc;
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->SR = ~TIM_SR_UIF;
+    TIM2->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief Escribe la duración de la siguiente nota en los registros de precarga del TIM2.
+ *
+ * Con ARPE activo, ARR y PSC se copian a los registros activos en el siguiente evento de actualización, es decir,
+ * justo cuando termina la nota actual.
+ * 
+ * @param p_config Valores de PSC y ARR del temporizador.
+ */
+static void _timer_duration_preload(const buzzer_timer_config_t *p_config)
+{
+    TIM2->ARR = p_config->arr;
+    TIM2->PSC = p_config->psc;
+}
+
+/**
+ * @brief Enmascara la interrupción de actualización del TIM2 para modificar la cola desde el programa principal.
+ *
+ * Se enmascara en el periférico y no en el NVIC para no alterar si la interrupción está habilitada o no.
+ * 
+ * @return uint32_t Valor previo de DIER, que se restaura con _timer_duration_unmask().
+ */
+static uint32_t _timer_duration_mask(void)
+{
+    uint32_t dier = TIM2->DIER;
+    TIM2->DIER = dier & ~TIM_DIER_UIE;
+    return dier;
+}
+
+/**
+ * @brief Restaura la interrupción de actualización del TIM2.
+ * 
+ * @param dier Valor de DIER devuelto por _timer_duration_mask().
+ */
+static void _timer_duration_unmask(uint32_t dier)
+{
+    __DMB();
+    TIM2->DIER = dier;
+}
+
+/**
+ * @brief Detiene los temporizadores PWM de las voces y el de duración.
+ */
+static void _timers_stop(void)
+{
+    for (uint32_t v = 0; v < PORT_BUZZER_NUM_VOICES; v++)
+    {
+        voices[v].p_timer->CCER &= ~TIM_CCER_CC1E;
+        voices[v].p_timer->CR1 &= ~TIM_CR1_CEN;
+    }
+    TIM2->CR1 &= ~TIM_CR1_CEN;
+}
+
+/**
+ * @brief Arranca la nota de la cabeza de la cola y precarga la duración de la siguiente, si la hay.
+ *
+ * Si la duración de la nota ya estaba precargada, el TIM2 la está contando desde el evento de actualización y solo se
+ * cambia la frecuencia. Si no, el TIM2 se arranca desde cero.
+ * 
+ * @param p_buzzer Zumbador con al menos una nota en la cola.
+ */
+static void _start_queued_note(port_buzzer_hw_t *p_buzzer)
+{
+    uint32_t tail = p_buzzer->tail;
+    const port_buzzer_note_t *p_note = &p_buzzer->queue[tail & NOTE_QUEUE_MASK];
+    for (uint32_t v = 0; v < PORT_BUZZER_NUM_VOICES; v++)
+    {
+        _timer_pwm_start(voices[v].p_timer, &p_note->pwm[v]);
+    }
+    if (!p_buzzer->preloaded)
+    {
+        _timer_duration_start(&p_note->duration);
+    }
+    tail++;
+    p_buzzer->tail = tail;
+    p_buzzer->running = true;
+    p_buzzer->preloaded = (tail != p_buzzer->head);
+    if (p_buzzer->preloaded)
+    {
+        _timer_duration_preload(&p_buzzer->queue[tail & NOTE_QUEUE_MASK].duration);
     }
 }
 
@@ -72,6 +226,9 @@ static void _timer_pwm_setup(uint32_t buzzer_id)
 
 /**
  * @brief Establece la duración de una nota en milisegundos.
+ *
+ * Los valores de PSC y ARR se toman de la tabla precalculada de duraciones, o se calculan con la expresión cerrada de
+ * `buzzer_timer.c` si la duración no está en la tabla.
  * 
  * @param buzzer_id Identificador del zumbador.
  * @param duration_ms Duración de la nota en milisegundos.
@@ -80,29 +237,24 @@ void port_buzzer_set_note_duration(uint32_t buzzer_id, uint32_t duration_ms)
 {
     if (buzzer_id == BUZZER_0_ID)
     {
-        TIM2->CR1 &= ~TIM_CR1_CEN;
-        TIM2->CNT = 0;
-        double duration_as_double = (double)duration_ms;
-        double sysclk_as_double = (double)SystemCoreClock;
-        double PSC = 0;
-        double ARR = ((sysclk_as_double * (duration_as_double / 1000)) / (PSC + 1)) - 1.0;
-        ARR = round(ARR);
-        while (ARR > 65535.0)
-        {
-            PSC += 1.0;
-            ARR = ((sysclk_as_double * (duration_as_double / 1000)) / (PSC + 1)) - 1.0;
-            ARR = round(ARR);
-        }
-        TIM2->ARR = (uint32_t)(round(ARR));
-        TIM2->PSC = (uint32_t)(round(PSC));
-        TIM2->EGR = TIM_EGR_UG;
-        buzzers_arr[buzzer_id].note_end = false;
-        TIM2->CR1 |= TIM_CR1_CEN;
+        port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+        buzzer_timer_config_t config;
+        buzzer_timer_get_duration_config(SystemCoreClock, duration_ms, &config);
+        uint32_t dier = _timer_duration_mask();
+        p_buzzer->tail = p_buzzer->head;
+        p_buzzer->preloaded = false;
+        p_buzzer->running = true;
+        p_buzzer->note_end = false;
+        _timer_duration_start(&config);
+        _timer_duration_unmask(dier);
     }
 }
 
 /**
  * @brief Establece la frecuencia de una nota en Hertzios.
+ *
+ * Los valores de PSC, ARR y CCR1 se toman de la tabla precalculada de notas, sin operaciones en coma flotante de
+ * doble precisión, o se calculan con la expresión cerrada de `buzzer_timer.c` si la frecuencia no está en la tabla.
  * 
  * @param buzzer_id Identificador del zumbador.
  * @param frequency_hz Frecuencia de la nota en Hertzios.
@@ -118,27 +270,37 @@ void port_buzzer_set_note_frequency(uint32_t buzzer_id, double frequency_hz)
         }
         else
         {
-            TIM3->CR1 &= ~TIM_CR1_CEN;
-            TIM3->CNT = 0;
-            double sysclk_as_double = (double)SystemCoreClock;
-            double PSC = 0;
-            double ARR = ((sysclk_as_double * (1.0 / frequency_hz)) / (PSC + 1)) - 1.0;
+            buzzer_timer_config_t config;
+            buzzer_timer_get_note_config(SystemCoreClock, frequency_hz, &config);
+            _timer_pwm_start(TIM3, &config);
+        }
+    }
+}
 
-            while (ARR > 65535)
-            {
-                PSC++;
-                ARR = ((sysclk_as_double * (1.0 / frequency_hz)) / (PSC + 1)) - 1.0;
-                ARR = round(ARR);
-            }
-            TIM3->ARR = (uint32_t)(round(ARR));
-            TIM3->PSC = (uint32_t)(round(PSC));
-            TIM3->CCR1 = (ARR + 1) * BUZZER_PWM_DC;
-            TIM3->EGR = TIM_EGR_UG;
-            TIM3->CCER |= TIM_CCER_CC1E;
-            TIM3->CR1 |= TIM_CR1_CEN;
+/**
+ * @brief Establece la nota a partir de su número MIDI.
+ *
+ * Las notas de DO3 a SI5 indexan directamente la tabla precalculada; el resto se calculan con la expresión cerrada
+ * entera de `buzzer_timer.c`. No se usa coma flotante.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ * @param note Número MIDI de la nota (MIDI_SILENCE para silencio).
+ */
+void port_buzzer_set_note(uint32_t buzzer_id, uint8_t note)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        if (melody_get_note_mhz(note) == 0)
+        {
+            TIM3->CR1 &= ~TIM_CR1_CEN;
+            return;
         }
+        buzzer_timer_config_t config;
+        buzzer_timer_get_midi_config(SystemCoreClock, note, &config);
+        _timer_pwm_start(TIM3, &config);
     }
 }
+
 /**
  * @brief Devuelve si ha transcurrido el tiempo de duración de la nota.
  * 
@@ -167,9 +329,140 @@ void port_buzzer_stop(uint32_t buzzer_id)
 {
     if (buzzer_id == BUZZER_0_ID)
     {
-        TIM3->CCER &= ~TIM_CCER_CC1E;
-        TIM3->CR1 &= ~TIM_CR1_CEN;
-        TIM2->CR1 &= ~TIM_CR1_CEN;
+        port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+        uint32_t dier = _timer_duration_mask();
+        _timers_stop();
+        TIM2->SR = ~TIM_SR_UIF;
+        p_buzzer->tail = p_buzzer->head;
+        p_buzzer->preloaded = false;
+        p_buzzer->running = false;
+        p_buzzer->duration_error = 0;
+        _timer_duration_unmask(dier);
+    }
+}
+
+/**
+ * @brief Añade una nota a la cola del zumbador.
+ *
+ * Los valores de los registros se calculan aquí, en el programa principal, para que la ISR solo tenga que copiarlos.
+ * Si la nota es la siguiente en sonar, su duración se precarga en el TIM2 salvo que el evento de actualización ya se
+ * haya producido (UIF activo): en ese caso la ISR, que está pendiente, la arrancará desde cero.
+ *
+ * Con PSC y ARR de 16 bits el TIM2 no cuenta cualquier duración exacta. La diferencia entre la duración pedida y la
+ * que cuenta el TIM2 se suma a la nota siguiente, sin redondear, así que el fin de cada nota nunca se separa del ideal
+ * más de medio paso del preescalado.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ * @param note Número MIDI de la nota (MIDI_SILENCE para silencio).
+ * @param duration_us Duración de la nota en microsegundos.
+ * @return true si la nota se ha encolado, false si la cola está llena.
+ */
+bool port_buzzer_queue_note(uint32_t buzzer_id, uint8_t note, uint32_t duration_us)
+{
+    return port_buzzer_queue_chord(buzzer_id, &note, 1, duration_us);
+}
+
+/**
+ * @brief Añade un acorde a la cola del zumbador.
+ *
+ * Los valores de los registros de todas las voces se calculan aquí, en el programa principal, como los de una nota.
+ * La ISR del TIM2 solo los copia, así que el coste en la interrupción es de unas escrituras por voz.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ * @param p_notes Número MIDI de la nota de cada voz (MIDI_SILENCE para silencio).
+ * @param num_voices Número de notas de p_notes.
+ * @param duration_us Duración del acorde en microsegundos.
+ * @return true si el acorde se ha encolado, false si la cola está llena.
+ */
+bool port_buzzer_queue_chord(uint32_t buzzer_id, const uint8_t *p_notes, uint32_t num_voices, uint32_t duration_us)
+{
+    if (buzzer_id != BUZZER_0_ID)
+    {
+        return false;
+    }
+    port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+    uint32_t head = p_buzzer->head;
+    if ((head - p_buzzer->tail) >= PORT_BUZZER_NOTE_QUEUE_LENGTH)
+    {
+        return false;
+    }
+    port_buzzer_note_t *p_note = &p_buzzer->queue[head & NOTE_QUEUE_MASK];
+    for (uint32_t v = 0; v < PORT_BUZZER_NUM_VOICES; v++)
+    {
+        if ((v >= num_voices) || (melody_get_note_mhz(p_notes[v]) == 0))
+        {
+            p_note->pwm[v] = silence_config;
+        }
+        else
+        {
+            buzzer_timer_get_midi_config(SystemCoreClock, p_notes[v], &p_note->pwm[v]);
+        }
+    }
+    buzzer_timer_get_carried_duration_config(SystemCoreClock, duration_us, &p_buzzer->duration_error, &p_note->duration);
+
+    uint32_t dier = _timer_duration_mask();
+    p_buzzer->head = head + 1U;
+    if (!p_buzzer->running)
+    {
+        p_buzzer->note_end = false;
+        p_buzzer->preloaded = false;
+        _start_queued_note(p_buzzer);
+    }
+    else if ((p_buzzer->tail == head) && !p_buzzer->preloaded && !(TIM2->SR & TIM_SR_UIF))
+    {
+        _timer_duration_preload(&p_note->duration);
+        /* Enmascarar la ISR no detiene el evento de actualización. Si ha llegado entre la comprobación y la escritura,
+         * el TIM2 ya cuenta otra vez con la duración anterior y la precarga serviría para la nota siguiente: en ese caso
+         * la nota no queda precargada y la ISR la arranca desde cero con su duración */
+        p_buzzer->preloaded = !(TIM2->SR & TIM_SR_UIF);
+    }
+    _timer_duration_unmask(dier);
+    return true;
+}
+
+/**
+ * @brief Devuelve el número de huecos libres de la cola de notas.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ * @return uint32_t Número de notas que se pueden encolar.
+ */
+uint32_t port_buzzer_get_queue_free(uint32_t buzzer_id)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+        return PORT_BUZZER_NOTE_QUEUE_LENGTH - (p_buzzer->head - p_buzzer->tail);
+    }
+    return 0;
+}
+
+/**
+ * @brief Fin de la nota actual, llamado desde la ISR del TIM2.
+ *
+ * Si hay otra nota en la cola empieza a sonar ya; si no, se detiene el zumbador y se indica el fin de la nota.
+ * 
+ * @param buzzer_id Identificador del zumbador.
+ */
+void port_buzzer_update_note(uint32_t buzzer_id)
+{
+    if (buzzer_id == BUZZER_0_ID)
+    {
+        port_buzzer_hw_t *p_buzzer = &buzzers_arr[buzzer_id];
+        if (!p_buzzer->running)
+        {
+            return;
+        }
+        if (p_buzzer->tail == p_buzzer->head)
+        {
+            _timers_stop();
+            p_buzzer->running = false;
+            p_buzzer->preloaded = false;
+            p_buzzer->note_end = true;
+        }
+        else
+        {
+            _start_queued_note(p_buzzer);
+        }
     }
 }
 
@@ -185,6 +478,11 @@ void port_buzzer_init(uint32_t buzzer_id)
     /* Configuración de GPIO */
     port_system_gpio_config(buzzer.p_port, buzzer.pin, GPIO_MODE_ALTERNATE, GPIO_PUPDR_NOPULL);
     port_system_gpio_config_alternate(buzzer.p_port, buzzer.pin, buzzer.alt_func);
+    buzzers_arr[buzzer_id].head = 0;
+    buzzers_arr[buzzer_id].tail = 0;
+    buzzers_arr[buzzer_id].preloaded = false;
+    buzzers_arr[buzzer_id].running = false;
+    buzzers_arr[buzzer_id].duration_error = 0;
     _timer_duration_setup(buzzer_id);
     _timer_pwm_setup(buzzer_id);
 }
@@ -11,8 +11,13 @@
 /* Defines -------------------------------------------------------------------*/
 #define HSI_VALUE ((uint32_t)16000000) /*!< Value of the Internal oscillator in Hz */
 #define IDR5_MASK 0x20
+#define RTC_PREDIV_A 31U                 /*!< Asynchronous prescaler of the RTC: LSI (32 kHz) / 32 = 1 kHz */
+#define RTC_PREDIV_S 999U                /*!< Synchronous prescaler of the RTC: 1 kHz / 1000 = 1 Hz, 1 ms per subsecond */
+#define RTC_MS_PER_DAY 86400000U         /*!< Milliseconds in a day, the period of the time of the RTC */
 /* GLOBAL VARIABLES */
-static volatile uint32_t msTicks = 0; /*!< Variable to store millisecond ticks. @warning **It must be declared volatile!** Just because it is modified in an ISR. **Add it to the definition** after *static*. */
+static volatile uint64_t msTicks = 0; /*!< Variable to store millisecond ticks (64 bits, it never wraps). @warning **It must be declared volatile!** Just because it is modified in an ISR. **Add it to the definition** after *static*. */
+static volatile uint32_t pending_events = 0; /*!< Events posted by the ISRs and not yet processed by the main loop */
+static bool rtc_ready = false; /*!< The RTC is running from the LSI to measure the time in Stop mode */
 
 /* These variables are declared extern in CMSIS (system_stm32f4xx.h) */
 uint32_t SystemCoreClock = HSI_VALUE;                                               /*!< Frequency of the System clock */
@@ -116,6 +121,11 @@ size_t port_system_init()
   /* Configure the system clock */
   system_clock_config();
 
+  /* Enable the cycle counter of the core (DWT) to measure the execution time */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
   return 0;
 }
 
@@ -124,12 +134,51 @@ size_t port_system_init()
 //------------------------------------------------------
 uint32_t port_system_get_millis()
 {
-  return msTicks;
+  return (uint32_t)msTicks;
 }
 
 void port_system_set_millis(uint32_t ms)
 {
+  /* The low 32 bits only go backwards when they wrap: carry to the high word, so the 64-bit tick is monotonic */
+  uint64_t high = msTicks & 0xFFFFFFFF00000000ULL;
+  if (ms < (uint32_t)msTicks)
+  {
+    high += 1ULL << 32;
+  }
+  msTicks = high | ms;
+}
+
+uint64_t port_system_get_millis64(void)
+{
+  /* A 64-bit read takes two accesses: the SysTick must not interrupt between them */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  uint64_t ms = msTicks;
+  __set_PRIMASK(primask);
+  return ms;
+}
+
+void port_system_set_millis64(uint64_t ms)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
   msTicks = ms;
+  __set_PRIMASK(primask);
+}
+
+uint64_t port_system_get_micros64(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  uint64_t ms = msTicks;
+  uint32_t val = SysTick->VAL;
+  /* The counter has reloaded but its interrupt has not run yet: that millisecond is not in msTicks */
+  if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && (SysTick->CTRL & SysTick_CTRL_TICKINT_Msk) && (val > SysTick->LOAD / 2))
+  {
+    ms++;
+  }
+  __set_PRIMASK(primask);
+  return ms * 1000U + (SysTick->LOAD - val) / (SystemCoreClock / 1000000U);
 }
 
 void port_system_delay_ms(uint32_t ms)
@@ -145,9 +194,11 @@ void port_system_delay_until_ms(uint32_t *p_t, uint32_t ms)
 {
   uint32_t until = *p_t + ms;
   uint32_t now = port_system_get_millis();
-  if (until > now)
+  /* Signed difference: the reference may be just before the wrap of the 32-bit tick */
+  int32_t remaining = (int32_t)(until - now);
+  if (remaining > 0)
   {
-    port_system_delay_ms(until - now);
+    port_system_delay_ms((uint32_t)remaining);
   }
   *p_t = port_system_get_millis();
 }
@@ -277,6 +328,64 @@ if (port_system_gpio_read(p_port, pin))
   }
 }
 
+/**
+ * @brief Start the RTC from the LSI, the only clock that keeps running in Stop mode, with a resolution of 1 ms.
+ */
+static void _rtc_init(void)
+{
+  RCC->CSR |= RCC_CSR_LSION;
+  while (!(RCC->CSR & RCC_CSR_LSIRDY))
+  {
+  }
+  PWR->CR |= PWR_CR_DBP; /* Access to the backup domain */
+  if ((RCC->BDCR & RCC_BDCR_RTCSEL) != RCC_BDCR_RTCSEL_1)
+  {
+    /* The clock of the RTC can only be changed after a reset of the backup domain */
+    RCC->BDCR |= RCC_BDCR_BDRST;
+    RCC->BDCR &= ~RCC_BDCR_BDRST;
+    RCC->BDCR |= RCC_BDCR_RTCSEL_1;
+  }
+  RCC->BDCR |= RCC_BDCR_RTCEN;
+
+  RTC->WPR = 0xCA; /* Unlock the write protection */
+  RTC->WPR = 0x53;
+  RTC->ISR |= RTC_ISR_INIT;
+  while (!(RTC->ISR & RTC_ISR_INITF))
+  {
+  }
+  RTC->PRER = RTC_PREDIV_S << RTC_PRER_PREDIV_S_Pos; /* Two separate writes, as required by the reference manual */
+  RTC->PRER |= RTC_PREDIV_A << RTC_PRER_PREDIV_A_Pos;
+  RTC->TR = 0;
+  RTC->ISR &= ~RTC_ISR_INIT;
+  RTC->WPR = 0xFF;
+  rtc_ready = true;
+}
+
+/**
+ * @brief Get the time of the day of the RTC.
+ *
+ * @return uint32_t Milliseconds since midnight
+ */
+static uint32_t _rtc_get_ms(void)
+{
+  /* After Stop mode the shadow registers must be resynchronized before reading them */
+  RTC->WPR = 0xCA;
+  RTC->WPR = 0x53;
+  RTC->ISR &= ~RTC_ISR_RSF;
+  RTC->WPR = 0xFF;
+  while (!(RTC->ISR & RTC_ISR_RSF))
+  {
+  }
+  uint32_t ssr = RTC->SSR & RTC_SSR_SS; /* Reading SSR locks TR and DR until DR is read */
+  uint32_t tr = RTC->TR;
+  (void)RTC->DR;
+
+  uint32_t hours = ((tr & RTC_TR_HT) >> RTC_TR_HT_Pos) * 10 + ((tr & RTC_TR_HU) >> RTC_TR_HU_Pos);
+  uint32_t minutes = ((tr & RTC_TR_MNT) >> RTC_TR_MNT_Pos) * 10 + ((tr & RTC_TR_MNU) >> RTC_TR_MNU_Pos);
+  uint32_t seconds = ((tr & RTC_TR_ST) >> RTC_TR_ST_Pos) * 10 + ((tr & RTC_TR_SU) >> RTC_TR_SU_Pos);
+  return ((hours * 60 + minutes) * 60 + seconds) * 1000 + (RTC_PREDIV_S - ssr) * 1000 / (RTC_PREDIV_S + 1);
+}
+
 // ------------------------------------------------------
 // POWER RELATED FUNCTIONS
 // ------------------------------------------------------
@@ -305,4 +414,114 @@ void port_system_systick_resume()
 void port_system_sleep(){
   port_system_systick_suspend();
   port_system_power_sleep();
-}
\ No newline at end of file
+}
+
+uint32_t port_system_tickless_sleep(uint32_t max_ms)
+{
+  uint32_t ticks = 0;
+  __disable_irq();
+  if ((pending_events == 0) && (max_ms > 0))
+  {
+    /* The SysTick counter keeps running while its interrupt is disabled: its position in the current millisecond
+     * before and after the sleep gives the number of periods elapsed */
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    uint32_t phase_us = (SysTick->LOAD - SysTick->VAL) / cycles_per_us;
+    port_system_systick_suspend();
+
+    /* TIM5 (32 bits) as one-shot wake-up timer at 1 MHz, expiring at the end of the last millisecond */
+    RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
+    TIM5->CR1 = TIM_CR1_OPM | TIM_CR1_URS;
+    TIM5->PSC = cycles_per_us - 1U;
+    TIM5->ARR = max_ms * 1000U - phase_us - 1U;
+    TIM5->CNT = 0;
+    TIM5->EGR = TIM_EGR_UG;
+    TIM5->SR = ~TIM_SR_UIF;
+    TIM5->DIER = TIM_DIER_UIE;
+    NVIC_SetPriority(TIM5_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 1, 0));
+    NVIC_EnableIRQ(TIM5_IRQn);
+    TIM5->CR1 |= TIM_CR1_CEN;
+
+    SCB->SCR &= ~((uint32_t)SCB_SCR_SLEEPDEEP_Msk);
+    __WFI(); // A pending interrupt wakes up the core even with PRIMASK set
+
+    bool expired = (TIM5->SR & TIM_SR_UIF) != 0;
+    uint32_t elapsed_us = expired ? (TIM5->ARR + 1U) : TIM5->CNT;
+    TIM5->CR1 = 0;
+    TIM5->DIER = 0;
+    TIM5->SR = ~TIM_SR_UIF;
+    NVIC_ClearPendingIRQ(TIM5_IRQn);
+
+    uint32_t end_phase_us = (SysTick->LOAD - SysTick->VAL) / cycles_per_us;
+    ticks = (phase_us + elapsed_us - end_phase_us + 500U) / 1000U;
+    msTicks += ticks;
+    if (expired)
+    {
+      pending_events |= PORT_SYSTEM_EVENT_TICK;
+    }
+    port_system_systick_resume();
+  }
+  __enable_irq(); // The ISR that woke up the core runs now, with msTicks already updated
+  return ticks;
+}
+
+uint32_t port_system_stop_sleep(void)
+{
+  uint32_t slept_ms = 0;
+  __disable_irq();
+  if (pending_events == 0)
+  {
+    if (!rtc_ready)
+    {
+      _rtc_init();
+    }
+    uint32_t start_ms = _rtc_get_ms();
+    port_system_systick_suspend();
+    port_system_power_stop(); // Only the EXTI lines wake up the core: the user button and the RX pin of the USART
+
+    /* The core wakes up from Stop mode with the HSI as system clock and the SysTick stopped */
+    system_clock_config();
+    slept_ms = (_rtc_get_ms() + RTC_MS_PER_DAY - start_ms) % RTC_MS_PER_DAY;
+    msTicks += slept_ms;
+    port_system_systick_resume();
+  }
+  __enable_irq(); // The ISR that woke up the core runs now, with msTicks already updated
+  return slept_ms;
+}
+
+// ------------------------------------------------------
+// EVENT RELATED FUNCTIONS
+// ------------------------------------------------------
+void port_system_post_event(uint32_t events)
+{
+  uint32_t value;
+  do
+  {
+    value = __LDREXW(&pending_events) | events;
+  } while (__STREXW(value, &pending_events) != 0);
+}
+
+uint32_t port_system_take_events(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  uint32_t events = pending_events;
+  pending_events = 0;
+  __set_PRIMASK(primask);
+  return events;
+}
+
+void port_system_wait_for_event(void)
+{
+  __disable_irq();
+  if (pending_events == 0)
+  {
+    SCB->SCR &= ~((uint32_t)SCB_SCR_SLEEPDEEP_Msk);
+    __WFI(); // A pending interrupt wakes up the core even with PRIMASK set
+  }
+  __enable_irq();
+}
+
+uint32_t port_system_get_cycles(void)
+{
+  return DWT->CYCCNT;
+}
@@ -20,12 +20,117 @@
 port_usart_hw_t usart_arr[] = {
 [USART_0_ID] = {.p_usart = USART_0, .p_port_tx =USART_0_GPIO_TX, .p_port_rx = USART_0_GPIO_RX,
  .pin_tx = USART_0_PIN_TX, .pin_rx = USART_0_PIN_RX,.alt_func_tx = USART_0_AF_TX, .alt_func_rx = USART_0_AF_RX,
- .i_idx =0, .read_complete = false, .o_idx =0 , .write_complete = false}
+ .o_idx =0 , .write_complete = false,
+ .p_dma_stream = USART_0_DMA_STREAM, .dma_stream_idx = USART_0_DMA_STREAM_IDX, .dma_channel = USART_0_DMA_CHANNEL, .dma_irqn = USART_0_DMA_IRQN,
+ .irqn = USART_0_IRQN, .rcc_en_mask = USART_0_RCC_EN, .apb2 = USART_0_APB2, .baudrate = USART_0_BAUDRATE},
+[USART_1_ID] = {.p_usart = USART_1, .p_port_tx =USART_1_GPIO_TX, .p_port_rx = USART_1_GPIO_RX,
+ .pin_tx = USART_1_PIN_TX, .pin_rx = USART_1_PIN_RX,.alt_func_tx = USART_1_AF_TX, .alt_func_rx = USART_1_AF_RX,
+ .o_idx =0 , .write_complete = false,
+ .p_dma_stream = USART_1_DMA_STREAM, .dma_stream_idx = USART_1_DMA_STREAM_IDX, .dma_channel = USART_1_DMA_CHANNEL, .dma_irqn = USART_1_DMA_IRQN,
+ .irqn = USART_1_IRQN, .rcc_en_mask = USART_1_RCC_EN, .apb2 = USART_1_APB2, .baudrate = USART_1_BAUDRATE}
 };
 
+/**
+ * @brief Tabla de rutas de las interrupciones: para cada IRQn, el identificador del USART más uno (0 si la
+ * interrupción no es de ningún USART), con USART_IRQ_ROUTE_DMA si es la de su stream de DMA.
+ */
+static uint8_t irq_routes[USART_NUM_IRQS];
+
+/* Defines */
+#define USART_IRQ_ROUTE_DMA 0x80U /*!< Marca de las rutas de los streams de DMA en irq_routes */
+
 /* Private functions */
+/**
+ * @brief Borra los flags de interrupción de un stream del DMA1.
+ *
+ * Los flags de los streams 0 a 3 están en LIFCR y los de 4 a 7 en HIFCR, con un desplazamiento distinto para cada
+ * stream.
+ *
+ * @param stream_idx Índice del stream.
+ */
+static void _dma_clear_flags(uint8_t stream_idx){
+    static const uint8_t shift[] = {0, 6, 16, 22};
+    uint32_t mask = (DMA_LIFCR_CFEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CTEIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTCIF0) << shift[stream_idx % 4];
+    if (stream_idx < 4){
+        DMA1->LIFCR = mask;
+    } else {
+        DMA1->HIFCR = mask;
+    }
+}
 
+/**
+ * @brief Lee los flags de fin de transferencia y de error de un stream del DMA1.
+ *
+ * @param stream_idx Índice del stream.
+ * @return true si el stream ha terminado la transferencia o ha tenido un error.
+ */
+static bool _dma_transfer_ended(uint8_t stream_idx){
+    static const uint8_t shift[] = {0, 6, 16, 22};
+    uint32_t flags = (stream_idx < 4) ? DMA1->LISR : DMA1->HISR;
+    return ((flags >> shift[stream_idx % 4]) & (DMA_LISR_TCIF0 | DMA_LISR_TEIF0)) != 0;
+}
 
+/**
+ * @brief Frecuencia del bus de un USART: SystemCoreClock dividida por el preescalado del APB1 o del APB2.
+ *
+ * @param usart_id Identificador del USART.
+ * @return uint32_t Frecuencia en Hz.
+ */
+static uint32_t _usart_pclk(uint32_t usart_id){
+    uint32_t ppre = usart_arr[usart_id].apb2 ? ((RCC->CFGR & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos)
+                                             : ((RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos);
+    return SystemCoreClock >> APBPrescTable[ppre];
+}
+
+/**
+ * @brief Escribe BRR y OVER8 de una velocidad ya comprobada. El USART se deshabilita mientras se cambian.
+ *
+ * @param usart_id Identificador del USART.
+ * @param p_baud Configuración calculada por usart_baud_compute().
+ * @param baudrate Velocidad en baudios.
+ */
+static void _apply_baud(uint32_t usart_id, const usart_baud_t *p_baud, uint32_t baudrate){
+    USART_TypeDef *p_usart = usart_arr[usart_id].p_usart;
+    uint32_t enabled = p_usart->CR1 & USART_CR1_UE;
+    p_usart->CR1 &= ~USART_CR1_UE;
+    if (p_baud->over8){
+        p_usart->CR1 |= USART_CR1_OVER8;
+    } else {
+        p_usart->CR1 &= ~USART_CR1_OVER8;
+    }
+    p_usart->BRR = p_baud->brr;
+    p_usart->CR1 |= enabled;
+    usart_arr[usart_id].baudrate = baudrate;
+}
+
+/**
+ * @brief Fin de la detección automática de la velocidad: desarma la línea EXTI del pin RX, vuelve a activar el
+ * receptor y descarta el resto de la línea en la que llegó el carácter medido.
+ *
+ * @param usart_id Identificador del USART.
+ */
+static void _autobaud_finish(uint32_t usart_id){
+    port_usart_hw_t *p_usart = &usart_arr[usart_id];
+    EXTI->IMR &= ~BIT_POS_TO_MASK(p_usart->pin_rx);
+    EXTI->PR = BIT_POS_TO_MASK(p_usart->pin_rx);
+    line_ring_discard_line(&p_usart->rx_ring);
+    p_usart->autobaud = false;
+    p_usart->p_usart->CR1 |= USART_CR1_RE;
+}
+/**
+ * @brief Aplica la velocidad pendiente cuando el último byte ha salido del registro de desplazamiento (TC) y da por
+ * terminada la transmisión. Se llama desde la ISR del USART.
+ *
+ * @param usart_id Identificador del USART.
+ */
+static void _tx_shifted_out(uint32_t usart_id){
+    USART_TypeDef *p_usart = usart_arr[usart_id].p_usart;
+    p_usart->CR1 &= ~USART_CR1_TCIE;
+    p_usart->SR = ~USART_SR_TC;
+    port_usart_set_baudrate(usart_id, usart_arr[usart_id].pending_baudrate, false);
+    usart_arr[usart_id].pending_baudrate = 0;
+    usart_arr[usart_id].write_complete = true;
+}
 
 /* Public functions */
 /**
@@ -39,26 +144,17 @@ void 	_reset_buffer (char *buffer, uint32_t length){
 memset(buffer,EMPTY_BUFFER_CONSTANT,length);
 }
 /**
- * @brief Almacena los datos recibidos en el buffer de entrada del USART especificado.
+ * @brief Almacena el byte recibido en el anillo de líneas del USART especificado.
+ *
+ * Se llama desde la ISR (productor). Las líneas solo quedan disponibles para la FSM cuando llega el carácter de fin
+ * de línea, y las que no caben se descartan enteras (ver line_ring.h).
  *
  * @param usart_id Identificador del USART.
  */
 
 void port_usart_store_data (uint32_t usart_id){
     USART_TypeDef *p_usart = usart_arr[usart_id].p_usart;
-    if(p_usart->DR != END_CHAR_CONSTANT){
-        if(usart_arr[usart_id].i_idx >= USART_INPUT_BUFFER_LENGTH){
-            usart_arr[usart_id].i_idx=0;
-        }    
-            usart_arr[usart_id].input_buffer[usart_arr[usart_id].i_idx]=p_usart->DR;
-            usart_arr[usart_id].i_idx=usart_arr[usart_id].i_idx + 1;
-            return;
-    }
-    else{
-        usart_arr[usart_id].read_complete=true;
-        usart_arr[usart_id].i_idx=0;
-        return;
-    }
+    line_ring_put(&usart_arr[usart_id].rx_ring, (char)p_usart->DR);
 }
 /**
  * @brief Escribe los datos del buffer de salida en el USART especificado.
@@ -93,25 +189,26 @@ bool     port_usart_tx_done (uint32_t usart_id){
     return write_complete;
 }
 /**
- * @brief Verifica si la recepción del USART especificado se ha completado.
+ * @brief Verifica si hay alguna línea completa recibida en el USART especificado.
  *
  * @param usart_id Identificador del USART.
- * @return true si la recepción está completa, false de lo contrario.
+ * @return true si hay al menos una línea pendiente, false de lo contrario.
  */
 
 bool     port_usart_rx_done (uint32_t usart_id){
-    bool read_complete=usart_arr[usart_id].read_complete;
-    return read_complete;
+    return line_ring_lines_pending(&usart_arr[usart_id].rx_ring) > 0;
 }
 /**
- * @brief Obtiene los datos del buffer de entrada del USART especificado.
+ * @brief Saca la línea más antigua del anillo de recepción del USART especificado.
  *
  * @param usart_id Identificador del USART.
- * @param p_input_data Puntero al buffer donde se almacenarán los datos.
+ * @param p_input_data Puntero al buffer donde se almacenarán los datos (USART_INPUT_BUFFER_LENGTH bytes).
  */
 
 void     port_usart_get_from_input_buffer (uint32_t usart_id, char *p_input_data){
-    memcpy(p_input_data,usart_arr[usart_id].input_buffer,USART_INPUT_BUFFER_LENGTH);
+    if (line_ring_get_line(&usart_arr[usart_id].rx_ring, p_input_data, USART_INPUT_BUFFER_LENGTH) < 0){
+        _reset_buffer(p_input_data, USART_INPUT_BUFFER_LENGTH);
+    }
 }
 /**
  * @brief Obtiene el estado de transmisión del USART especificado.
@@ -135,14 +232,13 @@ void port_usart_copy_to_output_buffer (uint32_t usart_id, char *p_out_data, uint
     memcpy(usart_arr[usart_id].output_buffer,p_out_data,nBytes);
 }
 /**
- * @brief Reinicia el buffer de entrada del USART especificado.
+ * @brief Descarta todas las líneas pendientes del USART especificado.
  *
  * @param usart_id Identificador del USART.
  */
 
 void     port_usart_reset_input_buffer (uint32_t usart_id){
-    _reset_buffer(usart_arr[usart_id].input_buffer,USART_INPUT_BUFFER_LENGTH);
-    usart_arr[usart_id].read_complete=false;
+    line_ring_flush(&usart_arr[usart_id].rx_ring);
 }
 /**
  * @brief Reinicia el buffer de salida del USART especificado.
@@ -213,27 +309,281 @@ void port_usart_init(uint32_t usart_id)
     port_system_gpio_config_alternate(p_port_rx, pin_rx, alt_func_rx);
 
     
-    RCC->APB1ENR |= RCC_APB1ENR_USART3EN;
+    if (usart_arr[usart_id].apb2){
+        RCC->APB2ENR |= usart_arr[usart_id].rcc_en_mask;
+    } else {
+        RCC->APB1ENR |= usart_arr[usart_id].rcc_en_mask;
+    }
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
     p_usart->CR1 &= ~USART_CR1_UE;
     p_usart->CR1 &= ~USART_CR1_M;
     p_usart->CR2 &= ~USART_CR2_STOP;
-    p_usart->CR1 &= ~(USART_CR1_PCE | USART_CR1_OVER8);
-    p_usart->BRR = 0x683;
+    p_usart->CR1 &= ~USART_CR1_PCE;
+    usart_baud_t baud;
+    usart_baud_compute(_usart_pclk(usart_id), usart_arr[usart_id].baudrate, &baud);
+    _apply_baud(usart_id, &baud, usart_arr[usart_id].baudrate);
+    usart_arr[usart_id].pending_baudrate = 0;
+    usart_arr[usart_id].autobaud = false;
     p_usart->CR1 |= (USART_CR1_TE | USART_CR1_RE);
 
     port_usart_disable_rx_interrupt(usart_id);
     port_usart_disable_tx_interrupt(usart_id);
     p_usart->SR &= ~(USART_SR_RXNE | USART_SR_TC);
 
-    // Enable USART interrupts globally
-    if (p_usart == USART3)
-    {
-        NVIC_SetPriority(USART3_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 2, 0));
-        NVIC_EnableIRQ(USART3_IRQn);
-    }
+    // Enable USART interrupts globally, routed to this USART by port_usart_irq_dispatch()
+    irq_routes[usart_arr[usart_id].irqn] = (uint8_t)(usart_id + 1U);
+    irq_routes[usart_arr[usart_id].dma_irqn] = (uint8_t)(usart_id + 1U) | USART_IRQ_ROUTE_DMA;
+    NVIC_SetPriority(usart_arr[usart_id].irqn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 2, 0));
+    NVIC_EnableIRQ(usart_arr[usart_id].irqn);
+    NVIC_SetPriority(usart_arr[usart_id].dma_irqn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 2, 0));
+    NVIC_EnableIRQ(usart_arr[usart_id].dma_irqn);
 
     /* TO-DO alumnos: */
     p_usart->CR1 |= USART_CR1_UE;
-    _reset_buffer(usart_arr[usart_id].input_buffer, USART_INPUT_BUFFER_LENGTH);
+    line_ring_init(&usart_arr[usart_id].rx_ring, USART_INPUT_BUFFER_LENGTH - 1);
     _reset_buffer(usart_arr[usart_id].output_buffer, USART_OUTPUT_BUFFER_LENGTH);
-}
\ No newline at end of file
+}
+/**
+ * @brief Inicia la transmisión de un mensaje por DMA.
+ *
+ * El stream copia cada byte al registro DR cuando el USART activa TXE, sin intervención de la CPU. Solo se produce
+ * la interrupción de transferencia completa al final del mensaje.
+ *
+ * @param usart_id Identificador del USART.
+ * @param p_data Puntero al mensaje (debe mantenerse sin cambios hasta el final de la transmisión).
+ * @param length Número de bytes a transmitir.
+ */
+void port_usart_tx_start (uint32_t usart_id, const char *p_data, uint32_t length){
+    USART_TypeDef *p_usart = usart_arr[usart_id].p_usart;
+    DMA_Stream_TypeDef *p_stream = usart_arr[usart_id].p_dma_stream;
+
+    usart_arr[usart_id].write_complete = false;
+    if (length == 0){
+        usart_arr[usart_id].write_complete = true;
+        return;
+    }
+    p_stream->CR &= ~DMA_SxCR_EN;
+    while (p_stream->CR & DMA_SxCR_EN){
+    }
+    _dma_clear_flags(usart_arr[usart_id].dma_stream_idx);
+
+    p_stream->PAR = (uint32_t)&p_usart->DR;
+    p_stream->M0AR = (uint32_t)p_data;
+    p_stream->NDTR = length;
+    /* Memoria a periférico, incremento de la dirección de memoria, datos de 8 bits e interrupción al terminar */
+    p_stream->CR = ((uint32_t)usart_arr[usart_id].dma_channel << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DIR_0 | DMA_SxCR_MINC | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    p_stream->FCR = 0; /* Modo directo */
+
+    /* Los flags de SR se borran escribiendo 0: una lectura-modificación-escritura borraría un RXNE recién llegado */
+    p_usart->SR = ~USART_SR_TC;
+    p_usart->CR3 |= USART_CR3_DMAT;
+    p_stream->CR |= DMA_SxCR_EN;
+}
+/**
+ * @brief Finaliza la transmisión por DMA. Se llama desde la ISR del stream de DMA.
+ *
+ * Si hay un cambio de velocidad pendiente, el DMA ha terminado de escribir DR pero el último byte aún sale por el
+ * registro de desplazamiento. La transmisión se da por terminada en la interrupción TC del USART, que aplica la
+ * velocidad nueva.
+ *
+ * @param usart_id Identificador del USART.
+ */
+void port_usart_tx_complete (uint32_t usart_id){
+    usart_arr[usart_id].p_usart->CR3 &= ~USART_CR3_DMAT;
+    usart_arr[usart_id].p_dma_stream->CR &= ~DMA_SxCR_EN;
+    if (usart_arr[usart_id].pending_baudrate != 0){
+        usart_arr[usart_id].p_usart->CR1 |= USART_CR1_TCIE;
+    } else {
+        usart_arr[usart_id].write_complete = true;
+    }
+}
+/**
+ * @brief Obtiene el número de líneas completas recibidas que aún no se han leído.
+ *
+ * @param usart_id Identificador del USART.
+ * @return uint32_t Número de líneas pendientes.
+ */
+uint32_t port_usart_get_lines_pending (uint32_t usart_id){
+    return line_ring_lines_pending(&usart_arr[usart_id].rx_ring);
+}
+/**
+ * @brief Obtiene el número de líneas descartadas porque no cabían en el buffer de recepción.
+ *
+ * @param usart_id Identificador del USART.
+ * @return uint32_t Número de líneas descartadas.
+ */
+uint32_t port_usart_get_rx_overruns (uint32_t usart_id){
+    return line_ring_get_overruns(&usart_arr[usart_id].rx_ring);
+}
+/**
+ * @brief Arma o desarma el pin RX como fuente de despertar del modo Stop.
+ *
+ * En modo Stop el reloj del USART está parado; el flanco de bajada del bit de inicio del primer byte en el pin RX
+ * despierta al micro por su línea EXTI, que atiende port_usart_exti_dispatch(). Una línea sin ISR llevaría el primer
+ * flanco a Default_Handler, así que no se arma. Solo se enmascara la línea al desarmarla: la interrupción EXTI15_10
+ * es compartida con el botón de usuario.
+ *
+ * @param usart_id Identificador del USART.
+ * @param enable true para armar el despertar, false para desarmarlo.
+ * @return true si el despertar se ha armado o desarmado, false si la línea del pin RX no tiene ISR.
+ */
+bool port_usart_set_rx_wakeup (uint32_t usart_id, bool enable){
+    port_usart_hw_t *p_usart = &usart_arr[usart_id];
+    if (!(USART_RX_EXTI_LINES & BIT_POS_TO_MASK(p_usart->pin_rx))){
+        return false;
+    }
+    if (enable){
+        port_system_gpio_config_exti(p_usart->p_port_rx, p_usart->pin_rx, (TRIGGER_FALLING_EDGE | TRIGGER_ENABLE_INTERR_REQ));
+        port_system_gpio_exti_enable(p_usart->pin_rx, 1, 0);
+    } else {
+        EXTI->IMR &= ~BIT_POS_TO_MASK(p_usart->pin_rx);
+        EXTI->PR = BIT_POS_TO_MASK(p_usart->pin_rx);
+    }
+    return true;
+}
+/**
+ * @brief Cambia la velocidad de un USART, ya o al terminar la siguiente transmisión por DMA.
+ *
+ * @param usart_id Identificador del USART.
+ * @param baudrate Velocidad en baudios.
+ * @param after_tx true para aplicarla al terminar la siguiente transmisión, false para aplicarla ya.
+ * @return true si la velocidad se puede obtener, false si no (la velocidad no cambia).
+ */
+bool port_usart_set_baudrate (uint32_t usart_id, uint32_t baudrate, bool after_tx){
+    usart_baud_t baud;
+    if (!usart_baud_compute(_usart_pclk(usart_id), baudrate, &baud)){
+        return false;
+    }
+    if (after_tx){
+        usart_arr[usart_id].pending_baudrate = baudrate;
+    } else {
+        _apply_baud(usart_id, &baud, baudrate);
+    }
+    return true;
+}
+/**
+ * @brief Obtiene la velocidad actual de un USART.
+ *
+ * @param usart_id Identificador del USART.
+ * @return uint32_t Velocidad en baudios.
+ */
+uint32_t port_usart_get_baudrate (uint32_t usart_id){
+    return usart_arr[usart_id].baudrate;
+}
+/**
+ * @brief Arranca la detección automática de la velocidad: receptor desactivado y línea EXTI del pin RX en los dos
+ * flancos.
+ *
+ * @param usart_id Identificador del USART.
+ */
+void port_usart_start_autobaud (uint32_t usart_id){
+    port_usart_hw_t *p_usart = &usart_arr[usart_id];
+    p_usart->p_usart->CR1 &= ~USART_CR1_RE;
+    p_usart->autobaud_started = false;
+    p_usart->autobaud = true;
+    port_system_gpio_config_exti(p_usart->p_port_rx, p_usart->pin_rx, (TRIGGER_BOTH_EDGE | TRIGGER_ENABLE_INTERR_REQ));
+    port_system_gpio_exti_enable(p_usart->pin_rx, 1, 0);
+}
+/**
+ * @brief Indica si la detección automática de la velocidad sigue esperando un bit de inicio.
+ *
+ * @param usart_id Identificador del USART.
+ * @return true si está esperando, false si no.
+ */
+bool port_usart_autobaud_pending (uint32_t usart_id){
+    return usart_arr[usart_id].autobaud;
+}
+/**
+ * @brief Mide el bit de inicio entre el flanco de bajada y el de subida del pin RX.
+ *
+ * Si la duración no corresponde a ninguna velocidad estándar se espera al siguiente flanco de bajada.
+ *
+ * @param usart_id Identificador del USART.
+ */
+void port_usart_autobaud_edge (uint32_t usart_id){
+    port_usart_hw_t *p_usart = &usart_arr[usart_id];
+    if (!p_usart->autobaud){
+        return;
+    }
+    uint32_t now = port_system_get_cycles();
+    if (!port_system_gpio_read(p_usart->p_port_rx, p_usart->pin_rx)){
+        p_usart->autobaud_start = now;
+        p_usart->autobaud_started = true;
+        return;
+    }
+    if (p_usart->autobaud_started){
+        uint32_t baudrate = usart_baud_detect(SystemCoreClock, now - p_usart->autobaud_start);
+        p_usart->autobaud_started = false;
+        if ((baudrate != 0) && port_usart_set_baudrate(usart_id, baudrate, false)){
+            _autobaud_finish(usart_id);
+        }
+    }
+}
+/**
+ * @brief Atiende la interrupción de un USART: guarda el byte recibido, envía el siguiente del buffer de salida y
+ * aplica la velocidad pendiente al terminar la transmisión por DMA.
+ *
+ * @param usart_id Identificador del USART.
+ */
+void port_usart_irq_handler (uint32_t usart_id){
+    USART_TypeDef *p_usart = usart_arr[usart_id].p_usart;
+    port_system_systick_resume();
+    if ((p_usart->CR1 & USART_CR1_RXNEIE) && (p_usart->SR & USART_SR_RXNE)){
+        port_usart_store_data(usart_id);
+    }
+    if ((p_usart->CR1 & USART_CR1_TXEIE) && (p_usart->SR & USART_SR_TXE)){
+        port_usart_write_data(usart_id);
+    }
+    if ((p_usart->CR1 & USART_CR1_TCIE) && (p_usart->SR & USART_SR_TC) && (usart_arr[usart_id].pending_baudrate != 0)){
+        _tx_shifted_out(usart_id);
+    }
+    port_system_post_event(PORT_SYSTEM_EVENT_USART);
+}
+/**
+ * @brief Atiende la interrupción del stream de DMA de transmisión de un USART: fin del mensaje o error.
+ *
+ * @param usart_id Identificador del USART.
+ */
+void port_usart_dma_irq_handler (uint32_t usart_id){
+    uint8_t stream_idx = usart_arr[usart_id].dma_stream_idx;
+    if (_dma_transfer_ended(stream_idx)){
+        _dma_clear_flags(stream_idx);
+        port_usart_tx_complete(usart_id);
+        port_system_post_event(PORT_SYSTEM_EVENT_USART);
+    }
+}
+/**
+ * @brief Despacha los flancos de las líneas EXTI de los pines RX al USART al que pertenecen.
+ *
+ * Recorre la tabla de USART y atiende cada línea desenmascarada con el flag pendiente: lo borra, mide el flanco si la
+ * detección automática de la velocidad está en marcha y avisa al bucle principal (despertar del modo Stop). Las
+ * líneas de otros periféricos, como la del botón, no se tocan.
+ */
+void port_usart_exti_dispatch (void){
+    for (uint32_t usart_id = 0; usart_id < sizeof(usart_arr) / sizeof(usart_arr[0]); usart_id++){
+        uint32_t mask = BIT_POS_TO_MASK(usart_arr[usart_id].pin_rx);
+        if ((EXTI->IMR & mask) && (EXTI->PR & mask)){
+            EXTI->PR = mask;
+            port_usart_autobaud_edge(usart_id);
+            port_system_post_event(PORT_SYSTEM_EVENT_USART);
+        }
+    }
+}
+/**
+ * @brief Despacha la interrupción activa (campo VECTACTIVE de SCB->ICSR) al USART al que pertenece.
+ *
+ * Las interrupciones que no son de ningún USART inicializado se ignoran.
+ */
+void port_usart_irq_dispatch (void){
+    uint32_t irqn = (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) - 16U;
+    uint8_t route = (irqn < USART_NUM_IRQS) ? irq_routes[irqn] : 0U;
+    if (route == 0U){
+        return;
+    }
+    uint32_t usart_id = (route & ~USART_IRQ_ROUTE_DMA) - 1U;
+    if (route & USART_IRQ_ROUTE_DMA){
+        port_usart_dma_irq_handler(usart_id);
+    } else {
+        port_usart_irq_handler(usart_id);
+    }
+}
@@ -0,0 +1,308 @@
+/**
+ * @file test_fsm_index.c
+ * @brief Unit test for the index of the transition tables on the native host port.
+ *
+ * It checks that the indexed fire takes the same transitions as fsm_fire(), and measures the rows visited and the
+ * guards evaluated per fire by the jukebox with and without index, and with the guards ordered by a profile.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_button.h"
+#include "port_usart.h"
+#include "port_buzzer.h"
+
+/* Other libraries */
+#include "fsm_index.h"
+#include "fsm_profile.h"
+#include "scheduler.h"
+#include "fsm_button.h"
+#include "fsm_usart.h"
+#include "fsm_buzzer.h"
+#include "fsm_jukebox.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Defines */
+#define TEST_STATE_A 0     /*!< First state of the test FSM */
+#define TEST_STATE_B 1     /*!< Second state of the test FSM */
+#define TEST_STATE_C 2     /*!< Third state of the test FSM */
+#define TEST_NUM_FIRES 1000 /*!< Number of fires of the test FSM */
+
+/* Global variables */
+static uint32_t input;       /*!< Input of the test FSM */
+static uint32_t log_actions; /*!< Hash of the actions executed by the test FSM */
+
+static bool _check_0(fsm_t *p_this)
+{
+    return input == 0;
+}
+
+static bool _check_1(fsm_t *p_this)
+{
+    return input == 1;
+}
+
+static bool _check_2(fsm_t *p_this)
+{
+    return input == 2;
+}
+
+static bool _check_3(fsm_t *p_this)
+{
+    return input == 3;
+}
+
+static bool _check_odd(fsm_t *p_this)
+{
+    return input & 1;
+}
+
+static void _do_a(fsm_t *p_this)
+{
+    log_actions = log_actions * 31 + 1;
+}
+
+static void _do_b(fsm_t *p_this)
+{
+    log_actions = log_actions * 31 + 2;
+}
+
+/* The rows of the states are interleaved and the guards of B and C overlap, so the order matters */
+static fsm_trans_t fsm_trans_test[] = {
+    {TEST_STATE_A, _check_0, TEST_STATE_B, _do_a},
+    {TEST_STATE_B, _check_odd, TEST_STATE_C, _do_b},
+    {TEST_STATE_A, _check_1, TEST_STATE_A, _do_b},
+    {TEST_STATE_C, _check_odd, TEST_STATE_A, NULL},
+    {TEST_STATE_B, _check_1, TEST_STATE_A, _do_a},
+    {TEST_STATE_A, _check_2, TEST_STATE_C, NULL},
+    {TEST_STATE_C, _check_3, TEST_STATE_B, _do_a},
+    {TEST_STATE_A, _check_3, TEST_STATE_A, _do_a},
+    {-1, NULL, -1, NULL}};
+
+void setUp(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+    scheduler_init();
+    fsm_index_init();
+    fsm_profile_init();
+    srand(1);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief The index groups the rows of each state keeping their order in the table.
+ *
+ */
+void test_build(void)
+{
+    const fsm_index_t *p_index = fsm_index_build(fsm_trans_test);
+    UNITY_TEST_ASSERT(p_index != NULL, __LINE__, "The table has not been indexed");
+    UNITY_TEST_ASSERT(fsm_index_build(fsm_trans_test) == p_index, __LINE__, "A table must be indexed only once");
+    UNITY_TEST_ASSERT_EQUAL_INT(8, p_index->num_trans, __LINE__, "Wrong number of transitions");
+
+    const uint8_t expected_a[] = {0, 2, 5, 7};
+    const uint8_t expected_b[] = {1, 4};
+    const uint8_t expected_c[] = {3, 6};
+    const uint8_t *p_rows;
+    UNITY_TEST_ASSERT_EQUAL_INT(4, fsm_index_get_rows(p_index, TEST_STATE_A, &p_rows), __LINE__, "Wrong rows of A");
+    UNITY_TEST_ASSERT(memcmp(p_rows, expected_a, sizeof(expected_a)) == 0, __LINE__, "Wrong order of A");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, fsm_index_get_rows(p_index, TEST_STATE_B, &p_rows), __LINE__, "Wrong rows of B");
+    UNITY_TEST_ASSERT(memcmp(p_rows, expected_b, sizeof(expected_b)) == 0, __LINE__, "Wrong order of B");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, fsm_index_get_rows(p_index, TEST_STATE_C, &p_rows), __LINE__, "Wrong rows of C");
+    UNITY_TEST_ASSERT(memcmp(p_rows, expected_c, sizeof(expected_c)) == 0, __LINE__, "Wrong order of C");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, fsm_index_get_rows(p_index, FSM_INDEX_MAX_STATES, &p_rows), __LINE__, "A state out of the index has no rows");
+}
+
+/**
+ * @brief The indexed fire takes the same transitions as fsm_fire() with random inputs.
+ *
+ */
+void test_same_as_fsm_fire(void)
+{
+    fsm_t *p_fsm_linear = fsm_new(fsm_trans_test);
+    fsm_t *p_fsm_indexed = fsm_new(fsm_trans_test);
+    fsm_index_build(fsm_trans_test);
+
+    for (uint32_t i = 0; i < TEST_NUM_FIRES; i++)
+    {
+        input = rand() % 5;
+        log_actions = 0;
+        fsm_fire(p_fsm_linear);
+        uint32_t log_linear = log_actions;
+        log_actions = 0;
+        fsm_index_fire(p_fsm_indexed);
+        UNITY_TEST_ASSERT_EQUAL_INT(fsm_get_state(p_fsm_linear), fsm_get_state(p_fsm_indexed), __LINE__, "The indexed fire went to another state");
+        UNITY_TEST_ASSERT_EQUAL_INT(log_linear, log_actions, __LINE__, "The indexed fire executed another action");
+    }
+
+    fsm_destroy(p_fsm_linear);
+    fsm_destroy(p_fsm_indexed);
+}
+
+/**
+ * @brief Order the rows of the exclusive states by their fires and compare the guards evaluated per fire.
+ *
+ */
+void test_reorder(void)
+{
+    fsm_t *p_fsm = fsm_new(fsm_trans_test);
+    fsm_index_build(fsm_trans_test);
+    fsm_profile_attach(p_fsm, "test");
+    const fsm_profile_t *p_profile = fsm_profile_get(p_fsm);
+
+    /* In A the guards compare the input with different values, so they are mutually exclusive. Input 3 is the most
+     * frequent and its row is the last one of A */
+    uint32_t evals[2];
+    for (uint32_t pass = 0; pass < 2; pass++)
+    {
+        srand(1);
+        fsm_profile_reset();
+        for (uint32_t i = 0; i < TEST_NUM_FIRES; i++)
+        {
+            fsm_set_state(p_fsm, TEST_STATE_A);
+            input = (rand() % 10 == 0) ? (uint32_t)(rand() % 3) : 3;
+            fsm_profile_fire(p_fsm);
+        }
+        evals[pass] = 0;
+        for (uint32_t t = 0; t < p_profile->num_trans; t++)
+        {
+            evals[pass] += p_profile->trans[t].guard_evals;
+        }
+        if (pass == 0)
+        {
+            UNITY_TEST_ASSERT_EQUAL_INT(1, fsm_index_reorder(p_profile, (1 << TEST_STATE_A)), __LINE__, "The state A has not been reordered");
+        }
+    }
+    printf("Guards evaluated per fire in A: %.2f in table order, %.2f ordered by profile\n",
+           evals[0] / (double)TEST_NUM_FIRES, evals[1] / (double)TEST_NUM_FIRES);
+    UNITY_TEST_ASSERT(evals[1] * 2 < evals[0], __LINE__, "The reordered guards must be evaluated much less");
+
+    const uint8_t *p_rows;
+    fsm_index_get_rows(fsm_index_find(fsm_trans_test), TEST_STATE_A, &p_rows);
+    UNITY_TEST_ASSERT_EQUAL_INT(7, p_rows[0], __LINE__, "The most frequent row must be evaluated first");
+    fsm_index_get_rows(fsm_index_find(fsm_trans_test), TEST_STATE_B, &p_rows);
+    UNITY_TEST_ASSERT_EQUAL_INT(1, p_rows[0], __LINE__, "States not declared exclusive must keep the table order");
+
+    fsm_destroy(p_fsm);
+}
+
+/**
+ * @brief Run the system with the scheduler for some time.
+ *
+ * @param ms Simulated milliseconds
+ */
+static void _run_ms(uint32_t ms)
+{
+    /* The SysTick is suspended while the jukebox sleeps, so the simulated clock is used instead of the millis */
+    uint64_t end = port_system_native_get_micros() + (uint64_t)ms * 1000;
+    while (port_system_native_get_micros() < end)
+    {
+        if (!scheduler_dispatch())
+        {
+            port_system_wait_for_event();
+        }
+    }
+}
+
+/**
+ * @brief Turn on the jukebox, send some commands and let it go to sleep, with and without index.
+ *
+ */
+void test_jukebox_benchmark(void)
+{
+    const char *p_names[] = {"button", "usart", "buzzer", "jukebox"};
+    uint32_t rows[2][4];
+    uint32_t evals[2][4];
+    uint32_t fires[2][4];
+
+    for (uint32_t indexed = 0; indexed < 2; indexed++)
+    {
+        port_system_init();
+        port_system_native_set_realtime(false);
+        scheduler_init();
+        fsm_profile_init();
+        fsm_t *p_fsm[4];
+        p_fsm[0] = fsm_button_new(BUTTON_0_ID);
+        p_fsm[1] = fsm_usart_new(USART_0_ID);
+        p_fsm[2] = fsm_buzzer_new(BUZZER_0_ID);
+        p_fsm[3] = fsm_jukebox_new(p_fsm[0], 1500, p_fsm[1], p_fsm[2], 300);
+        scheduler_subscribe(p_fsm[0], PORT_SYSTEM_EVENT_BUTTON | PORT_SYSTEM_EVENT_TICK);
+        scheduler_subscribe(p_fsm[1], PORT_SYSTEM_EVENT_USART | PORT_SYSTEM_EVENT_TICK);
+        scheduler_subscribe(p_fsm[2], PORT_SYSTEM_EVENT_NOTE | PORT_SYSTEM_EVENT_TICK | SCHEDULER_EVENT_STATE_CHANGE);
+        scheduler_subscribe(p_fsm[3], SCHEDULER_EVENT_ALL);
+        if (!indexed)
+        {
+            fsm_index_init();
+        }
+        for (uint32_t f = 0; f < 4; f++)
+        {
+            fsm_profile_attach(p_fsm[f], p_names[f]);
+        }
+        port_system_post_event(SCHEDULER_EVENT_STATE_CHANGE);
+
+        port_button_native_set_pressed(BUTTON_0_ID, true);
+        _run_ms(1600);
+        port_button_native_set_pressed(BUTTON_0_ID, false);
+        _run_ms(5000);
+        port_usart_native_inject_rx(USART_0_ID, "play\n", 5);
+        _run_ms(2000);
+        port_usart_native_inject_rx(USART_0_ID, "next\n", 5);
+        _run_ms(2000);
+        port_usart_native_inject_rx(USART_0_ID, "stop\n", 5);
+        _run_ms(5000);
+
+        for (uint32_t f = 0; f < 4; f++)
+        {
+            const fsm_profile_t *p_profile = fsm_profile_get(p_fsm[f]);
+            rows[indexed][f] = p_profile->rows;
+            fires[indexed][f] = p_profile->fires;
+            evals[indexed][f] = 0;
+            for (uint32_t t = 0; t < p_profile->num_trans; t++)
+            {
+                evals[indexed][f] += p_profile->trans[t].guard_evals;
+            }
+        }
+        fsm_destroy(p_fsm[3]);
+        fsm_destroy(p_fsm[2]);
+        fsm_destroy(p_fsm[1]);
+        fsm_destroy(p_fsm[0]);
+    }
+
+    printf("FSM       fires   rows/fire (table -> index)   guards/fire\n");
+    for (uint32_t f = 0; f < 4; f++)
+    {
+        printf("%-8s %6u   %5.2f -> %5.2f                %5.2f\n", p_names[f], (unsigned)fires[1][f],
+               rows[0][f] / (double)fires[0][f], rows[1][f] / (double)fires[1][f], evals[1][f] / (double)fires[1][f]);
+        UNITY_TEST_ASSERT_EQUAL_INT(fires[0][f], fires[1][f], __LINE__, "The index has changed the behaviour of the system");
+        UNITY_TEST_ASSERT_EQUAL_INT(evals[0][f], evals[1][f], __LINE__, "The index must evaluate the same guards");
+        UNITY_TEST_ASSERT(rows[1][f] <= rows[0][f], __LINE__, "The index must not visit more rows");
+    }
+    UNITY_TEST_ASSERT(rows[1][3] < rows[0][3], __LINE__, "The index must visit fewer rows of the jukebox table");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_build);
+    RUN_TEST(test_same_as_fsm_fire);
+    RUN_TEST(test_reorder);
+    RUN_TEST(test_jukebox_benchmark);
+
+    return UNITY_END();
+}
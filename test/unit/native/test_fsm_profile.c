@@ -0,0 +1,199 @@
+/**
+ * @file test_fsm_profile.c
+ * @brief Unit test for the profiler of the transition tables on the native host port.
+ *
+ * It checks the counters of the guards and actions of a small FSM, and prints the profile of the buzzer FSM while
+ * it plays a melody with the scheduler.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_buzzer.h"
+
+/* Other libraries */
+#include "fsm_profile.h"
+#include "scheduler.h"
+#include "fsm_buzzer.h"
+#include "melodies.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Defines */
+#define TEST_STATE_A 0             /*!< First state of the test FSM */
+#define TEST_STATE_B 1             /*!< Second state of the test FSM */
+#define TEST_ACTION_CYCLES 20000   /*!< Minimum duration of the action of the test FSM */
+
+/* Global variables */
+static bool go_b;    /*!< Input of the transition from A to B */
+static bool go_a;    /*!< Input of the transition from B to A */
+static uint32_t outs; /*!< Number of actions executed */
+
+static bool _never(fsm_t *p_this)
+{
+    return false;
+}
+
+static bool _check_go_b(fsm_t *p_this)
+{
+    return go_b;
+}
+
+static bool _check_go_a(fsm_t *p_this)
+{
+    return go_a;
+}
+
+/**
+ * @brief Action that lasts at least TEST_ACTION_CYCLES.
+ */
+static void _do_slow(fsm_t *p_this)
+{
+    uint32_t start = port_system_get_cycles();
+    while ((port_system_get_cycles() - start) < TEST_ACTION_CYCLES)
+    {
+    }
+    outs++;
+}
+
+static fsm_trans_t fsm_trans_test[] = {
+    {TEST_STATE_A, _never, TEST_STATE_B, NULL},
+    {TEST_STATE_A, _check_go_b, TEST_STATE_B, _do_slow},
+    {TEST_STATE_B, _check_go_a, TEST_STATE_A, NULL},
+    {-1, NULL, -1, NULL}};
+
+void setUp(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+    scheduler_init();
+    fsm_profile_init();
+    go_a = false;
+    go_b = false;
+    outs = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief The guards evaluated, the transitions fired and the duration of the actions are counted.
+ *
+ */
+void test_counters(void)
+{
+    fsm_t *p_fsm = fsm_new(fsm_trans_test);
+    UNITY_TEST_ASSERT(fsm_profile_get(p_fsm) == NULL, __LINE__, "The FSM is not attached yet");
+    UNITY_TEST_ASSERT(fsm_profile_attach(p_fsm, "test"), __LINE__, "The FSM has not been attached");
+    UNITY_TEST_ASSERT(!fsm_profile_attach(p_fsm, "test"), __LINE__, "An FSM must be attached only once");
+
+    const fsm_profile_t *p_profile = fsm_profile_get(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(3, p_profile->num_trans, __LINE__, "Wrong number of transitions");
+
+    fsm_profile_fire(p_fsm);
+    fsm_profile_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(TEST_STATE_A, fsm_get_state(p_fsm), __LINE__, "The FSM must stay in A");
+    go_b = true;
+    fsm_profile_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(TEST_STATE_B, fsm_get_state(p_fsm), __LINE__, "The FSM must go to B");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, outs, __LINE__, "The action has not been executed");
+    fsm_profile_fire(p_fsm);
+    go_a = true;
+    fsm_profile_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(TEST_STATE_A, fsm_get_state(p_fsm), __LINE__, "The FSM must go back to A");
+    fsm_profile_fire(p_fsm);
+
+    UNITY_TEST_ASSERT_EQUAL_INT(6, p_profile->fires, __LINE__, "The fires of the FSM have not been counted");
+    UNITY_TEST_ASSERT_EQUAL_INT(4, p_profile->trans[0].guard_evals, __LINE__, "Guards of A are evaluated in each fire in A");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, p_profile->trans[0].fires, __LINE__, "The first transition never fires");
+    UNITY_TEST_ASSERT_EQUAL_INT(4, p_profile->trans[1].guard_evals, __LINE__, "Wrong guard evaluations of A->B");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, p_profile->trans[1].fires, __LINE__, "Wrong fires of A->B");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, p_profile->trans[2].guard_evals, __LINE__, "Wrong guard evaluations of B->A");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, p_profile->trans[2].fires, __LINE__, "Wrong fires of B->A");
+
+    const fsm_profile_trans_t *p_slow = &p_profile->trans[1];
+    UNITY_TEST_ASSERT(p_slow->min_cycles >= TEST_ACTION_CYCLES, __LINE__, "The action has not been timed");
+    UNITY_TEST_ASSERT(p_slow->max_cycles >= p_slow->min_cycles, __LINE__, "Wrong maximum duration");
+    UNITY_TEST_ASSERT(p_slow->total_cycles >= 2ULL * TEST_ACTION_CYCLES, __LINE__, "Wrong total duration");
+
+    char msg[100];
+    UNITY_TEST_ASSERT(fsm_profile_format_hottest(msg, sizeof(msg)) > 0, __LINE__, "There is no summary");
+    UNITY_TEST_ASSERT(strncmp(msg, "Hot: test t", 11) == 0, __LINE__, "Wrong summary");
+
+    fsm_profile_reset();
+    UNITY_TEST_ASSERT_EQUAL_INT(0, p_profile->trans[1].fires, __LINE__, "The counters have not been reset");
+
+    fsm_destroy(p_fsm);
+}
+
+/**
+ * @brief The FSMs that are not attached are fired as with fsm_fire().
+ *
+ */
+void test_not_attached(void)
+{
+    fsm_t *p_fsm = fsm_new(fsm_trans_test);
+    char msg[100];
+    UNITY_TEST_ASSERT_EQUAL_INT(0, fsm_profile_format_hottest(msg, sizeof(msg)), __LINE__, "No FSM is attached");
+    go_b = true;
+    fsm_profile_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(TEST_STATE_B, fsm_get_state(p_fsm), __LINE__, "The FSM has not been fired");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, outs, __LINE__, "The action has not been executed");
+    fsm_destroy(p_fsm);
+}
+
+/**
+ * @brief Profile the buzzer FSM while it plays a melody with the scheduler.
+ *
+ */
+void test_buzzer_profile(void)
+{
+    fsm_t *p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+    UNITY_TEST_ASSERT(fsm_profile_attach(p_fsm, "buzzer"), __LINE__, "The buzzer FSM has not been attached");
+    scheduler_subscribe(p_fsm, PORT_SYSTEM_EVENT_NOTE | PORT_SYSTEM_EVENT_TICK | SCHEDULER_EVENT_STATE_CHANGE);
+    fsm_buzzer_set_melody(p_fsm, &scale_melody);
+    fsm_buzzer_set_action(p_fsm, PLAY);
+    port_system_post_event(SCHEDULER_EVENT_STATE_CHANGE);
+
+    while (fsm_buzzer_get_action(p_fsm) != STOP)
+    {
+        if (!scheduler_dispatch())
+        {
+            port_system_wait_for_event();
+        }
+    }
+
+    const fsm_profile_t *p_profile = fsm_profile_get(p_fsm);
+    scheduler_stats_t stats;
+    scheduler_get_stats(&stats);
+    UNITY_TEST_ASSERT_EQUAL_INT(stats.fires, p_profile->fires, __LINE__, "The scheduler must fire through the profiler");
+    uint32_t fires = 0;
+    for (uint32_t t = 0; t < p_profile->num_trans; t++)
+    {
+        fires += p_profile->trans[t].fires;
+    }
+    UNITY_TEST_ASSERT(fires >= scale_melody.melody_length, __LINE__, "Each note needs at least a transition");
+
+    fsm_profile_print();
+    fsm_destroy(p_fsm);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_counters);
+    RUN_TEST(test_not_attached);
+    RUN_TEST(test_buzzer_profile);
+
+    return UNITY_END();
+}
@@ -0,0 +1,296 @@
+/**
+ * @file test_golden_timelines.c
+ * @brief Regression test of the playback path against golden timelines on the native host port.
+ *
+ * Every melody of melodies.c is played by the buzzer FSM on the simulated buzzer at several speeds. The timeline of
+ * each run (frequency, start and end of each note in simulated microseconds) is extended with the quantisation of the
+ * timers of the target: the frequency that the PWM timer actually produces, and the error of the end of each note
+ * with the duration timer (TIM2 at 16 MHz, with the error carried from note to note as in the port of the board).
+ * The result must match the golden file of the run line by line, in `golden/` next to this file.
+ *
+ * Set the environment variable GOLDEN_UPDATE=1 to write the golden files instead of checking them, after a change
+ * that is meant to change the timelines. The test also reports the worst quantisation errors and the render time. The
+ * render time depends on the load of the host, so it is only printed and never fails the test.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_buzzer.h"
+
+/* Other libraries */
+#include "melodies.h"
+#include "buzzer_timer.h"
+#include "fsm_buzzer.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Defines */
+#define TEST_CLOCK_HZ 16000000ULL       /*!< Clock of the timers of the target */
+#define TEST_US_PER_S 1000000ULL        /*!< Microseconds per second */
+#define TEST_NS_PER_US 1000LL           /*!< Nanoseconds per microsecond */
+#define TEST_LINE_LENGTH 128            /*!< Maximum length of a line of a golden file */
+#define TEST_PATH_LENGTH 512            /*!< Maximum length of the path of a golden file */
+
+/* Global variables */
+/**
+ * @brief Melodies of melodies.c.
+ */
+static const melody_t *const melodies[] = {&scale_melody, &happy_birthday_melody, &tetris_melody,
+                                           &himno_madrid_melody, &windows_shutdown_melody};
+
+/**
+ * @brief Speeds of the player of each run.
+ */
+static const double speeds[] = {0.5, 1.0, 1.7};
+
+/**
+ * @brief Totals of all the runs.
+ */
+static struct
+{
+    uint32_t notes;          /*!< Notes played */
+    uint64_t simulated_us;   /*!< Simulated time played */
+    uint64_t render_ns;      /*!< Host time spent playing */
+    int64_t max_end_error_ns; /*!< Worst error of the end of a note with the duration timer */
+    uint32_t unbounded;      /*!< Notes whose end error is beyond half a prescaler step of the duration timer */
+    double max_pitch_cents;  /*!< Worst error of the frequency of the PWM timer */
+} totals;
+
+void setUp(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Time of the host in nanoseconds.
+ *
+ * @return uint64_t Nanoseconds of a monotonic clock
+ */
+static uint64_t _host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Path of the golden file of a run, in the directory `golden/` next to this file.
+ *
+ * @param p_path Pointer where the path is stored
+ * @param p_melody Melody of the run
+ * @param speed Speed of the run
+ */
+static void _golden_path(char *p_path, const melody_t *p_melody, double speed)
+{
+    const char *p_dir_end = strrchr(__FILE__, '/');
+    int dir_length = (p_dir_end != NULL) ? (int)(p_dir_end - __FILE__ + 1) : 0;
+    snprintf(p_path, TEST_PATH_LENGTH, "%.*sgolden/%s_x%03u.txt", dir_length, __FILE__, p_melody->p_name,
+             (unsigned)(speed * 100 + 0.5));
+}
+
+/**
+ * @brief Frequency produced by the PWM timer of the target for a note, as configured by its port.
+ *
+ * @param frequency_mhz Frequency of the note in millihertz
+ * @return uint32_t Frequency produced in millihertz (rounded), or 0 for a silence
+ */
+static uint32_t _pwm_frequency_mhz(uint32_t frequency_mhz)
+{
+    buzzer_timer_config_t config;
+    if (frequency_mhz == 0)
+    {
+        return 0;
+    }
+    int32_t index = buzzer_timer_find_note(frequency_mhz);
+    if (index >= 0)
+    {
+        config = *buzzer_timer_get_note_entry((uint32_t)index);
+    }
+    else
+    {
+        buzzer_timer_solve_frequency(TEST_CLOCK_HZ, frequency_mhz, &config);
+    }
+    uint64_t period = ((uint64_t)config.psc + 1U) * ((uint64_t)config.arr + 1U);
+    return (uint32_t)((TEST_CLOCK_HZ * 1000U + period / 2U) / period);
+}
+
+/**
+ * @brief Play a melody to the end and write its timeline, with the quantisation of the timers of the target.
+ *
+ * Each line is: frequency (mHz), start and end of the note (us from the start of the melody), frequency produced by
+ * the PWM timer (mHz), and end of the note with the duration timer minus the simulated end (ns).
+ *
+ * @param p_file File where the timeline is written
+ * @param p_melody Melody to play
+ * @param speed Speed of the player
+ */
+static void _render(FILE *p_file, const melody_t *p_melody, double speed)
+{
+    fsm_t *p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+    port_buzzer_native_reset_timeline(BUZZER_0_ID);
+    uint64_t start_ns = _host_ns();
+    fsm_buzzer_set_melody(p_fsm, p_melody);
+    fsm_buzzer_set_speed(p_fsm, speed);
+    fsm_buzzer_set_action(p_fsm, PLAY);
+    while (fsm_buzzer_get_action(p_fsm) == PLAY)
+    {
+        fsm_fire(p_fsm);
+        port_system_native_advance_ms(1);
+    }
+    uint64_t render_ns = _host_ns() - start_ns;
+    fsm_destroy(p_fsm);
+
+    uint32_t length;
+    const port_buzzer_native_event_t *p_timeline = port_buzzer_native_get_timeline(BUZZER_0_ID, &length);
+    uint64_t origin_us = (length > 0) ? p_timeline[0].start_us : 0;
+    int64_t carry = 0;
+    uint64_t timer_cycles = 0;
+    double max_cents = 0;
+    int64_t max_error_ns = 0;
+
+    fprintf(p_file, "# %s x%.2f: %lu notes\n", p_melody->p_name, speed, (unsigned long)length);
+    for (uint32_t i = 0; i < length; i++)
+    {
+        const port_buzzer_native_event_t *p_event = &p_timeline[i];
+
+        /* Duration timer with the error carried to the next note, as in port_buzzer_queue_note() of the board */
+        buzzer_timer_config_t config;
+        int64_t target = (int64_t)(TEST_CLOCK_HZ * p_event->duration_us) + carry;
+        bool stretched = target < (int64_t)TEST_US_PER_S;
+        if (stretched)
+        {
+            target = TEST_US_PER_S;
+        }
+        uint64_t cycles = buzzer_timer_solve((uint64_t)target, TEST_US_PER_S, &config);
+        carry = target - (int64_t)(cycles * TEST_US_PER_S);
+        timer_cycles += cycles;
+        int64_t end_error_ns = (int64_t)((timer_cycles * 1000000000ULL) / TEST_CLOCK_HZ) - (int64_t)(p_event->end_us - origin_us) * TEST_NS_PER_US;
+
+        uint32_t pwm_mhz = _pwm_frequency_mhz(p_event->frequency_mhz);
+        if (pwm_mhz > 0)
+        {
+            double cents = fabs(1200.0 * log2((double)pwm_mhz / p_event->frequency_mhz));
+            max_cents = (cents > max_cents) ? cents : max_cents;
+        }
+        max_error_ns = (llabs(end_error_ns) > max_error_ns) ? llabs(end_error_ns) : max_error_ns;
+        /* The carry keeps the error within half a step of the prescaler of the note (plus the truncation to the ns). A
+         * note too short for the timer is stretched to its minimum, and the next one pays the time back */
+        int64_t bound_ns = (int64_t)((((uint64_t)config.psc + 1U) * 1000000000ULL) / (2U * TEST_CLOCK_HZ)) + 1;
+        totals.unbounded += (!stretched && (llabs(end_error_ns) > bound_ns)) ? 1U : 0U;
+
+        fprintf(p_file, "%lu %llu %llu %lu %lld\n", (unsigned long)p_event->frequency_mhz,
+                (unsigned long long)(p_event->start_us - origin_us), (unsigned long long)(p_event->end_us - origin_us),
+                (unsigned long)pwm_mhz, (long long)end_error_ns);
+    }
+
+    uint64_t simulated_us = (length > 0) ? p_timeline[length - 1].end_us - origin_us : 0;
+    printf("%-16s x%.2f: %3lu notes, %8.3f s, pitch error %.2f cents, end error %lld ns, render %.2f ms\n",
+           p_melody->p_name, speed, (unsigned long)length, simulated_us / 1e6, max_cents, (long long)max_error_ns,
+           render_ns / 1e6);
+    totals.notes += length;
+    totals.simulated_us += simulated_us;
+    totals.render_ns += render_ns;
+    totals.max_end_error_ns = (max_error_ns > totals.max_end_error_ns) ? max_error_ns : totals.max_end_error_ns;
+    totals.max_pitch_cents = (max_cents > totals.max_pitch_cents) ? max_cents : totals.max_pitch_cents;
+}
+
+/**
+ * @brief Compare a timeline with its golden file, line by line.
+ *
+ * @param p_timeline Timeline rendered
+ * @param p_path Path of the golden file
+ * @return uint32_t Number of the first line that differs (1 is the first line), or 0 if they are equal
+ */
+static uint32_t _compare(FILE *p_timeline, const char *p_path)
+{
+    FILE *p_golden = fopen(p_path, "r");
+    char expected[TEST_LINE_LENGTH];
+    char actual[TEST_LINE_LENGTH];
+    uint32_t line = 0;
+    if (p_golden == NULL)
+    {
+        return 1;
+    }
+    rewind(p_timeline);
+    while (true)
+    {
+        char *p_expected = fgets(expected, sizeof(expected), p_golden);
+        char *p_actual = fgets(actual, sizeof(actual), p_timeline);
+        line++;
+        if ((p_expected == NULL) && (p_actual == NULL))
+        {
+            line = 0;
+            break;
+        }
+        if ((p_expected == NULL) || (p_actual == NULL) || (strcmp(expected, actual) != 0))
+        {
+            printf("%s:%lu\n  expected: %s  actual:   %s", p_path, (unsigned long)line, (p_expected != NULL) ? expected : "(end)\n",
+                   (p_actual != NULL) ? actual : "(end)\n");
+            break;
+        }
+    }
+    fclose(p_golden);
+    return line;
+}
+
+/**
+ * @brief The timelines of every melody at every speed match their golden files.
+ *
+ */
+void test_golden_timelines(void)
+{
+    const char *p_update = getenv("GOLDEN_UPDATE");
+    bool update = (p_update != NULL) && (strcmp(p_update, "1") == 0);
+    char path[TEST_PATH_LENGTH];
+    uint32_t failures = 0;
+
+    memset(&totals, 0, sizeof(totals));
+    for (uint32_t m = 0; m < sizeof(melodies) / sizeof(melodies[0]); m++)
+    {
+        for (uint32_t s = 0; s < sizeof(speeds) / sizeof(speeds[0]); s++)
+        {
+            _golden_path(path, melodies[m], speeds[s]);
+            FILE *p_file = update ? fopen(path, "w") : tmpfile();
+            UNITY_TEST_ASSERT(p_file != NULL, __LINE__, "The timeline file cannot be created");
+            _render(p_file, melodies[m], speeds[s]);
+            if (!update && (_compare(p_file, path) != 0))
+            {
+                failures++;
+            }
+            fclose(p_file);
+        }
+    }
+
+    double realtime_factor = (totals.simulated_us * 1000.0) / totals.render_ns;
+    printf("Total: %lu notes, %.1f s simulated in %.1f ms (%.0fx real time), pitch error %.2f cents, end error %lld ns%s\n",
+           (unsigned long)totals.notes, totals.simulated_us / 1e6, totals.render_ns / 1e6, realtime_factor,
+           totals.max_pitch_cents, (long long)totals.max_end_error_ns, update ? " (golden files written)" : "");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, failures, __LINE__, "Some timelines do not match their golden files (GOLDEN_UPDATE=1 rewrites them)");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, totals.unbounded, __LINE__, "The error of the duration timer accumulates");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_golden_timelines);
+
+    return UNITY_END();
+}
@@ -0,0 +1,208 @@
+/**
+ * @file test_note_timing.c
+ * @brief Unit test for the timing of the notes at any speed on the native host port.
+ *
+ * The timeline recorded by the simulated buzzer is compared with the ideal one: the end of each note must be the
+ * ideal position in the melody, at the speed set rounded to Q16.16, truncated to the microsecond. With several
+ * voices, all of them must change at the same time.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_buzzer.h"
+
+/* Other libraries */
+#include "melodies.h"
+#include "melody_poly.h"
+#include "fsm_buzzer.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Defines */
+#define TEST_US_PER_MS 1000U /*!< Microseconds per millisecond */
+
+void setUp(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Play a melody to the end at some speed.
+ *
+ * @param p_melody Melody to play
+ * @param speed Speed of the player
+ * @param p_length Pointer where the number of notes played is stored
+ * @return const port_buzzer_native_event_t* Timeline of the notes played
+ */
+static const port_buzzer_native_event_t *_play(const melody_t *p_melody, double speed, uint32_t *p_length)
+{
+    fsm_t *p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_buzzer_set_melody(p_fsm, p_melody);
+    fsm_buzzer_set_speed(p_fsm, speed);
+    fsm_buzzer_set_action(p_fsm, PLAY);
+    while (fsm_buzzer_get_action(p_fsm) == PLAY)
+    {
+        fsm_fire(p_fsm);
+        port_system_native_advance_ms(1);
+    }
+    fsm_destroy(p_fsm);
+    return port_buzzer_native_get_timeline(BUZZER_0_ID, p_length);
+}
+
+/**
+ * @brief Check that the notes of a melody end at their ideal positions at some speed.
+ *
+ * @param p_melody Melody to play
+ * @param speed Speed of the player
+ */
+static void _check_timeline(const melody_t *p_melody, double speed)
+{
+    uint32_t speed_q16 = (uint32_t)(speed * FSM_BUZZER_SPEED_ONE + 0.5);
+    uint32_t length;
+    const port_buzzer_native_event_t *p_timeline = _play(p_melody, speed, &length);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(p_melody->melody_length, length, __LINE__, "The melody has not been played completely");
+
+    uint64_t start_us = p_timeline[0].start_us;
+    uint64_t position_ms = 0;
+    uint64_t truncated_us = 0;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint32_t duration_ms = MELODY_EVENT_DURATION_MS(&p_melody->p_events[i]);
+        position_ms += duration_ms;
+        uint64_t ideal_us = ((position_ms * TEST_US_PER_MS) << FSM_BUZZER_SPEED_SHIFT) / speed_q16;
+        UNITY_TEST_ASSERT(p_timeline[i].end_us - start_us == ideal_us, __LINE__, "The note does not end at its ideal position");
+        UNITY_TEST_ASSERT(p_timeline[i].start_us + p_timeline[i].duration_us == p_timeline[i].end_us, __LINE__, "The note does not last its duration");
+        if (i + 1 < length)
+        {
+            UNITY_TEST_ASSERT(p_timeline[i + 1].start_us == p_timeline[i].end_us, __LINE__, "There is a gap between the notes");
+        }
+        /* Each note truncated to the millisecond, as the player did before */
+        truncated_us += ((((uint64_t)duration_ms) << FSM_BUZZER_SPEED_SHIFT) / speed_q16) * TEST_US_PER_MS;
+    }
+
+    double total_us = (double)(p_timeline[length - 1].end_us - start_us);
+    double ideal_us = (double)position_ms * TEST_US_PER_MS / speed;
+    double error_us = total_us - ideal_us;
+    printf("Speed %.2f: %lu notes, %.0f us, error %.1f us (truncated to ms: %.0f us)\n", speed, (unsigned long)length,
+           total_us, error_us, (double)truncated_us - ideal_us);
+    UNITY_TEST_ASSERT((error_us < TEST_US_PER_MS) && (error_us > -(double)TEST_US_PER_MS), __LINE__, "The length of the melody is not the ideal one");
+}
+
+/**
+ * @brief At the nominal speed the durations of the melody are played exactly.
+ *
+ */
+void test_nominal_speed(void)
+{
+    _check_timeline(&tetris_melody, 1.0);
+}
+
+/**
+ * @brief At fractional speeds the error of each note does not accumulate along the melody.
+ *
+ */
+void test_fractional_speed(void)
+{
+    const double speeds[] = {1.7, 0.75, 2.3, 1.33};
+    for (uint32_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+    {
+        _check_timeline(&tetris_melody, speeds[i]);
+    }
+    _check_timeline(&happy_birthday_melody, 1.7);
+}
+
+/**
+ * @brief The error of the durations at speed 1.7 would have accumulated to several milliseconds with a truncation to
+ * the millisecond in each note.
+ *
+ */
+void test_truncation_drift(void)
+{
+    uint32_t speed_q16 = (uint32_t)(1.7 * FSM_BUZZER_SPEED_ONE + 0.5);
+    uint64_t position_ms = 0;
+    uint64_t truncated_ms = 0;
+    for (uint32_t i = 0; i < tetris_melody.melody_length; i++)
+    {
+        uint32_t duration_ms = MELODY_EVENT_DURATION_MS(&tetris_melody.p_events[i]);
+        position_ms += duration_ms;
+        truncated_ms += ((uint64_t)duration_ms << FSM_BUZZER_SPEED_SHIFT) / speed_q16;
+    }
+    uint64_t ideal_ms = (position_ms << FSM_BUZZER_SPEED_SHIFT) / speed_q16;
+    UNITY_TEST_ASSERT(ideal_ms - truncated_ms > 1, __LINE__, "The truncation to the millisecond should drift more than one tick");
+}
+
+/**
+ * @brief The voices of a melody with bass change at the same time, at their ideal positions, with one chord per frame.
+ *
+ */
+void test_chord_timing(void)
+{
+    double speed = 1.7;
+    uint32_t speed_q16 = (uint32_t)(speed * FSM_BUZZER_SPEED_ONE + 0.5);
+    fsm_t *p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_buzzer_set_poly(p_fsm, &tetris_poly_melody);
+    fsm_buzzer_set_speed(p_fsm, speed);
+    fsm_buzzer_set_action(p_fsm, PLAY);
+    while (fsm_buzzer_get_action(p_fsm) == PLAY)
+    {
+        fsm_fire(p_fsm);
+        port_system_native_advance_ms(1);
+    }
+    fsm_destroy(p_fsm);
+
+    uint32_t length[PORT_BUZZER_NUM_VOICES];
+    const port_buzzer_native_event_t *p_voice[PORT_BUZZER_NUM_VOICES];
+    for (uint32_t v = 0; v < PORT_BUZZER_NUM_VOICES; v++)
+    {
+        p_voice[v] = port_buzzer_native_get_voice_timeline(BUZZER_0_ID, v, &length[v]);
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, length[2], __LINE__, "A voice that is not in the melody has sounded");
+
+    melody_poly_cursor_t cursor;
+    melody_frame_t frame;
+    uint64_t start_us = p_voice[0][0].start_us;
+    uint64_t position_ms = 0;
+    uint32_t frames = 0;
+    melody_poly_rewind(&cursor, &tetris_poly_melody);
+    while (melody_poly_next(&cursor, &frame))
+    {
+        uint64_t frame_start_us = ((position_ms * TEST_US_PER_MS) << FSM_BUZZER_SPEED_SHIFT) / speed_q16;
+        position_ms += frame.duration_ms;
+        uint64_t frame_end_us = ((position_ms * TEST_US_PER_MS) << FSM_BUZZER_SPEED_SHIFT) / speed_q16;
+        for (uint32_t v = 0; v < tetris_poly_melody.num_voices; v++)
+        {
+            UNITY_TEST_ASSERT(frames < length[v], __LINE__, "A chord has not been played");
+            UNITY_TEST_ASSERT_EQUAL_UINT32(melody_get_note_mhz(frame.notes[v]), p_voice[v][frames].frequency_mhz, __LINE__, "The voice does not sound its note");
+            UNITY_TEST_ASSERT(p_voice[v][frames].start_us - start_us == frame_start_us, __LINE__, "The chord does not start at its ideal position");
+            UNITY_TEST_ASSERT(p_voice[v][frames].end_us - start_us == frame_end_us, __LINE__, "The chord does not end at its ideal position");
+        }
+        frames++;
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(frames, length[0], __LINE__, "The first voice has sounded more chords than the melody has");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(frames, length[1], __LINE__, "The second voice has sounded more chords than the melody has");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_nominal_speed);
+    RUN_TEST(test_fractional_speed);
+    RUN_TEST(test_truncation_drift);
+    RUN_TEST(test_chord_timing);
+
+    return UNITY_END();
+}
@@ -0,0 +1,158 @@
+/**
+ * @file test_port_audio.c
+ * @brief Unit test for the audio output of the synthesizer on the native host port.
+ *
+ * The melody with bass is synthesized through the simulated DMA double buffer and written to a WAV file. The samples
+ * of the file must be the same as an offline render: no half of the buffer is lost or repeated.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_audio.h"
+
+/* Other libraries */
+#include "synth.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Defines */
+#define TEST_WAV_PATH "synth_tetris2.wav" /*!< File written by the test */
+#define TEST_MAX_SAMPLES (PORT_AUDIO_SAMPLE_RATE_HZ * 20U) /*!< Samples of the longest render (20 s) */
+
+/* Global variables */
+static uint16_t offline[TEST_MAX_SAMPLES];
+static int16_t recorded[TEST_MAX_SAMPLES];
+
+void setUp(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+    port_audio_init();
+}
+
+void tearDown(void)
+{
+    port_audio_stop();
+}
+
+/**
+ * @brief Read the samples of a mono 16-bit WAV file written by the native port.
+ *
+ * @param p_samples Pointer where the samples are stored
+ * @param max_samples Maximum number of samples
+ * @return uint32_t Number of samples of the file, or 0 if the header is not correct
+ */
+static uint32_t _read_wav(int16_t *p_samples, uint32_t max_samples)
+{
+    uint8_t header[44];
+    FILE *p_file = fopen(TEST_WAV_PATH, "rb");
+    if ((p_file == NULL) || (fread(header, 1, sizeof(header), p_file) != sizeof(header)))
+    {
+        return 0;
+    }
+    uint32_t rate = header[24] | (header[25] << 8) | (header[26] << 16) | ((uint32_t)header[27] << 24);
+    uint32_t bytes = header[40] | (header[41] << 8) | (header[42] << 16) | ((uint32_t)header[43] << 24);
+    uint32_t num_samples = bytes / sizeof(int16_t);
+    if ((memcmp(header, "RIFF", 4) != 0) || (memcmp(&header[8], "WAVE", 4) != 0) || (rate != PORT_AUDIO_SAMPLE_RATE_HZ) || (num_samples > max_samples))
+    {
+        fclose(p_file);
+        return 0;
+    }
+    num_samples = (uint32_t)fread(p_samples, sizeof(int16_t), num_samples, p_file);
+    fclose(p_file);
+    return num_samples;
+}
+
+/**
+ * @brief The melody is played through the double buffer to a WAV file with the same samples as an offline render, and
+ * the output stops by itself after the release of the last notes.
+ *
+ */
+void test_wav_render(void)
+{
+    /* Offline render of the same melody, in DAC codes */
+    synth_play(&tetris_poly_melody, SYNTH_SPEED_ONE);
+    uint32_t offline_samples = 0;
+    while (synth_is_active() && (offline_samples + PORT_AUDIO_HALF_SAMPLES <= TEST_MAX_SAMPLES))
+    {
+        synth_render_dac(&offline[offline_samples], PORT_AUDIO_HALF_SAMPLES);
+        offline_samples += PORT_AUDIO_HALF_SAMPLES;
+    }
+
+    port_audio_init();
+    UNITY_TEST_ASSERT(port_audio_native_open_wav(TEST_WAV_PATH), __LINE__, "The WAV file cannot be created");
+    synth_play(&tetris_poly_melody, SYNTH_SPEED_ONE);
+    port_audio_start();
+    uint64_t start_us = port_system_native_get_micros();
+    while (port_audio_is_running() && (port_system_native_get_micros() - start_us < 20000000ULL))
+    {
+        port_system_native_advance_ms(1);
+    }
+    uint32_t written = port_audio_native_close_wav();
+    uint64_t elapsed_ms = (port_system_native_get_micros() - start_us) / 1000U;
+
+    port_audio_stats_t stats;
+    port_audio_get_stats(&stats);
+    printf("%s: %lu samples in %llu ms, %lu halves, %.1f ns/sample (max %lu of %lu ns per half)\n", TEST_WAV_PATH,
+           (unsigned long)written, (unsigned long long)elapsed_ms, (unsigned long)stats.halves,
+           (double)stats.total_cycles / (stats.halves * PORT_AUDIO_HALF_SAMPLES), (unsigned long)stats.max_cycles,
+           (unsigned long)stats.budget_cycles);
+
+    UNITY_TEST_ASSERT(!port_audio_is_running(), __LINE__, "The output must stop by itself after the melody");
+    UNITY_TEST_ASSERT(!synth_is_active(), __LINE__, "The synthesizer must be silent after the melody");
+    UNITY_TEST_ASSERT(written >= offline_samples, __LINE__, "The WAV file is shorter than the melody");
+    UNITY_TEST_ASSERT(written <= offline_samples + 2 * PORT_AUDIO_HALF_SAMPLES, __LINE__, "The output has not stopped after the melody");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(stats.halves * PORT_AUDIO_HALF_SAMPLES, written, __LINE__, "A half sent has not been rendered once");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, stats.overruns, __LINE__, "A half has taken longer than the budget");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(written, _read_wav(recorded, TEST_MAX_SAMPLES), __LINE__, "The WAV file is not correct");
+    for (uint32_t i = 0; i < offline_samples; i++)
+    {
+        int16_t expected = (int16_t)(((int32_t)offline[i] << (16U - SYNTH_DAC_BITS)) - 32768);
+        if (recorded[i] != expected)
+        {
+            UNITY_TEST_FAIL(__LINE__, "The samples sent to the DAC are not the offline render");
+        }
+    }
+    for (uint32_t i = offline_samples; i < written; i++)
+    {
+        UNITY_TEST_ASSERT_EQUAL_INT(0, recorded[i], __LINE__, "The output after the melody must be silence");
+    }
+}
+
+/**
+ * @brief The output cannot start twice, and stopping it cancels the simulated DMA.
+ *
+ */
+void test_start_stop(void)
+{
+    synth_note_on(0, MIDI_LA4);
+    port_audio_start();
+    port_audio_start();
+    port_system_native_advance_ms(80);
+    port_audio_stop();
+    uint64_t sent = port_audio_native_get_samples_sent();
+    UNITY_TEST_ASSERT(sent == 10 * PORT_AUDIO_HALF_SAMPLES, __LINE__, "The DMA does not send one half every 8 ms");
+    port_system_native_advance_ms(80);
+    UNITY_TEST_ASSERT(port_audio_native_get_samples_sent() == sent, __LINE__, "The DMA must not send samples after the stop");
+    UNITY_TEST_ASSERT(!port_audio_is_running(), __LINE__, "The output must be stopped");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_wav_render);
+    RUN_TEST(test_start_stop);
+
+    return UNITY_END();
+}
@@ -0,0 +1,782 @@
+/**
+ * @file test_port_native.c
+ * @brief Unit test for the native host port: simulated clock, button, USART and buzzer.
+ *
+ * The simulated clock is used in manual mode, so the tests control exactly when the ISRs are called.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_button.h"
+#include "port_usart.h"
+#include "port_buzzer.h"
+#include "port_melody_file.h"
+
+/* Other libraries */
+#include "fsm_button.h"
+#include "fsm_usart.h"
+#include "fsm_buzzer.h"
+#include "fsm_jukebox.h"
+#include "melodies.h"
+#include "melody_stream.h"
+#include "command_frame.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define STREAM_REPEATS 4                                   /*!< Repetitions of a melody in the streamed file */
+#define STREAM_FILE_PATH "test_port_native_stream.bin"     /*!< File of the streamed melody */
+
+/* Global variables */
+static uint32_t timer_calls;
+static uint64_t timer_call_us;
+
+/**
+ * @brief Callback of the simulated timer used in the tests.
+ *
+ * @param arg
+ */
+static void _test_timer_cb(uint32_t arg)
+{
+    timer_calls += arg;
+    timer_call_us = port_system_native_get_micros();
+}
+
+void setUp(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+    timer_calls = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief The SysTick is called once per simulated millisecond, and only while it is enabled.
+ *
+ */
+void test_simulated_clock(void)
+{
+    port_system_native_advance_ms(10);
+    UNITY_TEST_ASSERT_EQUAL_INT(10, port_system_get_millis(), __LINE__, "The SysTick has not been called once per simulated millisecond");
+    UNITY_TEST_ASSERT_EQUAL_INT(10000, port_system_native_get_micros(), __LINE__, "The simulated clock is not in microseconds");
+
+    port_system_systick_suspend();
+    port_system_native_advance_ms(5);
+    UNITY_TEST_ASSERT_EQUAL_INT(10, port_system_get_millis(), __LINE__, "msTicks must not advance while the SysTick is suspended");
+    port_system_systick_resume();
+
+    port_system_delay_ms(3);
+    UNITY_TEST_ASSERT_EQUAL_INT(13, port_system_get_millis(), __LINE__, "port_system_delay_ms() must advance the simulated clock");
+}
+
+/**
+ * @brief Simulated timers are called in order and at their deadline.
+ *
+ */
+void test_simulated_timers(void)
+{
+    port_system_native_timer_start(2500, _test_timer_cb, 1);
+    port_system_native_timer_start(7000, _test_timer_cb, 10);
+    port_system_native_advance_ms(3);
+    UNITY_TEST_ASSERT_EQUAL_INT(1, timer_calls, __LINE__, "Only the first timer should have expired");
+    UNITY_TEST_ASSERT_EQUAL_INT(2500, timer_call_us, __LINE__, "The timer has not been called at its deadline");
+
+    port_system_native_timer_cancel(_test_timer_cb, 10);
+    port_system_native_advance_ms(10);
+    UNITY_TEST_ASSERT_EQUAL_INT(1, timer_calls, __LINE__, "A cancelled timer has been called");
+
+    port_system_native_timer_start(20500, _test_timer_cb, 1);
+    port_system_sleep();
+    UNITY_TEST_ASSERT_EQUAL_INT(20500, port_system_native_get_micros(), __LINE__, "The simulated Sleep mode must wake up at the next timer");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, port_system_native_get_sleep_count(), __LINE__, "The sleep has not been counted");
+}
+
+/**
+ * @brief A simulated press is debounced by the button FSM.
+ *
+ */
+void test_button_press(void)
+{
+    fsm_t *p_fsm = fsm_button_new(BUTTON_0_ID);
+
+    port_button_native_set_pressed(BUTTON_0_ID, true);
+    fsm_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(BUTTON_PRESSED_WAIT, fsm_get_state(p_fsm), __LINE__, "The FSM did not detect the simulated press");
+
+    port_system_native_advance_ms(BUTTON_0_DEBOUNCE_TIME_MS + 1);
+    fsm_fire(p_fsm);
+    port_system_native_advance_ms(500);
+    port_button_native_set_pressed(BUTTON_0_ID, false);
+    fsm_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(BUTTON_RELEASED_WAIT, fsm_get_state(p_fsm), __LINE__, "The FSM did not detect the simulated release");
+    TEST_ASSERT_INT_WITHIN_MESSAGE(2, BUTTON_0_DEBOUNCE_TIME_MS + 501, fsm_button_get_duration(p_fsm), "The duration of the press is not correct");
+
+    fsm_destroy(p_fsm);
+}
+
+/**
+ * @brief Bytes injected by the host are received by the USART FSM and the replies are captured in the TX FIFO.
+ *
+ */
+void test_usart_fifos(void)
+{
+    fsm_t *p_fsm = fsm_usart_new(USART_0_ID);
+    char msg[USART_INPUT_BUFFER_LENGTH];
+    char reply[USART_OUTPUT_BUFFER_LENGTH] = "pong\n";
+    char captured[16];
+
+    // Bytes wait in the FIFO until the RX interrupt is enabled
+    port_usart_native_inject_rx(USART_0_ID, "ping\n", 5);
+    fsm_fire(p_fsm);
+    UNITY_TEST_ASSERT(!fsm_usart_check_data_received(p_fsm), __LINE__, "Data received with the RX interrupt disabled");
+
+    fsm_usart_enable_rx_interrupt(p_fsm);
+    fsm_fire(p_fsm);
+    UNITY_TEST_ASSERT(fsm_usart_check_data_received(p_fsm), __LINE__, "The injected line has not been received");
+    fsm_usart_get_in_data(p_fsm, msg);
+    UNITY_TEST_ASSERT(strncmp(msg, "ping", 4) == 0, __LINE__, "The received line is not the injected one");
+    fsm_usart_reset_input_data(p_fsm);
+
+    fsm_usart_set_out_data(p_fsm, reply);
+    fsm_fire(p_fsm);
+    port_system_native_advance_ms(10);
+    fsm_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(WAIT_DATA, fsm_get_state(p_fsm), __LINE__, "The FSM did not finish the transmission");
+    uint32_t length = port_usart_native_read_tx(USART_0_ID, captured, sizeof(captured));
+    UNITY_TEST_ASSERT_EQUAL_INT(5, length, __LINE__, "The number of bytes transmitted is not correct");
+    UNITY_TEST_ASSERT(memcmp(captured, "pong\n", 5) == 0, __LINE__, "The transmitted bytes are not correct");
+
+    fsm_destroy(p_fsm);
+}
+
+/**
+ * @brief The DMA transmission of a message takes one interrupt, while the byte by byte path takes one per byte.
+ *
+ */
+void test_usart_dma_tx(void)
+{
+    const char msg[] = "Melody: happy_birthday\n";
+    uint32_t length = strlen(msg);
+    char captured[USART_OUTPUT_BUFFER_LENGTH];
+    char out[USART_OUTPUT_BUFFER_LENGTH] = {0};
+
+    // Byte by byte path: TXE interrupt per byte
+    port_usart_init(USART_0_ID);
+    memcpy(out, msg, length);
+    port_usart_copy_to_output_buffer(USART_0_ID, out, USART_OUTPUT_BUFFER_LENGTH);
+    port_usart_enable_tx_interrupt(USART_0_ID);
+    uint32_t irqs_byte = port_usart_native_get_irq_count(USART_0_ID);
+    UNITY_TEST_ASSERT_EQUAL_INT(length, irqs_byte, __LINE__, "The byte by byte path must take one interrupt per byte");
+    UNITY_TEST_ASSERT_EQUAL_INT(length, port_usart_native_read_tx(USART_0_ID, captured, sizeof(captured)), __LINE__, "The byte by byte path has not transmitted the message");
+
+    // DMA path: one transfer complete interrupt per message
+    port_usart_init(USART_0_ID);
+    uint64_t start_us = port_system_native_get_micros();
+    port_usart_tx_start(USART_0_ID, msg, length);
+    UNITY_TEST_ASSERT(!port_usart_tx_done(USART_0_ID), __LINE__, "The DMA transmission finished before the bytes were sent");
+    while (!port_usart_tx_done(USART_0_ID))
+    {
+        port_system_power_sleep();
+    }
+    uint64_t elapsed_us = port_system_native_get_micros() - start_us;
+    uint32_t irqs_dma = port_usart_native_get_irq_count(USART_0_ID);
+    UNITY_TEST_ASSERT_EQUAL_INT(1, irqs_dma, __LINE__, "The DMA path must take a single interrupt per message");
+    UNITY_TEST_ASSERT_EQUAL_INT(length * USART_NATIVE_BYTE_TIME_US, elapsed_us, __LINE__, "The DMA transfer does not last the time of the bytes on the line");
+    UNITY_TEST_ASSERT_EQUAL_INT(length, port_usart_native_read_tx(USART_0_ID, captured, sizeof(captured)), __LINE__, "The DMA path has not transmitted the message");
+    UNITY_TEST_ASSERT(memcmp(captured, msg, length) == 0, __LINE__, "The bytes transmitted by DMA are not correct");
+
+    printf("USART TX of %u bytes: %u interrupts byte by byte, %u by DMA (%.1f bytes/s on the line)\n",
+           (unsigned)length, (unsigned)irqs_byte, (unsigned)irqs_dma, length * 1e6 / (double)elapsed_us);
+}
+
+/**
+ * @brief Two USART FSMs (the control console and the telemetry link) receive and transmit at the same time, each one
+ * through its own ISRs and at its own baud rate, without mixing their bytes.
+ *
+ */
+void test_usart_two_instances(void)
+{
+    fsm_t *p_fsm_console = fsm_usart_new(USART_0_ID);
+    fsm_t *p_fsm_telemetry = fsm_usart_new(USART_1_ID);
+    char msg[USART_INPUT_BUFFER_LENGTH];
+    char reply_console[USART_OUTPUT_BUFFER_LENGTH] = "console ok\n";
+    char reply_telemetry[USART_OUTPUT_BUFFER_LENGTH] = "telemetry ok\n";
+    char captured[32];
+
+    fsm_usart_enable_rx_interrupt(p_fsm_console);
+    fsm_usart_enable_rx_interrupt(p_fsm_telemetry);
+    port_usart_native_inject_rx(USART_0_ID, "info\n", 5);
+    port_usart_native_inject_rx(USART_1_ID, "stats\n", 6);
+    fsm_fire(p_fsm_console);
+    fsm_fire(p_fsm_telemetry);
+    UNITY_TEST_ASSERT(fsm_usart_check_data_received(p_fsm_console), __LINE__, "The console has not received its line");
+    UNITY_TEST_ASSERT(fsm_usart_check_data_received(p_fsm_telemetry), __LINE__, "The telemetry link has not received its line");
+    fsm_usart_get_in_data(p_fsm_console, msg);
+    UNITY_TEST_ASSERT(strncmp(msg, "info", 5) == 0, __LINE__, "The console has received a line of the other USART");
+    fsm_usart_get_in_data(p_fsm_telemetry, msg);
+    UNITY_TEST_ASSERT(strncmp(msg, "stats", 6) == 0, __LINE__, "The telemetry link has received a line of the other USART");
+    fsm_usart_reset_input_data(p_fsm_console);
+    fsm_usart_reset_input_data(p_fsm_telemetry);
+
+    /* Both replies are sent at the same time; the faster link ends first */
+    uint32_t irqs_console = port_usart_native_get_irq_count(USART_0_ID);
+    uint32_t irqs_telemetry = port_usart_native_get_irq_count(USART_1_ID);
+    uint64_t start_us = port_system_native_get_micros();
+    fsm_usart_set_out_data(p_fsm_console, reply_console);
+    fsm_usart_set_out_data(p_fsm_telemetry, reply_telemetry);
+    fsm_fire(p_fsm_console);
+    fsm_fire(p_fsm_telemetry);
+    while (!port_usart_tx_done(USART_1_ID))
+    {
+        port_system_power_sleep();
+    }
+    uint64_t telemetry_us = port_system_native_get_micros() - start_us;
+    UNITY_TEST_ASSERT(!port_usart_tx_done(USART_0_ID), __LINE__, "The console at 9600 bauds must still be transmitting");
+    while (!port_usart_tx_done(USART_0_ID))
+    {
+        port_system_power_sleep();
+    }
+    uint64_t console_us = port_system_native_get_micros() - start_us;
+    fsm_fire(p_fsm_console);
+    fsm_fire(p_fsm_telemetry);
+
+    UNITY_TEST_ASSERT_EQUAL_INT(11 * port_usart_native_get_byte_time_us(USART_0_ID), console_us, __LINE__, "The console does not transmit at its baud rate");
+    UNITY_TEST_ASSERT_EQUAL_INT(13 * port_usart_native_get_byte_time_us(USART_1_ID), telemetry_us, __LINE__, "The telemetry link does not transmit at its baud rate");
+    UNITY_TEST_ASSERT_EQUAL_INT(irqs_console + 1, port_usart_native_get_irq_count(USART_0_ID), __LINE__, "The console has taken an interrupt of the other USART");
+    UNITY_TEST_ASSERT_EQUAL_INT(irqs_telemetry + 1, port_usart_native_get_irq_count(USART_1_ID), __LINE__, "The telemetry link has taken an interrupt of the other USART");
+    UNITY_TEST_ASSERT_EQUAL_INT(11, port_usart_native_read_tx(USART_0_ID, captured, sizeof(captured)), __LINE__, "The console has not transmitted its reply");
+    UNITY_TEST_ASSERT(memcmp(captured, "console ok\n", 11) == 0, __LINE__, "The reply of the console is not correct");
+    UNITY_TEST_ASSERT_EQUAL_INT(13, port_usart_native_read_tx(USART_1_ID, captured, sizeof(captured)), __LINE__, "The telemetry link has not transmitted its reply");
+    UNITY_TEST_ASSERT(memcmp(captured, "telemetry ok\n", 13) == 0, __LINE__, "The reply of the telemetry link is not correct");
+
+    fsm_destroy(p_fsm_console);
+    fsm_destroy(p_fsm_telemetry);
+}
+
+/**
+ * @brief A pasted script of commands is received without losses and the jukebox drains several commands per fire.
+ *
+ */
+void test_usart_burst(void)
+{
+    fsm_t *p_fsm_button = fsm_button_new(BUTTON_0_ID);
+    fsm_t *p_fsm_usart = fsm_usart_new(USART_0_ID);
+    fsm_t *p_fsm_buzzer = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_t *p_fsm_jukebox = fsm_jukebox_new(p_fsm_button, 1500, p_fsm_usart, p_fsm_buzzer, 300);
+    char script[256] = "";
+    char line[16];
+    uint32_t num_lines = JUKEBOX_MAX_COMMANDS_PER_FIRE + 4;
+
+    for (uint32_t i = 1; i <= num_lines; i++)
+    {
+        sprintf(line, "speed %u\n", (unsigned)i);
+        strcat(script, line);
+    }
+    fsm_set_state(p_fsm_jukebox, WAIT_COMMAND);
+    fsm_usart_enable_rx_interrupt(p_fsm_usart);
+    port_usart_native_inject_rx(USART_0_ID, script, strlen(script));
+    UNITY_TEST_ASSERT_EQUAL_INT(num_lines, port_usart_get_lines_pending(USART_0_ID), __LINE__, "Lines of the script have been lost");
+
+    fsm_fire(p_fsm_usart);
+    fsm_fire(p_fsm_jukebox);
+    UNITY_TEST_ASSERT_EQUAL_INT(num_lines - JUKEBOX_MAX_COMMANDS_PER_FIRE, fsm_usart_get_lines_pending(p_fsm_usart), __LINE__, "The jukebox has not drained several commands in one fire");
+
+    fsm_fire(p_fsm_usart);
+    fsm_fire(p_fsm_jukebox);
+    UNITY_TEST_ASSERT_EQUAL_INT(0, fsm_usart_get_lines_pending(p_fsm_usart), __LINE__, "The remaining commands have not been drained");
+    UNITY_TEST_ASSERT_EQUAL_INT(num_lines * FSM_BUZZER_SPEED_ONE, ((fsm_buzzer_t *)p_fsm_buzzer)->player_speed, __LINE__, "The speed has not been set by the command");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, port_usart_get_rx_overruns(USART_0_ID), __LINE__, "There must be no overruns");
+
+    fsm_destroy(p_fsm_jukebox);
+    fsm_destroy(p_fsm_buzzer);
+    fsm_destroy(p_fsm_usart);
+    fsm_destroy(p_fsm_button);
+}
+
+/**
+ * @brief Send the jukebox its pending command line, let the reply be transmitted and return it.
+ *
+ * @param p_fsm_usart USART FSM of the jukebox
+ * @param p_fsm_jukebox Jukebox FSM
+ * @param p_reply Buffer for the reply
+ * @param size Size of the buffer
+ * @return uint32_t Length of the reply
+ */
+static uint32_t _jukebox_reply(fsm_t *p_fsm_usart, fsm_t *p_fsm_jukebox, char *p_reply, uint32_t size)
+{
+    fsm_fire(p_fsm_usart);
+    fsm_fire(p_fsm_jukebox);
+    fsm_fire(p_fsm_usart);
+    while (!port_usart_tx_done(USART_0_ID))
+    {
+        port_system_power_sleep();
+    }
+    fsm_fire(p_fsm_usart);
+    uint32_t length = port_usart_native_read_tx(USART_0_ID, p_reply, size - 1);
+    p_reply[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief The baud command changes the rate after its reply, the host at the old rate gets framing errors, and the
+ * autobaud detection recovers the line from the first character sent by the host.
+ *
+ */
+void test_usart_baud(void)
+{
+    fsm_t *p_fsm_button = fsm_button_new(BUTTON_0_ID);
+    fsm_t *p_fsm_usart = fsm_usart_new(USART_0_ID);
+    fsm_t *p_fsm_buzzer = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_t *p_fsm_jukebox = fsm_jukebox_new(p_fsm_button, 1500, p_fsm_usart, p_fsm_buzzer, 300);
+    char reply[USART_OUTPUT_BUFFER_LENGTH];
+
+    fsm_set_state(p_fsm_jukebox, WAIT_COMMAND);
+    fsm_usart_enable_rx_interrupt(p_fsm_usart);
+    port_usart_native_inject_rx(USART_0_ID, "baud 115200\n", 12);
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("Baud: 115200\n", reply, __LINE__, "The reply of the baud command is not correct");
+    UNITY_TEST_ASSERT_EQUAL_INT(115200, port_usart_get_baudrate(USART_0_ID), __LINE__, "The rate has not changed after the reply");
+    UNITY_TEST_ASSERT_EQUAL_INT(87, port_usart_native_get_byte_time_us(USART_0_ID), __LINE__, "The DMA does not transmit at the new rate");
+
+    port_usart_native_inject_rx(USART_0_ID, "baud 1000\n", 10);
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("Error:Baud rate not available\n", reply, __LINE__, "A rate out of range must be refused");
+    UNITY_TEST_ASSERT_EQUAL_INT(115200, port_usart_get_baudrate(USART_0_ID), __LINE__, "A refused rate must not change the USART");
+
+    /* The host stays at 9600 bauds: nothing it sends is received */
+    port_usart_native_set_line_baudrate(USART_0_ID, 9600);
+    port_usart_native_inject_rx(USART_0_ID, "info\n", 5);
+    UNITY_TEST_ASSERT_EQUAL_INT(5, port_usart_native_get_framing_errors(USART_0_ID), __LINE__, "The bytes at the wrong rate are not framing errors");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, port_usart_get_lines_pending(USART_0_ID), __LINE__, "A line at the wrong rate has been received");
+
+    /* Autobaud: the first line only sets the rate, the next ones are commands */
+    port_usart_start_autobaud(USART_0_ID);
+    UNITY_TEST_ASSERT(port_usart_autobaud_pending(USART_0_ID), __LINE__, "The autobaud detection has not started");
+    port_usart_native_inject_rx(USART_0_ID, "U\n", 2);
+    UNITY_TEST_ASSERT(!port_usart_autobaud_pending(USART_0_ID), __LINE__, "The autobaud detection has not ended");
+    UNITY_TEST_ASSERT_EQUAL_INT(9600, port_usart_get_baudrate(USART_0_ID), __LINE__, "The rate of the host has not been detected");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, port_usart_get_lines_pending(USART_0_ID), __LINE__, "The line of the autobaud must be discarded");
+    port_usart_native_inject_rx(USART_0_ID, "baud\n", 5);
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("Baud: 9600\n", reply, __LINE__, "The line is not recovered after the autobaud");
+    UNITY_TEST_ASSERT_EQUAL_INT(5, port_usart_native_get_framing_errors(USART_0_ID), __LINE__, "There must be no framing errors after the autobaud");
+
+    port_usart_native_set_line_baudrate(USART_0_ID, 0);
+    fsm_destroy(p_fsm_jukebox);
+    fsm_destroy(p_fsm_buzzer);
+    fsm_destroy(p_fsm_usart);
+    fsm_destroy(p_fsm_button);
+}
+
+/**
+ * @brief Send a binary frame to the jukebox and decode its reply.
+ *
+ * @param p_fsm_usart USART FSM of the jukebox
+ * @param p_fsm_jukebox Jukebox FSM
+ * @param p_request Encoded request
+ * @param length Number of bytes of the request
+ * @param p_reply Pointer to store the decoded reply
+ * @return command_frame_status_t Status of the decoding of the reply
+ */
+static command_frame_status_t _jukebox_frame(fsm_t *p_fsm_usart, fsm_t *p_fsm_jukebox, const char *p_request, uint32_t length, command_frame_t *p_reply)
+{
+    char reply[USART_OUTPUT_BUFFER_LENGTH];
+    port_usart_native_inject_rx(USART_0_ID, p_request, length);
+    uint32_t reply_length = _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    return command_frame_decode(reply, reply_length, p_reply);
+}
+
+/**
+ * @brief Binary frames and text commands are accepted on the same line: each frame is executed without converting
+ * text and answered with a reply frame, and corrupted frames are answered with their error.
+ *
+ */
+void test_usart_binary_frames(void)
+{
+    fsm_t *p_fsm_button = fsm_button_new(BUTTON_0_ID);
+    fsm_t *p_fsm_usart = fsm_usart_new(USART_0_ID);
+    fsm_t *p_fsm_buzzer = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_t *p_fsm_jukebox = fsm_jukebox_new(p_fsm_button, 1500, p_fsm_usart, p_fsm_buzzer, 300);
+    char request[USART_INPUT_BUFFER_LENGTH];
+    char reply[USART_OUTPUT_BUFFER_LENGTH];
+    command_frame_t frame;
+    uint32_t length;
+
+    fsm_set_state(p_fsm_jukebox, WAIT_COMMAND);
+    fsm_usart_enable_rx_interrupt(p_fsm_usart);
+
+    length = command_frame_encode_request(COMMAND_OP_SELECT, 2, 1, request, sizeof(request));
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, _jukebox_frame(p_fsm_usart, p_fsm_jukebox, request, length, &frame), __LINE__, "The reply to select is not a valid frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_OP_SELECT | COMMAND_FRAME_REPLY_FLAG, frame.opcode, __LINE__, "The opcode of the reply is not correct");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, frame.length, __LINE__, "The reply to select must only have the status");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_FRAME_OK, frame.data[0], __LINE__, "The select frame has not been executed");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, ((fsm_jukebox_t *)p_fsm_jukebox)->melody_idx, __LINE__, "The melody has not been selected");
+
+    /* 1.5 in thousandths: 0x05DC, whose high byte must be escaped */
+    length = command_frame_encode_request(COMMAND_OP_SPEED, 1500, 2, request, sizeof(request));
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, _jukebox_frame(p_fsm_usart, p_fsm_jukebox, request, length, &frame), __LINE__, "The reply to speed is not a valid frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_FRAME_OK, frame.data[0], __LINE__, "The speed frame has not been executed");
+    UNITY_TEST_ASSERT_EQUAL_INT(1.5 * FSM_BUZZER_SPEED_ONE, ((fsm_buzzer_t *)p_fsm_buzzer)->player_speed, __LINE__, "The speed has not been set by the frame");
+
+    /* A text command between two frames */
+    port_usart_native_inject_rx(USART_0_ID, "select 9\n", 9);
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("Error:Melody not found\n", reply, __LINE__, "The text command has not been executed");
+
+    length = command_frame_encode_request(COMMAND_OP_INFO, 0, 0, request, sizeof(request));
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, _jukebox_frame(p_fsm_usart, p_fsm_jukebox, request, length, &frame), __LINE__, "The reply to info is not a valid frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_FRAME_OK, frame.data[0], __LINE__, "The info frame has not been executed");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(strlen("Reproduciendo: tetris"), frame.length - 1, __LINE__, "The reply to info has not the text of the command");
+    UNITY_TEST_ASSERT(memcmp("Reproduciendo: tetris", &frame.data[1], frame.length - 1) == 0, __LINE__, "The text of the reply to info is not correct");
+
+    /* Errors: CRC, opcode and width of the argument */
+    length = command_frame_encode_request(COMMAND_OP_SELECT, 0, 1, request, sizeof(request));
+    request[2] ^= 0x01;
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, _jukebox_frame(p_fsm_usart, p_fsm_jukebox, request, length, &frame), __LINE__, "The reply to a corrupted frame is not a valid frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_FRAME_ERROR_CRC, frame.data[0], __LINE__, "The corrupted frame has not been detected");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, ((fsm_jukebox_t *)p_fsm_jukebox)->melody_idx, __LINE__, "A corrupted frame has been executed");
+    length = command_frame_encode_request(0x7F, 0, 0, request, sizeof(request));
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, _jukebox_frame(p_fsm_usart, p_fsm_jukebox, request, length, &frame), __LINE__, "The reply to an unknown opcode is not a valid frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_FRAME_ERROR_OPCODE, frame.data[0], __LINE__, "The unknown opcode has not been detected");
+    length = command_frame_encode_request(COMMAND_OP_SELECT, 0, 2, request, sizeof(request));
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, _jukebox_frame(p_fsm_usart, p_fsm_jukebox, request, length, &frame), __LINE__, "The reply to a wrong argument is not a valid frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_FRAME_ERROR_ARG, frame.data[0], __LINE__, "The wrong width of the argument has not been detected");
+
+    /* Two frames received together: the second one waits until the reply to the first one has been sent */
+    char requests[2 * USART_INPUT_BUFFER_LENGTH];
+    length = command_frame_encode_request(COMMAND_OP_SELECT, 0, 1, requests, sizeof(requests));
+    length += command_frame_encode_request(COMMAND_OP_PAUSE, 0, 0, &requests[length], sizeof(requests) - length);
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, _jukebox_frame(p_fsm_usart, p_fsm_jukebox, requests, length, &frame), __LINE__, "The reply to the first frame is not valid");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_OP_SELECT | COMMAND_FRAME_REPLY_FLAG, frame.opcode, __LINE__, "The first frame has not been answered first");
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, _jukebox_frame(p_fsm_usart, p_fsm_jukebox, NULL, 0, &frame), __LINE__, "The reply to the second frame is not valid");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_OP_PAUSE | COMMAND_FRAME_REPLY_FLAG, frame.opcode, __LINE__, "The second frame has been lost");
+    UNITY_TEST_ASSERT_EQUAL_INT(PAUSE, fsm_buzzer_get_action(p_fsm_buzzer), __LINE__, "The second frame has not been executed");
+
+    fsm_destroy(p_fsm_jukebox);
+    fsm_destroy(p_fsm_buzzer);
+    fsm_destroy(p_fsm_usart);
+    fsm_destroy(p_fsm_button);
+}
+
+/**
+ * @brief A batch of commands is validated as a whole, executed in one fire of the jukebox and answered with one
+ * combined reply.
+ *
+ */
+void test_usart_batch(void)
+{
+    fsm_t *p_fsm_button = fsm_button_new(BUTTON_0_ID);
+    fsm_t *p_fsm_usart = fsm_usart_new(USART_0_ID);
+    fsm_t *p_fsm_buzzer = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_t *p_fsm_jukebox = fsm_jukebox_new(p_fsm_button, 1500, p_fsm_usart, p_fsm_buzzer, 300);
+    fsm_jukebox_t *p_jukebox = (fsm_jukebox_t *)p_fsm_jukebox;
+    char reply[USART_OUTPUT_BUFFER_LENGTH];
+
+    fsm_set_state(p_fsm_jukebox, WAIT_COMMAND);
+    fsm_usart_enable_rx_interrupt(p_fsm_usart);
+
+    const char *p_batch = "select 2; speed 1.5; pause\n";
+    port_usart_native_inject_rx(USART_0_ID, p_batch, strlen(p_batch));
+    fsm_fire(p_fsm_usart);
+    fsm_fire(p_fsm_jukebox);
+    UNITY_TEST_ASSERT_EQUAL_INT(2, p_jukebox->melody_idx, __LINE__, "The first command of the batch has not been executed");
+    UNITY_TEST_ASSERT_EQUAL_INT(1.5 * FSM_BUZZER_SPEED_ONE, ((fsm_buzzer_t *)p_fsm_buzzer)->player_speed, __LINE__, "The second command of the batch has not been executed");
+    UNITY_TEST_ASSERT_EQUAL_INT(PAUSE, fsm_buzzer_get_action(p_fsm_buzzer), __LINE__, "The last command of the batch has not been executed in the same fire");
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("OK; OK; OK\n", reply, __LINE__, "The combined reply of the batch is not correct");
+
+    /* The replies of the commands are joined in order, and empty commands are skipped */
+    p_batch = "lista;info;;\n";
+    port_usart_native_inject_rx(USART_0_ID, p_batch, strlen(p_batch));
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("OK; Reproduciendo: tetris\n", reply, __LINE__, "The replies of the commands are not joined");
+
+    /* A command not valid, by its argument or by its validator, rejects the whole batch before executing any of them */
+    p_batch = "pause; select 9; info\n";
+    port_usart_native_inject_rx(USART_0_ID, p_batch, strlen(p_batch));
+    fsm_buzzer_set_action(p_fsm_buzzer, PLAY);
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("Error:Batch rejected at command 2\n", reply, __LINE__, "The batch with a melody not loaded has not been rejected");
+    UNITY_TEST_ASSERT_EQUAL_INT(PLAY, fsm_buzzer_get_action(p_fsm_buzzer), __LINE__, "A command before the rejected one has been executed");
+    fsm_buzzer_set_action(p_fsm_buzzer, PAUSE);
+    p_batch = "select 0; speed 0; play\n";
+    port_usart_native_inject_rx(USART_0_ID, p_batch, strlen(p_batch));
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("Error:Batch rejected at command 2\n", reply, __LINE__, "The batch with a speed of 0 has not been rejected");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, p_jukebox->melody_idx, __LINE__, "A command of a rejected batch has been executed");
+    UNITY_TEST_ASSERT_EQUAL_INT(1.5 * FSM_BUZZER_SPEED_ONE, ((fsm_buzzer_t *)p_fsm_buzzer)->player_speed, __LINE__, "The speed of a rejected batch has been applied");
+    p_batch = "select 0; speed fast; play\n";
+    port_usart_native_inject_rx(USART_0_ID, p_batch, strlen(p_batch));
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("Error:Batch rejected at command 2\n", reply, __LINE__, "The batch with an invalid argument has not been rejected");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, p_jukebox->melody_idx, __LINE__, "A command of a rejected batch has been executed");
+    p_batch = "play;play;play;play;play;play;play;play;play\n";
+    port_usart_native_inject_rx(USART_0_ID, p_batch, strlen(p_batch));
+    _jukebox_reply(p_fsm_usart, p_fsm_jukebox, reply, sizeof(reply));
+    UNITY_TEST_ASSERT_EQUAL_STRING("Error:Batch too long\n", reply, __LINE__, "A batch with too many commands has been accepted");
+    UNITY_TEST_ASSERT_EQUAL_INT(PAUSE, fsm_buzzer_get_action(p_fsm_buzzer), __LINE__, "A command of a batch too long has been executed");
+
+    fsm_destroy(p_fsm_jukebox);
+    fsm_destroy(p_fsm_buzzer);
+    fsm_destroy(p_fsm_usart);
+    fsm_destroy(p_fsm_button);
+}
+
+/**
+ * @brief The buzzer records the notes of a melody with the simulated times.
+ *
+ */
+void test_buzzer_timeline(void)
+{
+    fsm_t *p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_buzzer_set_melody(p_fsm, &scale_melody);
+    fsm_buzzer_set_action(p_fsm, PLAY);
+
+    for (uint32_t ms = 0; ms < 2500; ms++)
+    {
+        fsm_fire(p_fsm);
+        port_system_native_advance_ms(1);
+    }
+
+    uint32_t length;
+    const port_buzzer_native_event_t *p_timeline = port_buzzer_native_get_timeline(BUZZER_0_ID, &length);
+    UNITY_TEST_ASSERT_EQUAL_INT(scale_melody.melody_length, length, __LINE__, "The timeline does not have one entry per note");
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint32_t duration_ms = MELODY_EVENT_DURATION_MS(&scale_melody.p_events[i]);
+        UNITY_TEST_ASSERT_EQUAL_INT(melody_get_note_mhz(scale_melody.p_events[i].note), p_timeline[i].frequency_mhz, __LINE__, "The frequency recorded is not the one of the melody");
+        UNITY_TEST_ASSERT_EQUAL_INT(duration_ms * 1000U, p_timeline[i].duration_us, __LINE__, "The duration recorded is not the one of the melody");
+        UNITY_TEST_ASSERT(p_timeline[i].end_us >= p_timeline[i].start_us + duration_ms * 1000U, __LINE__, "The note stopped before its duration");
+    }
+    UNITY_TEST_ASSERT_EQUAL_INT(STOP, fsm_buzzer_get_action(p_fsm), __LINE__, "The melody has not finished");
+
+    fsm_destroy(p_fsm);
+}
+
+/**
+ * @brief A melody set while the player is paused waiting for a note does not leave the FSM waiting for a note end that
+ * will never come: it stays paused and plays the new melody when it is resumed.
+ *
+ */
+void test_buzzer_pause_set_melody(void)
+{
+    fsm_t *p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_buzzer_set_melody(p_fsm, &scale_melody);
+    fsm_buzzer_set_action(p_fsm, PLAY);
+    fsm_fire(p_fsm);
+    fsm_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(WAIT_NOTE, fsm_get_state(p_fsm), __LINE__, "The player is not waiting for the end of a note");
+
+    fsm_buzzer_set_action(p_fsm, PAUSE);
+    fsm_buzzer_set_melody(p_fsm, &tetris_melody);
+    for (uint32_t ms = 0; ms < 100; ms++)
+    {
+        fsm_fire(p_fsm);
+        port_system_native_advance_ms(1);
+    }
+    UNITY_TEST_ASSERT_EQUAL_INT(PAUSE_NOTE, fsm_get_state(p_fsm), __LINE__, "The player is stuck waiting for a dropped note");
+
+    uint32_t length_paused;
+    port_buzzer_native_get_timeline(BUZZER_0_ID, &length_paused);
+    fsm_buzzer_set_action(p_fsm, PLAY);
+    for (uint32_t ms = 0; ms < 1000; ms++)
+    {
+        fsm_fire(p_fsm);
+        port_system_native_advance_ms(1);
+    }
+    uint32_t length;
+    port_buzzer_native_get_timeline(BUZZER_0_ID, &length);
+    UNITY_TEST_ASSERT(length > length_paused, __LINE__, "The new melody has not been played after resuming");
+
+    fsm_destroy(p_fsm);
+}
+
+/**
+ * @brief Play a melody with the buzzer FSM, firing it every simulated millisecond, and get its timeline.
+ *
+ * @param p_fsm Buzzer FSM with the melody or the stream already set
+ * @param p_length Pointer where the number of notes played is stored
+ * @return const port_buzzer_native_event_t* Timeline
+ */
+static const port_buzzer_native_event_t *_play_to_end(fsm_t *p_fsm, uint32_t *p_length)
+{
+    fsm_buzzer_set_action(p_fsm, PLAY);
+    while (fsm_buzzer_get_action(p_fsm) == PLAY)
+    {
+        fsm_fire(p_fsm);
+        port_system_native_advance_ms(1);
+    }
+    return port_buzzer_native_get_timeline(BUZZER_0_ID, p_length);
+}
+
+/**
+ * @brief A melody longer than the buffers, streamed from a file, sounds exactly as the same melody played from memory:
+ * the chunks are prefetched, so there is no gap between them.
+ *
+ */
+void test_buzzer_stream_file(void)
+{
+    static melody_event_t events[STREAM_REPEATS * 40];
+    static port_buzzer_native_event_t reference[STREAM_REPEATS * 40];
+    uint32_t num_events = 0;
+    for (uint32_t r = 0; r < STREAM_REPEATS; r++)
+    {
+        memcpy(&events[num_events], tetris_melody.p_events, tetris_melody.melody_length * sizeof(melody_event_t));
+        num_events += tetris_melody.melody_length;
+    }
+    FILE *p_file = fopen(STREAM_FILE_PATH, "wb");
+    UNITY_TEST_ASSERT(p_file != NULL, __LINE__, "The file of the melody cannot be created");
+    fwrite(events, sizeof(melody_event_t), num_events, p_file);
+    fclose(p_file);
+
+    /* Reference: the same melody from memory */
+    melody_t melody = {.p_name = "stream", .p_events = events, .melody_length = (uint16_t)num_events};
+    fsm_t *p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_buzzer_set_melody(p_fsm, &melody);
+    uint32_t length;
+    const port_buzzer_native_event_t *p_timeline = _play_to_end(p_fsm, &length);
+    UNITY_TEST_ASSERT_EQUAL_INT(num_events, length, __LINE__, "The melody has not been played from memory");
+    memcpy(reference, p_timeline, length * sizeof(port_buzzer_native_event_t));
+    fsm_destroy(p_fsm);
+
+    /* Stream from the file */
+    port_melody_file_t source;
+    melody_stream_t stream;
+    UNITY_TEST_ASSERT(port_melody_file_native_open(&source, STREAM_FILE_PATH), __LINE__, "The file of the melody cannot be opened");
+    melody_stream_open(&stream, port_melody_file_native_read, &source);
+    p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+    fsm_buzzer_set_stream(p_fsm, &stream);
+    uint64_t offset_us = port_system_native_get_micros() - reference[0].start_us;
+    p_timeline = _play_to_end(p_fsm, &length);
+
+    UNITY_TEST_ASSERT_EQUAL_INT(num_events, length, __LINE__, "The streamed melody has not been played completely");
+    for (uint32_t i = 0; i < length; i++)
+    {
+        UNITY_TEST_ASSERT_EQUAL_INT(reference[i].frequency_mhz, p_timeline[i].frequency_mhz, __LINE__, "The streamed note is not the one of the melody");
+        UNITY_TEST_ASSERT_EQUAL_INT(reference[i].duration_us, p_timeline[i].duration_us, __LINE__, "The streamed duration is not the one of the melody");
+        UNITY_TEST_ASSERT_EQUAL_INT(reference[i].start_us + offset_us, p_timeline[i].start_us, __LINE__, "The streamed note does not start at the same time as from memory");
+    }
+    UNITY_TEST_ASSERT_EQUAL_INT(0, stream.underruns, __LINE__, "A chunk has not been prefetched");
+    /* When the melody ends the stream is rewound: its first chunk is read again, ready to play it again */
+    UNITY_TEST_ASSERT_EQUAL_INT((num_events + MELODY_STREAM_CHUNK_EVENTS - 1) / MELODY_STREAM_CHUNK_EVENTS + 1, stream.chunks_loaded, __LINE__, "The file has not been read by chunks");
+
+    fsm_destroy(p_fsm);
+    port_melody_file_native_close(&source);
+    remove(STREAM_FILE_PATH);
+}
+
+/**
+ * @brief Get the distribution of the silences between consecutive notes of the timeline.
+ *
+ * @param p_timeline Timeline of the buzzer
+ * @param length Number of notes of the timeline
+ * @param p_max_us Pointer where the longest gap is stored
+ * @return uint64_t Sum of all the gaps in microseconds
+ */
+static uint64_t _timeline_gaps(const port_buzzer_native_event_t *p_timeline, uint32_t length, uint64_t *p_max_us)
+{
+    uint64_t total_us = 0;
+    *p_max_us = 0;
+    for (uint32_t i = 1; i < length; i++)
+    {
+        uint64_t gap_us = p_timeline[i].start_us - p_timeline[i - 1].end_us;
+        total_us += gap_us;
+        if (gap_us > *p_max_us)
+        {
+            *p_max_us = gap_us;
+        }
+    }
+    return total_us;
+}
+
+/**
+ * @brief Notes are chained by the duration timer ISR from the note queue, so there is no gap between them whatever the
+ * period at which the superloop fires the buzzer FSM. The direct path, which reprograms the timers from the superloop
+ * when the note has ended, is measured for comparison.
+ *
+ */
+void test_buzzer_gapless(void)
+{
+    const uint32_t loop_periods_ms[] = {1, 7, 33};
+    const melody_t *p_melody = &tetris_melody;
+
+    for (uint32_t p = 0; p < sizeof(loop_periods_ms) / sizeof(loop_periods_ms[0]); p++)
+    {
+        uint32_t period_ms = loop_periods_ms[p];
+        uint32_t length;
+        uint64_t max_us;
+
+        /* Direct path: the next note is programmed when the superloop sees the end of the previous one */
+        port_buzzer_init(BUZZER_0_ID);
+        for (uint32_t i = 0; i < p_melody->melody_length; i++)
+        {
+            port_buzzer_set_note(BUZZER_0_ID, p_melody->p_events[i].note);
+            port_buzzer_set_note_duration(BUZZER_0_ID, MELODY_EVENT_DURATION_MS(&p_melody->p_events[i]));
+            while (!port_buzzer_get_note_timeout(BUZZER_0_ID))
+            {
+                port_system_native_advance_ms(period_ms);
+            }
+        }
+        const port_buzzer_native_event_t *p_timeline = port_buzzer_native_get_timeline(BUZZER_0_ID, &length);
+        uint64_t direct_total_us = _timeline_gaps(p_timeline, length, &max_us);
+        uint64_t direct_max_us = max_us;
+
+        /* Queued path: the FSM is fired once per loop period */
+        fsm_t *p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+        fsm_buzzer_set_melody(p_fsm, p_melody);
+        fsm_buzzer_set_action(p_fsm, PLAY);
+        while (fsm_buzzer_get_action(p_fsm) == PLAY)
+        {
+            fsm_fire(p_fsm);
+            port_system_native_advance_ms(period_ms);
+        }
+        p_timeline = port_buzzer_native_get_timeline(BUZZER_0_ID, &length);
+        uint64_t queued_total_us = _timeline_gaps(p_timeline, length, &max_us);
+
+        UNITY_TEST_ASSERT_EQUAL_INT(p_melody->melody_length, length, __LINE__, "The queued melody has not been played completely");
+        UNITY_TEST_ASSERT_EQUAL_INT(0, max_us, __LINE__, "There is a gap between queued notes");
+        for (uint32_t i = 0; i < length; i++)
+        {
+            UNITY_TEST_ASSERT_EQUAL_INT(MELODY_EVENT_DURATION_MS(&p_melody->p_events[i]) * 1000U, p_timeline[i].end_us - p_timeline[i].start_us, __LINE__, "A queued note does not last its duration");
+        }
+        printf("Gaps with the superloop every %2u ms: direct path max %6u us mean %6.1f us, note queue max %u us mean %.1f us\n",
+               (unsigned)period_ms, (unsigned)direct_max_us, direct_total_us / (double)(p_melody->melody_length - 1),
+               (unsigned)max_us, queued_total_us / (double)(p_melody->melody_length - 1));
+
+        fsm_destroy(p_fsm);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_simulated_clock);
+    RUN_TEST(test_simulated_timers);
+    RUN_TEST(test_button_press);
+    RUN_TEST(test_usart_fifos);
+    RUN_TEST(test_usart_dma_tx);
+    RUN_TEST(test_usart_two_instances);
+    RUN_TEST(test_usart_burst);
+    RUN_TEST(test_usart_baud);
+    RUN_TEST(test_usart_binary_frames);
+    RUN_TEST(test_usart_batch);
+    RUN_TEST(test_buzzer_timeline);
+    RUN_TEST(test_buzzer_pause_set_melody);
+    RUN_TEST(test_buzzer_stream_file);
+    RUN_TEST(test_buzzer_gapless);
+
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+/**
+ * @file test_power_policy.c
+ * @brief Unit test for the power policy on the native host port.
+ *
+ * It checks that the system stays in Stop mode while the jukebox is off, that a byte on the RX pin of the USART wakes
+ * it up, that the residency counters add up to the elapsed time, and that Stop mode is never chosen while the jukebox
+ * plays.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_button.h"
+#include "port_usart.h"
+#include "port_buzzer.h"
+
+/* Other libraries */
+#include "power_policy.h"
+#include "tickless.h"
+#include "scheduler.h"
+#include "fsm_button.h"
+#include "fsm_usart.h"
+#include "fsm_buzzer.h"
+#include "fsm_jukebox.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Global variables */
+static fsm_t *p_fsm_button;  /*!< FSM of the user button */
+static fsm_t *p_fsm_usart;   /*!< FSM of the USART */
+static fsm_t *p_fsm_buzzer;  /*!< FSM of the buzzer */
+static fsm_t *p_fsm_jukebox; /*!< FSM of the jukebox */
+
+/**
+ * @brief Create the FSMs of the jukebox and subscribe them as main.c does.
+ */
+static void _create_system(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+    scheduler_init();
+    tickless_init();
+    p_fsm_button = fsm_button_new(BUTTON_0_ID);
+    p_fsm_usart = fsm_usart_new(USART_0_ID);
+    p_fsm_buzzer = fsm_buzzer_new(BUZZER_0_ID);
+    p_fsm_jukebox = fsm_jukebox_new(p_fsm_button, 1500, p_fsm_usart, p_fsm_buzzer, 300);
+    scheduler_subscribe(p_fsm_button, PORT_SYSTEM_EVENT_BUTTON | PORT_SYSTEM_EVENT_TICK);
+    scheduler_subscribe(p_fsm_usart, PORT_SYSTEM_EVENT_USART | PORT_SYSTEM_EVENT_TICK | SCHEDULER_EVENT_STATE_CHANGE);
+    scheduler_subscribe(p_fsm_buzzer, PORT_SYSTEM_EVENT_NOTE | PORT_SYSTEM_EVENT_TICK | SCHEDULER_EVENT_STATE_CHANGE);
+    scheduler_subscribe(p_fsm_jukebox, SCHEDULER_EVENT_ALL);
+    tickless_register(p_fsm_button, fsm_button_get_next_timeout);
+    power_policy_init(p_fsm_jukebox, fsm_jukebox_check_standby, USART_0_ID);
+    port_system_post_event(SCHEDULER_EVENT_STATE_CHANGE);
+}
+
+/**
+ * @brief Destroy the FSMs created by _create_system().
+ */
+static void _destroy_system(void)
+{
+    fsm_destroy(p_fsm_jukebox);
+    fsm_destroy(p_fsm_buzzer);
+    fsm_destroy(p_fsm_usart);
+    fsm_destroy(p_fsm_button);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Simulated interrupt that presses (arg 1) or releases (arg 0) the button.
+ *
+ * @param arg 1 to press the button, 0 to release it
+ */
+static void _set_button(uint32_t arg)
+{
+    port_button_native_set_pressed(BUTTON_0_ID, arg != 0);
+}
+
+/**
+ * @brief Simulated interrupt that sends the command "info" to the USART.
+ *
+ * @param arg Not used
+ */
+static void _send_info(uint32_t arg)
+{
+    port_usart_native_inject_rx(USART_0_ID, "info\n", 5);
+}
+
+/**
+ * @brief End of a run of the test: wakes up the main loop, as any interrupt would do.
+ *
+ * @param arg Not used
+ */
+static void _end_run(uint32_t arg)
+{
+    port_system_post_event(PORT_SYSTEM_EVENT_TICK);
+}
+
+/**
+ * @brief Run the main loop until some simulated time.
+ *
+ * @param end_ms Simulated time at which the run ends
+ * @param stop true to use the power policy, false to use only the tickless idle
+ */
+static void _run_until_ms(uint32_t end_ms, bool stop)
+{
+    uint64_t end = (uint64_t)end_ms * 1000;
+    port_system_native_timer_start(end, _end_run, 0);
+    while (port_system_native_get_micros() < end)
+    {
+        if (!scheduler_dispatch())
+        {
+            if (stop)
+            {
+                power_policy_idle();
+            }
+            else
+            {
+                tickless_idle();
+            }
+        }
+    }
+    port_system_native_timer_cancel(_end_run, 0);
+}
+
+/**
+ * @brief While the jukebox is off the system is in Stop mode, and a byte received by the USART wakes it up.
+ *
+ */
+void test_stop_while_off(void)
+{
+    _create_system();
+    power_policy_residency_t r[POWER_POLICY_NUM_STATES];
+
+    _run_until_ms(5000, true);
+    power_policy_get_residency(r);
+    UNITY_TEST_ASSERT_EQUAL_INT(POWER_POLICY_STOP, power_policy_select(), __LINE__, "The jukebox off must allow Stop mode");
+    UNITY_TEST_ASSERT(r[POWER_POLICY_STOP].residency_ms >= 4990, __LINE__, "The system must stay in Stop mode while the jukebox is off");
+    UNITY_TEST_ASSERT(r[POWER_POLICY_STOP].entries <= 2, __LINE__, "Nothing must wake up the system from Stop mode");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, r[POWER_POLICY_SLEEP].entries, __LINE__, "The tickless idle must not be used while the jukebox is off");
+
+    /* The jukebox off ignores the command, but the byte wakes up the system, that goes back to Stop mode */
+    uint32_t stop_entries = r[POWER_POLICY_STOP].entries;
+    port_system_native_timer_start(6000 * 1000, _send_info, 0);
+    _run_until_ms(8000, true);
+    power_policy_get_residency(r);
+    UNITY_TEST_ASSERT(r[POWER_POLICY_STOP].entries > stop_entries, __LINE__, "The byte received by the USART has not woken up the system");
+    UNITY_TEST_ASSERT(fsm_jukebox_check_standby(p_fsm_jukebox), __LINE__, "The jukebox must stay off");
+    UNITY_TEST_ASSERT(r[POWER_POLICY_STOP].residency_ms >= 7900, __LINE__, "The system must stay in Stop mode while the jukebox is off");
+
+    uint64_t total_ms = r[POWER_POLICY_RUN].residency_ms + r[POWER_POLICY_SLEEP].residency_ms + r[POWER_POLICY_STOP].residency_ms;
+    UNITY_TEST_ASSERT(port_system_get_millis64() == total_ms, __LINE__, "The residencies must add up to the elapsed time");
+    UNITY_TEST_ASSERT_EQUAL_INT(port_system_native_get_micros() / 1000, port_system_get_millis(), __LINE__, "The system tick has drifted");
+
+    char msg[USART_OUTPUT_BUFFER_LENGTH];
+    power_policy_format(msg, sizeof(msg));
+    printf("%s", msg);
+    _destroy_system();
+}
+
+/**
+ * @brief Turn on the jukebox and play a melody: Stop mode is not used and the notes sound as with the tickless idle.
+ *
+ */
+void test_sleep_while_on(void)
+{
+    uint32_t notes[2];
+    uint64_t note_end_us[2];
+    power_policy_residency_t r[POWER_POLICY_NUM_STATES];
+
+    for (uint32_t stop = 0; stop < 2; stop++)
+    {
+        _create_system();
+        port_system_native_timer_start(10 * 1000, _set_button, 1);
+        port_system_native_timer_start(1610 * 1000, _set_button, 0);
+        _run_until_ms(1620, stop);
+        UNITY_TEST_ASSERT_EQUAL_INT(POWER_POLICY_SLEEP, power_policy_select(), __LINE__, "The jukebox on must not allow Stop mode");
+        port_usart_native_inject_rx(USART_0_ID, "play\n", 5);
+        _run_until_ms(20000, stop);
+
+        const port_buzzer_native_event_t *p_timeline = port_buzzer_native_get_timeline(BUZZER_0_ID, &notes[stop]);
+        note_end_us[stop] = (notes[stop] > 0) ? p_timeline[notes[stop] - 1].end_us : 0;
+        UNITY_TEST_ASSERT_EQUAL_INT(port_system_native_get_micros() / 1000, port_system_get_millis(), __LINE__, "The system tick has drifted");
+        _destroy_system();
+    }
+
+    power_policy_get_residency(r);
+    UNITY_TEST_ASSERT(r[POWER_POLICY_STOP].residency_ms <= 10, __LINE__, "Stop mode must only be used before the jukebox is turned on");
+    UNITY_TEST_ASSERT(r[POWER_POLICY_SLEEP].residency_ms > 18000, __LINE__, "The system must sleep in the tickless idle while the jukebox is on");
+    UNITY_TEST_ASSERT(notes[0] > 0, __LINE__, "No melody has been played");
+    UNITY_TEST_ASSERT_EQUAL_INT(notes[0], notes[1], __LINE__, "The power policy has changed the notes played");
+    UNITY_TEST_ASSERT(note_end_us[0] == note_end_us[1], __LINE__, "The power policy has changed the timing of the notes");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_stop_while_off);
+    RUN_TEST(test_sleep_while_on);
+
+    return UNITY_END();
+}
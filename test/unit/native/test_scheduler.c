@@ -0,0 +1,175 @@
+/**
+ * @file test_scheduler.c
+ * @brief Unit test for the event-driven scheduler on the native host port.
+ *
+ * It checks that only the FSMs subscribed to the pending events are fired, and measures the fires and iterations
+ * needed to play a melody compared with the busy-polling superloop.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_buzzer.h"
+
+/* Other libraries */
+#include "scheduler.h"
+#include "fsm_buzzer.h"
+#include "melodies.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Defines */
+#define TEST_STATE_IDLE 0 /*!< Only state of the counter FSM */
+
+/* Global variables */
+static uint32_t fires_a; /*!< Number of fires of the FSM subscribed to the button events */
+static uint32_t fires_b; /*!< Number of fires of the FSM subscribed to the USART events */
+
+/**
+ * @brief Guard that counts the fires of the FSM A.
+ */
+static bool _count_a(fsm_t *p_this)
+{
+    fires_a++;
+    return false;
+}
+
+/**
+ * @brief Guard that counts the fires of the FSM B.
+ */
+static bool _count_b(fsm_t *p_this)
+{
+    fires_b++;
+    return false;
+}
+
+static fsm_trans_t fsm_trans_a[] = {
+    {TEST_STATE_IDLE, _count_a, TEST_STATE_IDLE, NULL},
+    {-1, NULL, -1, NULL}};
+
+static fsm_trans_t fsm_trans_b[] = {
+    {TEST_STATE_IDLE, _count_b, TEST_STATE_IDLE, NULL},
+    {-1, NULL, -1, NULL}};
+
+void setUp(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+    scheduler_init();
+    fires_a = 0;
+    fires_b = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Only the FSMs subscribed to the posted events are fired.
+ *
+ */
+void test_dispatch_subscribed_only(void)
+{
+    fsm_t *p_fsm_a = fsm_new(fsm_trans_a);
+    fsm_t *p_fsm_b = fsm_new(fsm_trans_b);
+    scheduler_subscribe(p_fsm_a, PORT_SYSTEM_EVENT_BUTTON);
+    scheduler_subscribe(p_fsm_b, PORT_SYSTEM_EVENT_USART);
+
+    UNITY_TEST_ASSERT(!scheduler_dispatch(), __LINE__, "There were no events to dispatch");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, fires_a + fires_b, __LINE__, "A FSM has been fired without events");
+
+    port_system_post_event(PORT_SYSTEM_EVENT_BUTTON);
+    UNITY_TEST_ASSERT(scheduler_dispatch(), __LINE__, "The event has not been dispatched");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, fires_a, __LINE__, "The FSM subscribed to the event has not been fired");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, fires_b, __LINE__, "A FSM not subscribed to the event has been fired");
+
+    port_system_post_event(PORT_SYSTEM_EVENT_BUTTON | PORT_SYSTEM_EVENT_USART);
+    scheduler_dispatch();
+    UNITY_TEST_ASSERT_EQUAL_INT(2, fires_a, __LINE__, "Several events must fire a FSM only once");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, fires_b, __LINE__, "The FSM subscribed to the event has not been fired");
+
+    scheduler_stats_t stats;
+    scheduler_get_stats(&stats);
+    UNITY_TEST_ASSERT_EQUAL_INT(3, stats.iterations, __LINE__, "The iterations have not been counted");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, stats.idle_iterations, __LINE__, "The idle iterations have not been counted");
+    UNITY_TEST_ASSERT_EQUAL_INT(3, stats.fires, __LINE__, "The fires have not been counted");
+    UNITY_TEST_ASSERT_EQUAL_INT(3, stats.events, __LINE__, "The events have not been counted");
+
+    fsm_destroy(p_fsm_a);
+    fsm_destroy(p_fsm_b);
+}
+
+/**
+ * @brief The ISRs of the port post the events: SysTick every millisecond and TIM2 at the end of each note.
+ *
+ */
+void test_isr_events(void)
+{
+    port_system_native_advance_ms(1);
+    UNITY_TEST_ASSERT_EQUAL_INT(PORT_SYSTEM_EVENT_TICK, port_system_take_events(), __LINE__, "The SysTick has not posted its event");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, port_system_take_events(), __LINE__, "The events must be cleared once taken");
+
+    port_system_systick_suspend();
+    port_buzzer_set_note_duration(BUZZER_0_ID, 10);
+    port_system_wait_for_event();
+    UNITY_TEST_ASSERT_EQUAL_INT(PORT_SYSTEM_EVENT_NOTE, port_system_take_events(), __LINE__, "The end of the note has not posted its event");
+    port_system_systick_resume();
+}
+
+/**
+ * @brief Play a melody with the scheduler and compare the number of fires with the busy-polling superloop.
+ *
+ */
+void test_melody_fires(void)
+{
+    fsm_t *p_fsm = fsm_buzzer_new(BUZZER_0_ID);
+    scheduler_subscribe(p_fsm, PORT_SYSTEM_EVENT_NOTE | PORT_SYSTEM_EVENT_TICK | SCHEDULER_EVENT_STATE_CHANGE);
+    fsm_buzzer_set_melody(p_fsm, &scale_melody);
+    fsm_buzzer_set_action(p_fsm, PLAY);
+    port_system_post_event(SCHEDULER_EVENT_STATE_CHANGE);
+
+    uint32_t sleeps = port_system_native_get_sleep_count();
+    while (fsm_buzzer_get_action(p_fsm) != STOP)
+    {
+        if (!scheduler_dispatch())
+        {
+            port_system_wait_for_event();
+        }
+    }
+
+    uint32_t length;
+    port_buzzer_native_get_timeline(BUZZER_0_ID, &length);
+    UNITY_TEST_ASSERT_EQUAL_INT(scale_melody.melody_length, length, __LINE__, "The melody has not been played completely");
+
+    scheduler_stats_t stats;
+    scheduler_get_stats(&stats);
+    uint32_t elapsed_ms = port_system_get_millis();
+    printf("Scheduler: %lu ms, %lu iterations (%lu idle), %lu fires, %lu sleeps, %lu active cycles\n",
+           (unsigned long)elapsed_ms, (unsigned long)stats.iterations, (unsigned long)stats.idle_iterations,
+           (unsigned long)stats.fires, (unsigned long)(port_system_native_get_sleep_count() - sleeps),
+           (unsigned long)stats.active_cycles);
+
+    /* The FSM is fired about once per millisecond instead of continuously, and the system sleeps between ticks */
+    UNITY_TEST_ASSERT(stats.fires <= 2 * elapsed_ms + scale_melody.melody_length * 2, __LINE__, "The FSM has been fired more than needed");
+    UNITY_TEST_ASSERT(stats.idle_iterations > 0, __LINE__, "The system never went to sleep");
+
+    fsm_destroy(p_fsm);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_dispatch_subscribed_only);
+    RUN_TEST(test_isr_events);
+    RUN_TEST(test_melody_fires);
+
+    return UNITY_END();
+}
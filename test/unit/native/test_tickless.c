@@ -0,0 +1,215 @@
+/**
+ * @file test_tickless.c
+ * @brief Unit test for the tickless idle on the native host port.
+ *
+ * It checks that the system tick is compensated after each sleep, so the debounce and the duration of a press are
+ * measured as with the SysTick running, and compares the wake-ups and the time slept by the jukebox with the idle
+ * that only waits for the next interrupt.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_button.h"
+#include "port_usart.h"
+#include "port_buzzer.h"
+
+/* Other libraries */
+#include "tickless.h"
+#include "scheduler.h"
+#include "fsm_button.h"
+#include "fsm_usart.h"
+#include "fsm_buzzer.h"
+#include "fsm_jukebox.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Defines */
+#define TEST_PRESS_MS 500 /*!< Duration of the press of the button */
+
+void setUp(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+    scheduler_init();
+    tickless_init();
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Simulated interrupt that presses (arg 1) or releases (arg 0) the button.
+ *
+ * @param arg 1 to press the button, 0 to release it
+ */
+static void _set_button(uint32_t arg)
+{
+    port_button_native_set_pressed(BUTTON_0_ID, arg != 0);
+}
+
+/**
+ * @brief Simulated interrupt that sends the command "play" to the USART.
+ *
+ * @param arg Not used
+ */
+static void _send_play(uint32_t arg)
+{
+    port_usart_native_inject_rx(USART_0_ID, "play\n", 5);
+}
+
+/**
+ * @brief Run the main loop for some simulated time.
+ *
+ * @param ms Simulated milliseconds
+ * @param tickless true to use the tickless idle, false to wait for the next interrupt with the SysTick running
+ */
+static void _run_ms(uint32_t ms, bool tickless)
+{
+    uint64_t end = port_system_native_get_micros() + (uint64_t)ms * 1000;
+    while (port_system_native_get_micros() < end)
+    {
+        if (!scheduler_dispatch())
+        {
+            if (tickless)
+            {
+                tickless_idle();
+            }
+            else
+            {
+                port_system_wait_for_event();
+            }
+        }
+    }
+}
+
+/**
+ * @brief The debounce timeout wakes up the system and the duration of a press is kept across the sleeps.
+ *
+ */
+void test_button_timing(void)
+{
+    fsm_t *p_fsm = fsm_button_new(BUTTON_0_ID);
+    scheduler_subscribe(p_fsm, PORT_SYSTEM_EVENT_BUTTON | PORT_SYSTEM_EVENT_TICK);
+    tickless_register(p_fsm, fsm_button_get_next_timeout);
+
+    /* The press and the release are interrupts that wake up the system */
+    uint32_t pressed_ms = 100;
+    port_system_native_timer_start(pressed_ms * 1000, _set_button, 1);
+    port_system_native_timer_start((pressed_ms + TEST_PRESS_MS) * 1000, _set_button, 0);
+    _run_ms(pressed_ms + TEST_PRESS_MS - 1, true);
+    UNITY_TEST_ASSERT_EQUAL_INT(BUTTON_PRESSED, fsm_get_state(p_fsm), __LINE__, "The debounce timeout has not been taken");
+    _run_ms(2 * BUTTON_0_DEBOUNCE_TIME_MS, true);
+    UNITY_TEST_ASSERT_EQUAL_INT(BUTTON_RELEASED, fsm_get_state(p_fsm), __LINE__, "The release has not been debounced");
+    TEST_ASSERT_INT_WITHIN_MESSAGE(1, TEST_PRESS_MS, fsm_button_get_duration(p_fsm), "The duration of the press is not correct");
+    UNITY_TEST_ASSERT_EQUAL_INT(port_system_native_get_micros() / 1000, port_system_get_millis(), __LINE__, "The system tick has drifted");
+
+    tickless_log_entry_t log[TICKLESS_LOG_LENGTH];
+    uint32_t length = tickless_get_log(log, TICKLESS_LOG_LENGTH);
+    printf("Power log of a press of %u ms:\n", TEST_PRESS_MS);
+    for (uint32_t i = 0; i < length; i++)
+    {
+        printf("  %5u ms: sleep %4u ms of %4u ms, %s\n", (unsigned)log[i].start_ms, (unsigned)log[i].slept_ms,
+               (unsigned)log[i].requested_ms, log[i].timeout ? "timeout" : "interrupt");
+    }
+
+    /* The debounce after the press is a sleep that ends exactly at its timeout */
+    bool debounce_found = false;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if ((log[i].start_ms >= pressed_ms) && log[i].timeout)
+        {
+            UNITY_TEST_ASSERT_EQUAL_INT(pressed_ms + BUTTON_0_DEBOUNCE_TIME_MS + 1, log[i].start_ms + log[i].slept_ms, __LINE__, "The debounce sleep must end at the timeout");
+            debounce_found = true;
+            break;
+        }
+    }
+    UNITY_TEST_ASSERT(debounce_found, __LINE__, "The debounce timeout has not woken up the system");
+
+    tickless_stats_t stats;
+    tickless_get_stats(&stats);
+    UNITY_TEST_ASSERT(stats.sleeps < 20, __LINE__, "The system must wake up only for the timeouts and the interrupts");
+
+    fsm_destroy(p_fsm);
+}
+
+/**
+ * @brief Turn on the jukebox, play a song and let it wait for commands, with and without tickless idle.
+ *
+ */
+void test_jukebox_sleep(void)
+{
+    uint32_t iterations[2];
+    uint32_t notes[2];
+    uint64_t note_end_us[2];
+
+    for (uint32_t tickless = 0; tickless < 2; tickless++)
+    {
+        port_system_init();
+        port_system_native_set_realtime(false);
+        scheduler_init();
+        tickless_init();
+        fsm_t *p_fsm_button = fsm_button_new(BUTTON_0_ID);
+        fsm_t *p_fsm_usart = fsm_usart_new(USART_0_ID);
+        fsm_t *p_fsm_buzzer = fsm_buzzer_new(BUZZER_0_ID);
+        fsm_t *p_fsm_jukebox = fsm_jukebox_new(p_fsm_button, 1500, p_fsm_usart, p_fsm_buzzer, 300);
+        scheduler_subscribe(p_fsm_button, PORT_SYSTEM_EVENT_BUTTON | PORT_SYSTEM_EVENT_TICK);
+        scheduler_subscribe(p_fsm_usart, PORT_SYSTEM_EVENT_USART | PORT_SYSTEM_EVENT_TICK | SCHEDULER_EVENT_STATE_CHANGE);
+        scheduler_subscribe(p_fsm_buzzer, PORT_SYSTEM_EVENT_NOTE | PORT_SYSTEM_EVENT_TICK | SCHEDULER_EVENT_STATE_CHANGE);
+        scheduler_subscribe(p_fsm_jukebox, SCHEDULER_EVENT_ALL);
+        tickless_register(p_fsm_button, fsm_button_get_next_timeout);
+        port_system_post_event(SCHEDULER_EVENT_STATE_CHANGE);
+
+        port_system_native_timer_start(10 * 1000, _set_button, 1);
+        port_system_native_timer_start(1610 * 1000, _set_button, 0);
+        port_system_native_timer_start(6610 * 1000, _send_play, 0);
+        _run_ms(26610, tickless);
+
+        scheduler_stats_t stats;
+        scheduler_get_stats(&stats);
+        iterations[tickless] = stats.iterations;
+        const port_buzzer_native_event_t *p_timeline = port_buzzer_native_get_timeline(BUZZER_0_ID, &notes[tickless]);
+        note_end_us[tickless] = (notes[tickless] > 0) ? p_timeline[notes[tickless] - 1].end_us : 0;
+        UNITY_TEST_ASSERT_EQUAL_INT(port_system_native_get_micros() / 1000, port_system_get_millis(), __LINE__, "The system tick has drifted");
+
+        if (tickless)
+        {
+            tickless_stats_t tickless_stats;
+            tickless_get_stats(&tickless_stats);
+            uint32_t elapsed_ms = port_system_get_millis();
+            printf("Tickless: %u sleeps (%u by timeout), %u of %u ms asleep (%.1f %%)\n", (unsigned)tickless_stats.sleeps,
+                   (unsigned)tickless_stats.timeout_wakeups, (unsigned)tickless_stats.slept_ms, (unsigned)elapsed_ms,
+                   100.0 * tickless_stats.slept_ms / elapsed_ms);
+            UNITY_TEST_ASSERT(tickless_stats.slept_ms > elapsed_ms * 9 / 10, __LINE__, "The system must sleep most of the time");
+        }
+
+        fsm_destroy(p_fsm_jukebox);
+        fsm_destroy(p_fsm_buzzer);
+        fsm_destroy(p_fsm_usart);
+        fsm_destroy(p_fsm_button);
+    }
+
+    printf("Main loop iterations: %u waiting for interrupts, %u tickless\n", (unsigned)iterations[0], (unsigned)iterations[1]);
+    UNITY_TEST_ASSERT(notes[0] > 0, __LINE__, "No melody has been played");
+    UNITY_TEST_ASSERT_EQUAL_INT(notes[0], notes[1], __LINE__, "The tickless idle has changed the notes played");
+    UNITY_TEST_ASSERT(note_end_us[0] == note_end_us[1], __LINE__, "The tickless idle has changed the timing of the notes");
+    UNITY_TEST_ASSERT(iterations[1] * 10 < iterations[0], __LINE__, "The tickless idle must wake up much less");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_button_timing);
+    RUN_TEST(test_jukebox_sleep);
+
+    return UNITY_END();
+}
@@ -0,0 +1,168 @@
+/**
+ * @file test_time_base.c
+ * @brief Unit test for the 64-bit time base and the wrap-safe deadlines on the native host port.
+ *
+ * The system tick is fast-forwarded close to 2^32 ms (49.7 days of uptime) and the tests run across the wrap of its
+ * low 32 bits.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+#include "port_button.h"
+
+/* Other libraries */
+#include "time_base.h"
+#include "tickless.h"
+#include "scheduler.h"
+#include "fsm_button.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Defines */
+#define TEST_WRAP_MS (1ULL << 32)        /*!< First value of the 64-bit tick after the wrap of its low 32 bits */
+#define TEST_PRESS_MS 300                /*!< Duration of the press of the button */
+
+void setUp(void)
+{
+    port_system_init();
+    port_system_native_set_realtime(false);
+    scheduler_init();
+    tickless_init();
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Simulated interrupt that presses (arg 1) or releases (arg 0) the button.
+ *
+ * @param arg 1 to press the button, 0 to release it
+ */
+static void _set_button(uint32_t arg)
+{
+    port_button_native_set_pressed(BUTTON_0_ID, arg != 0);
+}
+
+/**
+ * @brief Run the main loop with the tickless idle until some simulated time.
+ *
+ * @param end_us Simulated time in microseconds at which the run ends
+ */
+static void _run_until_us(uint64_t end_us)
+{
+    while (port_system_native_get_micros() < end_us)
+    {
+        if (!scheduler_dispatch())
+        {
+            tickless_idle();
+        }
+    }
+}
+
+/**
+ * @brief The 32-bit tick wraps and the 64-bit tick keeps counting.
+ *
+ */
+void test_millis_wrap(void)
+{
+    port_system_set_millis64(TEST_WRAP_MS - 5);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFB, port_system_get_millis(), __LINE__, "The 32-bit tick must be the low 32 bits");
+    port_system_native_advance_ms(10);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(5, port_system_get_millis(), __LINE__, "The 32-bit tick must wrap");
+    UNITY_TEST_ASSERT(port_system_get_millis64() == TEST_WRAP_MS + 5, __LINE__, "The 64-bit tick must carry the wrap");
+}
+
+/**
+ * @brief The time in microseconds is monotonic across the wrap and consistent with the tick.
+ *
+ */
+void test_micros_monotonic(void)
+{
+    port_system_set_millis64(TEST_WRAP_MS - 3);
+    uint64_t last_us = port_system_get_micros64();
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        port_system_native_advance_us(70);
+        uint64_t us = port_system_get_micros64();
+        UNITY_TEST_ASSERT(us == last_us + 70, __LINE__, "The time in microseconds must advance with the simulated clock");
+        UNITY_TEST_ASSERT(us / 1000 == port_system_get_millis64(), __LINE__, "The time in microseconds must be consistent with the tick");
+        last_us = us;
+    }
+    UNITY_TEST_ASSERT(last_us > TEST_WRAP_MS * 1000, __LINE__, "The test must cross the wrap");
+}
+
+/**
+ * @brief The deadlines of the 32-bit tick are compared with the signed difference across the wrap.
+ *
+ */
+void test_deadline_helpers(void)
+{
+    uint32_t before_wrap = 0xFFFFFFF0;
+    uint32_t after_wrap = 0x00000010;
+    /* The plain comparison fails across the wrap: this is what broke the debounce after 49.7 days */
+    UNITY_TEST_ASSERT(!(after_wrap > before_wrap), __LINE__, "The plain comparison of the 32-bit tick does not see the wrap");
+    UNITY_TEST_ASSERT(time_base_reached32(after_wrap, before_wrap), __LINE__, "A deadline before the wrap must be reached after it");
+    UNITY_TEST_ASSERT(!time_base_reached32(before_wrap, after_wrap), __LINE__, "A deadline after the wrap must not be reached before it");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0x20, time_base_remaining32(before_wrap, after_wrap), __LINE__, "The remaining time must cross the wrap");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, time_base_remaining32(after_wrap, before_wrap), __LINE__, "A deadline reached has no remaining time");
+
+    UNITY_TEST_ASSERT(time_base_reached(TEST_WRAP_MS, TEST_WRAP_MS), __LINE__, "A deadline is reached at its own time");
+    UNITY_TEST_ASSERT(!time_base_reached(TEST_WRAP_MS - 1, TEST_WRAP_MS), __LINE__, "A deadline is not reached before its time");
+    UNITY_TEST_ASSERT(time_base_remaining(TEST_WRAP_MS - 16, TEST_WRAP_MS + 16) == 32, __LINE__, "The remaining time of the 64-bit tick is not correct");
+
+    port_system_set_millis64(TEST_WRAP_MS - 1);
+    UNITY_TEST_ASSERT(time_base_deadline_ms(2) == TEST_WRAP_MS + 1, __LINE__, "The deadline must be in the 64-bit time base");
+}
+
+/**
+ * @brief A press of the button across the wrap is debounced and measured as any other, with the tickless idle.
+ *
+ */
+void test_button_across_wrap(void)
+{
+    fsm_t *p_fsm = fsm_button_new(BUTTON_0_ID);
+    scheduler_subscribe(p_fsm, PORT_SYSTEM_EVENT_BUTTON | PORT_SYSTEM_EVENT_TICK);
+    tickless_register(p_fsm, fsm_button_get_next_timeout);
+
+    /* Press 100 ms before the wrap, release 200 ms after it */
+    port_system_set_millis64(TEST_WRAP_MS - 1000);
+    port_system_native_timer_start(900 * 1000, _set_button, 1);
+    port_system_native_timer_start((900 + TEST_PRESS_MS) * 1000, _set_button, 0);
+
+    _run_until_us((900 + BUTTON_0_DEBOUNCE_TIME_MS + 10) * 1000);
+    UNITY_TEST_ASSERT_EQUAL_INT(BUTTON_PRESSED, fsm_get_state(p_fsm), __LINE__, "The debounce of the press has not ended");
+    _run_until_us((1000 + 10) * 1000);
+    UNITY_TEST_ASSERT(port_system_get_millis() < 1000, __LINE__, "The 32-bit tick must have wrapped during the press");
+    UNITY_TEST_ASSERT_EQUAL_INT(BUTTON_PRESSED, fsm_get_state(p_fsm), __LINE__, "The wrap must not release the button");
+    _run_until_us((900 + TEST_PRESS_MS + 2 * BUTTON_0_DEBOUNCE_TIME_MS) * 1000);
+    UNITY_TEST_ASSERT_EQUAL_INT(BUTTON_RELEASED, fsm_get_state(p_fsm), __LINE__, "The debounce of the release has not ended");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_PRESS_MS, fsm_button_get_duration(p_fsm), __LINE__, "The duration of the press across the wrap is not correct");
+    UNITY_TEST_ASSERT(port_system_get_millis64() == TEST_WRAP_MS - 1000 + port_system_native_get_micros() / 1000, __LINE__, "The system tick has drifted");
+
+    tickless_stats_t stats;
+    tickless_get_stats(&stats);
+    UNITY_TEST_ASSERT(stats.sleeps < 20, __LINE__, "The debounce timeouts must wake up the system across the wrap");
+
+    fsm_destroy(p_fsm);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_millis_wrap);
+    RUN_TEST(test_micros_monotonic);
+    RUN_TEST(test_deadline_helpers);
+    RUN_TEST(test_button_across_wrap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,386 @@
+/**
+ * @file test_buzzer_timer.c
+ * @brief Unit test for the register values of the timers of the buzzer, with micro-benchmarks of a note change and of
+ * the prescaler solver.
+ *
+ * The reference is the iterative search of the prescaler that port_buzzer.c used before the tables: it increments
+ * PSC by one, in double precision, until ARR fits in 16 bits. Costs are measured with port_system_get_cycles() (core
+ * cycles on the target, nanoseconds on the host).
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+
+/* Other libraries */
+#include "buzzer_timer.h"
+#include "melodies.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define BENCHMARK_ROUNDS 2000 /*!< Number of note changes of each melody in the benchmark */
+#define CLOCK_HZ BUZZER_TIMER_TABLE_CLOCK_HZ /*!< Clock of the timers in the tests */
+
+/* Global variables */
+static const melody_t *melodies[] = {&happy_birthday_melody, &tetris_melody, &scale_melody}; /*!< Melodies played in the benchmark */
+
+/**
+ * @brief Round a positive value to the nearest integer without libm.
+ */
+static double _round(double x)
+{
+    return (double)(uint64_t)(x + 0.5);
+}
+
+/**
+ * @brief Iterative search of the prescaler of the PWM timer, as port_buzzer.c did before the tables.
+ */
+static void _iterative_frequency(uint32_t clock_hz, double frequency_hz, buzzer_timer_config_t *p_config)
+{
+    double sysclk_as_double = (double)clock_hz;
+    double PSC = 0;
+    double ARR = ((sysclk_as_double * (1.0 / frequency_hz)) / (PSC + 1)) - 1.0;
+    while (ARR > 65535)
+    {
+        PSC++;
+        ARR = ((sysclk_as_double * (1.0 / frequency_hz)) / (PSC + 1)) - 1.0;
+        ARR = _round(ARR);
+    }
+    p_config->arr = (uint16_t)_round(ARR);
+    p_config->psc = (uint16_t)_round(PSC);
+    p_config->ccr1 = (uint16_t)((ARR + 1) * 0.5);
+}
+
+/**
+ * @brief Iterative search of the prescaler of the duration timer, as port_buzzer.c did before the tables.
+ */
+static void _iterative_duration(uint32_t clock_hz, uint32_t duration_ms, buzzer_timer_config_t *p_config)
+{
+    double duration_as_double = (double)duration_ms;
+    double sysclk_as_double = (double)clock_hz;
+    double PSC = 0;
+    double ARR = _round(((sysclk_as_double * (duration_as_double / 1000)) / (PSC + 1)) - 1.0);
+    while (ARR > 65535.0)
+    {
+        PSC += 1.0;
+        ARR = _round(((sysclk_as_double * (duration_as_double / 1000)) / (PSC + 1)) - 1.0);
+    }
+    p_config->arr = (uint16_t)ARR;
+    p_config->psc = (uint16_t)PSC;
+    p_config->ccr1 = 0;
+}
+
+/**
+ * @brief Frequency of the note of a melody event in Hz, as the old double arrays stored it.
+ */
+static double _event_frequency(const melody_event_t *p_event)
+{
+    return melody_get_note_mhz(p_event->note) / 1000.0;
+}
+
+/**
+ * @brief Frequency generated by a configuration of the PWM timer.
+ */
+static double _achieved_frequency(uint32_t clock_hz, const buzzer_timer_config_t *p_config)
+{
+    return (double)clock_hz / ((p_config->psc + 1.0) * (p_config->arr + 1.0));
+}
+
+void setUp(void)
+{
+    port_system_init();
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Every note of the melodies is in the table, and the table matches the closed form and the old search.
+ *
+ */
+void test_note_table(void)
+{
+    for (uint32_t m = 0; m < sizeof(melodies) / sizeof(melodies[0]); m++)
+    {
+        for (uint32_t i = 0; i < melodies[m]->melody_length; i++)
+        {
+            uint8_t note = melodies[m]->p_events[i].note;
+            if (note == MIDI_SILENCE)
+            {
+                continue;
+            }
+            uint32_t freq_mhz = melody_get_note_mhz(note);
+            int32_t index = buzzer_timer_find_note(freq_mhz);
+            UNITY_TEST_ASSERT(index >= 0, __LINE__, "A note of a melody is not in the table");
+            UNITY_TEST_ASSERT_EQUAL_INT(note - BUZZER_TIMER_FIRST_NOTE, index, __LINE__, "The table is not indexed by MIDI note number");
+
+            const buzzer_timer_config_t *p_entry = buzzer_timer_get_note_entry(index);
+            buzzer_timer_config_t computed, reference, midi;
+            UNITY_TEST_ASSERT(buzzer_timer_get_midi_config(CLOCK_HZ, note, &midi), __LINE__, "A MIDI note of the table has not been taken from the table");
+            UNITY_TEST_ASSERT_EQUAL_MEMORY(p_entry, &midi, sizeof(midi), __LINE__, "The MIDI lookup does not match the table");
+            buzzer_timer_solve_frequency(CLOCK_HZ, freq_mhz, &computed);
+            _iterative_frequency(CLOCK_HZ, _event_frequency(&melodies[m]->p_events[i]), &reference);
+            UNITY_TEST_ASSERT_EQUAL_INT(computed.psc, p_entry->psc, __LINE__, "The table and the closed form do not match");
+            UNITY_TEST_ASSERT_EQUAL_INT(computed.arr, p_entry->arr, __LINE__, "The table and the closed form do not match");
+            UNITY_TEST_ASSERT_EQUAL_INT(computed.ccr1, p_entry->ccr1, __LINE__, "The table and the closed form do not match");
+            UNITY_TEST_ASSERT_EQUAL_INT(reference.psc, p_entry->psc, __LINE__, "The prescaler is not the one of the iterative search");
+            TEST_ASSERT_INT_WITHIN_MESSAGE(1, reference.arr, p_entry->arr, "ARR is not the one of the iterative search");
+        }
+    }
+
+    for (uint32_t i = 0; i < BUZZER_TIMER_NUM_NOTES; i++)
+    {
+        const buzzer_timer_config_t *p_entry = buzzer_timer_get_note_entry(i);
+        UNITY_TEST_ASSERT_EQUAL_INT((p_entry->arr + 1U) / 2U, p_entry->ccr1, __LINE__, "CCR1 does not give a 50% duty cycle");
+        UNITY_TEST_ASSERT((i == 0) || (_achieved_frequency(CLOCK_HZ, p_entry) > _achieved_frequency(CLOCK_HZ, buzzer_timer_get_note_entry(i - 1))), __LINE__, "The notes of the table are not in ascending order");
+    }
+    UNITY_TEST_ASSERT(buzzer_timer_get_note_entry(BUZZER_TIMER_NUM_NOTES) == NULL, __LINE__, "An index out of the table has been accepted");
+
+    buzzer_timer_config_t config;
+    UNITY_TEST_ASSERT(buzzer_timer_get_note_config(CLOCK_HZ, LA4, &config), __LINE__, "A note of the table has not been taken from the table");
+    TEST_ASSERT_DOUBLE_WITHIN(0.01, LA4, _achieved_frequency(CLOCK_HZ, &config));
+}
+
+/**
+ * @brief Values out of the tables, or another clock, use the closed form.
+ *
+ */
+void test_fallback(void)
+{
+    const uint32_t clocks[] = {CLOCK_HZ, 84000000U, 180000000U};
+    const double freqs[] = {20.0, 100.5, 1234.567, 15000.0};
+    buzzer_timer_config_t config, reference;
+
+    for (uint32_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        for (uint32_t f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++)
+        {
+            UNITY_TEST_ASSERT(!buzzer_timer_get_note_config(clocks[c], freqs[f], &config), __LINE__, "A frequency out of the table has been taken from the table");
+            _iterative_frequency(clocks[c], freqs[f], &reference);
+            UNITY_TEST_ASSERT_EQUAL_INT(reference.psc, config.psc, __LINE__, "The closed form does not find the smallest prescaler");
+            TEST_ASSERT_DOUBLE_WITHIN(freqs[f] * 1e-3, freqs[f], _achieved_frequency(clocks[c], &config));
+        }
+    }
+
+    UNITY_TEST_ASSERT(!buzzer_timer_get_note_config(84000000U, LA4, &config), __LINE__, "The table has been used with another clock");
+    TEST_ASSERT_DOUBLE_WITHIN(0.01, LA4, _achieved_frequency(84000000U, &config));
+    UNITY_TEST_ASSERT(!buzzer_timer_get_midi_config(84000000U, MIDI_LA4, &config), __LINE__, "The table has been used with another clock");
+    TEST_ASSERT_DOUBLE_WITHIN(0.01, LA4, _achieved_frequency(84000000U, &config));
+    UNITY_TEST_ASSERT(!buzzer_timer_get_midi_config(CLOCK_HZ, MIDI_SI5 + 1, &config), __LINE__, "A MIDI note out of the table has been taken from the table");
+    TEST_ASSERT_DOUBLE_WITHIN(0.01, SI5 * 1.0594630943592953, _achieved_frequency(CLOCK_HZ, &config));
+}
+
+/**
+ * @brief The durations of the melodies are in the table, and any duration matches the old search.
+ *
+ */
+void test_durations(void)
+{
+    const uint32_t durations[] = {100, 150, 200, 250, 300, 400, 500, 600, 800, 1000, 1, 37, 133, 2000, 4096};
+    buzzer_timer_config_t config, reference;
+
+    for (uint32_t i = 0; i < sizeof(durations) / sizeof(durations[0]); i++)
+    {
+        bool from_table = buzzer_timer_get_duration_config(CLOCK_HZ, durations[i], &config);
+        UNITY_TEST_ASSERT(from_table == (i < BUZZER_TIMER_NUM_DURATIONS), __LINE__, "The table of durations has not been used as expected");
+        _iterative_duration(CLOCK_HZ, durations[i], &reference);
+        UNITY_TEST_ASSERT_EQUAL_INT(reference.psc, config.psc, __LINE__, "The prescaler of the duration is not the one of the iterative search");
+        TEST_ASSERT_INT_WITHIN_MESSAGE(1, reference.arr, config.arr, "ARR of the duration is not the one of the iterative search");
+    }
+}
+
+/**
+ * @brief The durations of a queue taken from the table, with the carried error, are the ones of the solver, and the
+ * carried error stays within half a prescaled count.
+ *
+ */
+void test_carried_durations(void)
+{
+    const uint32_t durations_us[] = {150000, 150000, 600000, 250000, 133000, 150000, 1000000, 1500, 800000, 150000};
+    buzzer_timer_config_t config, reference;
+    int64_t error = 0;
+    int64_t reference_error = 0;
+
+    for (uint32_t i = 0; i < sizeof(durations_us) / sizeof(durations_us[0]); i++)
+    {
+        bool from_table = buzzer_timer_get_carried_duration_config(CLOCK_HZ, durations_us[i], &error, &config);
+        UNITY_TEST_ASSERT(from_table == (durations_us[i] % 50000U == 0), __LINE__, "The table of durations has not been used as expected");
+
+        int64_t target = (int64_t)CLOCK_HZ * durations_us[i] + reference_error;
+        uint64_t cycles = buzzer_timer_solve((uint64_t)target, 1000000U, &reference);
+        reference_error = target - (int64_t)(cycles * 1000000U);
+        UNITY_TEST_ASSERT_EQUAL_INT(reference.psc, config.psc, __LINE__, "The prescaler is not the one of the solver");
+        UNITY_TEST_ASSERT_EQUAL_INT(reference.arr, config.arr, __LINE__, "ARR is not the one of the solver");
+        UNITY_TEST_ASSERT(reference_error == error, __LINE__, "The carried error is not the one of the solver");
+        UNITY_TEST_ASSERT(2 * (error < 0 ? -error : error) <= (int64_t)(config.psc + 1U) * 1000000, __LINE__, "The carried error is greater than half a prescaled count");
+    }
+}
+
+/**
+ * @brief The solver finds the smallest prescaler, the error is within half a prescaled count and the achieved value is
+ * reported.
+ *
+ */
+void test_solver(void)
+{
+    const uint64_t periods[][2] = {{1, 1}, {65536, 1}, {65537, 1}, {131072, 1}, {131073, 1}, {16000000000ULL, 130813}, {12800000, 1}, {1000001, 3}, {4294967295ULL, 7}};
+    buzzer_timer_config_t config;
+
+    for (uint32_t i = 0; i < sizeof(periods) / sizeof(periods[0]); i++)
+    {
+        uint64_t num = periods[i][0], den = periods[i][1];
+        uint64_t achieved = buzzer_timer_solve(num, den, &config);
+
+        /* Brute force: smallest prescaler with the nearest ARR in 16 bits */
+        uint32_t psc = 0;
+        while ((2 * num + den * (psc + 1)) / (2 * den * (psc + 1)) > BUZZER_TIMER_MAX_COUNT)
+        {
+            psc++;
+        }
+        UNITY_TEST_ASSERT_EQUAL_INT(psc, config.psc, __LINE__, "The solver does not find the smallest prescaler");
+        UNITY_TEST_ASSERT_EQUAL_INT((uint64_t)(config.psc + 1U) * (config.arr + 1U), achieved, __LINE__, "The period reported is not the one of the registers");
+        uint64_t error = (achieved * den > num) ? achieved * den - num : num - achieved * den;
+        UNITY_TEST_ASSERT(2 * error <= (config.psc + 1U) * den, __LINE__, "The error is greater than half a prescaled count");
+    }
+
+    /* 800 ms at 16 MHz needs PSC = 195, which took 195 iterations of the old search */
+    uint32_t achieved_us = buzzer_timer_solve_duration(CLOCK_HZ, 800000, &config);
+    UNITY_TEST_ASSERT_EQUAL_INT(195, config.psc, __LINE__, "The prescaler of 800 ms is not correct");
+    TEST_ASSERT_INT_WITHIN_MESSAGE(7, 800000, achieved_us, "The duration achieved is not within half a count of 800 ms");
+
+    uint32_t achieved_mhz = buzzer_timer_solve_frequency(CLOCK_HZ, 440000, &config);
+    uint64_t cycles = (uint64_t)(config.psc + 1U) * (config.arr + 1U);
+    UNITY_TEST_ASSERT_EQUAL_INT((CLOCK_HZ * 1000ULL + cycles / 2U) / cycles, achieved_mhz, __LINE__, "The frequency reported is not the one of the registers");
+    TEST_ASSERT_INT_WITHIN_MESSAGE(10, 440000, achieved_mhz, "The frequency achieved is not close to 440 Hz");
+
+    /* Longer than the timer allows: saturated, and the achieved value tells it */
+    achieved_us = buzzer_timer_solve_duration(CLOCK_HZ, 300000000, &config);
+    UNITY_TEST_ASSERT_EQUAL_INT(BUZZER_TIMER_MAX_COUNT - 1U, config.psc, __LINE__, "The prescaler has not been saturated");
+    UNITY_TEST_ASSERT_EQUAL_INT(BUZZER_TIMER_MAX_COUNT - 1U, config.arr, __LINE__, "ARR has not been saturated");
+    UNITY_TEST_ASSERT(achieved_us < 300000000U, __LINE__, "The saturated duration has not been reported");
+}
+
+/**
+ * @brief Micro-benchmark: cost of the prescaler of long durations, iterative search compared with the solver.
+ *
+ */
+void test_benchmark_solver(void)
+{
+    const uint32_t durations_ms[] = {800, 1600, 2000, 4000};
+    uint32_t num_durations = sizeof(durations_ms) / sizeof(durations_ms[0]);
+    buzzer_timer_config_t config;
+    volatile uint32_t sink = 0;
+
+    uint32_t start = port_system_get_cycles();
+    for (uint32_t r = 0; r < BENCHMARK_ROUNDS; r++)
+    {
+        for (uint32_t i = 0; i < num_durations; i++)
+        {
+            _iterative_duration(CLOCK_HZ, durations_ms[i], &config);
+            sink += config.psc;
+        }
+    }
+    uint32_t iterative_cycles = port_system_get_cycles() - start;
+
+    start = port_system_get_cycles();
+    for (uint32_t r = 0; r < BENCHMARK_ROUNDS; r++)
+    {
+        for (uint32_t i = 0; i < num_durations; i++)
+        {
+            buzzer_timer_solve_duration(CLOCK_HZ, durations_ms[i] * 1000U, &config);
+            sink -= config.psc;
+        }
+    }
+    uint32_t solver_cycles = port_system_get_cycles() - start;
+
+    UNITY_TEST_ASSERT_EQUAL_INT(0, sink, __LINE__, "The solver and the iterative search do not find the same prescalers");
+    printf("Cost per long duration (800 to 4000 ms): iterative search %lu, solver %lu (cycles, ns on host)\n",
+           (unsigned long)(iterative_cycles / (BENCHMARK_ROUNDS * num_durations)),
+           (unsigned long)(solver_cycles / (BENCHMARK_ROUNDS * num_durations)));
+}
+
+/**
+ * @brief Micro-benchmark: cost of the register values of a note change (frequency and duration).
+ *
+ */
+void test_benchmark_note_change(void)
+{
+    buzzer_timer_config_t freq_config, dur_config;
+    volatile uint32_t sink = 0;
+    uint32_t num_notes = 0;
+
+    uint32_t start = port_system_get_cycles();
+    for (uint32_t r = 0; r < BENCHMARK_ROUNDS; r++)
+    {
+        for (uint32_t m = 0; m < sizeof(melodies) / sizeof(melodies[0]); m++)
+        {
+            for (uint32_t i = 0; i < melodies[m]->melody_length; i++)
+            {
+                _iterative_frequency(CLOCK_HZ, _event_frequency(&melodies[m]->p_events[i]), &freq_config);
+                _iterative_duration(CLOCK_HZ, MELODY_EVENT_DURATION_MS(&melodies[m]->p_events[i]), &dur_config);
+                sink += freq_config.arr + dur_config.arr;
+            }
+        }
+    }
+    uint32_t iterative_cycles = port_system_get_cycles() - start;
+
+    start = port_system_get_cycles();
+    for (uint32_t r = 0; r < BENCHMARK_ROUNDS; r++)
+    {
+        for (uint32_t m = 0; m < sizeof(melodies) / sizeof(melodies[0]); m++)
+        {
+            for (uint32_t i = 0; i < melodies[m]->melody_length; i++)
+            {
+                buzzer_timer_get_midi_config(CLOCK_HZ, melodies[m]->p_events[i].note, &freq_config);
+                buzzer_timer_get_duration_config(CLOCK_HZ, MELODY_EVENT_DURATION_MS(&melodies[m]->p_events[i]), &dur_config);
+                sink += freq_config.arr + dur_config.arr;
+                num_notes++;
+            }
+        }
+    }
+    uint32_t table_cycles = port_system_get_cycles() - start;
+
+    start = port_system_get_cycles();
+    for (uint32_t r = 0; r < BENCHMARK_ROUNDS; r++)
+    {
+        for (uint32_t m = 0; m < sizeof(melodies) / sizeof(melodies[0]); m++)
+        {
+            for (uint32_t i = 0; i < melodies[m]->melody_length; i++)
+            {
+                buzzer_timer_solve_frequency(CLOCK_HZ, melody_get_note_mhz(melodies[m]->p_events[i].note), &freq_config);
+                buzzer_timer_compute_duration(CLOCK_HZ, MELODY_EVENT_DURATION_MS(&melodies[m]->p_events[i]), &dur_config);
+                sink += freq_config.arr + dur_config.arr;
+            }
+        }
+    }
+    uint32_t closed_form_cycles = port_system_get_cycles() - start;
+
+    UNITY_TEST_ASSERT(sink > 0, __LINE__, "The benchmark has not computed anything");
+    printf("Cost per note change: iterative search %lu, tables %lu, closed form %lu (cycles, ns on host)\n",
+           (unsigned long)(iterative_cycles / num_notes), (unsigned long)(table_cycles / num_notes),
+           (unsigned long)(closed_form_cycles / num_notes));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_note_table);
+    RUN_TEST(test_fallback);
+    RUN_TEST(test_durations);
+    RUN_TEST(test_carried_durations);
+    RUN_TEST(test_solver);
+    RUN_TEST(test_benchmark_note_change);
+    RUN_TEST(test_benchmark_solver);
+
+    return UNITY_END();
+}
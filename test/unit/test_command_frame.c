@@ -0,0 +1,132 @@
+/**
+ * @file test_command_frame.c
+ * @brief Unit test for the binary frames of the control protocol: CRC, escapes, round trip and corrupted frames.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+/* Other libraries */
+#include "command_frame.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define TEST_FRAME_SIZE 200U /*!< Size of the buffers of the encoded frames */
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Check that an encoded frame can go through the line ring: it starts with the start byte, it ends with the
+ * only '\n' of the frame and it has no '\0'.
+ *
+ * @param p_encoded Encoded frame
+ * @param length Number of bytes of the frame
+ * @return true if the frame is a valid line
+ */
+static bool _is_line(const char *p_encoded, uint32_t length)
+{
+    if ((length < 2U) || !command_frame_is_frame(p_encoded) || (p_encoded[length - 1U] != COMMAND_FRAME_END))
+    {
+        return false;
+    }
+    return (memchr(p_encoded, '\0', length) == NULL) && (memchr(p_encoded, COMMAND_FRAME_END, length - 1U) == NULL);
+}
+
+/**
+ * @brief The CRC is the CRC-16/CCITT-FALSE: 0x29B1 for "123456789".
+ *
+ */
+void test_crc(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0x29B1, command_frame_crc16((const uint8_t *)"123456789", 9), __LINE__, "The CRC of the check string is not correct");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0xFFFF, command_frame_crc16(NULL, 0), __LINE__, "The CRC of nothing must be the initial value");
+}
+
+/**
+ * @brief Every request, with arguments that contain the reserved bytes, is encoded as a valid line and decoded back
+ * with the same opcode and argument.
+ *
+ */
+void test_round_trip(void)
+{
+    const uint32_t args[] = {0, 1, '\n', 0xC0, 0xDB, 0xDC, 0xC00A, 0xDB00, 0xFFFF, 0x0A0AC0DBU};
+    char encoded[TEST_FRAME_SIZE];
+    command_frame_t frame;
+    for (uint32_t width = 0; width <= 4U; width++)
+    {
+        for (uint32_t i = 0; i < sizeof(args) / sizeof(args[0]); i++)
+        {
+            uint32_t mask = (width == 4U) ? 0xFFFFFFFFU : ((1U << (8U * width)) - 1U);
+            uint32_t length = command_frame_encode_request(COMMAND_OP_SPEED, args[i], width, encoded, sizeof(encoded));
+            UNITY_TEST_ASSERT(_is_line(encoded, length), __LINE__, "The encoded frame is not a valid line");
+            UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, command_frame_decode(encoded, length, &frame), __LINE__, "The encoded frame is not decoded");
+            UNITY_TEST_ASSERT_EQUAL_UINT32(COMMAND_OP_SPEED, frame.opcode, __LINE__, "The opcode is not correct");
+            UNITY_TEST_ASSERT_EQUAL_UINT32(width, frame.length, __LINE__, "The width of the argument is not correct");
+            UNITY_TEST_ASSERT_EQUAL_UINT32(args[i] & mask, command_frame_get_le(frame.data, width), __LINE__, "The argument is not correct");
+        }
+    }
+
+    /* A reply with all the byte values, the largest one allowed */
+    command_frame_t reply = {.opcode = COMMAND_OP_INFO | COMMAND_FRAME_REPLY_FLAG, .length = COMMAND_FRAME_MAX_DATA};
+    for (uint32_t i = 0; i < COMMAND_FRAME_MAX_DATA; i++)
+    {
+        reply.data[i] = (uint8_t)(i * 3U);
+    }
+    uint32_t length = command_frame_encode(&reply, encoded, sizeof(encoded));
+    UNITY_TEST_ASSERT(_is_line(encoded, length), __LINE__, "The encoded reply is not a valid line");
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_OK, command_frame_decode(encoded, length - 1U, &frame), __LINE__, "A frame without its end must be decoded");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(reply.opcode, frame.opcode, __LINE__, "The opcode of the reply is not correct");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(reply.length, frame.length, __LINE__, "The length of the reply is not correct");
+    UNITY_TEST_ASSERT(memcmp(reply.data, frame.data, reply.length) == 0, __LINE__, "The data of the reply is not correct");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, command_frame_encode(&reply, encoded, length - 1U), __LINE__, "A frame larger than the buffer must not be encoded");
+}
+
+/**
+ * @brief Every single-bit error of a frame is detected, by its CRC or by its format, and a text line is not a frame.
+ *
+ */
+void test_corrupted(void)
+{
+    char encoded[TEST_FRAME_SIZE];
+    char corrupted[TEST_FRAME_SIZE];
+    command_frame_t frame;
+    uint32_t length = command_frame_encode_request(COMMAND_OP_SELECT, 3, 1, encoded, sizeof(encoded));
+    for (uint32_t i = 0; i < length - 1U; i++)
+    {
+        for (uint32_t bit = 0; bit < 8U; bit++)
+        {
+            memcpy(corrupted, encoded, length);
+            corrupted[i] ^= (char)(1U << bit);
+            UNITY_TEST_ASSERT(command_frame_decode(corrupted, length, &frame) != COMMAND_FRAME_OK, __LINE__, "A corrupted frame has been accepted");
+        }
+    }
+
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_ERROR_FORMAT, command_frame_decode("select 3", 8, &frame), __LINE__, "A text line must not be a frame");
+    const char bad_escape[] = {(char)COMMAND_FRAME_START, 0x06, (char)COMMAND_FRAME_ESC, 0x41, 0x12, 0x34};
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_ERROR_FORMAT, command_frame_decode(bad_escape, sizeof(bad_escape), &frame), __LINE__, "A wrong escape has been accepted");
+    const char short_frame[] = {(char)COMMAND_FRAME_START, 0x06, 0x12};
+    UNITY_TEST_ASSERT_EQUAL_INT(COMMAND_FRAME_ERROR_FORMAT, command_frame_decode(short_frame, sizeof(short_frame), &frame), __LINE__, "A frame without CRC has been accepted");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_crc);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_corrupted);
+
+    return UNITY_END();
+}
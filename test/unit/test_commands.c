@@ -0,0 +1,283 @@
+/**
+ * @file test_commands.c
+ * @brief Unit test for the registry of commands, with a micro-benchmark of the dispatch cost.
+ *
+ * The benchmark compares the lookup in the hash table of the registry with the chain of strcmp() that the jukebox
+ * used before. Costs are measured with port_system_get_cycles() (core cycles on the target, nanoseconds on the host).
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+
+/* Other libraries */
+#include "commands.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define BENCHMARK_ROUNDS 10000 /*!< Number of lookups of each command in the benchmark */
+
+/* Global variables */
+static uint32_t handler_calls; /*!< Number of calls to the handlers of the test */
+
+static const char *names[] = {"play", "stop", "pause", "speed", "next", "select", "lista", "info", "unknown"}; /*!< Commands looked up in the benchmark */
+
+/**
+ * @brief Handler used in the tests.
+ */
+static void _handler(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    handler_calls++;
+}
+
+/**
+ * @brief Second handler used in the tests.
+ */
+static void _other_handler(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    handler_calls += 100;
+}
+
+/**
+ * @brief Validator used in the tests: the argument must be greater than 0.
+ */
+static bool _positive(fsm_t *p_this, const command_arg_t *p_arg)
+{
+    return p_arg->float_value > 0;
+}
+
+static const command_t test_commands[] = {
+    {"play", _handler, COMMAND_ARG_NONE},
+    {"stop", _handler, COMMAND_ARG_NONE},
+    {"pause", _handler, COMMAND_ARG_NONE},
+    {"speed", _handler, COMMAND_ARG_FLOAT, _positive},
+    {"next", _handler, COMMAND_ARG_NONE},
+    {"select", _handler, COMMAND_ARG_INT},
+    {"lista", _handler, COMMAND_ARG_NONE},
+    {"info", _handler, COMMAND_ARG_NONE},
+};
+
+/**
+ * @brief Lookup of a command with the chain of strcmp() that the jukebox used before the registry.
+ *
+ * @param p_command Name of the command
+ * @return int Index of the command, or -1 if not found
+ */
+static int _strcmp_chain(const char *p_command)
+{
+    if (strcmp(p_command, "play") == 0)
+    {
+        return 0;
+    }
+    else if (strcmp(p_command, "stop") == 0)
+    {
+        return 1;
+    }
+    else if (strcmp(p_command, "pause") == 0)
+    {
+        return 2;
+    }
+    else if (strcmp(p_command, "speed") == 0)
+    {
+        return 3;
+    }
+    else if (strcmp(p_command, "next") == 0)
+    {
+        return 4;
+    }
+    else if (strcmp(p_command, "select") == 0)
+    {
+        return 5;
+    }
+    else if (strcmp(p_command, "lista") == 0)
+    {
+        return 6;
+    }
+    else if (strcmp(p_command, "info") == 0)
+    {
+        return 7;
+    }
+    return -1;
+}
+
+void setUp(void)
+{
+    port_system_init();
+    commands_init();
+    commands_register_table(test_commands, sizeof(test_commands) / sizeof(test_commands[0]));
+    handler_calls = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief All the registered commands are found, the others are not.
+ *
+ */
+void test_find(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_INT(8, commands_get_count(), __LINE__, "The commands have not been registered");
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        const command_t *p_cmd = commands_find(names[i], strlen(names[i]));
+        UNITY_TEST_ASSERT(p_cmd != NULL, __LINE__, "A registered command has not been found");
+        UNITY_TEST_ASSERT(strcmp(p_cmd->p_name, names[i]) == 0, __LINE__, "The command found is not the one looked up");
+    }
+    UNITY_TEST_ASSERT(commands_find("unknown", 7) == NULL, __LINE__, "A command not registered has been found");
+    UNITY_TEST_ASSERT(commands_find("pla", 3) == NULL, __LINE__, "A prefix of a command has been found");
+
+    /* The name does not need to be null-terminated */
+    const char *p_line = "select 2";
+    UNITY_TEST_ASSERT(commands_find(p_line, 6) != NULL, __LINE__, "A command inside a line has not been found");
+}
+
+/**
+ * @brief Extra commands can be registered, and registering a name again replaces the command.
+ *
+ */
+void test_register(void)
+{
+    UNITY_TEST_ASSERT(commands_register("volume", _other_handler, COMMAND_ARG_INT), __LINE__, "An extra command has not been registered");
+    const command_t *p_cmd = commands_find("volume", 6);
+    UNITY_TEST_ASSERT(p_cmd != NULL, __LINE__, "The extra command has not been found");
+    p_cmd->handler(NULL, NULL);
+    UNITY_TEST_ASSERT_EQUAL_INT(100, handler_calls, __LINE__, "The handler of the extra command has not been called");
+
+    UNITY_TEST_ASSERT(commands_register("play", _other_handler, COMMAND_ARG_NONE), __LINE__, "A command has not been replaced");
+    UNITY_TEST_ASSERT_EQUAL_INT(9, commands_get_count(), __LINE__, "Replacing a command must not add a new one");
+    UNITY_TEST_ASSERT(commands_find("play", 4)->handler == _other_handler, __LINE__, "The command has not been replaced");
+
+    UNITY_TEST_ASSERT(!commands_register("a_very_long_command_name", _handler, COMMAND_ARG_NONE), __LINE__, "A too long name has been registered");
+
+    static char extra_names[COMMANDS_MAX][4];
+    uint32_t registered = commands_get_count();
+    for (uint32_t i = 0; registered < COMMANDS_MAX; i++, registered++)
+    {
+        sprintf(extra_names[i], "x%u", (unsigned)i);
+        commands_register(extra_names[i], _handler, COMMAND_ARG_NONE);
+    }
+    UNITY_TEST_ASSERT(!commands_register("full", _handler, COMMAND_ARG_NONE), __LINE__, "A command has been registered with the registry full");
+    UNITY_TEST_ASSERT(commands_find("volume", 6) != NULL, __LINE__, "A command has been lost with the registry full");
+}
+
+/**
+ * @brief The argument is checked and converted according to the arg-spec of the command.
+ *
+ */
+void test_parse_arg(void)
+{
+    command_arg_t arg;
+    const command_t *p_speed = commands_find("speed", 5);
+    const command_t *p_select = commands_find("select", 6);
+    const command_t *p_play = commands_find("play", 4);
+    token_t token;
+
+    token = (token_t){"1.5", 3};
+    UNITY_TEST_ASSERT(commands_parse_arg(p_speed, &token, 1, &arg), __LINE__, "A valid decimal argument has been rejected");
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1.5, arg.float_value);
+    token = (token_t){"2", 1};
+    UNITY_TEST_ASSERT(commands_parse_arg(p_speed, &token, 1, &arg), __LINE__, "An integer must be a valid decimal argument");
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 2.0, arg.float_value);
+    token = (token_t){"fast", 4};
+    UNITY_TEST_ASSERT(!commands_parse_arg(p_speed, &token, 1, &arg), __LINE__, "An invalid decimal argument has been accepted");
+    UNITY_TEST_ASSERT(!commands_parse_arg(p_speed, NULL, 0, &arg), __LINE__, "A missing argument has been accepted");
+
+    token = (token_t){"3", 1};
+    UNITY_TEST_ASSERT(commands_parse_arg(p_select, &token, 1, &arg), __LINE__, "A valid integer argument has been rejected");
+    UNITY_TEST_ASSERT_EQUAL_INT(3, arg.int_value, __LINE__, "The integer argument has not been converted");
+    token = (token_t){"-1", 2};
+    UNITY_TEST_ASSERT(!commands_parse_arg(p_select, &token, 1, &arg), __LINE__, "A negative index has been accepted");
+    token = (token_t){"1.5", 3};
+    UNITY_TEST_ASSERT(!commands_parse_arg(p_select, &token, 1, &arg), __LINE__, "A decimal index has been accepted");
+
+    UNITY_TEST_ASSERT(commands_parse_arg(p_play, NULL, 0, &arg), __LINE__, "A command without argument has been rejected");
+}
+
+/**
+ * @brief The validators are kept by the registry and checked with commands_validate(); a command without validator
+ * accepts any argument.
+ *
+ */
+void test_validate(void)
+{
+    command_arg_t arg;
+    const command_t *p_speed = commands_find("speed", 5);
+    token_t token;
+
+    token = (token_t){"1.5", 3};
+    commands_parse_arg(p_speed, &token, 1, &arg);
+    UNITY_TEST_ASSERT(commands_validate(p_speed, NULL, &arg), __LINE__, "A valid argument has not passed the validator");
+    token = (token_t){"0", 1};
+    UNITY_TEST_ASSERT(commands_parse_arg(p_speed, &token, 1, &arg), __LINE__, "The argument must be converted before it is validated");
+    UNITY_TEST_ASSERT(!commands_validate(p_speed, NULL, &arg), __LINE__, "An argument rejected by the validator has been accepted");
+
+    const command_t *p_play = commands_find("play", 4);
+    UNITY_TEST_ASSERT(p_play->validate == NULL, __LINE__, "A command without validator has one");
+    UNITY_TEST_ASSERT(commands_validate(p_play, NULL, &arg), __LINE__, "A command without validator has been rejected");
+    commands_register("speed", _handler, COMMAND_ARG_FLOAT);
+    UNITY_TEST_ASSERT(commands_validate(commands_find("speed", 5), NULL, &arg), __LINE__, "A command registered without validator keeps the old one");
+}
+
+/**
+ * @brief Micro-benchmark: cost of the lookup in the registry compared with the chain of strcmp().
+ *
+ */
+void test_benchmark_dispatch(void)
+{
+    uint32_t num_names = sizeof(names) / sizeof(names[0]);
+    uint32_t lengths[sizeof(names) / sizeof(names[0])];
+    volatile uint32_t found = 0;
+    for (uint32_t i = 0; i < num_names; i++)
+    {
+        lengths[i] = strlen(names[i]);
+    }
+
+    uint32_t start = port_system_get_cycles();
+    for (uint32_t r = 0; r < BENCHMARK_ROUNDS; r++)
+    {
+        for (uint32_t i = 0; i < num_names; i++)
+        {
+            found += (_strcmp_chain(names[i]) >= 0);
+        }
+    }
+    uint32_t chain_cycles = port_system_get_cycles() - start;
+
+    start = port_system_get_cycles();
+    for (uint32_t r = 0; r < BENCHMARK_ROUNDS; r++)
+    {
+        for (uint32_t i = 0; i < num_names; i++)
+        {
+            found += (commands_find(names[i], lengths[i]) != NULL);
+        }
+    }
+    uint32_t table_cycles = port_system_get_cycles() - start;
+
+    UNITY_TEST_ASSERT_EQUAL_INT(2 * 8 * BENCHMARK_ROUNDS, found, __LINE__, "Both lookups must find the same commands");
+    printf("Dispatch cost per lookup: strcmp chain %lu, registry %lu (cycles, ns on host)\n",
+           (unsigned long)(chain_cycles / (BENCHMARK_ROUNDS * num_names)),
+           (unsigned long)(table_cycles / (BENCHMARK_ROUNDS * num_names)));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_find);
+    RUN_TEST(test_register);
+    RUN_TEST(test_parse_arg);
+    RUN_TEST(test_validate);
+    RUN_TEST(test_benchmark_dispatch);
+
+    return UNITY_END();
+}
@@ -62,8 +62,8 @@ void test_initial_config(void)
 
     UNITY_TEST_ASSERT_EQUAL_INT(WAIT_START, fsm_get_state(p_fsm), __LINE__, "The initial state of the FSM is not WAIT_START");
 
-    // It assumes there are 8 transitions in the table plus the null transition
-    fsm_trans_t *last_transition = &p_inner_fsm->p_tt[8];
+    // It assumes there are 10 transitions in the table plus the null transition
+    fsm_trans_t *last_transition = &p_inner_fsm->p_tt[10];
 
     UNITY_TEST_ASSERT_EQUAL_INT(-1, last_transition->orig_state, __LINE__, "The origin state of the last transition of the FSM should be -1");
     UNITY_TEST_ASSERT_EQUAL_INT(NULL, last_transition->in, __LINE__, "The input condition function of the last transition of the FSM should be NULL");
@@ -91,7 +91,7 @@ void test_note_duration_interr(void)
     ((fsm_buzzer_t *)p_fsm)->user_action = PLAY;
 
     // Timeout a little bit more than the duration of the first note
-    uint16_t timeout_ms = ((fsm_buzzer_t *)p_fsm)->p_melody->p_durations[0] + 50;
+    uint16_t timeout_ms = MELODY_EVENT_DURATION_MS(&((fsm_buzzer_t *)p_fsm)->p_melody->p_events[0]) + 50;
 
     // Get the current time
     uint32_t start_tick = port_system_get_millis();
@@ -152,8 +152,8 @@ void test_buzzer_start()
     UNITY_TEST_ASSERT_EQUAL_INT(1, ((fsm_buzzer_t *)p_fsm)->note_index, __LINE__, "The note_index is not 1 after the first transition");
 
     // Ensure that the note has been set correctly (frequency and duration)
-    double freq = scale_melody.p_notes[0];
-    uint16_t dur = scale_melody.p_durations[0];
+    double freq = melody_get_note_mhz(scale_melody.p_events[0].note) / 1000.0;
+    uint16_t dur = MELODY_EVENT_DURATION_MS(&scale_melody.p_events[0]);
 
     // Compute frequency from user ARR and PSC values
     uint32_t arr = BUZZER_TIM_PWM->ARR;
@@ -205,6 +205,42 @@ void test_note_end()
     UNITY_TEST_ASSERT_EQUAL_INT(0, BUZZER_TIM_PWM->CR1 & TIM_CR1_CEN, __LINE__, "The PWM timer is not disabled after the note has ended");
 }
 
+/**
+ * @brief Test that the next note is queued while the current one is playing.
+ *
+ */
+void test_queue_note()
+{
+    printf("Testing transition WAIT_NOTE --> WAIT_NOTE...\n");
+    // Set state to WAIT_NOTE
+    fsm_set_state(p_fsm, WAIT_NOTE);
+
+    // Set a melody and the index to the second note.
+    ((fsm_buzzer_t *)p_fsm)->p_melody = (melody_t *)(&scale_melody);
+    ((fsm_buzzer_t *)p_fsm)->note_index = 1;
+    ((fsm_buzzer_t *)p_fsm)->user_action = PLAY;
+    buzzers_arr[BUZZER_0_ID].note_end = false;
+
+    // Fire the FSM: the buzzer is idle, so the note starts playing
+    fsm_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(PORT_BUZZER_NOTE_QUEUE_LENGTH, port_buzzer_get_queue_free(BUZZER_0_ID), __LINE__, "The note should have started playing instead of waiting in the queue");
+
+    // Fire the FSM again: the next note waits in the queue
+    fsm_fire(p_fsm);
+
+    // Ensure that the state has not changed but the note has been queued
+    UNITY_TEST_ASSERT_EQUAL_INT(WAIT_NOTE, fsm_get_state(p_fsm), __LINE__, "The FSM should stay in WAIT_NOTE while it queues the next note");
+    UNITY_TEST_ASSERT_EQUAL_INT(3, ((fsm_buzzer_t *)p_fsm)->note_index, __LINE__, "The note_index has not been increased after queueing the next note");
+    UNITY_TEST_ASSERT_EQUAL_INT(PORT_BUZZER_NOTE_QUEUE_LENGTH, port_buzzer_get_queue_free(BUZZER_0_ID) + 1, __LINE__, "The note has not been added to the queue of the buzzer");
+
+    // STOP must not wait for the queued notes
+    ((fsm_buzzer_t *)p_fsm)->user_action = STOP;
+    fsm_fire(p_fsm);
+    UNITY_TEST_ASSERT_EQUAL_INT(WAIT_START, fsm_get_state(p_fsm), __LINE__, "The FSM should have changed the state to WAIT_START when user_action is STOP in WAIT_NOTE");
+    UNITY_TEST_ASSERT_EQUAL_INT(PORT_BUZZER_NOTE_QUEUE_LENGTH, port_buzzer_get_queue_free(BUZZER_0_ID), __LINE__, "The queue of the buzzer has not been emptied after the stop");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, BUZZER_TIM_DUR->CR1 & TIM_CR1_CEN, __LINE__, "The note duration timer is not disabled after the melody has been stopped");
+}
+
 /**
  * @brief Test the pause of the melody.
  *
@@ -292,8 +328,8 @@ void test_play_note(void)
     UNITY_TEST_ASSERT_EQUAL_INT(2, ((fsm_buzzer_t *)p_fsm)->note_index, __LINE__, "The note_index has not been increased after the transition to WAIT_NOTE");
 
     // Ensure that the note has been set correctly (frequency and duration)
-    double freq = scale_melody.p_notes[1];
-    uint16_t dur = scale_melody.p_durations[1];
+    double freq = melody_get_note_mhz(scale_melody.p_events[1].note) / 1000.0;
+    uint16_t dur = MELODY_EVENT_DURATION_MS(&scale_melody.p_events[1]);
 
     // Compute frequency from user ARR and PSC values
     uint32_t arr = BUZZER_TIM_PWM->ARR;
@@ -416,7 +452,7 @@ void test_auxiliary_functions(void)
 
     // Test the function to set the speed
     fsm_buzzer_set_speed(p_fsm, 2);
-    UNITY_TEST_ASSERT_EQUAL_INT(2, (uint32_t)(((fsm_buzzer_t *)p_fsm)->player_speed), __LINE__, "The speed has not been set correctly in the function fsm_buzzer_set_speed()");
+    UNITY_TEST_ASSERT_EQUAL_INT(2 * FSM_BUZZER_SPEED_ONE, ((fsm_buzzer_t *)p_fsm)->player_speed, __LINE__, "The speed has not been set correctly in the function fsm_buzzer_set_speed()");
 }
 
 /**
@@ -438,6 +474,7 @@ int main(void)
     RUN_TEST(test_buzzer_start);
     RUN_TEST(test_note_duration_interr);
     RUN_TEST(test_note_end);
+    RUN_TEST(test_queue_note);
     RUN_TEST(test_play_note);
     RUN_TEST(test_pause_melody);
     RUN_TEST(test_stop_melody);
@@ -69,11 +69,13 @@ void test_usart_rx()
 {
     char char_array_test[] = "TEST RX";
 
-    // Copy the data to the USART buffer
-    memcpy(usart_arr[USART_0_ID].input_buffer, char_array_test, sizeof(char_array_test));
-
-    // Force read_complete
-    usart_arr[USART_0_ID].read_complete = true;
+    // Store the line in the RX ring of the USART as the ISR does
+    for (uint32_t i = 0; i < strlen(char_array_test); i++)
+    {
+        line_ring_put(&usart_arr[USART_0_ID].rx_ring, char_array_test[i]);
+    }
+    line_ring_put(&usart_arr[USART_0_ID].rx_ring, END_CHAR_CONSTANT);
+    UNITY_TEST_ASSERT_EQUAL_INT(1, port_usart_get_lines_pending(USART_0_ID), __LINE__, "The line has not been completed in the RX ring");
 
     // First transition
     fsm_fire(p_fsm);
@@ -82,13 +84,9 @@ void test_usart_rx()
     // Check that the data has been stored correctly from the USART buffer to the in_data buffer of the FSM
     UNITY_TEST_ASSERT_EQUAL_MEMORY(char_array_test, ((fsm_usart_t *)p_fsm)->in_data, sizeof(char_array_test), __LINE__, "The data has not been stored correctly in the in_data buffer of the USART FSM");
 
-    // Check that the USART buffer has been cleared correctly
-    char expected_buffer[sizeof(char_array_test)];
-    memset(expected_buffer, EMPTY_BUFFER_CONSTANT, sizeof(expected_buffer));
-    UNITY_TEST_ASSERT_EQUAL_MEMORY(expected_buffer, usart_arr[USART_0_ID].input_buffer, sizeof(expected_buffer), __LINE__, "The data has not been cleared correctly from the input buffer of the USART");
-
-    // Check that the read_complete flag has been cleared correctly
-    UNITY_TEST_ASSERT_EQUAL_INT(false, usart_arr[USART_0_ID].read_complete, __LINE__, "The read_complete flag has not been cleared correctly");
+    // Check that the line has been taken from the RX ring
+    UNITY_TEST_ASSERT_EQUAL_INT(0, port_usart_get_lines_pending(USART_0_ID), __LINE__, "The line has not been taken from the RX ring of the USART");
+    UNITY_TEST_ASSERT_EQUAL_INT(false, port_usart_rx_done(USART_0_ID), __LINE__, "The USART still reports data received");
 
     // Check that data_received flag has been set correctly
     UNITY_TEST_ASSERT_EQUAL_INT(true, ((fsm_usart_t *)p_fsm)->data_received, __LINE__, "The data_received flag has not been set correctly");
@@ -105,19 +103,20 @@ void test_usart_tx()
     // Copy the data to the out_data buffer of the FSM
     memcpy(((fsm_usart_t *)p_fsm)->out_data, char_array_test, sizeof(char_array_test));
 
-    // Second transition (first char transmitted)
+    // Second transition (DMA transfer started)
     fsm_fire(p_fsm);
     UNITY_TEST_ASSERT_EQUAL_INT(SEND_DATA, fsm_get_state(p_fsm), __LINE__, "The FSM did not change to SEND_DATA after sending a data to the usart");
 
-    // Check that the data has been stored correctly from the out_data buffer of the FSM to the USART buffer
-    UNITY_TEST_ASSERT_EQUAL_MEMORY(((fsm_usart_t *)p_fsm)->out_data, usart_arr[USART_0_ID].output_buffer, sizeof(char_array_test), __LINE__, "The data has not been stored correctly in the output buffer of the USART");
+    // Check that the DMA stream reads directly from the out_data buffer of the FSM, up to the end char
+    UNITY_TEST_ASSERT_EQUAL_INT((uint32_t)((fsm_usart_t *)p_fsm)->out_data, usart_arr[USART_0_ID].p_dma_stream->M0AR, __LINE__, "The DMA stream does not read from the out_data buffer of the FSM");
+    UNITY_TEST_ASSERT_EQUAL_INT(strlen(char_array_test), usart_arr[USART_0_ID].p_dma_stream->NDTR, __LINE__, "The number of bytes of the DMA transfer is not correct");
 
-    printf("Assuming that all the chars have been sent correctly from the output buffer of the USART to the data register...\n");
+    printf("Assuming that all the chars have been sent correctly by the DMA to the data register...\n");
 
-    // Check that the TXEIE bit has been enabled correctly --> The 2nd++ chars are sent by the ISR
-    UNITY_TEST_ASSERT_EQUAL_INT(USART_CR1_TXEIE, usart_arr[USART_0_ID].p_usart->CR1 & USART_CR1_TXEIE, __LINE__, "The TXEIE bit has not been enabled correctly after sending the first and following chars");
+    // Check that the DMAT bit has been enabled correctly --> The chars are sent by the DMA
+    UNITY_TEST_ASSERT_EQUAL_INT(USART_CR3_DMAT, usart_arr[USART_0_ID].p_usart->CR3 & USART_CR3_DMAT, __LINE__, "The DMAT bit has not been enabled correctly");
     
-    // Wait for the last char to be sent, leaving the ISR to send the rest of the chars.
+    // Wait for the transfer complete interrupt of the DMA stream.
     while ((!usart_arr[USART_0_ID].write_complete))
     {        
     }
@@ -130,8 +129,9 @@ void test_usart_tx()
     fsm_fire(p_fsm);
     UNITY_TEST_ASSERT_EQUAL_INT(WAIT_DATA, fsm_get_state(p_fsm), __LINE__, "The FSM did not change to WAIT_DATA after sending the last char to the usart");
 
-    // Check that the interrupt has been disabled correctly
-    UNITY_TEST_ASSERT_EQUAL_INT(0, usart_arr[USART_0_ID].p_usart->CR1 & USART_CR1_TXEIE, __LINE__, "The TXEIE bit has not been disabled correctly after sending the last char");
+    // Check that the DMA requests have been disabled correctly
+    UNITY_TEST_ASSERT_EQUAL_INT(0, usart_arr[USART_0_ID].p_usart->CR3 & USART_CR3_DMAT, __LINE__, "The DMAT bit has not been disabled correctly after the transfer");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, usart_arr[USART_0_ID].p_dma_stream->CR & DMA_SxCR_EN, __LINE__, "The DMA stream has not been disabled correctly after the transfer");
 
     // Check that the usart output buffer has been cleared correctly
     char expected_buffer[USART_OUTPUT_BUFFER_LENGTH];
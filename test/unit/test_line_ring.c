@@ -0,0 +1,189 @@
+/**
+ * @file test_line_ring.c
+ * @brief Unit test for the ring buffer of lines used by the RX of the USART.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+/* Other libraries */
+#include "line_ring.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define MAX_LINE_LENGTH 15 /*!< Maximum length of a line in the tests */
+
+/* Global variables */
+static line_ring_t ring;
+
+/**
+ * @brief Add a string to the ring as the ISR would do, byte by byte.
+ *
+ * @param p_data String
+ */
+static void _put_string(const char *p_data)
+{
+    while (*p_data)
+    {
+        line_ring_put(&ring, *p_data++);
+    }
+}
+
+void setUp(void)
+{
+    line_ring_init(&ring, MAX_LINE_LENGTH);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Lines are only visible when complete, and are taken in order.
+ *
+ */
+void test_lines_in_order(void)
+{
+    char line[MAX_LINE_LENGTH + 1];
+
+    _put_string("play");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, line_ring_lines_pending(&ring), __LINE__, "An incomplete line must not be pending");
+    UNITY_TEST_ASSERT_EQUAL_INT(-1, line_ring_get_line(&ring, line, sizeof(line)), __LINE__, "An incomplete line has been taken");
+
+    _put_string("\nselect 2\n\nnext\n");
+    UNITY_TEST_ASSERT_EQUAL_INT(3, line_ring_lines_pending(&ring), __LINE__, "The number of lines pending is not correct (empty lines are ignored)");
+
+    UNITY_TEST_ASSERT_EQUAL_INT(4, line_ring_get_line(&ring, line, sizeof(line)), __LINE__, "The length of the line is not correct");
+    UNITY_TEST_ASSERT_EQUAL_STRING("play", line, __LINE__, "The first line is not correct");
+    UNITY_TEST_ASSERT_EQUAL_INT(8, line_ring_get_line(&ring, line, sizeof(line)), __LINE__, "The length of the line is not correct");
+    UNITY_TEST_ASSERT_EQUAL_STRING("select 2", line, __LINE__, "The second line is not correct");
+    UNITY_TEST_ASSERT_EQUAL_INT(4, line_ring_get_line(&ring, line, sizeof(line)), __LINE__, "The length of the line is not correct");
+    UNITY_TEST_ASSERT_EQUAL_STRING("next", line, __LINE__, "The third line is not correct");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, line_ring_lines_pending(&ring), __LINE__, "There must be no lines pending");
+}
+
+/**
+ * @brief The line being received can be discarded up to its end without counting an overrun (garbage received while
+ * the baud rate is being detected).
+ *
+ */
+void test_discard_line(void)
+{
+    char line[MAX_LINE_LENGTH + 1];
+
+    _put_string("info\n\x55\xF0");
+    line_ring_discard_line(&ring);
+    _put_string("\x7Fx\nplay\n");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, line_ring_lines_pending(&ring), __LINE__, "The discarded line must not be pending");
+    line_ring_get_line(&ring, line, sizeof(line));
+    UNITY_TEST_ASSERT_EQUAL_STRING("info", line, __LINE__, "A complete line has been discarded");
+    line_ring_get_line(&ring, line, sizeof(line));
+    UNITY_TEST_ASSERT_EQUAL_STRING("play", line, __LINE__, "The line after the discarded one is not correct");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, line_ring_get_overruns(&ring), __LINE__, "A discarded line is not an overrun");
+}
+
+/**
+ * @brief Lines longer than the maximum are discarded whole and counted, and the next lines are not affected.
+ *
+ */
+void test_long_line_overrun(void)
+{
+    char line[MAX_LINE_LENGTH + 1];
+
+    _put_string("this line is far too long for the buffer\ninfo\n");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, line_ring_get_overruns(&ring), __LINE__, "The long line has not been counted as an overrun");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, line_ring_lines_pending(&ring), __LINE__, "Only the valid line must be pending");
+    line_ring_get_line(&ring, line, sizeof(line));
+    UNITY_TEST_ASSERT_EQUAL_STRING("info", line, __LINE__, "The line after the overrun is not correct");
+}
+
+/**
+ * @brief When the ring is full the incoming line is discarded whole, and the ring recovers once the lines are taken.
+ *
+ */
+void test_full_ring_overrun(void)
+{
+    char line[MAX_LINE_LENGTH + 1];
+    uint32_t lines = 0;
+
+    /* Each line takes 11 bytes in the ring ("command NN" plus its '\0') */
+    while (line_ring_get_overruns(&ring) == 0)
+    {
+        char command[16];
+        sprintf(command, "command %02u\n", (unsigned)(lines % 100));
+        _put_string(command);
+        lines++;
+    }
+    UNITY_TEST_ASSERT_EQUAL_INT(LINE_RING_LENGTH / 11, line_ring_lines_pending(&ring), __LINE__, "The ring has not been filled with complete lines");
+    UNITY_TEST_ASSERT_EQUAL_INT(lines - 1, line_ring_lines_pending(&ring), __LINE__, "Only the line that did not fit must be lost");
+
+    line_ring_get_line(&ring, line, sizeof(line));
+    UNITY_TEST_ASSERT_EQUAL_STRING("command 00", line, __LINE__, "The oldest line is not correct");
+    _put_string("stop\n");
+    line_ring_flush(&ring);
+    UNITY_TEST_ASSERT_EQUAL_INT(0, line_ring_lines_pending(&ring), __LINE__, "The ring has not been flushed");
+    _put_string("play\n");
+    line_ring_get_line(&ring, line, sizeof(line));
+    UNITY_TEST_ASSERT_EQUAL_STRING("play", line, __LINE__, "The ring does not work after being full");
+}
+
+/**
+ * @brief A burst of lines interleaved with the consumer: no line is lost while the consumer keeps up on average.
+ *
+ */
+void test_burst_no_loss(void)
+{
+    char line[MAX_LINE_LENGTH + 1];
+    char expected[16];
+    uint32_t produced = 0;
+    uint32_t consumed = 0;
+
+    /* The producer adds 4 lines for each 3 lines taken by the consumer, until 300 lines */
+    while (produced < 300)
+    {
+        for (uint32_t i = 0; (i < 4) && (produced < 300); i++)
+        {
+            sprintf(expected, "speed %u\n", (unsigned)produced++);
+            _put_string(expected);
+        }
+        for (uint32_t i = 0; (i < 3) && (line_ring_get_line(&ring, line, sizeof(line)) >= 0); i++)
+        {
+            sprintf(expected, "speed %u", (unsigned)consumed++);
+            UNITY_TEST_ASSERT_EQUAL_STRING(expected, line, __LINE__, "A line has been lost or corrupted");
+        }
+        if (line_ring_lines_pending(&ring) > 15)
+        {
+            /* Let the consumer catch up, as the main loop does after the burst */
+            while (line_ring_get_line(&ring, line, sizeof(line)) >= 0)
+            {
+                sprintf(expected, "speed %u", (unsigned)consumed++);
+                UNITY_TEST_ASSERT_EQUAL_STRING(expected, line, __LINE__, "A line has been lost or corrupted");
+            }
+        }
+    }
+    while (line_ring_get_line(&ring, line, sizeof(line)) >= 0)
+    {
+        consumed++;
+    }
+    UNITY_TEST_ASSERT_EQUAL_INT(300, consumed, __LINE__, "Lines have been lost");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, line_ring_get_overruns(&ring), __LINE__, "There must be no overruns");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_lines_in_order);
+    RUN_TEST(test_discard_line);
+    RUN_TEST(test_long_line_overrun);
+    RUN_TEST(test_full_ring_overrun);
+    RUN_TEST(test_burst_no_loss);
+
+    return UNITY_END();
+}
@@ -0,0 +1,224 @@
+/**
+ * @file test_log_ring.c
+ * @brief Unit test for the deferred log: records, expansion of the format strings, dropped records, decoding of a
+ * binary dump and cost of a log call.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+
+/* Other libraries */
+#include "log_ring.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define TEST_DUMP_PATH "log_dump.bin" /*!< Binary dump written by the test */
+#define TEST_BENCHMARK_CALLS 10000U   /*!< Log calls of the benchmark */
+
+/* Global variables */
+static char text[128];
+
+void setUp(void)
+{
+    port_system_init();
+    log_ring_init();
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Take the oldest record and expand its text.
+ *
+ * @return bool true if there was a record
+ */
+static bool _next_text(void)
+{
+    uint32_t words[LOG_RING_MAX_RECORD_WORDS];
+    log_record_t record;
+    int32_t num_words = log_ring_read(words, LOG_RING_MAX_RECORD_WORDS);
+    if ((num_words < 0) || (log_ring_parse(words, (uint32_t)num_words, &record) != (uint32_t)num_words))
+    {
+        return false;
+    }
+    log_ring_format(&record, text, sizeof(text));
+    return true;
+}
+
+/**
+ * @brief The records are expanded in order with the same text as printf would write.
+ *
+ */
+void test_format(void)
+{
+    log_ring_write(LOG_JUKEBOX_ON, NULL, 0);
+    log_ring_write(LOG_PLAYING, "happy_birthday", 0);
+    log_ring_write(LOG_LIST_ITEM, "tetris", 1, (uint32_t)-3);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, log_ring_pending(), __LINE__, "The records are not pending");
+
+    UNITY_TEST_ASSERT(_next_text(), __LINE__, "The first record cannot be read");
+    UNITY_TEST_ASSERT_EQUAL_STRING("Jukebox ON\n", text, __LINE__, "The record without arguments is not correct");
+    UNITY_TEST_ASSERT(_next_text(), __LINE__, "The second record cannot be read");
+    UNITY_TEST_ASSERT_EQUAL_STRING("Reproduciendo: happy_birthday\n", text, __LINE__, "The string argument is not correct");
+    UNITY_TEST_ASSERT(_next_text(), __LINE__, "The third record cannot be read");
+    UNITY_TEST_ASSERT_EQUAL_STRING("-3. tetris\n", text, __LINE__, "The integer argument is not correct");
+    UNITY_TEST_ASSERT(!_next_text(), __LINE__, "There must be no more records");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, log_ring_pending(), __LINE__, "No record must be pending");
+}
+
+/**
+ * @brief A long string is cut to the maximum length, and a small buffer always ends the text.
+ *
+ */
+void test_long_string(void)
+{
+    log_ring_write(LOG_SYNTH, "a_very_long_melody_name_that_does_not_fit", 0);
+    UNITY_TEST_ASSERT(_next_text(), __LINE__, "The record cannot be read");
+    UNITY_TEST_ASSERT_EQUAL_STRING("Sintetizando: a_very_long_melody_name\n", text, __LINE__, "The string is not cut to its maximum length");
+
+    log_record_t record = {.id = LOG_PLAYING, .num_args = 0, .text = "tetris"};
+    char small[8];
+    UNITY_TEST_ASSERT_EQUAL_UINT32(7, log_ring_format(&record, small, sizeof(small)), __LINE__, "The text must be cut to the buffer");
+    UNITY_TEST_ASSERT_EQUAL_STRING("Reprodu", small, __LINE__, "The cut text is not correct");
+}
+
+/**
+ * @brief When the ring is full, whole records are dropped and counted, and the records already written are kept.
+ *
+ */
+void test_dropped(void)
+{
+    uint32_t calls = 0;
+    log_ring_stats_t stats;
+    do
+    {
+        log_ring_write(LOG_LIST_ITEM, "scale", 1, calls++);
+        log_ring_get_stats(&stats);
+    } while (stats.dropped == 0);
+
+    /* Each record has the header, one argument and the string in 2 words */
+    uint32_t fit = LOG_RING_LENGTH / (LOG_RING_HEADER_WORDS + 1U + 2U);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(fit, stats.records, __LINE__, "The ring does not hold the expected records");
+    log_ring_write(LOG_JUKEBOX_OFF, NULL, 0);
+    log_ring_get_stats(&stats);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, stats.dropped, __LINE__, "The drops are not counted");
+
+    for (uint32_t i = 0; i < fit; i++)
+    {
+        char expected[32];
+        sprintf(expected, "%lu. scale\n", (unsigned long)i);
+        UNITY_TEST_ASSERT(_next_text(), __LINE__, "A record written has been lost");
+        UNITY_TEST_ASSERT_EQUAL_STRING(expected, text, __LINE__, "A record has been corrupted by the drops");
+    }
+    UNITY_TEST_ASSERT(!_next_text(), __LINE__, "A dropped record has been read");
+
+    /* With room again, the ring keeps working across the wrap of its indexes */
+    log_ring_write(LOG_JUKEBOX_OFF, NULL, 0);
+    UNITY_TEST_ASSERT(_next_text(), __LINE__, "The ring does not accept records after emptying it");
+    UNITY_TEST_ASSERT_EQUAL_STRING("Jukebox OFF\n", text, __LINE__, "The record after the wrap is not correct");
+}
+
+/**
+ * @brief The records sent in binary are decoded on the host from a dump file, also after some bytes that are not
+ * records (a capture started in the middle of a record).
+ *
+ */
+void test_binary_dump(void)
+{
+    log_ring_write(LOG_JUKEBOX_ON, NULL, 0);
+    log_ring_write(LOG_LIST_HEADER, NULL, 0);
+    log_ring_write(LOG_LIST_ITEM, "himno_madrid", 1, 3U);
+
+    FILE *p_file = fopen(TEST_DUMP_PATH, "wb");
+    UNITY_TEST_ASSERT(p_file != NULL, __LINE__, "The dump file cannot be created");
+    uint32_t words[LOG_RING_MAX_RECORD_WORDS];
+    const uint32_t garbage[] = {0x12345678U, 0x0000FF00U};
+    fwrite(garbage, sizeof(uint32_t), 2, p_file);
+    int32_t num_words;
+    while ((num_words = log_ring_read(words, LOG_RING_MAX_RECORD_WORDS)) > 0)
+    {
+        fwrite(words, sizeof(uint32_t), (size_t)num_words, p_file);
+    }
+    fclose(p_file);
+
+    /* Decoder of the host: the whole dump is read and decoded record by record */
+    uint32_t dump[64];
+    p_file = fopen(TEST_DUMP_PATH, "rb");
+    UNITY_TEST_ASSERT(p_file != NULL, __LINE__, "The dump file cannot be read");
+    uint32_t dump_words = (uint32_t)fread(dump, sizeof(uint32_t), 64, p_file);
+    fclose(p_file);
+
+    char decoded[256] = "";
+    uint32_t i = 0;
+    uint32_t num_records = 0;
+    while (i < dump_words)
+    {
+        log_record_t record;
+        uint32_t used = log_ring_parse(&dump[i], dump_words - i, &record);
+        if (used == 0)
+        {
+            i++;
+            continue;
+        }
+        log_ring_format(&record, text, sizeof(text));
+        strcat(decoded, text);
+        num_records++;
+        i += used;
+    }
+    printf("%s", decoded);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, num_records, __LINE__, "Not all the records have been decoded");
+    UNITY_TEST_ASSERT_EQUAL_STRING("Jukebox ON\nLista de melodías: \n3. himno_madrid\n", decoded, __LINE__, "The decoded dump is not correct");
+}
+
+/**
+ * @brief Cost of a log call on the host, compared with formatting the same text with snprintf.
+ *
+ */
+void test_benchmark(void)
+{
+    log_ring_stats_t stats;
+    char buffer[64];
+    uint32_t start = port_system_get_cycles();
+    for (uint32_t i = 0; i < TEST_BENCHMARK_CALLS; i++)
+    {
+        snprintf(buffer, sizeof(buffer), "%d. %s\n", (int)i, "windows_shutdown");
+    }
+    uint32_t snprintf_cycles = port_system_get_cycles() - start;
+
+    uint32_t words[LOG_RING_MAX_RECORD_WORDS];
+    for (uint32_t i = 0; i < TEST_BENCHMARK_CALLS; i++)
+    {
+        log_ring_write(LOG_LIST_ITEM, "windows_shutdown", 1, i);
+        log_ring_read(words, LOG_RING_MAX_RECORD_WORDS); /* The consumer keeps up: no call is a drop */
+    }
+    log_ring_get_stats(&stats);
+    double per_call = (double)stats.total_cycles / TEST_BENCHMARK_CALLS;
+    printf("Benchmark: %.1f cycles/log call (max %lu), %.1f cycles/snprintf, %lu records, %lu dropped\n", per_call,
+           (unsigned long)stats.max_cycles, (double)snprintf_cycles / TEST_BENCHMARK_CALLS, (unsigned long)stats.records,
+           (unsigned long)stats.dropped);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_BENCHMARK_CALLS, stats.records, __LINE__, "Not all the calls have been written");
+    UNITY_TEST_ASSERT(per_call < 10000.0, __LINE__, "A log call takes too long");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_format);
+    RUN_TEST(test_long_string);
+    RUN_TEST(test_dropped);
+    RUN_TEST(test_binary_dump);
+    RUN_TEST(test_benchmark);
+
+    return UNITY_END();
+}
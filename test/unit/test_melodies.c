@@ -0,0 +1,108 @@
+/**
+ * @file test_melodies.c
+ * @brief Unit test for the packed format of the melodies: MIDI note number and duration code.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* Other libraries */
+#include "melodies.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define OLD_BYTES_PER_NOTE (sizeof(double) + sizeof(uint16_t)) /*!< Flash per note of the double arrays */
+
+/* Global variables */
+static const melody_t *melodies[] = {&happy_birthday_melody, &tetris_melody, &scale_melody, &himno_madrid_melody, &windows_shutdown_melody}; /*!< Melodies of the jukebox */
+
+/**
+ * @brief Frequencies of the notes in Hz, as the double arrays stored them, from DO3 to SI5.
+ */
+static const double note_frequencies[] = {
+    DO3, DOs3, RE3, REs3, MI3, FA3, FAs3, SOL3, SOLs3, LA3, LAs3, SI3,
+    DO4, DOs4, RE4, REs4, MI4, FA4, FAs4, SOL4, SOLs4, LA4, LAs4, SI4,
+    DO5, DOs5, RE5, REs5, MI5, FA5, FAs5, SOL5, SOLs5, LA5, LAs5, SI5};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief The frequency of every MIDI note is the one of the old double constants, to the millihertz.
+ *
+ */
+void test_note_frequencies(void)
+{
+    for (uint32_t i = 0; i < sizeof(note_frequencies) / sizeof(note_frequencies[0]); i++)
+    {
+        uint32_t expected = (uint32_t)(note_frequencies[i] * 1000.0 + 0.5);
+        UNITY_TEST_ASSERT_EQUAL_INT(expected, melody_get_note_mhz(MIDI_DO3 + i), __LINE__, "The frequency of a MIDI note is not the one of the note constant");
+        UNITY_TEST_ASSERT_EQUAL_INT(expected, MELODY_NOTE_MHZ(MIDI_DO3 + i), __LINE__, "The constant expression does not match melody_get_note_mhz()");
+    }
+    UNITY_TEST_ASSERT_EQUAL_INT(440000, melody_get_note_mhz(MIDI_LA4), __LINE__, "LA4 is not 440 Hz");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, melody_get_note_mhz(MIDI_SILENCE), __LINE__, "A silence has a frequency");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, melody_get_note_mhz(MIDI_MAX_NOTE + 1), __LINE__, "A note out of range has a frequency");
+    UNITY_TEST_ASSERT(melody_get_note_mhz(1) > 0, __LINE__, "The lowest MIDI note has no frequency");
+    UNITY_TEST_ASSERT(melody_get_note_mhz(MIDI_MAX_NOTE) > melody_get_note_mhz(MIDI_MAX_NOTE - 1), __LINE__, "The highest MIDI notes are not in ascending order");
+}
+
+/**
+ * @brief The events take 2 bytes and their durations are decoded in milliseconds.
+ *
+ */
+void test_events(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_INT(2, sizeof(melody_event_t), __LINE__, "An event does not take 2 bytes");
+
+    const melody_event_t event = MELODY_EVENT(LA4, 1000);
+    UNITY_TEST_ASSERT_EQUAL_INT(MIDI_LA4, event.note, __LINE__, "The note of the event is not the MIDI note");
+    UNITY_TEST_ASSERT_EQUAL_INT(1000, MELODY_EVENT_DURATION_MS(&event), __LINE__, "The duration of the event is not decoded");
+
+    const melody_event_t longest = MELODY_EVENT(SILENCE, MELODY_MAX_DURATION_MS);
+    UNITY_TEST_ASSERT_EQUAL_INT(MIDI_SILENCE, longest.note, __LINE__, "The silence is not MIDI_SILENCE");
+    UNITY_TEST_ASSERT_EQUAL_INT(MELODY_MAX_DURATION_MS, MELODY_EVENT_DURATION_MS(&longest), __LINE__, "The longest duration is not decoded");
+}
+
+/**
+ * @brief Every event of the melodies is a valid note with a duration, and the flash used is reported.
+ *
+ */
+void test_melodies_footprint(void)
+{
+    uint32_t num_notes = 0;
+    for (uint32_t m = 0; m < sizeof(melodies) / sizeof(melodies[0]); m++)
+    {
+        for (uint32_t i = 0; i < melodies[m]->melody_length; i++)
+        {
+            const melody_event_t *p_event = &melodies[m]->p_events[i];
+            UNITY_TEST_ASSERT((p_event->note == MIDI_SILENCE) || ((p_event->note >= MIDI_DO3) && (p_event->note <= MIDI_SI5)), __LINE__, "A note of a melody is out of the range of the jukebox");
+            UNITY_TEST_ASSERT(MELODY_EVENT_DURATION_MS(p_event) <= MELODY_MAX_DURATION_MS, __LINE__, "A duration of a melody is too long");
+        }
+        num_notes += melodies[m]->melody_length;
+    }
+
+    printf("Flash of the notes of %lu melodies (%lu notes): double arrays %lu bytes, packed events %lu bytes\n",
+           (unsigned long)(sizeof(melodies) / sizeof(melodies[0])), (unsigned long)num_notes,
+           (unsigned long)(num_notes * OLD_BYTES_PER_NOTE), (unsigned long)(num_notes * sizeof(melody_event_t)));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_note_frequencies);
+    RUN_TEST(test_events);
+    RUN_TEST(test_melodies_footprint);
+
+    return UNITY_END();
+}
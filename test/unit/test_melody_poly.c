@@ -0,0 +1,117 @@
+/**
+ * @file test_melody_poly.c
+ * @brief Unit test for the merge of the voices of a melody into a stream of chords.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* Other libraries */
+#include "melody_poly.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Global variables */
+static melody_poly_cursor_t cursor;
+
+static const melody_event_t upper_events[] = {MELODY_EVENT(DO5, 300), MELODY_EVENT(RE5, 100), MELODY_EVENT(MI5, 400)};
+static const melody_event_t lower_events[] = {MELODY_EVENT(DO4, 200), MELODY_EVENT(SOL3, 0), MELODY_EVENT(SOL3, 400)};
+static const melody_t upper = {.p_name = "upper", .p_events = upper_events, .melody_length = 3};
+static const melody_t lower = {.p_name = "lower", .p_events = lower_events, .melody_length = 3};
+static const melody_poly_t two_voices = {.p_name = "two voices", .p_voices = {&upper, &lower}, .num_voices = 2};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief The voices are merged into frames that end when any note ends, and the voice that ends first is silent. Only
+ * the first frame of each note marks its onset.
+ *
+ */
+void test_merge(void)
+{
+    /* Upper: DO5 0-300, RE5 300-400, MI5 400-800. Lower: DO4 0-200, SOL3 200-600 (the empty event is skipped) */
+    const melody_frame_t expected[] = {
+        {.notes = {MIDI_DO5, MIDI_DO4}, .num_voices = 2, .onsets = 0x3, .duration_ms = 200},
+        {.notes = {MIDI_DO5, MIDI_SOL3}, .num_voices = 2, .onsets = 0x2, .duration_ms = 100},
+        {.notes = {MIDI_RE5, MIDI_SOL3}, .num_voices = 2, .onsets = 0x1, .duration_ms = 100},
+        {.notes = {MIDI_MI5, MIDI_SOL3}, .num_voices = 2, .onsets = 0x1, .duration_ms = 200},
+        {.notes = {MIDI_MI5, MIDI_SILENCE}, .num_voices = 2, .onsets = 0x2, .duration_ms = 200}};
+    melody_frame_t frame;
+
+    melody_poly_rewind(&cursor, &two_voices);
+    for (uint32_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++)
+    {
+        UNITY_TEST_ASSERT(melody_poly_next(&cursor, &frame), __LINE__, "The melody has ended before its longest voice");
+        UNITY_TEST_ASSERT_EQUAL_INT(expected[i].num_voices, frame.num_voices, __LINE__, "The number of voices is not correct");
+        UNITY_TEST_ASSERT_EQUAL_INT(expected[i].notes[0], frame.notes[0], __LINE__, "The note of the first voice is not correct");
+        UNITY_TEST_ASSERT_EQUAL_INT(expected[i].notes[1], frame.notes[1], __LINE__, "The note of the second voice is not correct");
+        UNITY_TEST_ASSERT_EQUAL_INT(expected[i].duration_ms, frame.duration_ms, __LINE__, "The duration of the frame is not correct");
+        UNITY_TEST_ASSERT_EQUAL_INT(expected[i].onsets, frame.onsets, __LINE__, "The notes that start in the frame are not correct");
+    }
+    UNITY_TEST_ASSERT(!melody_poly_has_next(&cursor), __LINE__, "The melody has not ended with its longest voice");
+    UNITY_TEST_ASSERT(!melody_poly_next(&cursor, &frame), __LINE__, "A frame has been returned after the end");
+}
+
+/**
+ * @brief The frames of the Tetris melody with bass add up to the length of each voice, and each voice sounds its own
+ * notes in order.
+ *
+ */
+void test_tetris_voices(void)
+{
+    melody_frame_t frame;
+    uint32_t total_ms = 0;
+    uint32_t frames = 0;
+    uint32_t voice_ms[2] = {0, 0};
+    uint32_t voice_index[2] = {0, 0};
+    uint32_t voice_elapsed[2] = {0, 0};
+
+    melody_poly_rewind(&cursor, &tetris_poly_melody);
+    while (melody_poly_next(&cursor, &frame))
+    {
+        for (uint32_t v = 0; v < 2; v++)
+        {
+            const melody_t *p_voice = tetris_poly_melody.p_voices[v];
+            if (voice_index[v] >= p_voice->melody_length)
+            {
+                UNITY_TEST_ASSERT_EQUAL_INT(MIDI_SILENCE, frame.notes[v], __LINE__, "A voice that has ended must be silent");
+                continue;
+            }
+            UNITY_TEST_ASSERT_EQUAL_INT(p_voice->p_events[voice_index[v]].note, frame.notes[v], __LINE__, "The voice does not sound its own note");
+            voice_elapsed[v] += frame.duration_ms;
+            voice_ms[v] += frame.duration_ms;
+            if (voice_elapsed[v] == MELODY_EVENT_DURATION_MS(&p_voice->p_events[voice_index[v]]))
+            {
+                voice_elapsed[v] = 0;
+                voice_index[v]++;
+            }
+        }
+        total_ms += frame.duration_ms;
+        frames++;
+    }
+    printf("%s: %lu frames, %lu ms\n", tetris_poly_melody.p_name, (unsigned long)frames, (unsigned long)total_ms);
+    UNITY_TEST_ASSERT_EQUAL_INT(tetris_melody.melody_length, voice_index[0], __LINE__, "Not all the notes of the melody have been played");
+    UNITY_TEST_ASSERT_EQUAL_INT(tetris_poly_melody.p_voices[1]->melody_length, voice_index[1], __LINE__, "Not all the notes of the bass have been played");
+    UNITY_TEST_ASSERT_EQUAL_INT(voice_ms[0], total_ms, __LINE__, "The frames do not add up to the length of the melody");
+    UNITY_TEST_ASSERT_EQUAL_INT(voice_ms[1], total_ms, __LINE__, "The bass does not last as long as the melody");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_merge);
+    RUN_TEST(test_tetris_voices);
+
+    return UNITY_END();
+}
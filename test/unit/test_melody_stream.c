@@ -0,0 +1,171 @@
+/**
+ * @file test_melody_stream.c
+ * @brief Unit test for the double-buffered streaming of melodies and its memory blob and upload sources.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+/* Other libraries */
+#include "melody_stream.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define LONG_MELODY_EVENTS 1000U /*!< Number of events of the long melody of the tests */
+
+/* Global variables */
+static melody_stream_t stream;
+static melody_stream_upload_t upload;
+static uint8_t long_blob[LONG_MELODY_EVENTS * sizeof(melody_event_t)]; /*!< Long melody, as it would be in flash */
+
+void setUp(void)
+{
+    for (uint32_t i = 0; i < LONG_MELODY_EVENTS; i++)
+    {
+        long_blob[2U * i] = (uint8_t)(MIDI_DO3 + (i % 36U));
+        long_blob[2U * i + 1U] = (uint8_t)(1U + (i % 100U));
+    }
+    melody_stream_upload_init(&upload);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief A melody of the jukebox streamed from a blob is played event by event, and the first chunk is read on open.
+ *
+ */
+void test_blob_source(void)
+{
+    melody_stream_blob_t blob = {.p_data = (const uint8_t *)tetris_melody.p_events, .size = tetris_melody.melody_length * sizeof(melody_event_t)};
+    melody_event_t event;
+
+    melody_stream_open(&stream, melody_stream_read_blob, &blob);
+    UNITY_TEST_ASSERT_EQUAL_INT(1, stream.chunks_loaded, __LINE__, "The first chunk has not been read on open");
+
+    for (uint32_t i = 0; i < tetris_melody.melody_length; i++)
+    {
+        UNITY_TEST_ASSERT(melody_stream_next(&stream, &event), __LINE__, "The stream has ended before the melody");
+        UNITY_TEST_ASSERT_EQUAL_INT(tetris_melody.p_events[i].note, event.note, __LINE__, "The note is not the one of the melody");
+        UNITY_TEST_ASSERT_EQUAL_INT(tetris_melody.p_events[i].duration, event.duration, __LINE__, "The duration is not the one of the melody");
+        melody_stream_prefetch(&stream);
+    }
+    UNITY_TEST_ASSERT(!melody_stream_has_next(&stream), __LINE__, "The stream has not ended with the melody");
+    UNITY_TEST_ASSERT(!melody_stream_next(&stream, &event), __LINE__, "An event has been returned after the end");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, stream.underruns, __LINE__, "A chunk has not been prefetched");
+
+    melody_stream_rewind(&stream);
+    UNITY_TEST_ASSERT(melody_stream_next(&stream, &event), __LINE__, "The stream has not been rewound");
+    UNITY_TEST_ASSERT_EQUAL_INT(tetris_melody.p_events[0].note, event.note, __LINE__, "The stream has not been rewound to the first event");
+}
+
+/**
+ * @brief A long melody is played with the RAM of two chunks. With prefetch the next chunk is always ready when the
+ * current one ends; without it, every chunk after the first is read when it is needed.
+ *
+ */
+void test_prefetch(void)
+{
+    melody_stream_blob_t blob = {.p_data = long_blob, .size = sizeof(long_blob)};
+    melody_event_t event;
+    uint32_t expected_chunks = (LONG_MELODY_EVENTS + MELODY_STREAM_CHUNK_EVENTS - 1U) / MELODY_STREAM_CHUNK_EVENTS;
+    uint32_t count = 0;
+
+    melody_stream_open(&stream, melody_stream_read_blob, &blob);
+    while (melody_stream_next(&stream, &event))
+    {
+        UNITY_TEST_ASSERT_EQUAL_INT(long_blob[2U * count], event.note, __LINE__, "The note is not the one of the blob");
+        count++;
+        melody_stream_prefetch(&stream);
+    }
+    UNITY_TEST_ASSERT_EQUAL_INT(LONG_MELODY_EVENTS, count, __LINE__, "The long melody has not been played completely");
+    UNITY_TEST_ASSERT_EQUAL_INT(expected_chunks, stream.chunks_loaded, __LINE__, "The chunks have not been read once each");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, stream.underruns, __LINE__, "A chunk has not been prefetched");
+
+    count = 0;
+    melody_stream_open(&stream, melody_stream_read_blob, &blob);
+    while (melody_stream_next(&stream, &event))
+    {
+        count++;
+    }
+    UNITY_TEST_ASSERT_EQUAL_INT(LONG_MELODY_EVENTS, count, __LINE__, "The long melody has not been played completely without prefetch");
+    UNITY_TEST_ASSERT_EQUAL_INT(expected_chunks - 1U, stream.underruns, __LINE__, "The chunks have not been read on demand");
+
+    printf("Stream of %lu events: %lu bytes of RAM, %lu chunks\n", (unsigned long)LONG_MELODY_EVENTS,
+           (unsigned long)sizeof(melody_stream_t), (unsigned long)expected_chunks);
+}
+
+/**
+ * @brief Events uploaded in hexadecimal are played while more are uploaded; the source waits with silences when it is
+ * empty and ends when it is closed.
+ *
+ */
+void test_upload_source(void)
+{
+    melody_event_t event;
+
+    UNITY_TEST_ASSERT(melody_stream_upload_put_hex(&upload, "450a4714", 8), __LINE__, "Valid events have been rejected");
+    UNITY_TEST_ASSERT(!melody_stream_upload_put_hex(&upload, "45", 2), __LINE__, "An incomplete event has been accepted");
+    UNITY_TEST_ASSERT(!melody_stream_upload_put_hex(&upload, "45zz", 4), __LINE__, "An invalid digit has been accepted");
+
+    melody_stream_open(&stream, melody_stream_read_upload, &upload);
+    UNITY_TEST_ASSERT(melody_stream_next(&stream, &event), __LINE__, "The first uploaded event has not been played");
+    UNITY_TEST_ASSERT_EQUAL_INT(MIDI_LA4, event.note, __LINE__, "The uploaded note is not LA4");
+    UNITY_TEST_ASSERT_EQUAL_INT(100, MELODY_EVENT_DURATION_MS(&event), __LINE__, "The uploaded duration is not 100 ms");
+    UNITY_TEST_ASSERT(melody_stream_next(&stream, &event), __LINE__, "The second uploaded event has not been played");
+    UNITY_TEST_ASSERT_EQUAL_INT(MIDI_SI4, event.note, __LINE__, "The uploaded note is not SI4");
+
+    /* Nothing uploaded yet: a short silence is played */
+    UNITY_TEST_ASSERT(melody_stream_next(&stream, &event), __LINE__, "The stream has ended before the upload is closed");
+    UNITY_TEST_ASSERT_EQUAL_INT(MIDI_SILENCE, event.note, __LINE__, "The stream does not wait with a silence");
+    UNITY_TEST_ASSERT_EQUAL_INT(MELODY_STREAM_WAIT_MS, MELODY_EVENT_DURATION_MS(&event), __LINE__, "The silence is not MELODY_STREAM_WAIT_MS");
+    UNITY_TEST_ASSERT_EQUAL_INT(1, upload.waits, __LINE__, "The wait has not been counted");
+
+    UNITY_TEST_ASSERT(melody_stream_upload_put_hex(&upload, "3c28", 4), __LINE__, "An event has been rejected after a wait");
+    melody_stream_upload_close(&upload);
+    UNITY_TEST_ASSERT(melody_stream_next(&stream, &event), __LINE__, "An event uploaded later has not been played");
+    UNITY_TEST_ASSERT_EQUAL_INT(MIDI_DO4, event.note, __LINE__, "The uploaded note is not DO4");
+    UNITY_TEST_ASSERT(!melody_stream_next(&stream, &event), __LINE__, "The stream has not ended after the upload was closed");
+    UNITY_TEST_ASSERT(!melody_stream_upload_put_hex(&upload, "3c28", 4), __LINE__, "An event has been accepted after the upload was closed");
+}
+
+/**
+ * @brief The FIFO of the upload source rejects the events that do not fit.
+ *
+ */
+void test_upload_full(void)
+{
+    char hex[4U * 8U + 1U];
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        memcpy(&hex[4U * i], "4514", 4);
+    }
+    for (uint32_t i = 0; i < MELODY_STREAM_UPLOAD_EVENTS / 8U; i++)
+    {
+        UNITY_TEST_ASSERT(melody_stream_upload_put_hex(&upload, hex, 4U * 8U), __LINE__, "Events that fit have been rejected");
+    }
+    UNITY_TEST_ASSERT(!melody_stream_upload_put_hex(&upload, hex, 4U), __LINE__, "An event has been accepted in a full FIFO");
+
+    melody_event_t events[MELODY_STREAM_CHUNK_EVENTS];
+    UNITY_TEST_ASSERT_EQUAL_INT(MELODY_STREAM_CHUNK_EVENTS, melody_stream_read_upload(&upload, 0, events, MELODY_STREAM_CHUNK_EVENTS), __LINE__, "A full chunk has not been read");
+    UNITY_TEST_ASSERT(melody_stream_upload_put_hex(&upload, hex, 4U * 8U), __LINE__, "Events have been rejected after a read");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_blob_source);
+    RUN_TEST(test_prefetch);
+    RUN_TEST(test_upload_source);
+    RUN_TEST(test_upload_full);
+
+    return UNITY_END();
+}
@@ -268,11 +268,9 @@ void test_buffer_reset(void)
     // Call configuration function
     port_usart_init(USART_0_ID);
 
-    // Check that the input and output buffers are reset with the EMPTY value
-    for (int i = 0; i < USART_INPUT_BUFFER_LENGTH; i++)
-    {
-        UNITY_TEST_ASSERT_EQUAL_UINT8(EMPTY_BUFFER_CONSTANT, usart_arr[USART_0_ID].input_buffer[i], __LINE__, "ERROR: USART input buffer is not reset with the EMPTY_BUFFER_CONSTANT value");
-    }
+    // Check that the RX ring is empty and the output buffer is reset with the EMPTY value
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_usart_get_lines_pending(USART_0_ID), __LINE__, "ERROR: USART RX ring is not empty after the initialization");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_usart_get_rx_overruns(USART_0_ID), __LINE__, "ERROR: USART RX overrun counter is not reset");
 
     for (int i = 0; i < USART_OUTPUT_BUFFER_LENGTH; i++)
     {
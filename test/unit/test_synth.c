@@ -0,0 +1,234 @@
+/**
+ * @file test_synth.c
+ * @brief Unit test for the wavetable synthesizer: tables, pitch, envelopes, timing of the sequencer and cost per sample.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+/* Other libraries */
+#include "synth.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Defines */
+#define TEST_SAMPLE_RATE_HZ 16000U /*!< Sample rate of the tests */
+#define TEST_SAMPLES_PER_MS (TEST_SAMPLE_RATE_HZ / 1000U) /*!< Samples per millisecond */
+#define TEST_MAX_SAMPLES (TEST_SAMPLE_RATE_HZ * 30U) /*!< Samples of the longest render (30 s) */
+#define TEST_MAX_FRAMES 64U /*!< Frames recorded of a melody */
+
+/* Global variables */
+static int16_t samples[TEST_MAX_SAMPLES];
+
+void setUp(void)
+{
+    synth_init(TEST_SAMPLE_RATE_HZ);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Peak amplitude of some samples.
+ *
+ * @param p_samples Pointer to the samples
+ * @param num_samples Number of samples
+ * @return int32_t Maximum absolute value
+ */
+static int32_t _peak(const int16_t *p_samples, uint32_t num_samples)
+{
+    int32_t peak = 0;
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        int32_t value = (p_samples[i] < 0) ? -p_samples[i] : p_samples[i];
+        peak = (value > peak) ? value : peak;
+    }
+    return peak;
+}
+
+/**
+ * @brief The sine table matches the sine within 0.2 % and the tables repeat their first sample at the end.
+ *
+ */
+void test_tables(void)
+{
+    const int16_t *p_sine = synth_get_table(SYNTH_WAVE_SINE);
+    double max_error = 0;
+    for (uint32_t i = 0; i < SYNTH_TABLE_SIZE; i++)
+    {
+        double ideal = SYNTH_LEVEL_ONE * sin(2.0 * M_PI * i / SYNTH_TABLE_SIZE);
+        double error = fabs(p_sine[i] - ideal) / SYNTH_LEVEL_ONE;
+        max_error = (error > max_error) ? error : max_error;
+    }
+    printf("Sine table: max error %.3f %%\n", 100.0 * max_error);
+    UNITY_TEST_ASSERT(max_error < 0.002, __LINE__, "The sine table is not accurate enough");
+    UNITY_TEST_ASSERT_EQUAL_INT(SYNTH_LEVEL_ONE, p_sine[SYNTH_TABLE_SIZE / 4], __LINE__, "The peak of the sine is not full scale");
+
+    const int16_t *p_triangle = synth_get_table(SYNTH_WAVE_TRIANGLE);
+    UNITY_TEST_ASSERT_EQUAL_INT(SYNTH_LEVEL_ONE, p_triangle[SYNTH_TABLE_SIZE / 4], __LINE__, "The peak of the triangle is not full scale");
+    UNITY_TEST_ASSERT_EQUAL_INT(-SYNTH_LEVEL_ONE, p_triangle[3 * SYNTH_TABLE_SIZE / 4], __LINE__, "The valley of the triangle is not full scale");
+    for (uint32_t w = 0; w < SYNTH_NUM_WAVES; w++)
+    {
+        const int16_t *p_table = synth_get_table(w);
+        UNITY_TEST_ASSERT_EQUAL_INT(p_table[0], p_table[SYNTH_TABLE_SIZE], __LINE__, "The guard sample must repeat the first one");
+    }
+    UNITY_TEST_ASSERT(synth_get_table(SYNTH_NUM_WAVES) == NULL, __LINE__, "An unknown waveform has a table");
+}
+
+/**
+ * @brief A note sounds at its frequency: the number of cycles in one second is the frequency of the note.
+ *
+ */
+void test_note_frequency(void)
+{
+    synth_set_voice(0, SYNTH_WAVE_SINE, NULL);
+    synth_note_on(0, MIDI_LA4);
+    synth_render(samples, TEST_SAMPLE_RATE_HZ);
+
+    uint32_t cycles = 0;
+    for (uint32_t i = 1; i < TEST_SAMPLE_RATE_HZ; i++)
+    {
+        cycles += ((samples[i - 1] < 0) && (samples[i] >= 0)) ? 1U : 0U;
+    }
+    printf("LA4: %lu cycles in 1 s\n", (unsigned long)cycles);
+    UNITY_TEST_ASSERT((cycles >= 439) && (cycles <= 441), __LINE__, "The note does not sound at 440 Hz");
+    UNITY_TEST_ASSERT(synth_is_active(), __LINE__, "The note must keep sounding until it is released");
+}
+
+/**
+ * @brief The envelope rises in the attack, decays to the sustain level, and the voice goes idle after the release.
+ *
+ */
+void test_envelope(void)
+{
+    const synth_adsr_t adsr = {.attack_ms = 10, .decay_ms = 20, .sustain = SYNTH_LEVEL_ONE / 2, .release_ms = 30};
+    const uint32_t ms = TEST_SAMPLES_PER_MS;
+    synth_set_voice(0, SYNTH_WAVE_SQUARE, &adsr);
+    synth_note_on(0, MIDI_LA4);
+    synth_render(samples, 100 * ms);
+
+    int32_t full = _peak(&samples[10 * ms], 2 * ms);
+    int32_t sustain = _peak(&samples[60 * ms], 10 * ms);
+    printf("Envelope: start %ld, full %ld, sustain %ld\n", (long)_peak(samples, ms), (long)full, (long)sustain);
+    UNITY_TEST_ASSERT(_peak(samples, ms) < full / 5, __LINE__, "The attack does not start from silence");
+    UNITY_TEST_ASSERT(full >= SYNTH_VOICE_GAIN - 2, __LINE__, "The attack does not reach full level");
+    UNITY_TEST_ASSERT(abs(sustain - SYNTH_VOICE_GAIN / 2) < 64, __LINE__, "The decay does not end at the sustain level");
+
+    synth_note_off(0);
+    synth_render(samples, 40 * ms);
+    UNITY_TEST_ASSERT(_peak(&samples[28 * ms], 2 * ms) < sustain / 5, __LINE__, "The release does not end in time");
+    UNITY_TEST_ASSERT(!synth_is_active(), __LINE__, "The voice must be idle after the release");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, _peak(&samples[32 * ms], 8 * ms), __LINE__, "An idle voice must be silent");
+}
+
+/**
+ * @brief Each frame of a melody starts at its ideal position truncated to the sample, at some speed.
+ *
+ * @param speed Speed of the sequencer in Q16.16
+ */
+static void _check_sequencer(uint32_t speed)
+{
+    uint64_t starts[TEST_MAX_FRAMES];
+    uint32_t num_frames = 0;
+    uint64_t sample = 0;
+    synth_stats_t before, after;
+    int16_t value;
+
+    /* One sample at a time, to see the sample in which each frame starts */
+    synth_play(&tetris_poly_melody, speed);
+    while (synth_is_playing() && (num_frames < TEST_MAX_FRAMES))
+    {
+        synth_get_stats(&before);
+        synth_render(&value, 1);
+        synth_get_stats(&after);
+        if (after.frames != before.frames)
+        {
+            starts[num_frames++] = sample;
+        }
+        sample++;
+    }
+
+    melody_poly_cursor_t cursor;
+    melody_frame_t frame;
+    uint64_t position_ms = 0;
+    uint32_t i = 0;
+    melody_poly_rewind(&cursor, &tetris_poly_melody);
+    while (melody_poly_next(&cursor, &frame))
+    {
+        uint64_t ideal = ((position_ms * TEST_SAMPLE_RATE_HZ) << SYNTH_SPEED_SHIFT) / (1000ULL * speed);
+        UNITY_TEST_ASSERT(i < num_frames, __LINE__, "A frame of the melody has not been played");
+        UNITY_TEST_ASSERT(starts[i] == ideal, __LINE__, "The frame does not start at its ideal sample");
+        position_ms += frame.duration_ms;
+        i++;
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(i, num_frames, __LINE__, "The sequencer has played more frames than the melody has");
+
+    /* The sequencer notices the end of the last frame when it renders the next sample */
+    uint64_t ideal_end = ((position_ms * TEST_SAMPLE_RATE_HZ) << SYNTH_SPEED_SHIFT) / (1000ULL * speed);
+    printf("Speed %.2f: %lu frames, %llu samples (ideal %llu)\n", (double)speed / SYNTH_SPEED_ONE,
+           (unsigned long)num_frames, (unsigned long long)(sample - 1), (unsigned long long)ideal_end);
+    UNITY_TEST_ASSERT(sample - 1 == ideal_end, __LINE__, "The melody does not end at its ideal sample");
+}
+
+/**
+ * @brief The sequencer plays the melody with bass with the length of the melody at any speed.
+ *
+ */
+void test_sequencer_timing(void)
+{
+    _check_sequencer(SYNTH_SPEED_ONE);
+    _check_sequencer((uint32_t)(1.7 * SYNTH_SPEED_ONE + 0.5));
+    _check_sequencer((uint32_t)(0.75 * SYNTH_SPEED_ONE + 0.5));
+}
+
+/**
+ * @brief Cost of the mix per sample on the host, with the melody with bass. It is only printed: it depends on the
+ * load of the host. The test checks that the melody ends and the mix does not overflow.
+ *
+ */
+void test_benchmark(void)
+{
+    uint32_t rendered = 0;
+    struct timespec start, end;
+    synth_set_voice(2, SYNTH_WAVE_SINE, NULL);
+    synth_set_voice(3, SYNTH_WAVE_SQUARE, NULL);
+    synth_note_on(2, MIDI_DO5);
+    synth_note_on(3, MIDI_SOL3);
+    synth_play(&tetris_poly_melody, SYNTH_SPEED_ONE);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (synth_is_playing() && (rendered + SYNTH_BLOCK_SAMPLES * 8U <= TEST_MAX_SAMPLES))
+    {
+        synth_render(&samples[rendered], SYNTH_BLOCK_SAMPLES * 8U);
+        rendered += SYNTH_BLOCK_SAMPLES * 8U;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    double ns_per_sample = ns / rendered;
+    printf("Benchmark: %lu samples with %lu voices, %.1f ns/sample (%.0fx real time)\n", (unsigned long)rendered,
+           (unsigned long)SYNTH_NUM_VOICES, ns_per_sample, 1e9 / TEST_SAMPLE_RATE_HZ / ns_per_sample);
+    UNITY_TEST_ASSERT(!synth_is_playing(), __LINE__, "The melody has not ended");
+    UNITY_TEST_ASSERT(_peak(samples, rendered) <= INT16_MAX, __LINE__, "The mix has overflowed");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_tables);
+    RUN_TEST(test_note_frequency);
+    RUN_TEST(test_envelope);
+    RUN_TEST(test_sequencer_timing);
+    RUN_TEST(test_benchmark);
+
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+/**
+ * @file test_tokenizer.c
+ * @brief Unit test for the tokenizer of the commands, with a throughput test.
+ *
+ * The throughput test compares the tokenizer with the previous parser, which copied the message out of the USART FSM
+ * and then each token with strtok() and strcpy(). Bytes copied are counted for both of them.
+ *
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+/* HW dependent libraries */
+#include "port_system.h"
+
+/* Other libraries */
+#include "tokenizer.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define BENCHMARK_ROUNDS 10000 /*!< Number of times each command is parsed in the throughput test */
+#define BUFFER_LENGTH 32       /*!< Size of the buffer of the commands in the throughput test */
+#define MAX_TOKENS 5           /*!< Maximum number of tokens of a command */
+
+/* Global variables */
+static const char *commands[] = {"play", "speed 1.5", "select 3", "next", "info", "stop"}; /*!< Commands parsed in the throughput test */
+static uint32_t bytes_copied;                                                              /*!< Bytes copied by the previous parser */
+
+/**
+ * @brief Previous parser: copy of the message and strtok() + strcpy() of the command and the parameter.
+ *
+ * @param p_in_data Buffer of the USART FSM
+ * @param p_command Buffer to store the command
+ * @param p_param Buffer to store the parameter
+ * @return true if there is a command, false otherwise
+ */
+static bool _strtok_parse(const char *p_in_data, char *p_command, char *p_param)
+{
+    char message[BUFFER_LENGTH];
+    memcpy(message, p_in_data, BUFFER_LENGTH);
+    bytes_copied += BUFFER_LENGTH;
+
+    char *p_token = strtok(message, " ");
+    if (p_token == NULL)
+    {
+        return false;
+    }
+    strcpy(p_command, p_token);
+    bytes_copied += strlen(p_token) + 1;
+    p_token = strtok(NULL, " ");
+    if (p_token != NULL)
+    {
+        strcpy(p_param, p_token);
+        bytes_copied += strlen(p_token) + 1;
+    }
+    else
+    {
+        p_param[0] = '\0';
+    }
+    return true;
+}
+
+/**
+ * @brief Check that a token is a view of the given string inside a buffer.
+ *
+ * @param p_buffer Source buffer
+ * @param length Size of the source buffer
+ * @param p_token Token
+ * @param p_expected Expected text of the token
+ * @return true if the token points into the buffer and has the expected text
+ */
+static bool _is_view(const char *p_buffer, uint32_t length, const token_t *p_token, const char *p_expected)
+{
+    return (p_token->p_start >= p_buffer) && (p_token->p_start + p_token->length <= p_buffer + length) &&
+           tokenizer_equals(p_token, p_expected);
+}
+
+void setUp(void)
+{
+    port_system_init();
+    bytes_copied = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief A command with several arguments is split into views of the source buffer.
+ *
+ */
+void test_split_arguments(void)
+{
+    const char buffer[] = "  select\t3  extra\r\n";
+    token_t tokens[MAX_TOKENS];
+    uint32_t num_tokens = tokenizer_split(buffer, sizeof(buffer), tokens, MAX_TOKENS);
+
+    UNITY_TEST_ASSERT_EQUAL_INT(3, num_tokens, __LINE__, "The number of tokens is not correct");
+    UNITY_TEST_ASSERT(_is_view(buffer, sizeof(buffer), &tokens[0], "select"), __LINE__, "The command is not correct");
+    UNITY_TEST_ASSERT(_is_view(buffer, sizeof(buffer), &tokens[1], "3"), __LINE__, "The first argument is not correct");
+    UNITY_TEST_ASSERT(_is_view(buffer, sizeof(buffer), &tokens[2], "extra"), __LINE__, "The second argument is not correct");
+
+    UNITY_TEST_ASSERT_EQUAL_INT(0, tokenizer_split("   \n", 4, tokens, MAX_TOKENS), __LINE__, "A blank line must have no tokens");
+    UNITY_TEST_ASSERT_EQUAL_INT(2, tokenizer_split("a b c d", 7, tokens, 2), __LINE__, "The tokens that do not fit must be discarded");
+}
+
+/**
+ * @brief Quoted tokens can contain blanks, and the quotes are not part of the token.
+ *
+ */
+void test_quoted_strings(void)
+{
+    const char buffer[] = "load \"happy birthday\" \"\" \"open";
+    token_t tokens[MAX_TOKENS];
+    uint32_t num_tokens = tokenizer_split(buffer, sizeof(buffer), tokens, MAX_TOKENS);
+
+    UNITY_TEST_ASSERT_EQUAL_INT(4, num_tokens, __LINE__, "The number of tokens is not correct");
+    UNITY_TEST_ASSERT(tokenizer_equals(&tokens[1], "happy birthday"), __LINE__, "The quoted token is not correct");
+    UNITY_TEST_ASSERT_EQUAL_INT(0, tokens[2].length, __LINE__, "An empty quoted token must have length 0");
+    UNITY_TEST_ASSERT(tokenizer_equals(&tokens[3], "open"), __LINE__, "An unterminated quoted token must extend to the end");
+}
+
+/**
+ * @brief The tokenizer stops at the end of the buffer even if it is not null-terminated, and never writes to it.
+ *
+ */
+void test_bounded_read_only(void)
+{
+    const char buffer[10] = {'s', 'e', 'l', 'e', 'c', 't', ' ', '1', '2', '3'}; /* Full buffer, no '\0' */
+    char snapshot[sizeof(buffer)];
+    memcpy(snapshot, buffer, sizeof(buffer));
+
+    token_t tokens[MAX_TOKENS];
+    uint32_t num_tokens = tokenizer_split(buffer, sizeof(buffer), tokens, MAX_TOKENS);
+    UNITY_TEST_ASSERT_EQUAL_INT(2, num_tokens, __LINE__, "The number of tokens is not correct");
+    UNITY_TEST_ASSERT(tokenizer_equals(&tokens[1], "123"), __LINE__, "The last token must end at the end of the buffer");
+    UNITY_TEST_ASSERT(memcmp(buffer, snapshot, sizeof(buffer)) == 0, __LINE__, "The source buffer has been modified");
+
+    /* Two tokenizers on different buffers can be interleaved */
+    tokenizer_t first, second;
+    token_t token;
+    tokenizer_init(&first, "a b", 3);
+    tokenizer_init(&second, "c d", 3);
+    tokenizer_next(&first, &token);
+    tokenizer_next(&second, &token);
+    tokenizer_next(&first, &token);
+    UNITY_TEST_ASSERT(tokenizer_equals(&token, "b"), __LINE__, "The tokenizer is not reentrant");
+}
+
+/**
+ * @brief Throughput and bytes copied per command compared with the previous parser.
+ *
+ */
+void test_throughput(void)
+{
+    uint32_t num_commands = sizeof(commands) / sizeof(commands[0]);
+    char in_data[sizeof(commands) / sizeof(commands[0])][BUFFER_LENGTH];
+    char snapshot[sizeof(commands) / sizeof(commands[0])][BUFFER_LENGTH];
+    char command[BUFFER_LENGTH];
+    char param[BUFFER_LENGTH];
+    token_t tokens[MAX_TOKENS];
+    volatile uint32_t found = 0;
+
+    memset(in_data, 0, sizeof(in_data));
+    for (uint32_t i = 0; i < num_commands; i++)
+    {
+        strcpy(in_data[i], commands[i]);
+    }
+    memcpy(snapshot, in_data, sizeof(in_data));
+
+    uint32_t start = port_system_get_cycles();
+    for (uint32_t r = 0; r < BENCHMARK_ROUNDS; r++)
+    {
+        for (uint32_t i = 0; i < num_commands; i++)
+        {
+            found += _strtok_parse(in_data[i], command, param);
+        }
+    }
+    uint32_t strtok_cycles = port_system_get_cycles() - start;
+    uint32_t strtok_bytes = bytes_copied;
+
+    start = port_system_get_cycles();
+    for (uint32_t r = 0; r < BENCHMARK_ROUNDS; r++)
+    {
+        for (uint32_t i = 0; i < num_commands; i++)
+        {
+            found += (tokenizer_split(in_data[i], BUFFER_LENGTH, tokens, MAX_TOKENS) > 0);
+        }
+    }
+    uint32_t tokenizer_cycles = port_system_get_cycles() - start;
+
+    UNITY_TEST_ASSERT_EQUAL_INT(2 * num_commands * BENCHMARK_ROUNDS, found, __LINE__, "Both parsers must find the same commands");
+    UNITY_TEST_ASSERT(memcmp(in_data, snapshot, sizeof(in_data)) == 0, __LINE__, "The tokenizer has modified the source buffers");
+    printf("Per command: strtok parser %lu cycles, %lu bytes copied; tokenizer %lu cycles, 0 bytes copied (cycles are ns on host)\n",
+           (unsigned long)(strtok_cycles / (BENCHMARK_ROUNDS * num_commands)),
+           (unsigned long)(strtok_bytes / (BENCHMARK_ROUNDS * num_commands)),
+           (unsigned long)(tokenizer_cycles / (BENCHMARK_ROUNDS * num_commands)));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_split_arguments);
+    RUN_TEST(test_quoted_strings);
+    RUN_TEST(test_bounded_read_only);
+    RUN_TEST(test_throughput);
+
+    return UNITY_END();
+}
@@ -0,0 +1,100 @@
+/**
+ * @file test_usart_baud.c
+ * @brief Unit test for the baud rate arithmetic of the USART: BRR, OVER8, error of the real rate and autobaud.
+ * @author Alejandro Gómez Ruiz
+ * @author Mariano Lorenzo Kayser
+ * @date 17/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* Other libraries */
+#include "usart_baud.h"
+
+/* Test dependencies */
+#include <unity.h>
+
+/* Private defines ------------------------------------------------------------*/
+#define TEST_HSI_HZ 16000000U /*!< Clock of the APB1 bus with the HSI */
+#define TEST_APB1_HZ 45000000U /*!< Clock of the APB1 bus with the PLL at 180 MHz */
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief At 16 MHz, 9600 bauds gives the BRR written by hand before, and all the standard rates up to 921600 are
+ * reachable within 2.5 %.
+ *
+ */
+void test_brr(void)
+{
+    usart_baud_t baud;
+    UNITY_TEST_ASSERT(usart_baud_compute(TEST_HSI_HZ, 9600, &baud), __LINE__, "9600 bauds must be reachable");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0x683, baud.brr, __LINE__, "The BRR of 9600 bauds is not correct");
+    UNITY_TEST_ASSERT(!baud.over8, __LINE__, "9600 bauds must use oversampling by 16");
+
+    const uint32_t rates[] = {1200, 9600, 57600, 115200, 230400, 460800, 921600};
+    for (uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        UNITY_TEST_ASSERT(usart_baud_compute(TEST_HSI_HZ, rates[i], &baud), __LINE__, "A standard rate is not reachable at 16 MHz");
+        printf("%6lu bauds: BRR 0x%04lX, OVER8 %d, real %lu (%.2f %%)\n", (unsigned long)rates[i], (unsigned long)baud.brr,
+               baud.over8, (unsigned long)baud.actual, baud.error_ppm / 10000.0);
+    }
+    UNITY_TEST_ASSERT(usart_baud_compute(TEST_APB1_HZ, 921600, &baud), __LINE__, "921600 bauds must be reachable at 45 MHz");
+    UNITY_TEST_ASSERT(baud.error_ppm < 5000, __LINE__, "921600 bauds at 45 MHz must be within 0.5 %");
+}
+
+/**
+ * @brief Dividers below 16 use OVER8 with a 3-bit fraction; rates out of range or too far from the divider are
+ * refused.
+ *
+ */
+void test_over8(void)
+{
+    usart_baud_t baud;
+    /* With a divider of 9 the real rate is 3.5 % off */
+    UNITY_TEST_ASSERT(!usart_baud_compute(8000000U, 921600, &baud), __LINE__, "921600 at 8 MHz must be refused");
+    UNITY_TEST_ASSERT(usart_baud_compute(7372800U, 921600, &baud), __LINE__, "921600 at 7.3728 MHz must be exact");
+    UNITY_TEST_ASSERT(baud.over8, __LINE__, "A divider of 8 must use OVER8");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0x10, baud.brr, __LINE__, "The BRR with OVER8 is not correct");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, baud.error_ppm, __LINE__, "The rate must be exact");
+
+    UNITY_TEST_ASSERT(usart_baud_compute(11059200U, 921600, &baud), __LINE__, "921600 at 11.0592 MHz must be exact");
+    UNITY_TEST_ASSERT(baud.over8, __LINE__, "A divider of 12 must use OVER8");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0x14, baud.brr, __LINE__, "The fraction with OVER8 must be in the 3 low bits");
+
+    UNITY_TEST_ASSERT(!usart_baud_compute(TEST_HSI_HZ, 1000, &baud), __LINE__, "A rate below the minimum must be refused");
+    UNITY_TEST_ASSERT(!usart_baud_compute(TEST_HSI_HZ, 1000000, &baud), __LINE__, "A rate above the maximum must be refused");
+    UNITY_TEST_ASSERT(!usart_baud_compute(4000000U, 921600, &baud), __LINE__, "A divider below 8 must be refused");
+}
+
+/**
+ * @brief The duration of a start bit gives the nearest standard rate, and a measure far from all of them gives 0.
+ *
+ */
+void test_detect(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(9600, usart_baud_detect(TEST_HSI_HZ, 1667), __LINE__, "A start bit of 9600 bauds is not detected");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(115200, usart_baud_detect(TEST_HSI_HZ, 139), __LINE__, "A start bit of 115200 bauds is not detected");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(115200, usart_baud_detect(TEST_HSI_HZ, 139 + 8), __LINE__, "The latency of the ISR must be tolerated");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(57600, usart_baud_detect(1000000000U, 17361), __LINE__, "A start bit measured in ns is not detected");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, usart_baud_detect(TEST_HSI_HZ, 1400), __LINE__, "A start bit between two rates must not be detected");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, usart_baud_detect(TEST_HSI_HZ, 0), __LINE__, "An empty start bit must not be detected");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_brr);
+    RUN_TEST(test_over8);
+    RUN_TEST(test_detect);
+
+    return UNITY_END();
+}